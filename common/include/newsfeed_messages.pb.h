@@ -36,6 +36,15 @@ namespace proto {
 class news;
 class newsDefaultTypeInternal;
 extern newsDefaultTypeInternal _news_default_instance_;
+class news_batch;
+class news_batchDefaultTypeInternal;
+extern news_batchDefaultTypeInternal _news_batch_default_instance_;
+class peer_ack;
+class peer_ackDefaultTypeInternal;
+extern peer_ackDefaultTypeInternal _peer_ack_default_instance_;
+class peer_news;
+class peer_newsDefaultTypeInternal;
+extern peer_newsDefaultTypeInternal _peer_news_default_instance_;
 class post_news_request;
 class post_news_requestDefaultTypeInternal;
 extern post_news_requestDefaultTypeInternal _post_news_request_default_instance_;
@@ -85,11 +94,12 @@ enum req_envelope_msg_type {
   req_envelope_msg_type_topic_response_t = 4,
   req_envelope_msg_type_post_news_request_t = 5,
   req_envelope_msg_type_post_news_response_t = 6,
-  req_envelope_msg_type_news_t = 7
+  req_envelope_msg_type_news_t = 7,
+  req_envelope_msg_type_news_batch_t = 8
 };
 bool req_envelope_msg_type_IsValid(int value);
 const req_envelope_msg_type req_envelope_msg_type_msg_type_MIN = req_envelope_msg_type_register_request_t;
-const req_envelope_msg_type req_envelope_msg_type_msg_type_MAX = req_envelope_msg_type_news_t;
+const req_envelope_msg_type req_envelope_msg_type_msg_type_MAX = req_envelope_msg_type_news_batch_t;
 const int req_envelope_msg_type_msg_type_ARRAYSIZE = req_envelope_msg_type_msg_type_MAX + 1;
 
 const ::google::protobuf::EnumDescriptor* req_envelope_msg_type_descriptor();
@@ -962,15 +972,146 @@ class news : public ::google::protobuf::Message /* @@protoc_insertion_point(clas
   ::std::string* release_data();
   void set_allocated_data(::std::string* data);
 
+  // optional int64 timestamp = 2;
+  bool has_timestamp() const;
+  void clear_timestamp();
+  static const int kTimestampFieldNumber = 2;
+  ::google::protobuf::int64 timestamp() const;
+  void set_timestamp(::google::protobuf::int64 value);
+
   // @@protoc_insertion_point(class_scope:newsfeed.proto.news)
  private:
   void set_has_data();
   void clear_has_data();
+  void set_has_timestamp();
+  void clear_has_timestamp();
 
   ::google::protobuf::internal::InternalMetadataWithArena _internal_metadata_;
   ::google::protobuf::internal::HasBits<1> _has_bits_;
   mutable int _cached_size_;
   ::google::protobuf::internal::ArenaStringPtr data_;
+  ::google::protobuf::int64 timestamp_;
+  friend struct protobuf_newsfeed_5fmessages_2eproto::TableStruct;
+};
+// -------------------------------------------------------------------
+
+class news_batch : public ::google::protobuf::Message /* @@protoc_insertion_point(class_definition:newsfeed.proto.news_batch) */ {
+ public:
+  news_batch();
+  virtual ~news_batch();
+
+  news_batch(const news_batch& from);
+
+  inline news_batch& operator=(const news_batch& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  #if LANG_CXX11
+  news_batch(news_batch&& from) noexcept
+    : news_batch() {
+    *this = ::std::move(from);
+  }
+
+  inline news_batch& operator=(news_batch&& from) noexcept {
+    if (GetArenaNoVirtual() == from.GetArenaNoVirtual()) {
+      if (this != &from) InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+  #endif
+  inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
+    return _internal_metadata_.unknown_fields();
+  }
+  inline ::google::protobuf::UnknownFieldSet* mutable_unknown_fields() {
+    return _internal_metadata_.mutable_unknown_fields();
+  }
+
+  static const ::google::protobuf::Descriptor* descriptor();
+  static const news_batch& default_instance();
+
+  static inline const news_batch* internal_default_instance() {
+    return reinterpret_cast<const news_batch*>(
+               &_news_batch_default_instance_);
+  }
+  static PROTOBUF_CONSTEXPR int const kIndexInFileMessages =
+    7;
+
+  void Swap(news_batch* other);
+  friend void swap(news_batch& a, news_batch& b) {
+    a.Swap(&b);
+  }
+
+  // implements Message ----------------------------------------------
+
+  inline news_batch* New() const PROTOBUF_FINAL { return New(NULL); }
+
+  news_batch* New(::google::protobuf::Arena* arena) const PROTOBUF_FINAL;
+  void CopyFrom(const ::google::protobuf::Message& from) PROTOBUF_FINAL;
+  void MergeFrom(const ::google::protobuf::Message& from) PROTOBUF_FINAL;
+  void CopyFrom(const news_batch& from);
+  void MergeFrom(const news_batch& from);
+  void Clear() PROTOBUF_FINAL;
+  bool IsInitialized() const PROTOBUF_FINAL;
+
+  size_t ByteSizeLong() const PROTOBUF_FINAL;
+  bool MergePartialFromCodedStream(
+      ::google::protobuf::io::CodedInputStream* input) PROTOBUF_FINAL;
+  void SerializeWithCachedSizes(
+      ::google::protobuf::io::CodedOutputStream* output) const PROTOBUF_FINAL;
+  ::google::protobuf::uint8* InternalSerializeWithCachedSizesToArray(
+      bool deterministic, ::google::protobuf::uint8* target) const PROTOBUF_FINAL;
+  int GetCachedSize() const PROTOBUF_FINAL { return _cached_size_; }
+  private:
+  void SharedCtor();
+  void SharedDtor();
+  void SetCachedSize(int size) const PROTOBUF_FINAL;
+  void InternalSwap(news_batch* other);
+  private:
+  inline ::google::protobuf::Arena* GetArenaNoVirtual() const {
+    return NULL;
+  }
+  inline void* MaybeArenaPtr() const {
+    return NULL;
+  }
+  public:
+
+  ::google::protobuf::Metadata GetMetadata() const PROTOBUF_FINAL;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  // repeated .newsfeed.proto.news items = 1;
+  int items_size() const;
+  void clear_items();
+  static const int kItemsFieldNumber = 1;
+  const ::newsfeed::proto::news& items(int index) const;
+  ::newsfeed::proto::news* mutable_items(int index);
+  ::newsfeed::proto::news* add_items();
+  ::google::protobuf::RepeatedPtrField< ::newsfeed::proto::news >*
+      mutable_items();
+  const ::google::protobuf::RepeatedPtrField< ::newsfeed::proto::news >&
+      items() const;
+
+  // optional int64 missed = 2;
+  bool has_missed() const;
+  void clear_missed();
+  static const int kMissedFieldNumber = 2;
+  ::google::protobuf::int64 missed() const;
+  void set_missed(::google::protobuf::int64 value);
+
+  // @@protoc_insertion_point(class_scope:newsfeed.proto.news_batch)
+ private:
+  void set_has_missed();
+  void clear_has_missed();
+
+  ::google::protobuf::internal::InternalMetadataWithArena _internal_metadata_;
+  ::google::protobuf::internal::HasBits<1> _has_bits_;
+  mutable int _cached_size_;
+  ::google::protobuf::RepeatedPtrField< ::newsfeed::proto::news > items_;
+  ::google::protobuf::int64 missed_;
   friend struct protobuf_newsfeed_5fmessages_2eproto::TableStruct;
 };
 // -------------------------------------------------------------------
@@ -1016,7 +1157,7 @@ class req_envelope : public ::google::protobuf::Message /* @@protoc_insertion_po
                &_req_envelope_default_instance_);
   }
   static PROTOBUF_CONSTEXPR int const kIndexInFileMessages =
-    7;
+    8;
 
   void Swap(req_envelope* other);
   friend void swap(req_envelope& a, req_envelope& b) {
@@ -1076,6 +1217,8 @@ class req_envelope : public ::google::protobuf::Message /* @@protoc_insertion_po
     req_envelope_msg_type_post_news_response_t;
   static const msg_type news_t =
     req_envelope_msg_type_news_t;
+  static const msg_type news_batch_t =
+    req_envelope_msg_type_news_batch_t;
   static inline bool msg_type_IsValid(int value) {
     return req_envelope_msg_type_IsValid(value);
   }
@@ -1162,6 +1305,15 @@ class req_envelope : public ::google::protobuf::Message /* @@protoc_insertion_po
   ::newsfeed::proto::news* release_news_data();
   void set_allocated_news_data(::newsfeed::proto::news* news_data);
 
+  // optional .newsfeed.proto.news_batch news_batch_data = 9;
+  bool has_news_batch_data() const;
+  void clear_news_batch_data();
+  static const int kNewsBatchDataFieldNumber = 9;
+  const ::newsfeed::proto::news_batch& news_batch_data() const;
+  ::newsfeed::proto::news_batch* mutable_news_batch_data();
+  ::newsfeed::proto::news_batch* release_news_batch_data();
+  void set_allocated_news_batch_data(::newsfeed::proto::news_batch* news_batch_data);
+
   // required .newsfeed.proto.req_envelope.msg_type type = 1;
   bool has_type() const;
   void clear_type();
@@ -1187,6 +1339,8 @@ class req_envelope : public ::google::protobuf::Message /* @@protoc_insertion_po
   void clear_has_post_resp();
   void set_has_news_data();
   void clear_has_news_data();
+  void set_has_news_batch_data();
+  void clear_has_news_batch_data();
 
   ::google::protobuf::internal::InternalMetadataWithArena _internal_metadata_;
   ::google::protobuf::internal::HasBits<1> _has_bits_;
@@ -1198,9 +1352,273 @@ class req_envelope : public ::google::protobuf::Message /* @@protoc_insertion_po
   ::newsfeed::proto::post_news_request* post_req_;
   ::newsfeed::proto::post_news_response* post_resp_;
   ::newsfeed::proto::news* news_data_;
+  ::newsfeed::proto::news_batch* news_batch_data_;
   int type_;
   friend struct protobuf_newsfeed_5fmessages_2eproto::TableStruct;
 };
+// -------------------------------------------------------------------
+
+class peer_news : public ::google::protobuf::Message /* @@protoc_insertion_point(class_definition:newsfeed.proto.peer_news) */ {
+ public:
+  peer_news();
+  virtual ~peer_news();
+
+  peer_news(const peer_news& from);
+
+  inline peer_news& operator=(const peer_news& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  #if LANG_CXX11
+  peer_news(peer_news&& from) noexcept
+    : peer_news() {
+    *this = ::std::move(from);
+  }
+
+  inline peer_news& operator=(peer_news&& from) noexcept {
+    if (GetArenaNoVirtual() == from.GetArenaNoVirtual()) {
+      if (this != &from) InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+  #endif
+  inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
+    return _internal_metadata_.unknown_fields();
+  }
+  inline ::google::protobuf::UnknownFieldSet* mutable_unknown_fields() {
+    return _internal_metadata_.mutable_unknown_fields();
+  }
+
+  static const ::google::protobuf::Descriptor* descriptor();
+  static const peer_news& default_instance();
+
+  static inline const peer_news* internal_default_instance() {
+    return reinterpret_cast<const peer_news*>(
+               &_peer_news_default_instance_);
+  }
+  static PROTOBUF_CONSTEXPR int const kIndexInFileMessages =
+    9;
+
+  void Swap(peer_news* other);
+  friend void swap(peer_news& a, peer_news& b) {
+    a.Swap(&b);
+  }
+
+  // implements Message ----------------------------------------------
+
+  inline peer_news* New() const PROTOBUF_FINAL { return New(NULL); }
+
+  peer_news* New(::google::protobuf::Arena* arena) const PROTOBUF_FINAL;
+  void CopyFrom(const ::google::protobuf::Message& from) PROTOBUF_FINAL;
+  void MergeFrom(const ::google::protobuf::Message& from) PROTOBUF_FINAL;
+  void CopyFrom(const peer_news& from);
+  void MergeFrom(const peer_news& from);
+  void Clear() PROTOBUF_FINAL;
+  bool IsInitialized() const PROTOBUF_FINAL;
+
+  size_t ByteSizeLong() const PROTOBUF_FINAL;
+  bool MergePartialFromCodedStream(
+      ::google::protobuf::io::CodedInputStream* input) PROTOBUF_FINAL;
+  void SerializeWithCachedSizes(
+      ::google::protobuf::io::CodedOutputStream* output) const PROTOBUF_FINAL;
+  ::google::protobuf::uint8* InternalSerializeWithCachedSizesToArray(
+      bool deterministic, ::google::protobuf::uint8* target) const PROTOBUF_FINAL;
+  int GetCachedSize() const PROTOBUF_FINAL { return _cached_size_; }
+  private:
+  void SharedCtor();
+  void SharedDtor();
+  void SetCachedSize(int size) const PROTOBUF_FINAL;
+  void InternalSwap(peer_news* other);
+  private:
+  inline ::google::protobuf::Arena* GetArenaNoVirtual() const {
+    return NULL;
+  }
+  inline void* MaybeArenaPtr() const {
+    return NULL;
+  }
+  public:
+
+  ::google::protobuf::Metadata GetMetadata() const PROTOBUF_FINAL;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  // required string topic = 1;
+  bool has_topic() const;
+  void clear_topic();
+  static const int kTopicFieldNumber = 1;
+  const ::std::string& topic() const;
+  void set_topic(const ::std::string& value);
+  #if LANG_CXX11
+  void set_topic(::std::string&& value);
+  #endif
+  void set_topic(const char* value);
+  void set_topic(const char* value, size_t size);
+  ::std::string* mutable_topic();
+  ::std::string* release_topic();
+  void set_allocated_topic(::std::string* topic);
+
+  // required bytes sort_key = 2;
+  bool has_sort_key() const;
+  void clear_sort_key();
+  static const int kSortKeyFieldNumber = 2;
+  const ::std::string& sort_key() const;
+  void set_sort_key(const ::std::string& value);
+  #if LANG_CXX11
+  void set_sort_key(::std::string&& value);
+  #endif
+  void set_sort_key(const char* value);
+  void set_sort_key(const void* value, size_t size);
+  ::std::string* mutable_sort_key();
+  ::std::string* release_sort_key();
+  void set_allocated_sort_key(::std::string* sort_key);
+
+  // required string data = 3;
+  bool has_data() const;
+  void clear_data();
+  static const int kDataFieldNumber = 3;
+  const ::std::string& data() const;
+  void set_data(const ::std::string& value);
+  #if LANG_CXX11
+  void set_data(::std::string&& value);
+  #endif
+  void set_data(const char* value);
+  void set_data(const char* value, size_t size);
+  ::std::string* mutable_data();
+  ::std::string* release_data();
+  void set_allocated_data(::std::string* data);
+
+  // @@protoc_insertion_point(class_scope:newsfeed.proto.peer_news)
+ private:
+  void set_has_topic();
+  void clear_has_topic();
+  void set_has_sort_key();
+  void clear_has_sort_key();
+  void set_has_data();
+  void clear_has_data();
+
+  // helper for ByteSizeLong()
+  size_t RequiredFieldsByteSizeFallback() const;
+
+  ::google::protobuf::internal::InternalMetadataWithArena _internal_metadata_;
+  ::google::protobuf::internal::HasBits<1> _has_bits_;
+  mutable int _cached_size_;
+  ::google::protobuf::internal::ArenaStringPtr topic_;
+  ::google::protobuf::internal::ArenaStringPtr sort_key_;
+  ::google::protobuf::internal::ArenaStringPtr data_;
+  friend struct protobuf_newsfeed_5fmessages_2eproto::TableStruct;
+};
+// -------------------------------------------------------------------
+
+class peer_ack : public ::google::protobuf::Message /* @@protoc_insertion_point(class_definition:newsfeed.proto.peer_ack) */ {
+ public:
+  peer_ack();
+  virtual ~peer_ack();
+
+  peer_ack(const peer_ack& from);
+
+  inline peer_ack& operator=(const peer_ack& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  #if LANG_CXX11
+  peer_ack(peer_ack&& from) noexcept
+    : peer_ack() {
+    *this = ::std::move(from);
+  }
+
+  inline peer_ack& operator=(peer_ack&& from) noexcept {
+    if (GetArenaNoVirtual() == from.GetArenaNoVirtual()) {
+      if (this != &from) InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+  #endif
+  inline const ::google::protobuf::UnknownFieldSet& unknown_fields() const {
+    return _internal_metadata_.unknown_fields();
+  }
+  inline ::google::protobuf::UnknownFieldSet* mutable_unknown_fields() {
+    return _internal_metadata_.mutable_unknown_fields();
+  }
+
+  static const ::google::protobuf::Descriptor* descriptor();
+  static const peer_ack& default_instance();
+
+  static inline const peer_ack* internal_default_instance() {
+    return reinterpret_cast<const peer_ack*>(
+               &_peer_ack_default_instance_);
+  }
+  static PROTOBUF_CONSTEXPR int const kIndexInFileMessages =
+    10;
+
+  void Swap(peer_ack* other);
+  friend void swap(peer_ack& a, peer_ack& b) {
+    a.Swap(&b);
+  }
+
+  // implements Message ----------------------------------------------
+
+  inline peer_ack* New() const PROTOBUF_FINAL { return New(NULL); }
+
+  peer_ack* New(::google::protobuf::Arena* arena) const PROTOBUF_FINAL;
+  void CopyFrom(const ::google::protobuf::Message& from) PROTOBUF_FINAL;
+  void MergeFrom(const ::google::protobuf::Message& from) PROTOBUF_FINAL;
+  void CopyFrom(const peer_ack& from);
+  void MergeFrom(const peer_ack& from);
+  void Clear() PROTOBUF_FINAL;
+  bool IsInitialized() const PROTOBUF_FINAL;
+
+  size_t ByteSizeLong() const PROTOBUF_FINAL;
+  bool MergePartialFromCodedStream(
+      ::google::protobuf::io::CodedInputStream* input) PROTOBUF_FINAL;
+  void SerializeWithCachedSizes(
+      ::google::protobuf::io::CodedOutputStream* output) const PROTOBUF_FINAL;
+  ::google::protobuf::uint8* InternalSerializeWithCachedSizesToArray(
+      bool deterministic, ::google::protobuf::uint8* target) const PROTOBUF_FINAL;
+  int GetCachedSize() const PROTOBUF_FINAL { return _cached_size_; }
+  private:
+  void SharedCtor();
+  void SharedDtor();
+  void SetCachedSize(int size) const PROTOBUF_FINAL;
+  void InternalSwap(peer_ack* other);
+  private:
+  inline ::google::protobuf::Arena* GetArenaNoVirtual() const {
+    return NULL;
+  }
+  inline void* MaybeArenaPtr() const {
+    return NULL;
+  }
+  public:
+
+  ::google::protobuf::Metadata GetMetadata() const PROTOBUF_FINAL;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  // required bool interested = 1;
+  bool has_interested() const;
+  void clear_interested();
+  static const int kInterestedFieldNumber = 1;
+  bool interested() const;
+  void set_interested(bool value);
+
+  // @@protoc_insertion_point(class_scope:newsfeed.proto.peer_ack)
+ private:
+  void set_has_interested();
+  void clear_has_interested();
+
+  ::google::protobuf::internal::InternalMetadataWithArena _internal_metadata_;
+  ::google::protobuf::internal::HasBits<1> _has_bits_;
+  mutable int _cached_size_;
+  bool interested_;
+  friend struct protobuf_newsfeed_5fmessages_2eproto::TableStruct;
+};
 // ===================================================================
 
 
@@ -1677,19 +2095,101 @@ inline void news::set_allocated_data(::std::string* data) {
   // @@protoc_insertion_point(field_set_allocated:newsfeed.proto.news.data)
 }
 
+// optional int64 timestamp = 2;
+inline bool news::has_timestamp() const {
+  return (_has_bits_[0] & 0x00000002u) != 0;
+}
+inline void news::set_has_timestamp() {
+  _has_bits_[0] |= 0x00000002u;
+}
+inline void news::clear_has_timestamp() {
+  _has_bits_[0] &= ~0x00000002u;
+}
+inline void news::clear_timestamp() {
+  timestamp_ = GOOGLE_LONGLONG(0);
+  clear_has_timestamp();
+}
+inline ::google::protobuf::int64 news::timestamp() const {
+  // @@protoc_insertion_point(field_get:newsfeed.proto.news.timestamp)
+  return timestamp_;
+}
+inline void news::set_timestamp(::google::protobuf::int64 value) {
+  set_has_timestamp();
+  timestamp_ = value;
+  // @@protoc_insertion_point(field_set:newsfeed.proto.news.timestamp)
+}
+
+// -------------------------------------------------------------------
+
+// news_batch
+
+// repeated .newsfeed.proto.news items = 1;
+inline int news_batch::items_size() const {
+  return items_.size();
+}
+inline void news_batch::clear_items() {
+  items_.Clear();
+}
+inline const ::newsfeed::proto::news& news_batch::items(int index) const {
+  // @@protoc_insertion_point(field_get:newsfeed.proto.news_batch.items)
+  return items_.Get(index);
+}
+inline ::newsfeed::proto::news* news_batch::mutable_items(int index) {
+  // @@protoc_insertion_point(field_mutable:newsfeed.proto.news_batch.items)
+  return items_.Mutable(index);
+}
+inline ::newsfeed::proto::news* news_batch::add_items() {
+  // @@protoc_insertion_point(field_add:newsfeed.proto.news_batch.items)
+  return items_.Add();
+}
+inline ::google::protobuf::RepeatedPtrField< ::newsfeed::proto::news >*
+news_batch::mutable_items() {
+  // @@protoc_insertion_point(field_mutable_list:newsfeed.proto.news_batch.items)
+  return &items_;
+}
+inline const ::google::protobuf::RepeatedPtrField< ::newsfeed::proto::news >&
+news_batch::items() const {
+  // @@protoc_insertion_point(field_list:newsfeed.proto.news_batch.items)
+  return items_;
+}
+
+// optional int64 missed = 2;
+inline bool news_batch::has_missed() const {
+  return (_has_bits_[0] & 0x00000001u) != 0;
+}
+inline void news_batch::set_has_missed() {
+  _has_bits_[0] |= 0x00000001u;
+}
+inline void news_batch::clear_has_missed() {
+  _has_bits_[0] &= ~0x00000001u;
+}
+inline void news_batch::clear_missed() {
+  missed_ = GOOGLE_LONGLONG(0);
+  clear_has_missed();
+}
+inline ::google::protobuf::int64 news_batch::missed() const {
+  // @@protoc_insertion_point(field_get:newsfeed.proto.news_batch.missed)
+  return missed_;
+}
+inline void news_batch::set_missed(::google::protobuf::int64 value) {
+  set_has_missed();
+  missed_ = value;
+  // @@protoc_insertion_point(field_set:newsfeed.proto.news_batch.missed)
+}
+
 // -------------------------------------------------------------------
 
 // req_envelope
 
 // required .newsfeed.proto.req_envelope.msg_type type = 1;
 inline bool req_envelope::has_type() const {
-  return (_has_bits_[0] & 0x00000080u) != 0;
+  return (_has_bits_[0] & 0x00000100u) != 0;
 }
 inline void req_envelope::set_has_type() {
-  _has_bits_[0] |= 0x00000080u;
+  _has_bits_[0] |= 0x00000100u;
 }
 inline void req_envelope::clear_has_type() {
-  _has_bits_[0] &= ~0x00000080u;
+  _has_bits_[0] &= ~0x00000100u;
 }
 inline void req_envelope::clear_type() {
   type_ = 1;
@@ -2028,6 +2528,273 @@ inline void req_envelope::set_allocated_news_data(::newsfeed::proto::news* news_
   // @@protoc_insertion_point(field_set_allocated:newsfeed.proto.req_envelope.news_data)
 }
 
+// optional .newsfeed.proto.news_batch news_batch_data = 9;
+inline bool req_envelope::has_news_batch_data() const {
+  return (_has_bits_[0] & 0x00000080u) != 0;
+}
+inline void req_envelope::set_has_news_batch_data() {
+  _has_bits_[0] |= 0x00000080u;
+}
+inline void req_envelope::clear_has_news_batch_data() {
+  _has_bits_[0] &= ~0x00000080u;
+}
+inline void req_envelope::clear_news_batch_data() {
+  if (news_batch_data_ != NULL) news_batch_data_->::newsfeed::proto::news_batch::Clear();
+  clear_has_news_batch_data();
+}
+inline const ::newsfeed::proto::news_batch& req_envelope::news_batch_data() const {
+  const ::newsfeed::proto::news_batch* p = news_batch_data_;
+  // @@protoc_insertion_point(field_get:newsfeed.proto.req_envelope.news_batch_data)
+  return p != NULL ? *p : *reinterpret_cast<const ::newsfeed::proto::news_batch*>(
+      &::newsfeed::proto::_news_batch_default_instance_);
+}
+inline ::newsfeed::proto::news_batch* req_envelope::mutable_news_batch_data() {
+  set_has_news_batch_data();
+  if (news_batch_data_ == NULL) {
+    news_batch_data_ = new ::newsfeed::proto::news_batch;
+  }
+  // @@protoc_insertion_point(field_mutable:newsfeed.proto.req_envelope.news_batch_data)
+  return news_batch_data_;
+}
+inline ::newsfeed::proto::news_batch* req_envelope::release_news_batch_data() {
+  // @@protoc_insertion_point(field_release:newsfeed.proto.req_envelope.news_batch_data)
+  clear_has_news_batch_data();
+  ::newsfeed::proto::news_batch* temp = news_batch_data_;
+  news_batch_data_ = NULL;
+  return temp;
+}
+inline void req_envelope::set_allocated_news_batch_data(::newsfeed::proto::news_batch* news_batch_data) {
+  delete news_batch_data_;
+  news_batch_data_ = news_batch_data;
+  if (news_batch_data) {
+    set_has_news_batch_data();
+  } else {
+    clear_has_news_batch_data();
+  }
+  // @@protoc_insertion_point(field_set_allocated:newsfeed.proto.req_envelope.news_batch_data)
+}
+
+// -------------------------------------------------------------------
+
+// peer_news
+
+// required string topic = 1;
+inline bool peer_news::has_topic() const {
+  return (_has_bits_[0] & 0x00000001u) != 0;
+}
+inline void peer_news::set_has_topic() {
+  _has_bits_[0] |= 0x00000001u;
+}
+inline void peer_news::clear_has_topic() {
+  _has_bits_[0] &= ~0x00000001u;
+}
+inline void peer_news::clear_topic() {
+  topic_.ClearToEmptyNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+  clear_has_topic();
+}
+inline const ::std::string& peer_news::topic() const {
+  // @@protoc_insertion_point(field_get:newsfeed.proto.peer_news.topic)
+  return topic_.GetNoArena();
+}
+inline void peer_news::set_topic(const ::std::string& value) {
+  set_has_topic();
+  topic_.SetNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), value);
+  // @@protoc_insertion_point(field_set:newsfeed.proto.peer_news.topic)
+}
+#if LANG_CXX11
+inline void peer_news::set_topic(::std::string&& value) {
+  set_has_topic();
+  topic_.SetNoArena(
+    &::google::protobuf::internal::GetEmptyStringAlreadyInited(), ::std::move(value));
+  // @@protoc_insertion_point(field_set_rvalue:newsfeed.proto.peer_news.topic)
+}
+#endif
+inline void peer_news::set_topic(const char* value) {
+  GOOGLE_DCHECK(value != NULL);
+  set_has_topic();
+  topic_.SetNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), ::std::string(value));
+  // @@protoc_insertion_point(field_set_char:newsfeed.proto.peer_news.topic)
+}
+inline void peer_news::set_topic(const char* value, size_t size) {
+  set_has_topic();
+  topic_.SetNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(),
+      ::std::string(reinterpret_cast<const char*>(value), size));
+  // @@protoc_insertion_point(field_set_pointer:newsfeed.proto.peer_news.topic)
+}
+inline ::std::string* peer_news::mutable_topic() {
+  set_has_topic();
+  // @@protoc_insertion_point(field_mutable:newsfeed.proto.peer_news.topic)
+  return topic_.MutableNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+}
+inline ::std::string* peer_news::release_topic() {
+  // @@protoc_insertion_point(field_release:newsfeed.proto.peer_news.topic)
+  clear_has_topic();
+  return topic_.ReleaseNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+}
+inline void peer_news::set_allocated_topic(::std::string* topic) {
+  if (topic != NULL) {
+    set_has_topic();
+  } else {
+    clear_has_topic();
+  }
+  topic_.SetAllocatedNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), topic);
+  // @@protoc_insertion_point(field_set_allocated:newsfeed.proto.peer_news.topic)
+}
+
+// required bytes sort_key = 2;
+inline bool peer_news::has_sort_key() const {
+  return (_has_bits_[0] & 0x00000002u) != 0;
+}
+inline void peer_news::set_has_sort_key() {
+  _has_bits_[0] |= 0x00000002u;
+}
+inline void peer_news::clear_has_sort_key() {
+  _has_bits_[0] &= ~0x00000002u;
+}
+inline void peer_news::clear_sort_key() {
+  sort_key_.ClearToEmptyNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+  clear_has_sort_key();
+}
+inline const ::std::string& peer_news::sort_key() const {
+  // @@protoc_insertion_point(field_get:newsfeed.proto.peer_news.sort_key)
+  return sort_key_.GetNoArena();
+}
+inline void peer_news::set_sort_key(const ::std::string& value) {
+  set_has_sort_key();
+  sort_key_.SetNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), value);
+  // @@protoc_insertion_point(field_set:newsfeed.proto.peer_news.sort_key)
+}
+#if LANG_CXX11
+inline void peer_news::set_sort_key(::std::string&& value) {
+  set_has_sort_key();
+  sort_key_.SetNoArena(
+    &::google::protobuf::internal::GetEmptyStringAlreadyInited(), ::std::move(value));
+  // @@protoc_insertion_point(field_set_rvalue:newsfeed.proto.peer_news.sort_key)
+}
+#endif
+inline void peer_news::set_sort_key(const char* value) {
+  GOOGLE_DCHECK(value != NULL);
+  set_has_sort_key();
+  sort_key_.SetNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), ::std::string(value));
+  // @@protoc_insertion_point(field_set_char:newsfeed.proto.peer_news.sort_key)
+}
+inline void peer_news::set_sort_key(const void* value, size_t size) {
+  set_has_sort_key();
+  sort_key_.SetNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(),
+      ::std::string(reinterpret_cast<const char*>(value), size));
+  // @@protoc_insertion_point(field_set_pointer:newsfeed.proto.peer_news.sort_key)
+}
+inline ::std::string* peer_news::mutable_sort_key() {
+  set_has_sort_key();
+  // @@protoc_insertion_point(field_mutable:newsfeed.proto.peer_news.sort_key)
+  return sort_key_.MutableNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+}
+inline ::std::string* peer_news::release_sort_key() {
+  // @@protoc_insertion_point(field_release:newsfeed.proto.peer_news.sort_key)
+  clear_has_sort_key();
+  return sort_key_.ReleaseNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+}
+inline void peer_news::set_allocated_sort_key(::std::string* sort_key) {
+  if (sort_key != NULL) {
+    set_has_sort_key();
+  } else {
+    clear_has_sort_key();
+  }
+  sort_key_.SetAllocatedNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), sort_key);
+  // @@protoc_insertion_point(field_set_allocated:newsfeed.proto.peer_news.sort_key)
+}
+
+// required string data = 3;
+inline bool peer_news::has_data() const {
+  return (_has_bits_[0] & 0x00000004u) != 0;
+}
+inline void peer_news::set_has_data() {
+  _has_bits_[0] |= 0x00000004u;
+}
+inline void peer_news::clear_has_data() {
+  _has_bits_[0] &= ~0x00000004u;
+}
+inline void peer_news::clear_data() {
+  data_.ClearToEmptyNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+  clear_has_data();
+}
+inline const ::std::string& peer_news::data() const {
+  // @@protoc_insertion_point(field_get:newsfeed.proto.peer_news.data)
+  return data_.GetNoArena();
+}
+inline void peer_news::set_data(const ::std::string& value) {
+  set_has_data();
+  data_.SetNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), value);
+  // @@protoc_insertion_point(field_set:newsfeed.proto.peer_news.data)
+}
+#if LANG_CXX11
+inline void peer_news::set_data(::std::string&& value) {
+  set_has_data();
+  data_.SetNoArena(
+    &::google::protobuf::internal::GetEmptyStringAlreadyInited(), ::std::move(value));
+  // @@protoc_insertion_point(field_set_rvalue:newsfeed.proto.peer_news.data)
+}
+#endif
+inline void peer_news::set_data(const char* value) {
+  GOOGLE_DCHECK(value != NULL);
+  set_has_data();
+  data_.SetNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), ::std::string(value));
+  // @@protoc_insertion_point(field_set_char:newsfeed.proto.peer_news.data)
+}
+inline void peer_news::set_data(const char* value, size_t size) {
+  set_has_data();
+  data_.SetNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(),
+      ::std::string(reinterpret_cast<const char*>(value), size));
+  // @@protoc_insertion_point(field_set_pointer:newsfeed.proto.peer_news.data)
+}
+inline ::std::string* peer_news::mutable_data() {
+  set_has_data();
+  // @@protoc_insertion_point(field_mutable:newsfeed.proto.peer_news.data)
+  return data_.MutableNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+}
+inline ::std::string* peer_news::release_data() {
+  // @@protoc_insertion_point(field_release:newsfeed.proto.peer_news.data)
+  clear_has_data();
+  return data_.ReleaseNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+}
+inline void peer_news::set_allocated_data(::std::string* data) {
+  if (data != NULL) {
+    set_has_data();
+  } else {
+    clear_has_data();
+  }
+  data_.SetAllocatedNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), data);
+  // @@protoc_insertion_point(field_set_allocated:newsfeed.proto.peer_news.data)
+}
+
+// -------------------------------------------------------------------
+
+// peer_ack
+
+// required bool interested = 1;
+inline bool peer_ack::has_interested() const {
+  return (_has_bits_[0] & 0x00000001u) != 0;
+}
+inline void peer_ack::set_has_interested() {
+  _has_bits_[0] |= 0x00000001u;
+}
+inline void peer_ack::clear_has_interested() {
+  _has_bits_[0] &= ~0x00000001u;
+}
+inline void peer_ack::clear_interested() {
+  interested_ = false;
+  clear_has_interested();
+}
+inline bool peer_ack::interested() const {
+  // @@protoc_insertion_point(field_get:newsfeed.proto.peer_ack.interested)
+  return interested_;
+}
+inline void peer_ack::set_interested(bool value) {
+  set_has_interested();
+  interested_ = value;
+  // @@protoc_insertion_point(field_set:newsfeed.proto.peer_ack.interested)
+}
+
 #ifdef __GNUC__
   #pragma GCC diagnostic pop
 #endif  // __GNUC__
@@ -2046,6 +2813,12 @@ inline void req_envelope::set_allocated_news_data(::newsfeed::proto::news* news_
 
 // -------------------------------------------------------------------
 
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
 
 // @@protoc_insertion_point(namespace_scope)
 
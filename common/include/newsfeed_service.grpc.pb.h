@@ -112,6 +112,105 @@ class Newsfeed final {
   typedef Service StreamedService;
 };
 
+class NewsfeedPeering final {
+ public:
+  static constexpr char const* service_full_name() {
+    return "newsfeed.proto.NewsfeedPeering";
+  }
+  class StubInterface {
+   public:
+    virtual ~StubInterface() {}
+    virtual ::grpc::Status Forward(::grpc::ClientContext* context, const ::newsfeed::proto::peer_news& request, ::newsfeed::proto::peer_ack* response) = 0;
+    std::unique_ptr< ::grpc::ClientAsyncResponseReaderInterface< ::newsfeed::proto::peer_ack>> AsyncForward(::grpc::ClientContext* context, const ::newsfeed::proto::peer_news& request, ::grpc::CompletionQueue* cq) {
+      return std::unique_ptr< ::grpc::ClientAsyncResponseReaderInterface< ::newsfeed::proto::peer_ack>>(AsyncForwardRaw(context, request, cq));
+    }
+  private:
+    virtual ::grpc::ClientAsyncResponseReaderInterface< ::newsfeed::proto::peer_ack>* AsyncForwardRaw(::grpc::ClientContext* context, const ::newsfeed::proto::peer_news& request, ::grpc::CompletionQueue* cq) = 0;
+  };
+  class Stub final : public StubInterface {
+   public:
+    Stub(const std::shared_ptr< ::grpc::ChannelInterface>& channel);
+    ::grpc::Status Forward(::grpc::ClientContext* context, const ::newsfeed::proto::peer_news& request, ::newsfeed::proto::peer_ack* response) override;
+    std::unique_ptr< ::grpc::ClientAsyncResponseReader< ::newsfeed::proto::peer_ack>> AsyncForward(::grpc::ClientContext* context, const ::newsfeed::proto::peer_news& request, ::grpc::CompletionQueue* cq) {
+      return std::unique_ptr< ::grpc::ClientAsyncResponseReader< ::newsfeed::proto::peer_ack>>(AsyncForwardRaw(context, request, cq));
+    }
+
+   private:
+    std::shared_ptr< ::grpc::ChannelInterface> channel_;
+    ::grpc::ClientAsyncResponseReader< ::newsfeed::proto::peer_ack>* AsyncForwardRaw(::grpc::ClientContext* context, const ::newsfeed::proto::peer_news& request, ::grpc::CompletionQueue* cq) override;
+    const ::grpc::RpcMethod rpcmethod_Forward_;
+  };
+  static std::unique_ptr<Stub> NewStub(const std::shared_ptr< ::grpc::ChannelInterface>& channel, const ::grpc::StubOptions& options = ::grpc::StubOptions());
+
+  class Service : public ::grpc::Service {
+   public:
+    Service();
+    virtual ~Service();
+    virtual ::grpc::Status Forward(::grpc::ServerContext* context, const ::newsfeed::proto::peer_news* request, ::newsfeed::proto::peer_ack* response);
+  };
+  template <class BaseClass>
+  class WithAsyncMethod_Forward : public BaseClass {
+   private:
+    void BaseClassMustBeDerivedFromService(const Service *service) {}
+   public:
+    WithAsyncMethod_Forward() {
+      ::grpc::Service::MarkMethodAsync(0);
+    }
+    ~WithAsyncMethod_Forward() override {
+      BaseClassMustBeDerivedFromService(this);
+    }
+    // disable synchronous version of this method
+    ::grpc::Status Forward(::grpc::ServerContext* context, const ::newsfeed::proto::peer_news* request, ::newsfeed::proto::peer_ack* response) final override {
+      abort();
+      return ::grpc::Status(::grpc::StatusCode::UNIMPLEMENTED, "");
+    }
+    void RequestForward(::grpc::ServerContext* context, ::newsfeed::proto::peer_news* request, ::grpc::ServerAsyncResponseWriter< ::newsfeed::proto::peer_ack>* response, ::grpc::CompletionQueue* new_call_cq, ::grpc::ServerCompletionQueue* notification_cq, void *tag) {
+      ::grpc::Service::RequestAsyncUnary(0, context, request, response, new_call_cq, notification_cq, tag);
+    }
+  };
+  typedef WithAsyncMethod_Forward<Service > AsyncService;
+  template <class BaseClass>
+  class WithGenericMethod_Forward : public BaseClass {
+   private:
+    void BaseClassMustBeDerivedFromService(const Service *service) {}
+   public:
+    WithGenericMethod_Forward() {
+      ::grpc::Service::MarkMethodGeneric(0);
+    }
+    ~WithGenericMethod_Forward() override {
+      BaseClassMustBeDerivedFromService(this);
+    }
+    // disable synchronous version of this method
+    ::grpc::Status Forward(::grpc::ServerContext* context, const ::newsfeed::proto::peer_news* request, ::newsfeed::proto::peer_ack* response) final override {
+      abort();
+      return ::grpc::Status(::grpc::StatusCode::UNIMPLEMENTED, "");
+    }
+  };
+  template <class BaseClass>
+  class WithStreamedUnaryMethod_Forward : public BaseClass {
+   private:
+    void BaseClassMustBeDerivedFromService(const Service *service) {}
+   public:
+    WithStreamedUnaryMethod_Forward() {
+      ::grpc::Service::MarkMethodStreamed(0,
+        new ::grpc::StreamedUnaryHandler< ::newsfeed::proto::peer_news, ::newsfeed::proto::peer_ack>(std::bind(&WithStreamedUnaryMethod_Forward<BaseClass>::StreamedForward, this, std::placeholders::_1, std::placeholders::_2)));
+    }
+    ~WithStreamedUnaryMethod_Forward() override {
+      BaseClassMustBeDerivedFromService(this);
+    }
+    // disable regular version of this method
+    ::grpc::Status Forward(::grpc::ServerContext* context, const ::newsfeed::proto::peer_news* request, ::newsfeed::proto::peer_ack* response) final override {
+      abort();
+      return ::grpc::Status(::grpc::StatusCode::UNIMPLEMENTED, "");
+    }
+    // replace default version of method with streamed unary
+    virtual ::grpc::Status StreamedForward(::grpc::ServerContext* context, ::grpc::ServerUnaryStreamer< ::newsfeed::proto::peer_news,::newsfeed::proto::peer_ack>* server_unary_streamer) = 0;
+  };
+  typedef WithStreamedUnaryMethod_Forward<Service > StreamedUnaryService;
+  typedef Service SplitStreamedService;
+  typedef WithStreamedUnaryMethod_Forward<Service > StreamedService;
+};
+
 }  // namespace proto
 }  // namespace newsfeed
 
@@ -54,18 +54,33 @@ public:
  ::google::protobuf::internal::ExplicitlyConstructed<news>
      _instance;
 } _news_default_instance_;
+class news_batchDefaultTypeInternal {
+public:
+ ::google::protobuf::internal::ExplicitlyConstructed<news_batch>
+     _instance;
+} _news_batch_default_instance_;
 class req_envelopeDefaultTypeInternal {
 public:
  ::google::protobuf::internal::ExplicitlyConstructed<req_envelope>
      _instance;
 } _req_envelope_default_instance_;
+class peer_newsDefaultTypeInternal {
+public:
+ ::google::protobuf::internal::ExplicitlyConstructed<peer_news>
+     _instance;
+} _peer_news_default_instance_;
+class peer_ackDefaultTypeInternal {
+public:
+ ::google::protobuf::internal::ExplicitlyConstructed<peer_ack>
+     _instance;
+} _peer_ack_default_instance_;
 
 namespace protobuf_newsfeed_5fmessages_2eproto {
 
 
 namespace {
 
-::google::protobuf::Metadata file_level_metadata[8];
+::google::protobuf::Metadata file_level_metadata[11];
 const ::google::protobuf::EnumDescriptor* file_level_enum_descriptors[3];
 
 }  // namespace
@@ -89,6 +104,9 @@ PROTOBUF_CONSTEXPR_VAR ::google::protobuf::internal::ParseTable const
   { NULL, NULL, 0, -1, -1, -1, -1, NULL, false },
   { NULL, NULL, 0, -1, -1, -1, -1, NULL, false },
   { NULL, NULL, 0, -1, -1, -1, -1, NULL, false },
+  { NULL, NULL, 0, -1, -1, -1, -1, NULL, false },
+  { NULL, NULL, 0, -1, -1, -1, -1, NULL, false },
+  { NULL, NULL, 0, -1, -1, -1, -1, NULL, false },
 };
 
 const ::google::protobuf::uint32 TableStruct::offsets[] GOOGLE_ATTRIBUTE_SECTION_VARIABLE(protodesc_cold) = {
@@ -146,6 +164,17 @@ const ::google::protobuf::uint32 TableStruct::offsets[] GOOGLE_ATTRIBUTE_SECTION
   ~0u,  // no _oneof_case_
   ~0u,  // no _weak_field_map_
   GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(news, data_),
+  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(news, timestamp_),
+  0,
+  1,
+  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(news_batch, _has_bits_),
+  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(news_batch, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(news_batch, items_),
+  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(news_batch, missed_),
+  ~0u,
   0,
   GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(req_envelope, _has_bits_),
   GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(req_envelope, _internal_metadata_),
@@ -160,7 +189,8 @@ const ::google::protobuf::uint32 TableStruct::offsets[] GOOGLE_ATTRIBUTE_SECTION
   GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(req_envelope, post_req_),
   GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(req_envelope, post_resp_),
   GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(req_envelope, news_data_),
-  7,
+  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(req_envelope, news_batch_data_),
+  8,
   0,
   1,
   2,
@@ -168,6 +198,25 @@ const ::google::protobuf::uint32 TableStruct::offsets[] GOOGLE_ATTRIBUTE_SECTION
   4,
   5,
   6,
+  7,
+  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(peer_news, _has_bits_),
+  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(peer_news, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(peer_news, topic_),
+  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(peer_news, sort_key_),
+  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(peer_news, data_),
+  0,
+  1,
+  2,
+  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(peer_ack, _has_bits_),
+  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(peer_ack, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(peer_ack, interested_),
+  0,
 };
 static const ::google::protobuf::internal::MigrationSchema schemas[] GOOGLE_ATTRIBUTE_SECTION_VARIABLE(protodesc_cold) = {
   { 0, 6, sizeof(register_request)},
@@ -176,8 +225,11 @@ static const ::google::protobuf::internal::MigrationSchema schemas[] GOOGLE_ATTR
   { 25, 32, sizeof(topic_response)},
   { 34, 40, sizeof(post_news_request)},
   { 41, 47, sizeof(post_news_response)},
-  { 48, 54, sizeof(news)},
-  { 55, 68, sizeof(req_envelope)},
+  { 48, 55, sizeof(news)},
+  { 57, 64, sizeof(news_batch)},
+  { 66, 80, sizeof(req_envelope)},
+  { 89, 97, sizeof(peer_news)},
+  { 100, 106, sizeof(peer_ack)},
 };
 
 static ::google::protobuf::Message const * const file_default_instances[] = {
@@ -188,7 +240,10 @@ static ::google::protobuf::Message const * const file_default_instances[] = {
   reinterpret_cast<const ::google::protobuf::Message*>(&_post_news_request_default_instance_),
   reinterpret_cast<const ::google::protobuf::Message*>(&_post_news_response_default_instance_),
   reinterpret_cast<const ::google::protobuf::Message*>(&_news_default_instance_),
+  reinterpret_cast<const ::google::protobuf::Message*>(&_news_batch_default_instance_),
   reinterpret_cast<const ::google::protobuf::Message*>(&_req_envelope_default_instance_),
+  reinterpret_cast<const ::google::protobuf::Message*>(&_peer_news_default_instance_),
+  reinterpret_cast<const ::google::protobuf::Message*>(&_peer_ack_default_instance_),
 };
 
 namespace {
@@ -209,7 +264,7 @@ void protobuf_AssignDescriptorsOnce() {
 void protobuf_RegisterTypes(const ::std::string&) GOOGLE_ATTRIBUTE_COLD;
 void protobuf_RegisterTypes(const ::std::string&) {
   protobuf_AssignDescriptorsOnce();
-  ::google::protobuf::internal::RegisterAllTypes(file_level_metadata, 8);
+  ::google::protobuf::internal::RegisterAllTypes(file_level_metadata, 11);
 }
 
 }  // namespace
@@ -231,9 +286,15 @@ void TableStruct::InitDefaultsImpl() {
   ::google::protobuf::internal::OnShutdownDestroyMessage(
       &_post_news_response_default_instance_);_news_default_instance_._instance.DefaultConstruct();
   ::google::protobuf::internal::OnShutdownDestroyMessage(
-      &_news_default_instance_);_req_envelope_default_instance_._instance.DefaultConstruct();
+      &_news_default_instance_);_news_batch_default_instance_._instance.DefaultConstruct();
+  ::google::protobuf::internal::OnShutdownDestroyMessage(
+      &_news_batch_default_instance_);_req_envelope_default_instance_._instance.DefaultConstruct();
+  ::google::protobuf::internal::OnShutdownDestroyMessage(
+      &_req_envelope_default_instance_);_peer_news_default_instance_._instance.DefaultConstruct();
   ::google::protobuf::internal::OnShutdownDestroyMessage(
-      &_req_envelope_default_instance_);_req_envelope_default_instance_._instance.get_mutable()->reg_req_ = const_cast< ::newsfeed::proto::register_request*>(
+      &_peer_news_default_instance_);_peer_ack_default_instance_._instance.DefaultConstruct();
+  ::google::protobuf::internal::OnShutdownDestroyMessage(
+      &_peer_ack_default_instance_);_req_envelope_default_instance_._instance.get_mutable()->reg_req_ = const_cast< ::newsfeed::proto::register_request*>(
       ::newsfeed::proto::register_request::internal_default_instance());
   _req_envelope_default_instance_._instance.get_mutable()->reg_resp_ = const_cast< ::newsfeed::proto::register_response*>(
       ::newsfeed::proto::register_response::internal_default_instance());
@@ -247,6 +308,8 @@ void TableStruct::InitDefaultsImpl() {
       ::newsfeed::proto::post_news_response::internal_default_instance());
   _req_envelope_default_instance_._instance.get_mutable()->news_data_ = const_cast< ::newsfeed::proto::news*>(
       ::newsfeed::proto::news::internal_default_instance());
+  _req_envelope_default_instance_._instance.get_mutable()->news_batch_data_ = const_cast< ::newsfeed::proto::news_batch*>(
+      ::newsfeed::proto::news_batch::internal_default_instance());
 }
 
 void InitDefaults() {
@@ -268,28 +331,34 @@ void AddDescriptorsImpl() {
       "\0162\036.newsfeed.proto.global_error_t\"!\n\021pos"
       "t_news_request\022\014\n\004news\030\001 \002(\t\"C\n\022post_new"
       "s_response\022-\n\005error\030\001 \002(\0162\036.newsfeed.pro"
-      "to.global_error_t\"\024\n\004news\022\014\n\004data\030\001 \002(\t\""
-      "\316\004\n\014req_envelope\0223\n\004type\030\001 \002(\0162%.newsfee"
-      "d.proto.req_envelope.msg_type\0221\n\007reg_req"
-      "\030\002 \001(\0132 .newsfeed.proto.register_request"
-      "\0223\n\010reg_resp\030\003 \001(\0132!.newsfeed.proto.regi"
-      "ster_response\0220\n\ttopic_req\030\004 \001(\0132\035.newsf"
-      "eed.proto.topic_request\0222\n\ntopic_resp\030\005 "
-      "\001(\0132\036.newsfeed.proto.topic_response\0223\n\010p"
-      "ost_req\030\006 \001(\0132!.newsfeed.proto.post_news"
-      "_request\0225\n\tpost_resp\030\007 \001(\0132\".newsfeed.p"
-      "roto.post_news_response\022\'\n\tnews_data\030\010 \001"
-      "(\0132\024.newsfeed.proto.news\"\245\001\n\010msg_type\022\026\n"
-      "\022register_request_t\020\001\022\027\n\023register_respon"
-      "se_t\020\002\022\023\n\017topic_request_t\020\003\022\024\n\020topic_res"
-      "ponse_t\020\004\022\027\n\023post_news_request_t\020\005\022\030\n\024po"
-      "st_news_response_t\020\006\022\n\n\006news_t\020\007*0\n\016topi"
-      "c_action_t\022\r\n\tsubscribe\020\001\022\017\n\013unsubscribe"
-      "\020\002*:\n\016global_error_t\022\006\n\002ok\020\001\022\022\n\016not_regi"
-      "stered\020\002\022\014\n\010internal\020\003"
+      "to.global_error_t\"\'\n\004news\022\014\n\004data\030\001 \002(\t\022"
+      "\021\n\ttimestamp\030\002 \001(\003\"A\n\nnews_batch\022#\n\005item"
+      "s\030\001 \003(\0132\024.newsfeed.proto.news\022\016\n\006missed\030"
+      "\002 \001(\003\"\225\005\n\014req_envelope\0223\n\004type\030\001 \002(\0162%.n"
+      "ewsfeed.proto.req_envelope.msg_type\0221\n\007r"
+      "eg_req\030\002 \001(\0132 .newsfeed.proto.register_r"
+      "equest\0223\n\010reg_resp\030\003 \001(\0132!.newsfeed.prot"
+      "o.register_response\0220\n\ttopic_req\030\004 \001(\0132\035"
+      ".newsfeed.proto.topic_request\0222\n\ntopic_r"
+      "esp\030\005 \001(\0132\036.newsfeed.proto.topic_respons"
+      "e\0223\n\010post_req\030\006 \001(\0132!.newsfeed.proto.pos"
+      "t_news_request\0225\n\tpost_resp\030\007 \001(\0132\".news"
+      "feed.proto.post_news_response\022\'\n\tnews_da"
+      "ta\030\010 \001(\0132\024.newsfeed.proto.news\0223\n\017news_b"
+      "atch_data\030\t \001(\0132\032.newsfeed.proto.news_ba"
+      "tch\"\267\001\n\010msg_type\022\026\n\022register_request_t\020\001"
+      "\022\027\n\023register_response_t\020\002\022\023\n\017topic_reque"
+      "st_t\020\003\022\024\n\020topic_response_t\020\004\022\027\n\023post_new"
+      "s_request_t\020\005\022\030\n\024post_news_response_t\020\006\022"
+      "\n\n\006news_t\020\007\022\020\n\014news_batch_t\020\010\":\n\tpeer_ne"
+      "ws\022\r\n\005topic\030\001 \002(\t\022\020\n\010sort_key\030\002 \002(\014\022\014\n\004d"
+      "ata\030\003 \002(\t\"\036\n\010peer_ack\022\022\n\ninterested\030\001 \002("
+      "\010*0\n\016topic_action_t\022\r\n\tsubscribe\020\001\022\017\n\013un"
+      "subscribe\020\002*:\n\016global_error_t\022\006\n\002ok\020\001\022\022\n"
+      "\016not_registered\020\002\022\014\n\010internal\020\003"
   };
   ::google::protobuf::DescriptorPool::InternalAddGeneratedFile(
-      descriptor, 1182);
+      descriptor, 1431);
   ::google::protobuf::MessageFactory::InternalRegisterGeneratedFile(
     "newsfeed_messages.proto", &protobuf_RegisterTypes);
 }
@@ -321,6 +390,7 @@ bool req_envelope_msg_type_IsValid(int value) {
     case 5:
     case 6:
     case 7:
+    case 8:
       return true;
     default:
       return false;
@@ -335,6 +405,7 @@ const req_envelope_msg_type req_envelope::topic_response_t;
 const req_envelope_msg_type req_envelope::post_news_request_t;
 const req_envelope_msg_type req_envelope::post_news_response_t;
 const req_envelope_msg_type req_envelope::news_t;
+const req_envelope_msg_type req_envelope::news_batch_t;
 const req_envelope_msg_type req_envelope::msg_type_MIN;
 const req_envelope_msg_type req_envelope::msg_type_MAX;
 const int req_envelope::msg_type_ARRAYSIZE;
@@ -2517,6 +2588,7 @@ void post_news_response::set_error(::newsfeed::proto::global_error_t value) {
 
 #if !defined(_MSC_VER) || _MSC_VER >= 1900
 const int news::kDataFieldNumber;
+const int news::kTimestampFieldNumber;
 #endif  // !defined(_MSC_VER) || _MSC_VER >= 1900
 
 news::news()
@@ -2537,12 +2609,14 @@ news::news(const news& from)
   if (from.has_data()) {
     data_.AssignWithDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), from.data_);
   }
+  timestamp_ = from.timestamp_;
   // @@protoc_insertion_point(copy_constructor:newsfeed.proto.news)
 }
 
 void news::SharedCtor() {
   _cached_size_ = 0;
   data_.UnsafeSetDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+  timestamp_ = GOOGLE_LONGLONG(0);
 }
 
 news::~news() {
@@ -2587,6 +2661,7 @@ void news::Clear() {
     GOOGLE_DCHECK(!data_.IsDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited()));
     (*data_.UnsafeRawStringPointer())->clear();
   }
+  timestamp_ = GOOGLE_LONGLONG(0);
   _has_bits_.Clear();
   _internal_metadata_.Clear();
 }
@@ -2617,6 +2692,20 @@ bool news::MergePartialFromCodedStream(
         break;
       }
 
+      // optional int64 timestamp = 2;
+      case 2: {
+        if (static_cast< ::google::protobuf::uint8>(tag) ==
+            static_cast< ::google::protobuf::uint8>(16u /* 16 & 0xFF */)) {
+          set_has_timestamp();
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::int64, ::google::protobuf::internal::WireFormatLite::TYPE_INT64>(
+                 input, &timestamp_)));
+        } else {
+          goto handle_unusual;
+        }
+        break;
+      }
+
       default: {
       handle_unusual:
         if (tag == 0) {
@@ -2654,6 +2743,11 @@ void news::SerializeWithCachedSizes(
       1, this->data(), output);
   }
 
+  // optional int64 timestamp = 2;
+  if (cached_has_bits & 0x00000002u) {
+    ::google::protobuf::internal::WireFormatLite::WriteInt64(2, this->timestamp(), output);
+  }
+
   if (_internal_metadata_.have_unknown_fields()) {
     ::google::protobuf::internal::WireFormat::SerializeUnknownFields(
         _internal_metadata_.unknown_fields(), output);
@@ -2680,6 +2774,11 @@ void news::SerializeWithCachedSizes(
         1, this->data(), target);
   }
 
+  // optional int64 timestamp = 2;
+  if (cached_has_bits & 0x00000002u) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteInt64ToArray(2, this->timestamp(), target);
+  }
+
   if (_internal_metadata_.have_unknown_fields()) {
     target = ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsToArray(
         _internal_metadata_.unknown_fields(), target);
@@ -2703,6 +2802,13 @@ size_t news::ByteSizeLong() const {
       ::google::protobuf::internal::WireFormatLite::StringSize(
         this->data());
   }
+  // optional int64 timestamp = 2;
+  if (has_timestamp()) {
+    total_size += 1 +
+      ::google::protobuf::internal::WireFormatLite::Int64Size(
+        this->timestamp());
+  }
+
   int cached_size = ::google::protobuf::internal::ToCachedSize(total_size);
   GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
   _cached_size_ = cached_size;
@@ -2732,9 +2838,16 @@ void news::MergeFrom(const news& from) {
   ::google::protobuf::uint32 cached_has_bits = 0;
   (void) cached_has_bits;
 
-  if (from.has_data()) {
-    set_has_data();
-    data_.AssignWithDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), from.data_);
+  cached_has_bits = from._has_bits_[0];
+  if (cached_has_bits & 3u) {
+    if (cached_has_bits & 0x00000001u) {
+      set_has_data();
+      data_.AssignWithDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), from.data_);
+    }
+    if (cached_has_bits & 0x00000002u) {
+      timestamp_ = from.timestamp_;
+    }
+    _has_bits_[0] |= cached_has_bits;
   }
 }
 
@@ -2764,6 +2877,7 @@ void news::Swap(news* other) {
 void news::InternalSwap(news* other) {
   using std::swap;
   data_.Swap(&other->data_);
+  swap(timestamp_, other->timestamp_);
   swap(_has_bits_[0], other->_has_bits_[0]);
   _internal_metadata_.Swap(&other->_internal_metadata_);
   swap(_cached_size_, other->_cached_size_);
@@ -2840,431 +2954,218 @@ void news::set_allocated_data(::std::string* data) {
   // @@protoc_insertion_point(field_set_allocated:newsfeed.proto.news.data)
 }
 
+// optional int64 timestamp = 2;
+bool news::has_timestamp() const {
+  return (_has_bits_[0] & 0x00000002u) != 0;
+}
+void news::set_has_timestamp() {
+  _has_bits_[0] |= 0x00000002u;
+}
+void news::clear_has_timestamp() {
+  _has_bits_[0] &= ~0x00000002u;
+}
+void news::clear_timestamp() {
+  timestamp_ = GOOGLE_LONGLONG(0);
+  clear_has_timestamp();
+}
+::google::protobuf::int64 news::timestamp() const {
+  // @@protoc_insertion_point(field_get:newsfeed.proto.news.timestamp)
+  return timestamp_;
+}
+void news::set_timestamp(::google::protobuf::int64 value) {
+  set_has_timestamp();
+  timestamp_ = value;
+  // @@protoc_insertion_point(field_set:newsfeed.proto.news.timestamp)
+}
+
 #endif  // PROTOBUF_INLINE_NOT_IN_HEADERS
 
 // ===================================================================
 
 #if !defined(_MSC_VER) || _MSC_VER >= 1900
-const int req_envelope::kTypeFieldNumber;
-const int req_envelope::kRegReqFieldNumber;
-const int req_envelope::kRegRespFieldNumber;
-const int req_envelope::kTopicReqFieldNumber;
-const int req_envelope::kTopicRespFieldNumber;
-const int req_envelope::kPostReqFieldNumber;
-const int req_envelope::kPostRespFieldNumber;
-const int req_envelope::kNewsDataFieldNumber;
+const int news_batch::kItemsFieldNumber;
+const int news_batch::kMissedFieldNumber;
 #endif  // !defined(_MSC_VER) || _MSC_VER >= 1900
 
-req_envelope::req_envelope()
+news_batch::news_batch()
   : ::google::protobuf::Message(), _internal_metadata_(NULL) {
   if (GOOGLE_PREDICT_TRUE(this != internal_default_instance())) {
     protobuf_newsfeed_5fmessages_2eproto::InitDefaults();
   }
   SharedCtor();
-  // @@protoc_insertion_point(constructor:newsfeed.proto.req_envelope)
+  // @@protoc_insertion_point(constructor:newsfeed.proto.news_batch)
 }
-req_envelope::req_envelope(const req_envelope& from)
+news_batch::news_batch(const news_batch& from)
   : ::google::protobuf::Message(),
       _internal_metadata_(NULL),
       _has_bits_(from._has_bits_),
-      _cached_size_(0) {
+      _cached_size_(0),
+      items_(from.items_) {
   _internal_metadata_.MergeFrom(from._internal_metadata_);
-  if (from.has_reg_req()) {
-    reg_req_ = new ::newsfeed::proto::register_request(*from.reg_req_);
-  } else {
-    reg_req_ = NULL;
-  }
-  if (from.has_reg_resp()) {
-    reg_resp_ = new ::newsfeed::proto::register_response(*from.reg_resp_);
-  } else {
-    reg_resp_ = NULL;
-  }
-  if (from.has_topic_req()) {
-    topic_req_ = new ::newsfeed::proto::topic_request(*from.topic_req_);
-  } else {
-    topic_req_ = NULL;
-  }
-  if (from.has_topic_resp()) {
-    topic_resp_ = new ::newsfeed::proto::topic_response(*from.topic_resp_);
-  } else {
-    topic_resp_ = NULL;
-  }
-  if (from.has_post_req()) {
-    post_req_ = new ::newsfeed::proto::post_news_request(*from.post_req_);
-  } else {
-    post_req_ = NULL;
-  }
-  if (from.has_post_resp()) {
-    post_resp_ = new ::newsfeed::proto::post_news_response(*from.post_resp_);
-  } else {
-    post_resp_ = NULL;
-  }
-  if (from.has_news_data()) {
-    news_data_ = new ::newsfeed::proto::news(*from.news_data_);
-  } else {
-    news_data_ = NULL;
-  }
-  type_ = from.type_;
-  // @@protoc_insertion_point(copy_constructor:newsfeed.proto.req_envelope)
+  missed_ = from.missed_;
+  // @@protoc_insertion_point(copy_constructor:newsfeed.proto.news_batch)
 }
 
-void req_envelope::SharedCtor() {
+void news_batch::SharedCtor() {
   _cached_size_ = 0;
-  ::memset(&reg_req_, 0, static_cast<size_t>(
-      reinterpret_cast<char*>(&news_data_) -
-      reinterpret_cast<char*>(&reg_req_)) + sizeof(news_data_));
-  type_ = 1;
+  missed_ = GOOGLE_LONGLONG(0);
 }
 
-req_envelope::~req_envelope() {
-  // @@protoc_insertion_point(destructor:newsfeed.proto.req_envelope)
+news_batch::~news_batch() {
+  // @@protoc_insertion_point(destructor:newsfeed.proto.news_batch)
   SharedDtor();
 }
 
-void req_envelope::SharedDtor() {
-  if (this != internal_default_instance()) delete reg_req_;
-  if (this != internal_default_instance()) delete reg_resp_;
-  if (this != internal_default_instance()) delete topic_req_;
-  if (this != internal_default_instance()) delete topic_resp_;
-  if (this != internal_default_instance()) delete post_req_;
-  if (this != internal_default_instance()) delete post_resp_;
-  if (this != internal_default_instance()) delete news_data_;
+void news_batch::SharedDtor() {
 }
 
-void req_envelope::SetCachedSize(int size) const {
+void news_batch::SetCachedSize(int size) const {
   GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
   _cached_size_ = size;
   GOOGLE_SAFE_CONCURRENT_WRITES_END();
 }
-const ::google::protobuf::Descriptor* req_envelope::descriptor() {
+const ::google::protobuf::Descriptor* news_batch::descriptor() {
   protobuf_newsfeed_5fmessages_2eproto::protobuf_AssignDescriptorsOnce();
   return protobuf_newsfeed_5fmessages_2eproto::file_level_metadata[kIndexInFileMessages].descriptor;
 }
 
-const req_envelope& req_envelope::default_instance() {
+const news_batch& news_batch::default_instance() {
   protobuf_newsfeed_5fmessages_2eproto::InitDefaults();
   return *internal_default_instance();
 }
 
-req_envelope* req_envelope::New(::google::protobuf::Arena* arena) const {
-  req_envelope* n = new req_envelope;
+news_batch* news_batch::New(::google::protobuf::Arena* arena) const {
+  news_batch* n = new news_batch;
   if (arena != NULL) {
     arena->Own(n);
   }
   return n;
 }
 
-void req_envelope::Clear() {
-// @@protoc_insertion_point(message_clear_start:newsfeed.proto.req_envelope)
+void news_batch::Clear() {
+// @@protoc_insertion_point(message_clear_start:newsfeed.proto.news_batch)
   ::google::protobuf::uint32 cached_has_bits = 0;
   // Prevent compiler warnings about cached_has_bits being unused
   (void) cached_has_bits;
 
-  cached_has_bits = _has_bits_[0];
-  if (cached_has_bits & 255u) {
-    if (cached_has_bits & 0x00000001u) {
-      GOOGLE_DCHECK(reg_req_ != NULL);
-      reg_req_->::newsfeed::proto::register_request::Clear();
-    }
-    if (cached_has_bits & 0x00000002u) {
-      GOOGLE_DCHECK(reg_resp_ != NULL);
-      reg_resp_->::newsfeed::proto::register_response::Clear();
-    }
-    if (cached_has_bits & 0x00000004u) {
-      GOOGLE_DCHECK(topic_req_ != NULL);
-      topic_req_->::newsfeed::proto::topic_request::Clear();
-    }
-    if (cached_has_bits & 0x00000008u) {
-      GOOGLE_DCHECK(topic_resp_ != NULL);
-      topic_resp_->::newsfeed::proto::topic_response::Clear();
-    }
-    if (cached_has_bits & 0x00000010u) {
-      GOOGLE_DCHECK(post_req_ != NULL);
-      post_req_->::newsfeed::proto::post_news_request::Clear();
-    }
-    if (cached_has_bits & 0x00000020u) {
-      GOOGLE_DCHECK(post_resp_ != NULL);
-      post_resp_->::newsfeed::proto::post_news_response::Clear();
-    }
-    if (cached_has_bits & 0x00000040u) {
-      GOOGLE_DCHECK(news_data_ != NULL);
-      news_data_->::newsfeed::proto::news::Clear();
-    }
-    type_ = 1;
-  }
+  items_.Clear();
+  missed_ = GOOGLE_LONGLONG(0);
   _has_bits_.Clear();
   _internal_metadata_.Clear();
 }
 
-bool req_envelope::MergePartialFromCodedStream(
+bool news_batch::MergePartialFromCodedStream(
     ::google::protobuf::io::CodedInputStream* input) {
 #define DO_(EXPRESSION) if (!GOOGLE_PREDICT_TRUE(EXPRESSION)) goto failure
   ::google::protobuf::uint32 tag;
-  // @@protoc_insertion_point(parse_start:newsfeed.proto.req_envelope)
+  // @@protoc_insertion_point(parse_start:newsfeed.proto.news_batch)
   for (;;) {
     ::std::pair< ::google::protobuf::uint32, bool> p = input->ReadTagWithCutoffNoLastTag(127u);
     tag = p.first;
     if (!p.second) goto handle_unusual;
     switch (::google::protobuf::internal::WireFormatLite::GetTagFieldNumber(tag)) {
-      // required .newsfeed.proto.req_envelope.msg_type type = 1;
+      // repeated .newsfeed.proto.news items = 1;
       case 1: {
         if (static_cast< ::google::protobuf::uint8>(tag) ==
-            static_cast< ::google::protobuf::uint8>(8u /* 8 & 0xFF */)) {
-          int value;
-          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
-                   int, ::google::protobuf::internal::WireFormatLite::TYPE_ENUM>(
-                 input, &value)));
-          if (::newsfeed::proto::req_envelope_msg_type_IsValid(value)) {
-            set_type(static_cast< ::newsfeed::proto::req_envelope_msg_type >(value));
-          } else {
-            mutable_unknown_fields()->AddVarint(
-                1, static_cast< ::google::protobuf::uint64>(value));
-          }
+            static_cast< ::google::protobuf::uint8>(10u /* 10 & 0xFF */)) {
+          DO_(::google::protobuf::internal::WireFormatLite::ReadMessageNoVirtual(input, add_items()));
         } else {
           goto handle_unusual;
         }
         break;
       }
 
-      // optional .newsfeed.proto.register_request reg_req = 2;
+      // optional int64 missed = 2;
       case 2: {
         if (static_cast< ::google::protobuf::uint8>(tag) ==
-            static_cast< ::google::protobuf::uint8>(18u /* 18 & 0xFF */)) {
-          DO_(::google::protobuf::internal::WireFormatLite::ReadMessageNoVirtual(
-               input, mutable_reg_req()));
+            static_cast< ::google::protobuf::uint8>(16u /* 16 & 0xFF */)) {
+          set_has_missed();
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::int64, ::google::protobuf::internal::WireFormatLite::TYPE_INT64>(
+                 input, &missed_)));
         } else {
           goto handle_unusual;
         }
         break;
       }
 
-      // optional .newsfeed.proto.register_response reg_resp = 3;
-      case 3: {
-        if (static_cast< ::google::protobuf::uint8>(tag) ==
-            static_cast< ::google::protobuf::uint8>(26u /* 26 & 0xFF */)) {
-          DO_(::google::protobuf::internal::WireFormatLite::ReadMessageNoVirtual(
-               input, mutable_reg_resp()));
-        } else {
-          goto handle_unusual;
+      default: {
+      handle_unusual:
+        if (tag == 0) {
+          goto success;
         }
+        DO_(::google::protobuf::internal::WireFormat::SkipField(
+              input, tag, _internal_metadata_.mutable_unknown_fields()));
         break;
       }
+    }
+  }
+success:
+  // @@protoc_insertion_point(parse_success:newsfeed.proto.news_batch)
+  return true;
+failure:
+  // @@protoc_insertion_point(parse_failure:newsfeed.proto.news_batch)
+  return false;
+#undef DO_
+}
 
-      // optional .newsfeed.proto.topic_request topic_req = 4;
-      case 4: {
-        if (static_cast< ::google::protobuf::uint8>(tag) ==
-            static_cast< ::google::protobuf::uint8>(34u /* 34 & 0xFF */)) {
-          DO_(::google::protobuf::internal::WireFormatLite::ReadMessageNoVirtual(
-               input, mutable_topic_req()));
-        } else {
-          goto handle_unusual;
-        }
-        break;
-      }
+void news_batch::SerializeWithCachedSizes(
+    ::google::protobuf::io::CodedOutputStream* output) const {
+  // @@protoc_insertion_point(serialize_start:newsfeed.proto.news_batch)
+  ::google::protobuf::uint32 cached_has_bits = 0;
+  (void) cached_has_bits;
 
-      // optional .newsfeed.proto.topic_response topic_resp = 5;
-      case 5: {
-        if (static_cast< ::google::protobuf::uint8>(tag) ==
-            static_cast< ::google::protobuf::uint8>(42u /* 42 & 0xFF */)) {
-          DO_(::google::protobuf::internal::WireFormatLite::ReadMessageNoVirtual(
-               input, mutable_topic_resp()));
-        } else {
-          goto handle_unusual;
-        }
-        break;
-      }
+  // repeated .newsfeed.proto.news items = 1;
+  for (unsigned int i = 0,
+      n = static_cast<unsigned int>(this->items_size()); i < n; i++) {
+    ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
+      1, this->items(static_cast<int>(i)), output);
+  }
 
-      // optional .newsfeed.proto.post_news_request post_req = 6;
-      case 6: {
-        if (static_cast< ::google::protobuf::uint8>(tag) ==
-            static_cast< ::google::protobuf::uint8>(50u /* 50 & 0xFF */)) {
-          DO_(::google::protobuf::internal::WireFormatLite::ReadMessageNoVirtual(
-               input, mutable_post_req()));
-        } else {
-          goto handle_unusual;
-        }
-        break;
-      }
-
-      // optional .newsfeed.proto.post_news_response post_resp = 7;
-      case 7: {
-        if (static_cast< ::google::protobuf::uint8>(tag) ==
-            static_cast< ::google::protobuf::uint8>(58u /* 58 & 0xFF */)) {
-          DO_(::google::protobuf::internal::WireFormatLite::ReadMessageNoVirtual(
-               input, mutable_post_resp()));
-        } else {
-          goto handle_unusual;
-        }
-        break;
-      }
-
-      // optional .newsfeed.proto.news news_data = 8;
-      case 8: {
-        if (static_cast< ::google::protobuf::uint8>(tag) ==
-            static_cast< ::google::protobuf::uint8>(66u /* 66 & 0xFF */)) {
-          DO_(::google::protobuf::internal::WireFormatLite::ReadMessageNoVirtual(
-               input, mutable_news_data()));
-        } else {
-          goto handle_unusual;
-        }
-        break;
-      }
-
-      default: {
-      handle_unusual:
-        if (tag == 0) {
-          goto success;
-        }
-        DO_(::google::protobuf::internal::WireFormat::SkipField(
-              input, tag, _internal_metadata_.mutable_unknown_fields()));
-        break;
-      }
-    }
-  }
-success:
-  // @@protoc_insertion_point(parse_success:newsfeed.proto.req_envelope)
-  return true;
-failure:
-  // @@protoc_insertion_point(parse_failure:newsfeed.proto.req_envelope)
-  return false;
-#undef DO_
-}
-
-void req_envelope::SerializeWithCachedSizes(
-    ::google::protobuf::io::CodedOutputStream* output) const {
-  // @@protoc_insertion_point(serialize_start:newsfeed.proto.req_envelope)
-  ::google::protobuf::uint32 cached_has_bits = 0;
-  (void) cached_has_bits;
-
-  cached_has_bits = _has_bits_[0];
-  // required .newsfeed.proto.req_envelope.msg_type type = 1;
-  if (cached_has_bits & 0x00000080u) {
-    ::google::protobuf::internal::WireFormatLite::WriteEnum(
-      1, this->type(), output);
-  }
-
-  // optional .newsfeed.proto.register_request reg_req = 2;
-  if (cached_has_bits & 0x00000001u) {
-    ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
-      2, *this->reg_req_, output);
-  }
-
-  // optional .newsfeed.proto.register_response reg_resp = 3;
-  if (cached_has_bits & 0x00000002u) {
-    ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
-      3, *this->reg_resp_, output);
-  }
-
-  // optional .newsfeed.proto.topic_request topic_req = 4;
-  if (cached_has_bits & 0x00000004u) {
-    ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
-      4, *this->topic_req_, output);
-  }
-
-  // optional .newsfeed.proto.topic_response topic_resp = 5;
-  if (cached_has_bits & 0x00000008u) {
-    ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
-      5, *this->topic_resp_, output);
-  }
-
-  // optional .newsfeed.proto.post_news_request post_req = 6;
-  if (cached_has_bits & 0x00000010u) {
-    ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
-      6, *this->post_req_, output);
-  }
-
-  // optional .newsfeed.proto.post_news_response post_resp = 7;
-  if (cached_has_bits & 0x00000020u) {
-    ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
-      7, *this->post_resp_, output);
-  }
-
-  // optional .newsfeed.proto.news news_data = 8;
-  if (cached_has_bits & 0x00000040u) {
-    ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
-      8, *this->news_data_, output);
-  }
+  cached_has_bits = _has_bits_[0];
+  // optional int64 missed = 2;
+  if (cached_has_bits & 0x00000001u) {
+    ::google::protobuf::internal::WireFormatLite::WriteInt64(2, this->missed(), output);
+  }
 
   if (_internal_metadata_.have_unknown_fields()) {
     ::google::protobuf::internal::WireFormat::SerializeUnknownFields(
         _internal_metadata_.unknown_fields(), output);
   }
-  // @@protoc_insertion_point(serialize_end:newsfeed.proto.req_envelope)
+  // @@protoc_insertion_point(serialize_end:newsfeed.proto.news_batch)
 }
 
-::google::protobuf::uint8* req_envelope::InternalSerializeWithCachedSizesToArray(
+::google::protobuf::uint8* news_batch::InternalSerializeWithCachedSizesToArray(
     bool deterministic, ::google::protobuf::uint8* target) const {
   (void)deterministic; // Unused
-  // @@protoc_insertion_point(serialize_to_array_start:newsfeed.proto.req_envelope)
+  // @@protoc_insertion_point(serialize_to_array_start:newsfeed.proto.news_batch)
   ::google::protobuf::uint32 cached_has_bits = 0;
   (void) cached_has_bits;
 
-  cached_has_bits = _has_bits_[0];
-  // required .newsfeed.proto.req_envelope.msg_type type = 1;
-  if (cached_has_bits & 0x00000080u) {
-    target = ::google::protobuf::internal::WireFormatLite::WriteEnumToArray(
-      1, this->type(), target);
-  }
-
-  // optional .newsfeed.proto.register_request reg_req = 2;
-  if (cached_has_bits & 0x00000001u) {
-    target = ::google::protobuf::internal::WireFormatLite::
-      InternalWriteMessageNoVirtualToArray(
-        2, *this->reg_req_, deterministic, target);
-  }
-
-  // optional .newsfeed.proto.register_response reg_resp = 3;
-  if (cached_has_bits & 0x00000002u) {
-    target = ::google::protobuf::internal::WireFormatLite::
-      InternalWriteMessageNoVirtualToArray(
-        3, *this->reg_resp_, deterministic, target);
-  }
-
-  // optional .newsfeed.proto.topic_request topic_req = 4;
-  if (cached_has_bits & 0x00000004u) {
-    target = ::google::protobuf::internal::WireFormatLite::
-      InternalWriteMessageNoVirtualToArray(
-        4, *this->topic_req_, deterministic, target);
-  }
-
-  // optional .newsfeed.proto.topic_response topic_resp = 5;
-  if (cached_has_bits & 0x00000008u) {
-    target = ::google::protobuf::internal::WireFormatLite::
-      InternalWriteMessageNoVirtualToArray(
-        5, *this->topic_resp_, deterministic, target);
-  }
-
-  // optional .newsfeed.proto.post_news_request post_req = 6;
-  if (cached_has_bits & 0x00000010u) {
-    target = ::google::protobuf::internal::WireFormatLite::
-      InternalWriteMessageNoVirtualToArray(
-        6, *this->post_req_, deterministic, target);
-  }
-
-  // optional .newsfeed.proto.post_news_response post_resp = 7;
-  if (cached_has_bits & 0x00000020u) {
+  // repeated .newsfeed.proto.news items = 1;
+  for (unsigned int i = 0,
+      n = static_cast<unsigned int>(this->items_size()); i < n; i++) {
     target = ::google::protobuf::internal::WireFormatLite::
       InternalWriteMessageNoVirtualToArray(
-        7, *this->post_resp_, deterministic, target);
+        1, this->items(static_cast<int>(i)), deterministic, target);
   }
 
-  // optional .newsfeed.proto.news news_data = 8;
-  if (cached_has_bits & 0x00000040u) {
-    target = ::google::protobuf::internal::WireFormatLite::
-      InternalWriteMessageNoVirtualToArray(
-        8, *this->news_data_, deterministic, target);
+  cached_has_bits = _has_bits_[0];
+  // optional int64 missed = 2;
+  if (cached_has_bits & 0x00000001u) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteInt64ToArray(2, this->missed(), target);
   }
 
   if (_internal_metadata_.have_unknown_fields()) {
     target = ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsToArray(
         _internal_metadata_.unknown_fields(), target);
   }
-  // @@protoc_insertion_point(serialize_to_array_end:newsfeed.proto.req_envelope)
+  // @@protoc_insertion_point(serialize_to_array_end:newsfeed.proto.news_batch)
   return target;
 }
 
-size_t req_envelope::ByteSizeLong() const {
-// @@protoc_insertion_point(message_byte_size_start:newsfeed.proto.req_envelope)
+size_t news_batch::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:newsfeed.proto.news_batch)
   size_t total_size = 0;
 
   if (_internal_metadata_.have_unknown_fields()) {
@@ -3272,62 +3173,24 @@ size_t req_envelope::ByteSizeLong() const {
       ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
         _internal_metadata_.unknown_fields());
   }
-  // required .newsfeed.proto.req_envelope.msg_type type = 1;
-  if (has_type()) {
-    total_size += 1 +
-      ::google::protobuf::internal::WireFormatLite::EnumSize(this->type());
-  }
-  if (_has_bits_[0 / 32] & 127u) {
-    // optional .newsfeed.proto.register_request reg_req = 2;
-    if (has_reg_req()) {
-      total_size += 1 +
-        ::google::protobuf::internal::WireFormatLite::MessageSizeNoVirtual(
-          *this->reg_req_);
-    }
-
-    // optional .newsfeed.proto.register_response reg_resp = 3;
-    if (has_reg_resp()) {
-      total_size += 1 +
-        ::google::protobuf::internal::WireFormatLite::MessageSizeNoVirtual(
-          *this->reg_resp_);
-    }
-
-    // optional .newsfeed.proto.topic_request topic_req = 4;
-    if (has_topic_req()) {
-      total_size += 1 +
-        ::google::protobuf::internal::WireFormatLite::MessageSizeNoVirtual(
-          *this->topic_req_);
-    }
-
-    // optional .newsfeed.proto.topic_response topic_resp = 5;
-    if (has_topic_resp()) {
-      total_size += 1 +
-        ::google::protobuf::internal::WireFormatLite::MessageSizeNoVirtual(
-          *this->topic_resp_);
-    }
-
-    // optional .newsfeed.proto.post_news_request post_req = 6;
-    if (has_post_req()) {
-      total_size += 1 +
-        ::google::protobuf::internal::WireFormatLite::MessageSizeNoVirtual(
-          *this->post_req_);
-    }
-
-    // optional .newsfeed.proto.post_news_response post_resp = 7;
-    if (has_post_resp()) {
-      total_size += 1 +
-        ::google::protobuf::internal::WireFormatLite::MessageSizeNoVirtual(
-          *this->post_resp_);
-    }
-
-    // optional .newsfeed.proto.news news_data = 8;
-    if (has_news_data()) {
-      total_size += 1 +
+  // repeated .newsfeed.proto.news items = 1;
+  {
+    unsigned int count = static_cast<unsigned int>(this->items_size());
+    total_size += 1UL * count;
+    for (unsigned int i = 0; i < count; i++) {
+      total_size +=
         ::google::protobuf::internal::WireFormatLite::MessageSizeNoVirtual(
-          *this->news_data_);
+          this->items(static_cast<int>(i)));
     }
+  }
 
+  // optional int64 missed = 2;
+  if (has_missed()) {
+    total_size += 1 +
+      ::google::protobuf::internal::WireFormatLite::Int64Size(
+        this->missed());
   }
+
   int cached_size = ::google::protobuf::internal::ToCachedSize(total_size);
   GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
   _cached_size_ = cached_size;
@@ -3335,470 +3198,2044 @@ size_t req_envelope::ByteSizeLong() const {
   return total_size;
 }
 
-void req_envelope::MergeFrom(const ::google::protobuf::Message& from) {
-// @@protoc_insertion_point(generalized_merge_from_start:newsfeed.proto.req_envelope)
+void news_batch::MergeFrom(const ::google::protobuf::Message& from) {
+// @@protoc_insertion_point(generalized_merge_from_start:newsfeed.proto.news_batch)
   GOOGLE_DCHECK_NE(&from, this);
-  const req_envelope* source =
-      ::google::protobuf::internal::DynamicCastToGenerated<const req_envelope>(
+  const news_batch* source =
+      ::google::protobuf::internal::DynamicCastToGenerated<const news_batch>(
           &from);
   if (source == NULL) {
-  // @@protoc_insertion_point(generalized_merge_from_cast_fail:newsfeed.proto.req_envelope)
+  // @@protoc_insertion_point(generalized_merge_from_cast_fail:newsfeed.proto.news_batch)
     ::google::protobuf::internal::ReflectionOps::Merge(from, this);
   } else {
-  // @@protoc_insertion_point(generalized_merge_from_cast_success:newsfeed.proto.req_envelope)
+  // @@protoc_insertion_point(generalized_merge_from_cast_success:newsfeed.proto.news_batch)
     MergeFrom(*source);
   }
 }
 
-void req_envelope::MergeFrom(const req_envelope& from) {
-// @@protoc_insertion_point(class_specific_merge_from_start:newsfeed.proto.req_envelope)
+void news_batch::MergeFrom(const news_batch& from) {
+// @@protoc_insertion_point(class_specific_merge_from_start:newsfeed.proto.news_batch)
   GOOGLE_DCHECK_NE(&from, this);
   _internal_metadata_.MergeFrom(from._internal_metadata_);
   ::google::protobuf::uint32 cached_has_bits = 0;
   (void) cached_has_bits;
 
-  cached_has_bits = from._has_bits_[0];
-  if (cached_has_bits & 255u) {
-    if (cached_has_bits & 0x00000001u) {
-      mutable_reg_req()->::newsfeed::proto::register_request::MergeFrom(from.reg_req());
-    }
-    if (cached_has_bits & 0x00000002u) {
-      mutable_reg_resp()->::newsfeed::proto::register_response::MergeFrom(from.reg_resp());
-    }
-    if (cached_has_bits & 0x00000004u) {
-      mutable_topic_req()->::newsfeed::proto::topic_request::MergeFrom(from.topic_req());
-    }
-    if (cached_has_bits & 0x00000008u) {
-      mutable_topic_resp()->::newsfeed::proto::topic_response::MergeFrom(from.topic_resp());
-    }
-    if (cached_has_bits & 0x00000010u) {
-      mutable_post_req()->::newsfeed::proto::post_news_request::MergeFrom(from.post_req());
-    }
-    if (cached_has_bits & 0x00000020u) {
-      mutable_post_resp()->::newsfeed::proto::post_news_response::MergeFrom(from.post_resp());
-    }
-    if (cached_has_bits & 0x00000040u) {
-      mutable_news_data()->::newsfeed::proto::news::MergeFrom(from.news_data());
-    }
-    if (cached_has_bits & 0x00000080u) {
-      type_ = from.type_;
-    }
-    _has_bits_[0] |= cached_has_bits;
+  items_.MergeFrom(from.items_);
+  if (from.has_missed()) {
+    set_missed(from.missed());
   }
 }
 
-void req_envelope::CopyFrom(const ::google::protobuf::Message& from) {
-// @@protoc_insertion_point(generalized_copy_from_start:newsfeed.proto.req_envelope)
+void news_batch::CopyFrom(const ::google::protobuf::Message& from) {
+// @@protoc_insertion_point(generalized_copy_from_start:newsfeed.proto.news_batch)
   if (&from == this) return;
   Clear();
   MergeFrom(from);
 }
 
-void req_envelope::CopyFrom(const req_envelope& from) {
-// @@protoc_insertion_point(class_specific_copy_from_start:newsfeed.proto.req_envelope)
+void news_batch::CopyFrom(const news_batch& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:newsfeed.proto.news_batch)
   if (&from == this) return;
   Clear();
   MergeFrom(from);
 }
 
-bool req_envelope::IsInitialized() const {
-  if ((_has_bits_[0] & 0x00000080) != 0x00000080) return false;
-  if (has_reg_req()) {
-    if (!this->reg_req_->IsInitialized()) return false;
-  }
-  if (has_reg_resp()) {
-    if (!this->reg_resp_->IsInitialized()) return false;
-  }
-  if (has_topic_req()) {
-    if (!this->topic_req_->IsInitialized()) return false;
-  }
-  if (has_topic_resp()) {
-    if (!this->topic_resp_->IsInitialized()) return false;
-  }
-  if (has_post_req()) {
-    if (!this->post_req_->IsInitialized()) return false;
-  }
-  if (has_post_resp()) {
-    if (!this->post_resp_->IsInitialized()) return false;
-  }
-  if (has_news_data()) {
-    if (!this->news_data_->IsInitialized()) return false;
-  }
+bool news_batch::IsInitialized() const {
+  if (!::google::protobuf::internal::AllAreInitialized(this->items())) return false;
   return true;
 }
 
-void req_envelope::Swap(req_envelope* other) {
+void news_batch::Swap(news_batch* other) {
   if (other == this) return;
   InternalSwap(other);
 }
-void req_envelope::InternalSwap(req_envelope* other) {
+void news_batch::InternalSwap(news_batch* other) {
   using std::swap;
-  swap(reg_req_, other->reg_req_);
-  swap(reg_resp_, other->reg_resp_);
-  swap(topic_req_, other->topic_req_);
-  swap(topic_resp_, other->topic_resp_);
-  swap(post_req_, other->post_req_);
-  swap(post_resp_, other->post_resp_);
-  swap(news_data_, other->news_data_);
-  swap(type_, other->type_);
+  items_.InternalSwap(&other->items_);
+  swap(missed_, other->missed_);
   swap(_has_bits_[0], other->_has_bits_[0]);
   _internal_metadata_.Swap(&other->_internal_metadata_);
   swap(_cached_size_, other->_cached_size_);
 }
 
-::google::protobuf::Metadata req_envelope::GetMetadata() const {
+::google::protobuf::Metadata news_batch::GetMetadata() const {
   protobuf_newsfeed_5fmessages_2eproto::protobuf_AssignDescriptorsOnce();
   return protobuf_newsfeed_5fmessages_2eproto::file_level_metadata[kIndexInFileMessages];
 }
 
 #if PROTOBUF_INLINE_NOT_IN_HEADERS
-// req_envelope
+// news_batch
 
-// required .newsfeed.proto.req_envelope.msg_type type = 1;
-bool req_envelope::has_type() const {
-  return (_has_bits_[0] & 0x00000080u) != 0;
+// repeated .newsfeed.proto.news items = 1;
+int news_batch::items_size() const {
+  return items_.size();
 }
-void req_envelope::set_has_type() {
-  _has_bits_[0] |= 0x00000080u;
+void news_batch::clear_items() {
+  items_.Clear();
 }
-void req_envelope::clear_has_type() {
-  _has_bits_[0] &= ~0x00000080u;
+const ::newsfeed::proto::news& news_batch::items(int index) const {
+  // @@protoc_insertion_point(field_get:newsfeed.proto.news_batch.items)
+  return items_.Get(index);
 }
-void req_envelope::clear_type() {
-  type_ = 1;
-  clear_has_type();
+::newsfeed::proto::news* news_batch::mutable_items(int index) {
+  // @@protoc_insertion_point(field_mutable:newsfeed.proto.news_batch.items)
+  return items_.Mutable(index);
 }
-::newsfeed::proto::req_envelope_msg_type req_envelope::type() const {
-  // @@protoc_insertion_point(field_get:newsfeed.proto.req_envelope.type)
-  return static_cast< ::newsfeed::proto::req_envelope_msg_type >(type_);
+::newsfeed::proto::news* news_batch::add_items() {
+  // @@protoc_insertion_point(field_add:newsfeed.proto.news_batch.items)
+  return items_.Add();
 }
-void req_envelope::set_type(::newsfeed::proto::req_envelope_msg_type value) {
-  assert(::newsfeed::proto::req_envelope_msg_type_IsValid(value));
-  set_has_type();
-  type_ = value;
-  // @@protoc_insertion_point(field_set:newsfeed.proto.req_envelope.type)
+::google::protobuf::RepeatedPtrField< ::newsfeed::proto::news >*
+news_batch::mutable_items() {
+  // @@protoc_insertion_point(field_mutable_list:newsfeed.proto.news_batch.items)
+  return &items_;
+}
+const ::google::protobuf::RepeatedPtrField< ::newsfeed::proto::news >&
+news_batch::items() const {
+  // @@protoc_insertion_point(field_list:newsfeed.proto.news_batch.items)
+  return items_;
 }
 
-// optional .newsfeed.proto.register_request reg_req = 2;
-bool req_envelope::has_reg_req() const {
+// optional int64 missed = 2;
+bool news_batch::has_missed() const {
   return (_has_bits_[0] & 0x00000001u) != 0;
 }
-void req_envelope::set_has_reg_req() {
+void news_batch::set_has_missed() {
   _has_bits_[0] |= 0x00000001u;
 }
-void req_envelope::clear_has_reg_req() {
+void news_batch::clear_has_missed() {
   _has_bits_[0] &= ~0x00000001u;
 }
-void req_envelope::clear_reg_req() {
-  if (reg_req_ != NULL) reg_req_->::newsfeed::proto::register_request::Clear();
-  clear_has_reg_req();
+void news_batch::clear_missed() {
+  missed_ = GOOGLE_LONGLONG(0);
+  clear_has_missed();
 }
-const ::newsfeed::proto::register_request& req_envelope::reg_req() const {
-  const ::newsfeed::proto::register_request* p = reg_req_;
-  // @@protoc_insertion_point(field_get:newsfeed.proto.req_envelope.reg_req)
-  return p != NULL ? *p : *reinterpret_cast<const ::newsfeed::proto::register_request*>(
-      &::newsfeed::proto::_register_request_default_instance_);
+::google::protobuf::int64 news_batch::missed() const {
+  // @@protoc_insertion_point(field_get:newsfeed.proto.news_batch.missed)
+  return missed_;
 }
-::newsfeed::proto::register_request* req_envelope::mutable_reg_req() {
-  set_has_reg_req();
-  if (reg_req_ == NULL) {
-    reg_req_ = new ::newsfeed::proto::register_request;
-  }
-  // @@protoc_insertion_point(field_mutable:newsfeed.proto.req_envelope.reg_req)
-  return reg_req_;
+void news_batch::set_missed(::google::protobuf::int64 value) {
+  set_has_missed();
+  missed_ = value;
+  // @@protoc_insertion_point(field_set:newsfeed.proto.news_batch.missed)
 }
-::newsfeed::proto::register_request* req_envelope::release_reg_req() {
-  // @@protoc_insertion_point(field_release:newsfeed.proto.req_envelope.reg_req)
-  clear_has_reg_req();
-  ::newsfeed::proto::register_request* temp = reg_req_;
-  reg_req_ = NULL;
-  return temp;
+
+#endif  // PROTOBUF_INLINE_NOT_IN_HEADERS
+
+// ===================================================================
+
+#if !defined(_MSC_VER) || _MSC_VER >= 1900
+const int req_envelope::kTypeFieldNumber;
+const int req_envelope::kRegReqFieldNumber;
+const int req_envelope::kRegRespFieldNumber;
+const int req_envelope::kTopicReqFieldNumber;
+const int req_envelope::kTopicRespFieldNumber;
+const int req_envelope::kPostReqFieldNumber;
+const int req_envelope::kPostRespFieldNumber;
+const int req_envelope::kNewsDataFieldNumber;
+const int req_envelope::kNewsBatchDataFieldNumber;
+#endif  // !defined(_MSC_VER) || _MSC_VER >= 1900
+
+req_envelope::req_envelope()
+  : ::google::protobuf::Message(), _internal_metadata_(NULL) {
+  if (GOOGLE_PREDICT_TRUE(this != internal_default_instance())) {
+    protobuf_newsfeed_5fmessages_2eproto::InitDefaults();
+  }
+  SharedCtor();
+  // @@protoc_insertion_point(constructor:newsfeed.proto.req_envelope)
 }
-void req_envelope::set_allocated_reg_req(::newsfeed::proto::register_request* reg_req) {
-  delete reg_req_;
-  reg_req_ = reg_req;
-  if (reg_req) {
-    set_has_reg_req();
+req_envelope::req_envelope(const req_envelope& from)
+  : ::google::protobuf::Message(),
+      _internal_metadata_(NULL),
+      _has_bits_(from._has_bits_),
+      _cached_size_(0) {
+  _internal_metadata_.MergeFrom(from._internal_metadata_);
+  if (from.has_reg_req()) {
+    reg_req_ = new ::newsfeed::proto::register_request(*from.reg_req_);
   } else {
-    clear_has_reg_req();
+    reg_req_ = NULL;
   }
-  // @@protoc_insertion_point(field_set_allocated:newsfeed.proto.req_envelope.reg_req)
-}
-
-// optional .newsfeed.proto.register_response reg_resp = 3;
-bool req_envelope::has_reg_resp() const {
-  return (_has_bits_[0] & 0x00000002u) != 0;
-}
-void req_envelope::set_has_reg_resp() {
-  _has_bits_[0] |= 0x00000002u;
-}
-void req_envelope::clear_has_reg_resp() {
-  _has_bits_[0] &= ~0x00000002u;
-}
-void req_envelope::clear_reg_resp() {
-  if (reg_resp_ != NULL) reg_resp_->::newsfeed::proto::register_response::Clear();
-  clear_has_reg_resp();
-}
-const ::newsfeed::proto::register_response& req_envelope::reg_resp() const {
-  const ::newsfeed::proto::register_response* p = reg_resp_;
-  // @@protoc_insertion_point(field_get:newsfeed.proto.req_envelope.reg_resp)
-  return p != NULL ? *p : *reinterpret_cast<const ::newsfeed::proto::register_response*>(
-      &::newsfeed::proto::_register_response_default_instance_);
-}
-::newsfeed::proto::register_response* req_envelope::mutable_reg_resp() {
-  set_has_reg_resp();
-  if (reg_resp_ == NULL) {
-    reg_resp_ = new ::newsfeed::proto::register_response;
+  if (from.has_reg_resp()) {
+    reg_resp_ = new ::newsfeed::proto::register_response(*from.reg_resp_);
+  } else {
+    reg_resp_ = NULL;
   }
-  // @@protoc_insertion_point(field_mutable:newsfeed.proto.req_envelope.reg_resp)
-  return reg_resp_;
-}
-::newsfeed::proto::register_response* req_envelope::release_reg_resp() {
-  // @@protoc_insertion_point(field_release:newsfeed.proto.req_envelope.reg_resp)
-  clear_has_reg_resp();
-  ::newsfeed::proto::register_response* temp = reg_resp_;
-  reg_resp_ = NULL;
-  return temp;
-}
-void req_envelope::set_allocated_reg_resp(::newsfeed::proto::register_response* reg_resp) {
-  delete reg_resp_;
-  reg_resp_ = reg_resp;
-  if (reg_resp) {
-    set_has_reg_resp();
+  if (from.has_topic_req()) {
+    topic_req_ = new ::newsfeed::proto::topic_request(*from.topic_req_);
   } else {
-    clear_has_reg_resp();
+    topic_req_ = NULL;
   }
-  // @@protoc_insertion_point(field_set_allocated:newsfeed.proto.req_envelope.reg_resp)
+  if (from.has_topic_resp()) {
+    topic_resp_ = new ::newsfeed::proto::topic_response(*from.topic_resp_);
+  } else {
+    topic_resp_ = NULL;
+  }
+  if (from.has_post_req()) {
+    post_req_ = new ::newsfeed::proto::post_news_request(*from.post_req_);
+  } else {
+    post_req_ = NULL;
+  }
+  if (from.has_post_resp()) {
+    post_resp_ = new ::newsfeed::proto::post_news_response(*from.post_resp_);
+  } else {
+    post_resp_ = NULL;
+  }
+  if (from.has_news_data()) {
+    news_data_ = new ::newsfeed::proto::news(*from.news_data_);
+  } else {
+    news_data_ = NULL;
+  }
+  if (from.has_news_batch_data()) {
+    news_batch_data_ = new ::newsfeed::proto::news_batch(*from.news_batch_data_);
+  } else {
+    news_batch_data_ = NULL;
+  }
+  type_ = from.type_;
+  // @@protoc_insertion_point(copy_constructor:newsfeed.proto.req_envelope)
 }
 
-// optional .newsfeed.proto.topic_request topic_req = 4;
-bool req_envelope::has_topic_req() const {
-  return (_has_bits_[0] & 0x00000004u) != 0;
-}
-void req_envelope::set_has_topic_req() {
-  _has_bits_[0] |= 0x00000004u;
+void req_envelope::SharedCtor() {
+  _cached_size_ = 0;
+  ::memset(&reg_req_, 0, static_cast<size_t>(
+      reinterpret_cast<char*>(&news_batch_data_) -
+      reinterpret_cast<char*>(&reg_req_)) + sizeof(news_batch_data_));
+  type_ = 1;
 }
-void req_envelope::clear_has_topic_req() {
-  _has_bits_[0] &= ~0x00000004u;
+
+req_envelope::~req_envelope() {
+  // @@protoc_insertion_point(destructor:newsfeed.proto.req_envelope)
+  SharedDtor();
 }
-void req_envelope::clear_topic_req() {
-  if (topic_req_ != NULL) topic_req_->::newsfeed::proto::topic_request::Clear();
-  clear_has_topic_req();
+
+void req_envelope::SharedDtor() {
+  if (this != internal_default_instance()) delete reg_req_;
+  if (this != internal_default_instance()) delete reg_resp_;
+  if (this != internal_default_instance()) delete topic_req_;
+  if (this != internal_default_instance()) delete topic_resp_;
+  if (this != internal_default_instance()) delete post_req_;
+  if (this != internal_default_instance()) delete post_resp_;
+  if (this != internal_default_instance()) delete news_data_;
+  if (this != internal_default_instance()) delete news_batch_data_;
 }
-const ::newsfeed::proto::topic_request& req_envelope::topic_req() const {
-  const ::newsfeed::proto::topic_request* p = topic_req_;
-  // @@protoc_insertion_point(field_get:newsfeed.proto.req_envelope.topic_req)
-  return p != NULL ? *p : *reinterpret_cast<const ::newsfeed::proto::topic_request*>(
-      &::newsfeed::proto::_topic_request_default_instance_);
+
+void req_envelope::SetCachedSize(int size) const {
+  GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
+  _cached_size_ = size;
+  GOOGLE_SAFE_CONCURRENT_WRITES_END();
 }
-::newsfeed::proto::topic_request* req_envelope::mutable_topic_req() {
-  set_has_topic_req();
-  if (topic_req_ == NULL) {
-    topic_req_ = new ::newsfeed::proto::topic_request;
-  }
-  // @@protoc_insertion_point(field_mutable:newsfeed.proto.req_envelope.topic_req)
-  return topic_req_;
+const ::google::protobuf::Descriptor* req_envelope::descriptor() {
+  protobuf_newsfeed_5fmessages_2eproto::protobuf_AssignDescriptorsOnce();
+  return protobuf_newsfeed_5fmessages_2eproto::file_level_metadata[kIndexInFileMessages].descriptor;
 }
-::newsfeed::proto::topic_request* req_envelope::release_topic_req() {
-  // @@protoc_insertion_point(field_release:newsfeed.proto.req_envelope.topic_req)
-  clear_has_topic_req();
-  ::newsfeed::proto::topic_request* temp = topic_req_;
-  topic_req_ = NULL;
-  return temp;
+
+const req_envelope& req_envelope::default_instance() {
+  protobuf_newsfeed_5fmessages_2eproto::InitDefaults();
+  return *internal_default_instance();
 }
-void req_envelope::set_allocated_topic_req(::newsfeed::proto::topic_request* topic_req) {
-  delete topic_req_;
-  topic_req_ = topic_req;
-  if (topic_req) {
-    set_has_topic_req();
-  } else {
-    clear_has_topic_req();
+
+req_envelope* req_envelope::New(::google::protobuf::Arena* arena) const {
+  req_envelope* n = new req_envelope;
+  if (arena != NULL) {
+    arena->Own(n);
   }
-  // @@protoc_insertion_point(field_set_allocated:newsfeed.proto.req_envelope.topic_req)
+  return n;
 }
 
-// optional .newsfeed.proto.topic_response topic_resp = 5;
-bool req_envelope::has_topic_resp() const {
-  return (_has_bits_[0] & 0x00000008u) != 0;
-}
+void req_envelope::Clear() {
+// @@protoc_insertion_point(message_clear_start:newsfeed.proto.req_envelope)
+  ::google::protobuf::uint32 cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  cached_has_bits = _has_bits_[0];
+  if (cached_has_bits & 255u) {
+    if (cached_has_bits & 0x00000001u) {
+      GOOGLE_DCHECK(reg_req_ != NULL);
+      reg_req_->::newsfeed::proto::register_request::Clear();
+    }
+    if (cached_has_bits & 0x00000002u) {
+      GOOGLE_DCHECK(reg_resp_ != NULL);
+      reg_resp_->::newsfeed::proto::register_response::Clear();
+    }
+    if (cached_has_bits & 0x00000004u) {
+      GOOGLE_DCHECK(topic_req_ != NULL);
+      topic_req_->::newsfeed::proto::topic_request::Clear();
+    }
+    if (cached_has_bits & 0x00000008u) {
+      GOOGLE_DCHECK(topic_resp_ != NULL);
+      topic_resp_->::newsfeed::proto::topic_response::Clear();
+    }
+    if (cached_has_bits & 0x00000010u) {
+      GOOGLE_DCHECK(post_req_ != NULL);
+      post_req_->::newsfeed::proto::post_news_request::Clear();
+    }
+    if (cached_has_bits & 0x00000020u) {
+      GOOGLE_DCHECK(post_resp_ != NULL);
+      post_resp_->::newsfeed::proto::post_news_response::Clear();
+    }
+    if (cached_has_bits & 0x00000040u) {
+      GOOGLE_DCHECK(news_data_ != NULL);
+      news_data_->::newsfeed::proto::news::Clear();
+    }
+    if (cached_has_bits & 0x00000080u) {
+      GOOGLE_DCHECK(news_batch_data_ != NULL);
+      news_batch_data_->::newsfeed::proto::news_batch::Clear();
+    }
+  }
+  type_ = 1;
+  _has_bits_.Clear();
+  _internal_metadata_.Clear();
+}
+
+bool req_envelope::MergePartialFromCodedStream(
+    ::google::protobuf::io::CodedInputStream* input) {
+#define DO_(EXPRESSION) if (!GOOGLE_PREDICT_TRUE(EXPRESSION)) goto failure
+  ::google::protobuf::uint32 tag;
+  // @@protoc_insertion_point(parse_start:newsfeed.proto.req_envelope)
+  for (;;) {
+    ::std::pair< ::google::protobuf::uint32, bool> p = input->ReadTagWithCutoffNoLastTag(127u);
+    tag = p.first;
+    if (!p.second) goto handle_unusual;
+    switch (::google::protobuf::internal::WireFormatLite::GetTagFieldNumber(tag)) {
+      // required .newsfeed.proto.req_envelope.msg_type type = 1;
+      case 1: {
+        if (static_cast< ::google::protobuf::uint8>(tag) ==
+            static_cast< ::google::protobuf::uint8>(8u /* 8 & 0xFF */)) {
+          int value;
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   int, ::google::protobuf::internal::WireFormatLite::TYPE_ENUM>(
+                 input, &value)));
+          if (::newsfeed::proto::req_envelope_msg_type_IsValid(value)) {
+            set_type(static_cast< ::newsfeed::proto::req_envelope_msg_type >(value));
+          } else {
+            mutable_unknown_fields()->AddVarint(
+                1, static_cast< ::google::protobuf::uint64>(value));
+          }
+        } else {
+          goto handle_unusual;
+        }
+        break;
+      }
+
+      // optional .newsfeed.proto.register_request reg_req = 2;
+      case 2: {
+        if (static_cast< ::google::protobuf::uint8>(tag) ==
+            static_cast< ::google::protobuf::uint8>(18u /* 18 & 0xFF */)) {
+          DO_(::google::protobuf::internal::WireFormatLite::ReadMessageNoVirtual(
+               input, mutable_reg_req()));
+        } else {
+          goto handle_unusual;
+        }
+        break;
+      }
+
+      // optional .newsfeed.proto.register_response reg_resp = 3;
+      case 3: {
+        if (static_cast< ::google::protobuf::uint8>(tag) ==
+            static_cast< ::google::protobuf::uint8>(26u /* 26 & 0xFF */)) {
+          DO_(::google::protobuf::internal::WireFormatLite::ReadMessageNoVirtual(
+               input, mutable_reg_resp()));
+        } else {
+          goto handle_unusual;
+        }
+        break;
+      }
+
+      // optional .newsfeed.proto.topic_request topic_req = 4;
+      case 4: {
+        if (static_cast< ::google::protobuf::uint8>(tag) ==
+            static_cast< ::google::protobuf::uint8>(34u /* 34 & 0xFF */)) {
+          DO_(::google::protobuf::internal::WireFormatLite::ReadMessageNoVirtual(
+               input, mutable_topic_req()));
+        } else {
+          goto handle_unusual;
+        }
+        break;
+      }
+
+      // optional .newsfeed.proto.topic_response topic_resp = 5;
+      case 5: {
+        if (static_cast< ::google::protobuf::uint8>(tag) ==
+            static_cast< ::google::protobuf::uint8>(42u /* 42 & 0xFF */)) {
+          DO_(::google::protobuf::internal::WireFormatLite::ReadMessageNoVirtual(
+               input, mutable_topic_resp()));
+        } else {
+          goto handle_unusual;
+        }
+        break;
+      }
+
+      // optional .newsfeed.proto.post_news_request post_req = 6;
+      case 6: {
+        if (static_cast< ::google::protobuf::uint8>(tag) ==
+            static_cast< ::google::protobuf::uint8>(50u /* 50 & 0xFF */)) {
+          DO_(::google::protobuf::internal::WireFormatLite::ReadMessageNoVirtual(
+               input, mutable_post_req()));
+        } else {
+          goto handle_unusual;
+        }
+        break;
+      }
+
+      // optional .newsfeed.proto.post_news_response post_resp = 7;
+      case 7: {
+        if (static_cast< ::google::protobuf::uint8>(tag) ==
+            static_cast< ::google::protobuf::uint8>(58u /* 58 & 0xFF */)) {
+          DO_(::google::protobuf::internal::WireFormatLite::ReadMessageNoVirtual(
+               input, mutable_post_resp()));
+        } else {
+          goto handle_unusual;
+        }
+        break;
+      }
+
+      // optional .newsfeed.proto.news news_data = 8;
+      case 8: {
+        if (static_cast< ::google::protobuf::uint8>(tag) ==
+            static_cast< ::google::protobuf::uint8>(66u /* 66 & 0xFF */)) {
+          DO_(::google::protobuf::internal::WireFormatLite::ReadMessageNoVirtual(
+               input, mutable_news_data()));
+        } else {
+          goto handle_unusual;
+        }
+        break;
+      }
+
+      // optional .newsfeed.proto.news_batch news_batch_data = 9;
+      case 9: {
+        if (static_cast< ::google::protobuf::uint8>(tag) ==
+            static_cast< ::google::protobuf::uint8>(74u /* 74 & 0xFF */)) {
+          DO_(::google::protobuf::internal::WireFormatLite::ReadMessageNoVirtual(
+               input, mutable_news_batch_data()));
+        } else {
+          goto handle_unusual;
+        }
+        break;
+      }
+
+      default: {
+      handle_unusual:
+        if (tag == 0) {
+          goto success;
+        }
+        DO_(::google::protobuf::internal::WireFormat::SkipField(
+              input, tag, _internal_metadata_.mutable_unknown_fields()));
+        break;
+      }
+    }
+  }
+success:
+  // @@protoc_insertion_point(parse_success:newsfeed.proto.req_envelope)
+  return true;
+failure:
+  // @@protoc_insertion_point(parse_failure:newsfeed.proto.req_envelope)
+  return false;
+#undef DO_
+}
+
+void req_envelope::SerializeWithCachedSizes(
+    ::google::protobuf::io::CodedOutputStream* output) const {
+  // @@protoc_insertion_point(serialize_start:newsfeed.proto.req_envelope)
+  ::google::protobuf::uint32 cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  cached_has_bits = _has_bits_[0];
+  // required .newsfeed.proto.req_envelope.msg_type type = 1;
+  if (cached_has_bits & 0x00000100u) {
+    ::google::protobuf::internal::WireFormatLite::WriteEnum(
+      1, this->type(), output);
+  }
+
+  // optional .newsfeed.proto.register_request reg_req = 2;
+  if (cached_has_bits & 0x00000001u) {
+    ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
+      2, *this->reg_req_, output);
+  }
+
+  // optional .newsfeed.proto.register_response reg_resp = 3;
+  if (cached_has_bits & 0x00000002u) {
+    ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
+      3, *this->reg_resp_, output);
+  }
+
+  // optional .newsfeed.proto.topic_request topic_req = 4;
+  if (cached_has_bits & 0x00000004u) {
+    ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
+      4, *this->topic_req_, output);
+  }
+
+  // optional .newsfeed.proto.topic_response topic_resp = 5;
+  if (cached_has_bits & 0x00000008u) {
+    ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
+      5, *this->topic_resp_, output);
+  }
+
+  // optional .newsfeed.proto.post_news_request post_req = 6;
+  if (cached_has_bits & 0x00000010u) {
+    ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
+      6, *this->post_req_, output);
+  }
+
+  // optional .newsfeed.proto.post_news_response post_resp = 7;
+  if (cached_has_bits & 0x00000020u) {
+    ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
+      7, *this->post_resp_, output);
+  }
+
+  // optional .newsfeed.proto.news news_data = 8;
+  if (cached_has_bits & 0x00000040u) {
+    ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
+      8, *this->news_data_, output);
+  }
+
+  // optional .newsfeed.proto.news_batch news_batch_data = 9;
+  if (cached_has_bits & 0x00000080u) {
+    ::google::protobuf::internal::WireFormatLite::WriteMessageMaybeToArray(
+      9, *this->news_batch_data_, output);
+  }
+
+  if (_internal_metadata_.have_unknown_fields()) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFields(
+        _internal_metadata_.unknown_fields(), output);
+  }
+  // @@protoc_insertion_point(serialize_end:newsfeed.proto.req_envelope)
+}
+
+::google::protobuf::uint8* req_envelope::InternalSerializeWithCachedSizesToArray(
+    bool deterministic, ::google::protobuf::uint8* target) const {
+  (void)deterministic; // Unused
+  // @@protoc_insertion_point(serialize_to_array_start:newsfeed.proto.req_envelope)
+  ::google::protobuf::uint32 cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  cached_has_bits = _has_bits_[0];
+  // required .newsfeed.proto.req_envelope.msg_type type = 1;
+  if (cached_has_bits & 0x00000100u) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteEnumToArray(
+      1, this->type(), target);
+  }
+
+  // optional .newsfeed.proto.register_request reg_req = 2;
+  if (cached_has_bits & 0x00000001u) {
+    target = ::google::protobuf::internal::WireFormatLite::
+      InternalWriteMessageNoVirtualToArray(
+        2, *this->reg_req_, deterministic, target);
+  }
+
+  // optional .newsfeed.proto.register_response reg_resp = 3;
+  if (cached_has_bits & 0x00000002u) {
+    target = ::google::protobuf::internal::WireFormatLite::
+      InternalWriteMessageNoVirtualToArray(
+        3, *this->reg_resp_, deterministic, target);
+  }
+
+  // optional .newsfeed.proto.topic_request topic_req = 4;
+  if (cached_has_bits & 0x00000004u) {
+    target = ::google::protobuf::internal::WireFormatLite::
+      InternalWriteMessageNoVirtualToArray(
+        4, *this->topic_req_, deterministic, target);
+  }
+
+  // optional .newsfeed.proto.topic_response topic_resp = 5;
+  if (cached_has_bits & 0x00000008u) {
+    target = ::google::protobuf::internal::WireFormatLite::
+      InternalWriteMessageNoVirtualToArray(
+        5, *this->topic_resp_, deterministic, target);
+  }
+
+  // optional .newsfeed.proto.post_news_request post_req = 6;
+  if (cached_has_bits & 0x00000010u) {
+    target = ::google::protobuf::internal::WireFormatLite::
+      InternalWriteMessageNoVirtualToArray(
+        6, *this->post_req_, deterministic, target);
+  }
+
+  // optional .newsfeed.proto.post_news_response post_resp = 7;
+  if (cached_has_bits & 0x00000020u) {
+    target = ::google::protobuf::internal::WireFormatLite::
+      InternalWriteMessageNoVirtualToArray(
+        7, *this->post_resp_, deterministic, target);
+  }
+
+  // optional .newsfeed.proto.news news_data = 8;
+  if (cached_has_bits & 0x00000040u) {
+    target = ::google::protobuf::internal::WireFormatLite::
+      InternalWriteMessageNoVirtualToArray(
+        8, *this->news_data_, deterministic, target);
+  }
+
+  // optional .newsfeed.proto.news_batch news_batch_data = 9;
+  if (cached_has_bits & 0x00000080u) {
+    target = ::google::protobuf::internal::WireFormatLite::
+      InternalWriteMessageNoVirtualToArray(
+        9, *this->news_batch_data_, deterministic, target);
+  }
+
+  if (_internal_metadata_.have_unknown_fields()) {
+    target = ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields(), target);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:newsfeed.proto.req_envelope)
+  return target;
+}
+
+size_t req_envelope::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:newsfeed.proto.req_envelope)
+  size_t total_size = 0;
+
+  if (_internal_metadata_.have_unknown_fields()) {
+    total_size +=
+      ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
+        _internal_metadata_.unknown_fields());
+  }
+  // required .newsfeed.proto.req_envelope.msg_type type = 1;
+  if (has_type()) {
+    total_size += 1 +
+      ::google::protobuf::internal::WireFormatLite::EnumSize(this->type());
+  }
+  if (_has_bits_[0 / 32] & 255u) {
+    // optional .newsfeed.proto.register_request reg_req = 2;
+    if (has_reg_req()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::MessageSizeNoVirtual(
+          *this->reg_req_);
+    }
+
+    // optional .newsfeed.proto.register_response reg_resp = 3;
+    if (has_reg_resp()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::MessageSizeNoVirtual(
+          *this->reg_resp_);
+    }
+
+    // optional .newsfeed.proto.topic_request topic_req = 4;
+    if (has_topic_req()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::MessageSizeNoVirtual(
+          *this->topic_req_);
+    }
+
+    // optional .newsfeed.proto.topic_response topic_resp = 5;
+    if (has_topic_resp()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::MessageSizeNoVirtual(
+          *this->topic_resp_);
+    }
+
+    // optional .newsfeed.proto.post_news_request post_req = 6;
+    if (has_post_req()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::MessageSizeNoVirtual(
+          *this->post_req_);
+    }
+
+    // optional .newsfeed.proto.post_news_response post_resp = 7;
+    if (has_post_resp()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::MessageSizeNoVirtual(
+          *this->post_resp_);
+    }
+
+    // optional .newsfeed.proto.news news_data = 8;
+    if (has_news_data()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::MessageSizeNoVirtual(
+          *this->news_data_);
+    }
+
+    // optional .newsfeed.proto.news_batch news_batch_data = 9;
+    if (has_news_batch_data()) {
+      total_size += 1 +
+        ::google::protobuf::internal::WireFormatLite::MessageSizeNoVirtual(
+          *this->news_batch_data_);
+    }
+
+  }
+  int cached_size = ::google::protobuf::internal::ToCachedSize(total_size);
+  GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
+  _cached_size_ = cached_size;
+  GOOGLE_SAFE_CONCURRENT_WRITES_END();
+  return total_size;
+}
+
+void req_envelope::MergeFrom(const ::google::protobuf::Message& from) {
+// @@protoc_insertion_point(generalized_merge_from_start:newsfeed.proto.req_envelope)
+  GOOGLE_DCHECK_NE(&from, this);
+  const req_envelope* source =
+      ::google::protobuf::internal::DynamicCastToGenerated<const req_envelope>(
+          &from);
+  if (source == NULL) {
+  // @@protoc_insertion_point(generalized_merge_from_cast_fail:newsfeed.proto.req_envelope)
+    ::google::protobuf::internal::ReflectionOps::Merge(from, this);
+  } else {
+  // @@protoc_insertion_point(generalized_merge_from_cast_success:newsfeed.proto.req_envelope)
+    MergeFrom(*source);
+  }
+}
+
+void req_envelope::MergeFrom(const req_envelope& from) {
+// @@protoc_insertion_point(class_specific_merge_from_start:newsfeed.proto.req_envelope)
+  GOOGLE_DCHECK_NE(&from, this);
+  _internal_metadata_.MergeFrom(from._internal_metadata_);
+  ::google::protobuf::uint32 cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  cached_has_bits = from._has_bits_[0];
+  if (cached_has_bits & 255u) {
+    if (cached_has_bits & 0x00000001u) {
+      mutable_reg_req()->::newsfeed::proto::register_request::MergeFrom(from.reg_req());
+    }
+    if (cached_has_bits & 0x00000002u) {
+      mutable_reg_resp()->::newsfeed::proto::register_response::MergeFrom(from.reg_resp());
+    }
+    if (cached_has_bits & 0x00000004u) {
+      mutable_topic_req()->::newsfeed::proto::topic_request::MergeFrom(from.topic_req());
+    }
+    if (cached_has_bits & 0x00000008u) {
+      mutable_topic_resp()->::newsfeed::proto::topic_response::MergeFrom(from.topic_resp());
+    }
+    if (cached_has_bits & 0x00000010u) {
+      mutable_post_req()->::newsfeed::proto::post_news_request::MergeFrom(from.post_req());
+    }
+    if (cached_has_bits & 0x00000020u) {
+      mutable_post_resp()->::newsfeed::proto::post_news_response::MergeFrom(from.post_resp());
+    }
+    if (cached_has_bits & 0x00000040u) {
+      mutable_news_data()->::newsfeed::proto::news::MergeFrom(from.news_data());
+    }
+    if (cached_has_bits & 0x00000080u) {
+      mutable_news_batch_data()->::newsfeed::proto::news_batch::MergeFrom(from.news_batch_data());
+    }
+  }
+  if (cached_has_bits & 0x00000100u) {
+    set_type(from.type());
+  }
+}
+
+void req_envelope::CopyFrom(const ::google::protobuf::Message& from) {
+// @@protoc_insertion_point(generalized_copy_from_start:newsfeed.proto.req_envelope)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+void req_envelope::CopyFrom(const req_envelope& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:newsfeed.proto.req_envelope)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool req_envelope::IsInitialized() const {
+  if ((_has_bits_[0] & 0x00000100) != 0x00000100) return false;
+  if (has_reg_req()) {
+    if (!this->reg_req_->IsInitialized()) return false;
+  }
+  if (has_reg_resp()) {
+    if (!this->reg_resp_->IsInitialized()) return false;
+  }
+  if (has_topic_req()) {
+    if (!this->topic_req_->IsInitialized()) return false;
+  }
+  if (has_topic_resp()) {
+    if (!this->topic_resp_->IsInitialized()) return false;
+  }
+  if (has_post_req()) {
+    if (!this->post_req_->IsInitialized()) return false;
+  }
+  if (has_post_resp()) {
+    if (!this->post_resp_->IsInitialized()) return false;
+  }
+  if (has_news_data()) {
+    if (!this->news_data_->IsInitialized()) return false;
+  }
+  if (has_news_batch_data()) {
+    if (!this->news_batch_data_->IsInitialized()) return false;
+  }
+  return true;
+}
+
+void req_envelope::Swap(req_envelope* other) {
+  if (other == this) return;
+  InternalSwap(other);
+}
+void req_envelope::InternalSwap(req_envelope* other) {
+  using std::swap;
+  swap(reg_req_, other->reg_req_);
+  swap(reg_resp_, other->reg_resp_);
+  swap(topic_req_, other->topic_req_);
+  swap(topic_resp_, other->topic_resp_);
+  swap(post_req_, other->post_req_);
+  swap(post_resp_, other->post_resp_);
+  swap(news_data_, other->news_data_);
+  swap(news_batch_data_, other->news_batch_data_);
+  swap(type_, other->type_);
+  swap(_has_bits_[0], other->_has_bits_[0]);
+  _internal_metadata_.Swap(&other->_internal_metadata_);
+  swap(_cached_size_, other->_cached_size_);
+}
+
+::google::protobuf::Metadata req_envelope::GetMetadata() const {
+  protobuf_newsfeed_5fmessages_2eproto::protobuf_AssignDescriptorsOnce();
+  return protobuf_newsfeed_5fmessages_2eproto::file_level_metadata[kIndexInFileMessages];
+}
+
+#if PROTOBUF_INLINE_NOT_IN_HEADERS
+// req_envelope
+
+// required .newsfeed.proto.req_envelope.msg_type type = 1;
+bool req_envelope::has_type() const {
+  return (_has_bits_[0] & 0x00000100u) != 0;
+}
+void req_envelope::set_has_type() {
+  _has_bits_[0] |= 0x00000100u;
+}
+void req_envelope::clear_has_type() {
+  _has_bits_[0] &= ~0x00000100u;
+}
+void req_envelope::clear_type() {
+  type_ = 1;
+  clear_has_type();
+}
+::newsfeed::proto::req_envelope_msg_type req_envelope::type() const {
+  // @@protoc_insertion_point(field_get:newsfeed.proto.req_envelope.type)
+  return static_cast< ::newsfeed::proto::req_envelope_msg_type >(type_);
+}
+void req_envelope::set_type(::newsfeed::proto::req_envelope_msg_type value) {
+  assert(::newsfeed::proto::req_envelope_msg_type_IsValid(value));
+  set_has_type();
+  type_ = value;
+  // @@protoc_insertion_point(field_set:newsfeed.proto.req_envelope.type)
+}
+
+// optional .newsfeed.proto.register_request reg_req = 2;
+bool req_envelope::has_reg_req() const {
+  return (_has_bits_[0] & 0x00000001u) != 0;
+}
+void req_envelope::set_has_reg_req() {
+  _has_bits_[0] |= 0x00000001u;
+}
+void req_envelope::clear_has_reg_req() {
+  _has_bits_[0] &= ~0x00000001u;
+}
+void req_envelope::clear_reg_req() {
+  if (reg_req_ != NULL) reg_req_->::newsfeed::proto::register_request::Clear();
+  clear_has_reg_req();
+}
+const ::newsfeed::proto::register_request& req_envelope::reg_req() const {
+  const ::newsfeed::proto::register_request* p = reg_req_;
+  // @@protoc_insertion_point(field_get:newsfeed.proto.req_envelope.reg_req)
+  return p != NULL ? *p : *reinterpret_cast<const ::newsfeed::proto::register_request*>(
+      &::newsfeed::proto::_register_request_default_instance_);
+}
+::newsfeed::proto::register_request* req_envelope::mutable_reg_req() {
+  set_has_reg_req();
+  if (reg_req_ == NULL) {
+    reg_req_ = new ::newsfeed::proto::register_request;
+  }
+  // @@protoc_insertion_point(field_mutable:newsfeed.proto.req_envelope.reg_req)
+  return reg_req_;
+}
+::newsfeed::proto::register_request* req_envelope::release_reg_req() {
+  // @@protoc_insertion_point(field_release:newsfeed.proto.req_envelope.reg_req)
+  clear_has_reg_req();
+  ::newsfeed::proto::register_request* temp = reg_req_;
+  reg_req_ = NULL;
+  return temp;
+}
+void req_envelope::set_allocated_reg_req(::newsfeed::proto::register_request* reg_req) {
+  delete reg_req_;
+  reg_req_ = reg_req;
+  if (reg_req) {
+    set_has_reg_req();
+  } else {
+    clear_has_reg_req();
+  }
+  // @@protoc_insertion_point(field_set_allocated:newsfeed.proto.req_envelope.reg_req)
+}
+
+// optional .newsfeed.proto.register_response reg_resp = 3;
+bool req_envelope::has_reg_resp() const {
+  return (_has_bits_[0] & 0x00000002u) != 0;
+}
+void req_envelope::set_has_reg_resp() {
+  _has_bits_[0] |= 0x00000002u;
+}
+void req_envelope::clear_has_reg_resp() {
+  _has_bits_[0] &= ~0x00000002u;
+}
+void req_envelope::clear_reg_resp() {
+  if (reg_resp_ != NULL) reg_resp_->::newsfeed::proto::register_response::Clear();
+  clear_has_reg_resp();
+}
+const ::newsfeed::proto::register_response& req_envelope::reg_resp() const {
+  const ::newsfeed::proto::register_response* p = reg_resp_;
+  // @@protoc_insertion_point(field_get:newsfeed.proto.req_envelope.reg_resp)
+  return p != NULL ? *p : *reinterpret_cast<const ::newsfeed::proto::register_response*>(
+      &::newsfeed::proto::_register_response_default_instance_);
+}
+::newsfeed::proto::register_response* req_envelope::mutable_reg_resp() {
+  set_has_reg_resp();
+  if (reg_resp_ == NULL) {
+    reg_resp_ = new ::newsfeed::proto::register_response;
+  }
+  // @@protoc_insertion_point(field_mutable:newsfeed.proto.req_envelope.reg_resp)
+  return reg_resp_;
+}
+::newsfeed::proto::register_response* req_envelope::release_reg_resp() {
+  // @@protoc_insertion_point(field_release:newsfeed.proto.req_envelope.reg_resp)
+  clear_has_reg_resp();
+  ::newsfeed::proto::register_response* temp = reg_resp_;
+  reg_resp_ = NULL;
+  return temp;
+}
+void req_envelope::set_allocated_reg_resp(::newsfeed::proto::register_response* reg_resp) {
+  delete reg_resp_;
+  reg_resp_ = reg_resp;
+  if (reg_resp) {
+    set_has_reg_resp();
+  } else {
+    clear_has_reg_resp();
+  }
+  // @@protoc_insertion_point(field_set_allocated:newsfeed.proto.req_envelope.reg_resp)
+}
+
+// optional .newsfeed.proto.topic_request topic_req = 4;
+bool req_envelope::has_topic_req() const {
+  return (_has_bits_[0] & 0x00000004u) != 0;
+}
+void req_envelope::set_has_topic_req() {
+  _has_bits_[0] |= 0x00000004u;
+}
+void req_envelope::clear_has_topic_req() {
+  _has_bits_[0] &= ~0x00000004u;
+}
+void req_envelope::clear_topic_req() {
+  if (topic_req_ != NULL) topic_req_->::newsfeed::proto::topic_request::Clear();
+  clear_has_topic_req();
+}
+const ::newsfeed::proto::topic_request& req_envelope::topic_req() const {
+  const ::newsfeed::proto::topic_request* p = topic_req_;
+  // @@protoc_insertion_point(field_get:newsfeed.proto.req_envelope.topic_req)
+  return p != NULL ? *p : *reinterpret_cast<const ::newsfeed::proto::topic_request*>(
+      &::newsfeed::proto::_topic_request_default_instance_);
+}
+::newsfeed::proto::topic_request* req_envelope::mutable_topic_req() {
+  set_has_topic_req();
+  if (topic_req_ == NULL) {
+    topic_req_ = new ::newsfeed::proto::topic_request;
+  }
+  // @@protoc_insertion_point(field_mutable:newsfeed.proto.req_envelope.topic_req)
+  return topic_req_;
+}
+::newsfeed::proto::topic_request* req_envelope::release_topic_req() {
+  // @@protoc_insertion_point(field_release:newsfeed.proto.req_envelope.topic_req)
+  clear_has_topic_req();
+  ::newsfeed::proto::topic_request* temp = topic_req_;
+  topic_req_ = NULL;
+  return temp;
+}
+void req_envelope::set_allocated_topic_req(::newsfeed::proto::topic_request* topic_req) {
+  delete topic_req_;
+  topic_req_ = topic_req;
+  if (topic_req) {
+    set_has_topic_req();
+  } else {
+    clear_has_topic_req();
+  }
+  // @@protoc_insertion_point(field_set_allocated:newsfeed.proto.req_envelope.topic_req)
+}
+
+// optional .newsfeed.proto.topic_response topic_resp = 5;
+bool req_envelope::has_topic_resp() const {
+  return (_has_bits_[0] & 0x00000008u) != 0;
+}
 void req_envelope::set_has_topic_resp() {
   _has_bits_[0] |= 0x00000008u;
 }
-void req_envelope::clear_has_topic_resp() {
-  _has_bits_[0] &= ~0x00000008u;
+void req_envelope::clear_has_topic_resp() {
+  _has_bits_[0] &= ~0x00000008u;
+}
+void req_envelope::clear_topic_resp() {
+  if (topic_resp_ != NULL) topic_resp_->::newsfeed::proto::topic_response::Clear();
+  clear_has_topic_resp();
+}
+const ::newsfeed::proto::topic_response& req_envelope::topic_resp() const {
+  const ::newsfeed::proto::topic_response* p = topic_resp_;
+  // @@protoc_insertion_point(field_get:newsfeed.proto.req_envelope.topic_resp)
+  return p != NULL ? *p : *reinterpret_cast<const ::newsfeed::proto::topic_response*>(
+      &::newsfeed::proto::_topic_response_default_instance_);
+}
+::newsfeed::proto::topic_response* req_envelope::mutable_topic_resp() {
+  set_has_topic_resp();
+  if (topic_resp_ == NULL) {
+    topic_resp_ = new ::newsfeed::proto::topic_response;
+  }
+  // @@protoc_insertion_point(field_mutable:newsfeed.proto.req_envelope.topic_resp)
+  return topic_resp_;
+}
+::newsfeed::proto::topic_response* req_envelope::release_topic_resp() {
+  // @@protoc_insertion_point(field_release:newsfeed.proto.req_envelope.topic_resp)
+  clear_has_topic_resp();
+  ::newsfeed::proto::topic_response* temp = topic_resp_;
+  topic_resp_ = NULL;
+  return temp;
+}
+void req_envelope::set_allocated_topic_resp(::newsfeed::proto::topic_response* topic_resp) {
+  delete topic_resp_;
+  topic_resp_ = topic_resp;
+  if (topic_resp) {
+    set_has_topic_resp();
+  } else {
+    clear_has_topic_resp();
+  }
+  // @@protoc_insertion_point(field_set_allocated:newsfeed.proto.req_envelope.topic_resp)
+}
+
+// optional .newsfeed.proto.post_news_request post_req = 6;
+bool req_envelope::has_post_req() const {
+  return (_has_bits_[0] & 0x00000010u) != 0;
+}
+void req_envelope::set_has_post_req() {
+  _has_bits_[0] |= 0x00000010u;
+}
+void req_envelope::clear_has_post_req() {
+  _has_bits_[0] &= ~0x00000010u;
+}
+void req_envelope::clear_post_req() {
+  if (post_req_ != NULL) post_req_->::newsfeed::proto::post_news_request::Clear();
+  clear_has_post_req();
+}
+const ::newsfeed::proto::post_news_request& req_envelope::post_req() const {
+  const ::newsfeed::proto::post_news_request* p = post_req_;
+  // @@protoc_insertion_point(field_get:newsfeed.proto.req_envelope.post_req)
+  return p != NULL ? *p : *reinterpret_cast<const ::newsfeed::proto::post_news_request*>(
+      &::newsfeed::proto::_post_news_request_default_instance_);
+}
+::newsfeed::proto::post_news_request* req_envelope::mutable_post_req() {
+  set_has_post_req();
+  if (post_req_ == NULL) {
+    post_req_ = new ::newsfeed::proto::post_news_request;
+  }
+  // @@protoc_insertion_point(field_mutable:newsfeed.proto.req_envelope.post_req)
+  return post_req_;
+}
+::newsfeed::proto::post_news_request* req_envelope::release_post_req() {
+  // @@protoc_insertion_point(field_release:newsfeed.proto.req_envelope.post_req)
+  clear_has_post_req();
+  ::newsfeed::proto::post_news_request* temp = post_req_;
+  post_req_ = NULL;
+  return temp;
+}
+void req_envelope::set_allocated_post_req(::newsfeed::proto::post_news_request* post_req) {
+  delete post_req_;
+  post_req_ = post_req;
+  if (post_req) {
+    set_has_post_req();
+  } else {
+    clear_has_post_req();
+  }
+  // @@protoc_insertion_point(field_set_allocated:newsfeed.proto.req_envelope.post_req)
+}
+
+// optional .newsfeed.proto.post_news_response post_resp = 7;
+bool req_envelope::has_post_resp() const {
+  return (_has_bits_[0] & 0x00000020u) != 0;
+}
+void req_envelope::set_has_post_resp() {
+  _has_bits_[0] |= 0x00000020u;
+}
+void req_envelope::clear_has_post_resp() {
+  _has_bits_[0] &= ~0x00000020u;
+}
+void req_envelope::clear_post_resp() {
+  if (post_resp_ != NULL) post_resp_->::newsfeed::proto::post_news_response::Clear();
+  clear_has_post_resp();
+}
+const ::newsfeed::proto::post_news_response& req_envelope::post_resp() const {
+  const ::newsfeed::proto::post_news_response* p = post_resp_;
+  // @@protoc_insertion_point(field_get:newsfeed.proto.req_envelope.post_resp)
+  return p != NULL ? *p : *reinterpret_cast<const ::newsfeed::proto::post_news_response*>(
+      &::newsfeed::proto::_post_news_response_default_instance_);
+}
+::newsfeed::proto::post_news_response* req_envelope::mutable_post_resp() {
+  set_has_post_resp();
+  if (post_resp_ == NULL) {
+    post_resp_ = new ::newsfeed::proto::post_news_response;
+  }
+  // @@protoc_insertion_point(field_mutable:newsfeed.proto.req_envelope.post_resp)
+  return post_resp_;
+}
+::newsfeed::proto::post_news_response* req_envelope::release_post_resp() {
+  // @@protoc_insertion_point(field_release:newsfeed.proto.req_envelope.post_resp)
+  clear_has_post_resp();
+  ::newsfeed::proto::post_news_response* temp = post_resp_;
+  post_resp_ = NULL;
+  return temp;
+}
+void req_envelope::set_allocated_post_resp(::newsfeed::proto::post_news_response* post_resp) {
+  delete post_resp_;
+  post_resp_ = post_resp;
+  if (post_resp) {
+    set_has_post_resp();
+  } else {
+    clear_has_post_resp();
+  }
+  // @@protoc_insertion_point(field_set_allocated:newsfeed.proto.req_envelope.post_resp)
+}
+
+// optional .newsfeed.proto.news news_data = 8;
+bool req_envelope::has_news_data() const {
+  return (_has_bits_[0] & 0x00000040u) != 0;
+}
+void req_envelope::set_has_news_data() {
+  _has_bits_[0] |= 0x00000040u;
+}
+void req_envelope::clear_has_news_data() {
+  _has_bits_[0] &= ~0x00000040u;
+}
+void req_envelope::clear_news_data() {
+  if (news_data_ != NULL) news_data_->::newsfeed::proto::news::Clear();
+  clear_has_news_data();
+}
+const ::newsfeed::proto::news& req_envelope::news_data() const {
+  const ::newsfeed::proto::news* p = news_data_;
+  // @@protoc_insertion_point(field_get:newsfeed.proto.req_envelope.news_data)
+  return p != NULL ? *p : *reinterpret_cast<const ::newsfeed::proto::news*>(
+      &::newsfeed::proto::_news_default_instance_);
+}
+::newsfeed::proto::news* req_envelope::mutable_news_data() {
+  set_has_news_data();
+  if (news_data_ == NULL) {
+    news_data_ = new ::newsfeed::proto::news;
+  }
+  // @@protoc_insertion_point(field_mutable:newsfeed.proto.req_envelope.news_data)
+  return news_data_;
+}
+::newsfeed::proto::news* req_envelope::release_news_data() {
+  // @@protoc_insertion_point(field_release:newsfeed.proto.req_envelope.news_data)
+  clear_has_news_data();
+  ::newsfeed::proto::news* temp = news_data_;
+  news_data_ = NULL;
+  return temp;
+}
+void req_envelope::set_allocated_news_data(::newsfeed::proto::news* news_data) {
+  delete news_data_;
+  news_data_ = news_data;
+  if (news_data) {
+    set_has_news_data();
+  } else {
+    clear_has_news_data();
+  }
+  // @@protoc_insertion_point(field_set_allocated:newsfeed.proto.req_envelope.news_data)
+}
+
+// optional .newsfeed.proto.news_batch news_batch_data = 9;
+bool req_envelope::has_news_batch_data() const {
+  return (_has_bits_[0] & 0x00000080u) != 0;
+}
+void req_envelope::set_has_news_batch_data() {
+  _has_bits_[0] |= 0x00000080u;
+}
+void req_envelope::clear_has_news_batch_data() {
+  _has_bits_[0] &= ~0x00000080u;
+}
+void req_envelope::clear_news_batch_data() {
+  if (news_batch_data_ != NULL) news_batch_data_->::newsfeed::proto::news_batch::Clear();
+  clear_has_news_batch_data();
+}
+const ::newsfeed::proto::news_batch& req_envelope::news_batch_data() const {
+  const ::newsfeed::proto::news_batch* p = news_batch_data_;
+  // @@protoc_insertion_point(field_get:newsfeed.proto.req_envelope.news_batch_data)
+  return p != NULL ? *p : *reinterpret_cast<const ::newsfeed::proto::news_batch*>(
+      &::newsfeed::proto::_news_batch_default_instance_);
+}
+::newsfeed::proto::news_batch* req_envelope::mutable_news_batch_data() {
+  set_has_news_batch_data();
+  if (news_batch_data_ == NULL) {
+    news_batch_data_ = new ::newsfeed::proto::news_batch;
+  }
+  // @@protoc_insertion_point(field_mutable:newsfeed.proto.req_envelope.news_batch_data)
+  return news_batch_data_;
+}
+::newsfeed::proto::news_batch* req_envelope::release_news_batch_data() {
+  // @@protoc_insertion_point(field_release:newsfeed.proto.req_envelope.news_batch_data)
+  clear_has_news_batch_data();
+  ::newsfeed::proto::news_batch* temp = news_batch_data_;
+  news_batch_data_ = NULL;
+  return temp;
+}
+void req_envelope::set_allocated_news_batch_data(::newsfeed::proto::news_batch* news_batch_data) {
+  delete news_batch_data_;
+  news_batch_data_ = news_batch_data;
+  if (news_batch_data) {
+    set_has_news_batch_data();
+  } else {
+    clear_has_news_batch_data();
+  }
+  // @@protoc_insertion_point(field_set_allocated:newsfeed.proto.req_envelope.news_batch_data)
+}
+
+#endif  // PROTOBUF_INLINE_NOT_IN_HEADERS
+
+// ===================================================================
+
+#if !defined(_MSC_VER) || _MSC_VER >= 1900
+const int peer_news::kTopicFieldNumber;
+const int peer_news::kSortKeyFieldNumber;
+const int peer_news::kDataFieldNumber;
+#endif  // !defined(_MSC_VER) || _MSC_VER >= 1900
+
+peer_news::peer_news()
+  : ::google::protobuf::Message(), _internal_metadata_(NULL) {
+  if (GOOGLE_PREDICT_TRUE(this != internal_default_instance())) {
+    protobuf_newsfeed_5fmessages_2eproto::InitDefaults();
+  }
+  SharedCtor();
+  // @@protoc_insertion_point(constructor:newsfeed.proto.peer_news)
+}
+peer_news::peer_news(const peer_news& from)
+  : ::google::protobuf::Message(),
+      _internal_metadata_(NULL),
+      _has_bits_(from._has_bits_),
+      _cached_size_(0) {
+  _internal_metadata_.MergeFrom(from._internal_metadata_);
+  topic_.UnsafeSetDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+  if (from.has_topic()) {
+    topic_.AssignWithDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), from.topic_);
+  }
+  sort_key_.UnsafeSetDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+  if (from.has_sort_key()) {
+    sort_key_.AssignWithDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), from.sort_key_);
+  }
+  data_.UnsafeSetDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+  if (from.has_data()) {
+    data_.AssignWithDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), from.data_);
+  }
+  // @@protoc_insertion_point(copy_constructor:newsfeed.proto.peer_news)
+}
+
+void peer_news::SharedCtor() {
+  _cached_size_ = 0;
+  topic_.UnsafeSetDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+  sort_key_.UnsafeSetDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+  data_.UnsafeSetDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+}
+
+peer_news::~peer_news() {
+  // @@protoc_insertion_point(destructor:newsfeed.proto.peer_news)
+  SharedDtor();
+}
+
+void peer_news::SharedDtor() {
+  topic_.DestroyNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+  sort_key_.DestroyNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+  data_.DestroyNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+}
+
+void peer_news::SetCachedSize(int size) const {
+  GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
+  _cached_size_ = size;
+  GOOGLE_SAFE_CONCURRENT_WRITES_END();
+}
+const ::google::protobuf::Descriptor* peer_news::descriptor() {
+  protobuf_newsfeed_5fmessages_2eproto::protobuf_AssignDescriptorsOnce();
+  return protobuf_newsfeed_5fmessages_2eproto::file_level_metadata[kIndexInFileMessages].descriptor;
+}
+
+const peer_news& peer_news::default_instance() {
+  protobuf_newsfeed_5fmessages_2eproto::InitDefaults();
+  return *internal_default_instance();
+}
+
+peer_news* peer_news::New(::google::protobuf::Arena* arena) const {
+  peer_news* n = new peer_news;
+  if (arena != NULL) {
+    arena->Own(n);
+  }
+  return n;
+}
+
+void peer_news::Clear() {
+// @@protoc_insertion_point(message_clear_start:newsfeed.proto.peer_news)
+  ::google::protobuf::uint32 cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  cached_has_bits = _has_bits_[0];
+  if (cached_has_bits & 7u) {
+    if (cached_has_bits & 0x00000001u) {
+      GOOGLE_DCHECK(!topic_.IsDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited()));
+      (*topic_.UnsafeRawStringPointer())->clear();
+    }
+    if (cached_has_bits & 0x00000002u) {
+      GOOGLE_DCHECK(!sort_key_.IsDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited()));
+      (*sort_key_.UnsafeRawStringPointer())->clear();
+    }
+    if (cached_has_bits & 0x00000004u) {
+      GOOGLE_DCHECK(!data_.IsDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited()));
+      (*data_.UnsafeRawStringPointer())->clear();
+    }
+  }
+  _has_bits_.Clear();
+  _internal_metadata_.Clear();
+}
+
+bool peer_news::MergePartialFromCodedStream(
+    ::google::protobuf::io::CodedInputStream* input) {
+#define DO_(EXPRESSION) if (!GOOGLE_PREDICT_TRUE(EXPRESSION)) goto failure
+  ::google::protobuf::uint32 tag;
+  // @@protoc_insertion_point(parse_start:newsfeed.proto.peer_news)
+  for (;;) {
+    ::std::pair< ::google::protobuf::uint32, bool> p = input->ReadTagWithCutoffNoLastTag(127u);
+    tag = p.first;
+    if (!p.second) goto handle_unusual;
+    switch (::google::protobuf::internal::WireFormatLite::GetTagFieldNumber(tag)) {
+      // required string topic = 1;
+      case 1: {
+        if (static_cast< ::google::protobuf::uint8>(tag) ==
+            static_cast< ::google::protobuf::uint8>(10u /* 10 & 0xFF */)) {
+          DO_(::google::protobuf::internal::WireFormatLite::ReadString(
+                input, this->mutable_topic()));
+          ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
+            this->topic().data(), static_cast<int>(this->topic().length()),
+            ::google::protobuf::internal::WireFormat::PARSE,
+            "newsfeed.proto.peer_news.topic");
+        } else {
+          goto handle_unusual;
+        }
+        break;
+      }
+
+      // required bytes sort_key = 2;
+      case 2: {
+        if (static_cast< ::google::protobuf::uint8>(tag) ==
+            static_cast< ::google::protobuf::uint8>(18u /* 18 & 0xFF */)) {
+          DO_(::google::protobuf::internal::WireFormatLite::ReadBytes(
+                input, this->mutable_sort_key()));
+        } else {
+          goto handle_unusual;
+        }
+        break;
+      }
+
+      // required string data = 3;
+      case 3: {
+        if (static_cast< ::google::protobuf::uint8>(tag) ==
+            static_cast< ::google::protobuf::uint8>(26u /* 26 & 0xFF */)) {
+          DO_(::google::protobuf::internal::WireFormatLite::ReadString(
+                input, this->mutable_data()));
+          ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
+            this->data().data(), static_cast<int>(this->data().length()),
+            ::google::protobuf::internal::WireFormat::PARSE,
+            "newsfeed.proto.peer_news.data");
+        } else {
+          goto handle_unusual;
+        }
+        break;
+      }
+
+      default: {
+      handle_unusual:
+        if (tag == 0) {
+          goto success;
+        }
+        DO_(::google::protobuf::internal::WireFormat::SkipField(
+              input, tag, _internal_metadata_.mutable_unknown_fields()));
+        break;
+      }
+    }
+  }
+success:
+  // @@protoc_insertion_point(parse_success:newsfeed.proto.peer_news)
+  return true;
+failure:
+  // @@protoc_insertion_point(parse_failure:newsfeed.proto.peer_news)
+  return false;
+#undef DO_
+}
+
+void peer_news::SerializeWithCachedSizes(
+    ::google::protobuf::io::CodedOutputStream* output) const {
+  // @@protoc_insertion_point(serialize_start:newsfeed.proto.peer_news)
+  ::google::protobuf::uint32 cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  cached_has_bits = _has_bits_[0];
+  // required string topic = 1;
+  if (cached_has_bits & 0x00000001u) {
+    ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
+      this->topic().data(), static_cast<int>(this->topic().length()),
+      ::google::protobuf::internal::WireFormat::SERIALIZE,
+      "newsfeed.proto.peer_news.topic");
+    ::google::protobuf::internal::WireFormatLite::WriteStringMaybeAliased(
+      1, this->topic(), output);
+  }
+
+  // required bytes sort_key = 2;
+  if (cached_has_bits & 0x00000002u) {
+    ::google::protobuf::internal::WireFormatLite::WriteBytesMaybeAliased(
+      2, this->sort_key(), output);
+  }
+
+  // required string data = 3;
+  if (cached_has_bits & 0x00000004u) {
+    ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
+      this->data().data(), static_cast<int>(this->data().length()),
+      ::google::protobuf::internal::WireFormat::SERIALIZE,
+      "newsfeed.proto.peer_news.data");
+    ::google::protobuf::internal::WireFormatLite::WriteStringMaybeAliased(
+      3, this->data(), output);
+  }
+
+  if (_internal_metadata_.have_unknown_fields()) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFields(
+        _internal_metadata_.unknown_fields(), output);
+  }
+  // @@protoc_insertion_point(serialize_end:newsfeed.proto.peer_news)
+}
+
+::google::protobuf::uint8* peer_news::InternalSerializeWithCachedSizesToArray(
+    bool deterministic, ::google::protobuf::uint8* target) const {
+  (void)deterministic; // Unused
+  // @@protoc_insertion_point(serialize_to_array_start:newsfeed.proto.peer_news)
+  ::google::protobuf::uint32 cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  cached_has_bits = _has_bits_[0];
+  // required string topic = 1;
+  if (cached_has_bits & 0x00000001u) {
+    ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
+      this->topic().data(), static_cast<int>(this->topic().length()),
+      ::google::protobuf::internal::WireFormat::SERIALIZE,
+      "newsfeed.proto.peer_news.topic");
+    target =
+      ::google::protobuf::internal::WireFormatLite::WriteStringToArray(
+        1, this->topic(), target);
+  }
+
+  // required bytes sort_key = 2;
+  if (cached_has_bits & 0x00000002u) {
+    target =
+      ::google::protobuf::internal::WireFormatLite::WriteBytesToArray(
+        2, this->sort_key(), target);
+  }
+
+  // required string data = 3;
+  if (cached_has_bits & 0x00000004u) {
+    ::google::protobuf::internal::WireFormat::VerifyUTF8StringNamedField(
+      this->data().data(), static_cast<int>(this->data().length()),
+      ::google::protobuf::internal::WireFormat::SERIALIZE,
+      "newsfeed.proto.peer_news.data");
+    target =
+      ::google::protobuf::internal::WireFormatLite::WriteStringToArray(
+        3, this->data(), target);
+  }
+
+  if (_internal_metadata_.have_unknown_fields()) {
+    target = ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields(), target);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:newsfeed.proto.peer_news)
+  return target;
+}
+
+size_t peer_news::RequiredFieldsByteSizeFallback() const {
+// @@protoc_insertion_point(required_fields_byte_size_fallback_start:newsfeed.proto.peer_news)
+  size_t total_size = 0;
+
+  if (has_topic()) {
+    // required string topic = 1;
+    total_size += 1 +
+      ::google::protobuf::internal::WireFormatLite::StringSize(
+        this->topic());
+  }
+
+  if (has_sort_key()) {
+    // required bytes sort_key = 2;
+    total_size += 1 +
+      ::google::protobuf::internal::WireFormatLite::BytesSize(
+        this->sort_key());
+  }
+
+  if (has_data()) {
+    // required string data = 3;
+    total_size += 1 +
+      ::google::protobuf::internal::WireFormatLite::StringSize(
+        this->data());
+  }
+
+  return total_size;
 }
-void req_envelope::clear_topic_resp() {
-  if (topic_resp_ != NULL) topic_resp_->::newsfeed::proto::topic_response::Clear();
-  clear_has_topic_resp();
+size_t peer_news::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:newsfeed.proto.peer_news)
+  size_t total_size = 0;
+
+  if (_internal_metadata_.have_unknown_fields()) {
+    total_size +=
+      ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
+        _internal_metadata_.unknown_fields());
+  }
+  if (((_has_bits_[0] & 0x00000007) ^ 0x00000007) == 0) {  // All required fields are present.
+    // required string topic = 1;
+    total_size += 1 +
+      ::google::protobuf::internal::WireFormatLite::StringSize(
+        this->topic());
+
+    // required bytes sort_key = 2;
+    total_size += 1 +
+      ::google::protobuf::internal::WireFormatLite::BytesSize(
+        this->sort_key());
+
+    // required string data = 3;
+    total_size += 1 +
+      ::google::protobuf::internal::WireFormatLite::StringSize(
+        this->data());
+
+  } else {
+    total_size += RequiredFieldsByteSizeFallback();
+  }
+  int cached_size = ::google::protobuf::internal::ToCachedSize(total_size);
+  GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
+  _cached_size_ = cached_size;
+  GOOGLE_SAFE_CONCURRENT_WRITES_END();
+  return total_size;
 }
-const ::newsfeed::proto::topic_response& req_envelope::topic_resp() const {
-  const ::newsfeed::proto::topic_response* p = topic_resp_;
-  // @@protoc_insertion_point(field_get:newsfeed.proto.req_envelope.topic_resp)
-  return p != NULL ? *p : *reinterpret_cast<const ::newsfeed::proto::topic_response*>(
-      &::newsfeed::proto::_topic_response_default_instance_);
+
+void peer_news::MergeFrom(const ::google::protobuf::Message& from) {
+// @@protoc_insertion_point(generalized_merge_from_start:newsfeed.proto.peer_news)
+  GOOGLE_DCHECK_NE(&from, this);
+  const peer_news* source =
+      ::google::protobuf::internal::DynamicCastToGenerated<const peer_news>(
+          &from);
+  if (source == NULL) {
+  // @@protoc_insertion_point(generalized_merge_from_cast_fail:newsfeed.proto.peer_news)
+    ::google::protobuf::internal::ReflectionOps::Merge(from, this);
+  } else {
+  // @@protoc_insertion_point(generalized_merge_from_cast_success:newsfeed.proto.peer_news)
+    MergeFrom(*source);
+  }
 }
-::newsfeed::proto::topic_response* req_envelope::mutable_topic_resp() {
-  set_has_topic_resp();
-  if (topic_resp_ == NULL) {
-    topic_resp_ = new ::newsfeed::proto::topic_response;
+
+void peer_news::MergeFrom(const peer_news& from) {
+// @@protoc_insertion_point(class_specific_merge_from_start:newsfeed.proto.peer_news)
+  GOOGLE_DCHECK_NE(&from, this);
+  _internal_metadata_.MergeFrom(from._internal_metadata_);
+  ::google::protobuf::uint32 cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  cached_has_bits = from._has_bits_[0];
+  if (cached_has_bits & 7u) {
+    if (cached_has_bits & 0x00000001u) {
+      set_has_topic();
+      topic_.AssignWithDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), from.topic_);
+    }
+    if (cached_has_bits & 0x00000002u) {
+      set_has_sort_key();
+      sort_key_.AssignWithDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), from.sort_key_);
+    }
+    if (cached_has_bits & 0x00000004u) {
+      set_has_data();
+      data_.AssignWithDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), from.data_);
+    }
   }
-  // @@protoc_insertion_point(field_mutable:newsfeed.proto.req_envelope.topic_resp)
-  return topic_resp_;
 }
-::newsfeed::proto::topic_response* req_envelope::release_topic_resp() {
-  // @@protoc_insertion_point(field_release:newsfeed.proto.req_envelope.topic_resp)
-  clear_has_topic_resp();
-  ::newsfeed::proto::topic_response* temp = topic_resp_;
-  topic_resp_ = NULL;
-  return temp;
+
+void peer_news::CopyFrom(const ::google::protobuf::Message& from) {
+// @@protoc_insertion_point(generalized_copy_from_start:newsfeed.proto.peer_news)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
 }
-void req_envelope::set_allocated_topic_resp(::newsfeed::proto::topic_response* topic_resp) {
-  delete topic_resp_;
-  topic_resp_ = topic_resp;
-  if (topic_resp) {
-    set_has_topic_resp();
+
+void peer_news::CopyFrom(const peer_news& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:newsfeed.proto.peer_news)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool peer_news::IsInitialized() const {
+  if ((_has_bits_[0] & 0x00000007) != 0x00000007) return false;
+  return true;
+}
+
+void peer_news::Swap(peer_news* other) {
+  if (other == this) return;
+  InternalSwap(other);
+}
+void peer_news::InternalSwap(peer_news* other) {
+  using std::swap;
+  topic_.Swap(&other->topic_);
+  sort_key_.Swap(&other->sort_key_);
+  data_.Swap(&other->data_);
+  swap(_has_bits_[0], other->_has_bits_[0]);
+  _internal_metadata_.Swap(&other->_internal_metadata_);
+  swap(_cached_size_, other->_cached_size_);
+}
+
+::google::protobuf::Metadata peer_news::GetMetadata() const {
+  protobuf_newsfeed_5fmessages_2eproto::protobuf_AssignDescriptorsOnce();
+  return protobuf_newsfeed_5fmessages_2eproto::file_level_metadata[kIndexInFileMessages];
+}
+
+#if PROTOBUF_INLINE_NOT_IN_HEADERS
+// peer_news
+
+// required string topic = 1;
+bool peer_news::has_topic() const {
+  return (_has_bits_[0] & 0x00000001u) != 0;
+}
+void peer_news::set_has_topic() {
+  _has_bits_[0] |= 0x00000001u;
+}
+void peer_news::clear_has_topic() {
+  _has_bits_[0] &= ~0x00000001u;
+}
+void peer_news::clear_topic() {
+  topic_.ClearToEmptyNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+  clear_has_topic();
+}
+const ::std::string& peer_news::topic() const {
+  // @@protoc_insertion_point(field_get:newsfeed.proto.peer_news.topic)
+  return topic_.GetNoArena();
+}
+void peer_news::set_topic(const ::std::string& value) {
+  set_has_topic();
+  topic_.SetNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), value);
+  // @@protoc_insertion_point(field_set:newsfeed.proto.peer_news.topic)
+}
+#if LANG_CXX11
+void peer_news::set_topic(::std::string&& value) {
+  set_has_topic();
+  topic_.SetNoArena(
+    &::google::protobuf::internal::GetEmptyStringAlreadyInited(), ::std::move(value));
+  // @@protoc_insertion_point(field_set_rvalue:newsfeed.proto.peer_news.topic)
+}
+#endif
+void peer_news::set_topic(const char* value) {
+  GOOGLE_DCHECK(value != NULL);
+  set_has_topic();
+  topic_.SetNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), ::std::string(value));
+  // @@protoc_insertion_point(field_set_char:newsfeed.proto.peer_news.topic)
+}
+void peer_news::set_topic(const char* value, size_t size) {
+  set_has_topic();
+  topic_.SetNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(),
+      ::std::string(reinterpret_cast<const char*>(value), size));
+  // @@protoc_insertion_point(field_set_pointer:newsfeed.proto.peer_news.topic)
+}
+::std::string* peer_news::mutable_topic() {
+  set_has_topic();
+  // @@protoc_insertion_point(field_mutable:newsfeed.proto.peer_news.topic)
+  return topic_.MutableNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+}
+::std::string* peer_news::release_topic() {
+  // @@protoc_insertion_point(field_release:newsfeed.proto.peer_news.topic)
+  clear_has_topic();
+  return topic_.ReleaseNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+}
+void peer_news::set_allocated_topic(::std::string* topic) {
+  if (topic != NULL) {
+    set_has_topic();
   } else {
-    clear_has_topic_resp();
+    clear_has_topic();
   }
-  // @@protoc_insertion_point(field_set_allocated:newsfeed.proto.req_envelope.topic_resp)
+  topic_.SetAllocatedNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), topic);
+  // @@protoc_insertion_point(field_set_allocated:newsfeed.proto.peer_news.topic)
+}
+
+// required bytes sort_key = 2;
+bool peer_news::has_sort_key() const {
+  return (_has_bits_[0] & 0x00000002u) != 0;
+}
+void peer_news::set_has_sort_key() {
+  _has_bits_[0] |= 0x00000002u;
+}
+void peer_news::clear_has_sort_key() {
+  _has_bits_[0] &= ~0x00000002u;
+}
+void peer_news::clear_sort_key() {
+  sort_key_.ClearToEmptyNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+  clear_has_sort_key();
+}
+const ::std::string& peer_news::sort_key() const {
+  // @@protoc_insertion_point(field_get:newsfeed.proto.peer_news.sort_key)
+  return sort_key_.GetNoArena();
+}
+void peer_news::set_sort_key(const ::std::string& value) {
+  set_has_sort_key();
+  sort_key_.SetNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), value);
+  // @@protoc_insertion_point(field_set:newsfeed.proto.peer_news.sort_key)
+}
+#if LANG_CXX11
+void peer_news::set_sort_key(::std::string&& value) {
+  set_has_sort_key();
+  sort_key_.SetNoArena(
+    &::google::protobuf::internal::GetEmptyStringAlreadyInited(), ::std::move(value));
+  // @@protoc_insertion_point(field_set_rvalue:newsfeed.proto.peer_news.sort_key)
+}
+#endif
+void peer_news::set_sort_key(const char* value) {
+  GOOGLE_DCHECK(value != NULL);
+  set_has_sort_key();
+  sort_key_.SetNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), ::std::string(value));
+  // @@protoc_insertion_point(field_set_char:newsfeed.proto.peer_news.sort_key)
+}
+void peer_news::set_sort_key(const void* value, size_t size) {
+  set_has_sort_key();
+  sort_key_.SetNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(),
+      ::std::string(reinterpret_cast<const char*>(value), size));
+  // @@protoc_insertion_point(field_set_pointer:newsfeed.proto.peer_news.sort_key)
+}
+::std::string* peer_news::mutable_sort_key() {
+  set_has_sort_key();
+  // @@protoc_insertion_point(field_mutable:newsfeed.proto.peer_news.sort_key)
+  return sort_key_.MutableNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+}
+::std::string* peer_news::release_sort_key() {
+  // @@protoc_insertion_point(field_release:newsfeed.proto.peer_news.sort_key)
+  clear_has_sort_key();
+  return sort_key_.ReleaseNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+}
+void peer_news::set_allocated_sort_key(::std::string* sort_key) {
+  if (sort_key != NULL) {
+    set_has_sort_key();
+  } else {
+    clear_has_sort_key();
+  }
+  sort_key_.SetAllocatedNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), sort_key);
+  // @@protoc_insertion_point(field_set_allocated:newsfeed.proto.peer_news.sort_key)
+}
+
+// required string data = 3;
+bool peer_news::has_data() const {
+  return (_has_bits_[0] & 0x00000004u) != 0;
+}
+void peer_news::set_has_data() {
+  _has_bits_[0] |= 0x00000004u;
+}
+void peer_news::clear_has_data() {
+  _has_bits_[0] &= ~0x00000004u;
+}
+void peer_news::clear_data() {
+  data_.ClearToEmptyNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+  clear_has_data();
+}
+const ::std::string& peer_news::data() const {
+  // @@protoc_insertion_point(field_get:newsfeed.proto.peer_news.data)
+  return data_.GetNoArena();
+}
+void peer_news::set_data(const ::std::string& value) {
+  set_has_data();
+  data_.SetNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), value);
+  // @@protoc_insertion_point(field_set:newsfeed.proto.peer_news.data)
+}
+#if LANG_CXX11
+void peer_news::set_data(::std::string&& value) {
+  set_has_data();
+  data_.SetNoArena(
+    &::google::protobuf::internal::GetEmptyStringAlreadyInited(), ::std::move(value));
+  // @@protoc_insertion_point(field_set_rvalue:newsfeed.proto.peer_news.data)
+}
+#endif
+void peer_news::set_data(const char* value) {
+  GOOGLE_DCHECK(value != NULL);
+  set_has_data();
+  data_.SetNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), ::std::string(value));
+  // @@protoc_insertion_point(field_set_char:newsfeed.proto.peer_news.data)
+}
+void peer_news::set_data(const char* value, size_t size) {
+  set_has_data();
+  data_.SetNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(),
+      ::std::string(reinterpret_cast<const char*>(value), size));
+  // @@protoc_insertion_point(field_set_pointer:newsfeed.proto.peer_news.data)
+}
+::std::string* peer_news::mutable_data() {
+  set_has_data();
+  // @@protoc_insertion_point(field_mutable:newsfeed.proto.peer_news.data)
+  return data_.MutableNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+}
+::std::string* peer_news::release_data() {
+  // @@protoc_insertion_point(field_release:newsfeed.proto.peer_news.data)
+  clear_has_data();
+  return data_.ReleaseNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
+}
+void peer_news::set_allocated_data(::std::string* data) {
+  if (data != NULL) {
+    set_has_data();
+  } else {
+    clear_has_data();
+  }
+  data_.SetAllocatedNoArena(&::google::protobuf::internal::GetEmptyStringAlreadyInited(), data);
+  // @@protoc_insertion_point(field_set_allocated:newsfeed.proto.peer_news.data)
+}
+
+#endif  // PROTOBUF_INLINE_NOT_IN_HEADERS
+
+// ===================================================================
+
+#if !defined(_MSC_VER) || _MSC_VER >= 1900
+const int peer_ack::kInterestedFieldNumber;
+#endif  // !defined(_MSC_VER) || _MSC_VER >= 1900
+
+peer_ack::peer_ack()
+  : ::google::protobuf::Message(), _internal_metadata_(NULL) {
+  if (GOOGLE_PREDICT_TRUE(this != internal_default_instance())) {
+    protobuf_newsfeed_5fmessages_2eproto::InitDefaults();
+  }
+  SharedCtor();
+  // @@protoc_insertion_point(constructor:newsfeed.proto.peer_ack)
+}
+peer_ack::peer_ack(const peer_ack& from)
+  : ::google::protobuf::Message(),
+      _internal_metadata_(NULL),
+      _has_bits_(from._has_bits_),
+      _cached_size_(0) {
+  _internal_metadata_.MergeFrom(from._internal_metadata_);
+  interested_ = from.interested_;
+  // @@protoc_insertion_point(copy_constructor:newsfeed.proto.peer_ack)
 }
 
-// optional .newsfeed.proto.post_news_request post_req = 6;
-bool req_envelope::has_post_req() const {
-  return (_has_bits_[0] & 0x00000010u) != 0;
+void peer_ack::SharedCtor() {
+  _cached_size_ = 0;
+  interested_ = false;
 }
-void req_envelope::set_has_post_req() {
-  _has_bits_[0] |= 0x00000010u;
+
+peer_ack::~peer_ack() {
+  // @@protoc_insertion_point(destructor:newsfeed.proto.peer_ack)
+  SharedDtor();
 }
-void req_envelope::clear_has_post_req() {
-  _has_bits_[0] &= ~0x00000010u;
+
+void peer_ack::SharedDtor() {
 }
-void req_envelope::clear_post_req() {
-  if (post_req_ != NULL) post_req_->::newsfeed::proto::post_news_request::Clear();
-  clear_has_post_req();
+
+void peer_ack::SetCachedSize(int size) const {
+  GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
+  _cached_size_ = size;
+  GOOGLE_SAFE_CONCURRENT_WRITES_END();
 }
-const ::newsfeed::proto::post_news_request& req_envelope::post_req() const {
-  const ::newsfeed::proto::post_news_request* p = post_req_;
-  // @@protoc_insertion_point(field_get:newsfeed.proto.req_envelope.post_req)
-  return p != NULL ? *p : *reinterpret_cast<const ::newsfeed::proto::post_news_request*>(
-      &::newsfeed::proto::_post_news_request_default_instance_);
+const ::google::protobuf::Descriptor* peer_ack::descriptor() {
+  protobuf_newsfeed_5fmessages_2eproto::protobuf_AssignDescriptorsOnce();
+  return protobuf_newsfeed_5fmessages_2eproto::file_level_metadata[kIndexInFileMessages].descriptor;
 }
-::newsfeed::proto::post_news_request* req_envelope::mutable_post_req() {
-  set_has_post_req();
-  if (post_req_ == NULL) {
-    post_req_ = new ::newsfeed::proto::post_news_request;
+
+const peer_ack& peer_ack::default_instance() {
+  protobuf_newsfeed_5fmessages_2eproto::InitDefaults();
+  return *internal_default_instance();
+}
+
+peer_ack* peer_ack::New(::google::protobuf::Arena* arena) const {
+  peer_ack* n = new peer_ack;
+  if (arena != NULL) {
+    arena->Own(n);
   }
-  // @@protoc_insertion_point(field_mutable:newsfeed.proto.req_envelope.post_req)
-  return post_req_;
+  return n;
 }
-::newsfeed::proto::post_news_request* req_envelope::release_post_req() {
-  // @@protoc_insertion_point(field_release:newsfeed.proto.req_envelope.post_req)
-  clear_has_post_req();
-  ::newsfeed::proto::post_news_request* temp = post_req_;
-  post_req_ = NULL;
-  return temp;
+
+void peer_ack::Clear() {
+// @@protoc_insertion_point(message_clear_start:newsfeed.proto.peer_ack)
+  ::google::protobuf::uint32 cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  interested_ = false;
+  _has_bits_.Clear();
+  _internal_metadata_.Clear();
 }
-void req_envelope::set_allocated_post_req(::newsfeed::proto::post_news_request* post_req) {
-  delete post_req_;
-  post_req_ = post_req;
-  if (post_req) {
-    set_has_post_req();
-  } else {
-    clear_has_post_req();
+
+bool peer_ack::MergePartialFromCodedStream(
+    ::google::protobuf::io::CodedInputStream* input) {
+#define DO_(EXPRESSION) if (!GOOGLE_PREDICT_TRUE(EXPRESSION)) goto failure
+  ::google::protobuf::uint32 tag;
+  // @@protoc_insertion_point(parse_start:newsfeed.proto.peer_ack)
+  for (;;) {
+    ::std::pair< ::google::protobuf::uint32, bool> p = input->ReadTagWithCutoffNoLastTag(127u);
+    tag = p.first;
+    if (!p.second) goto handle_unusual;
+    switch (::google::protobuf::internal::WireFormatLite::GetTagFieldNumber(tag)) {
+      // required bool interested = 1;
+      case 1: {
+        if (static_cast< ::google::protobuf::uint8>(tag) ==
+            static_cast< ::google::protobuf::uint8>(8u /* 8 & 0xFF */)) {
+          set_has_interested();
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   bool, ::google::protobuf::internal::WireFormatLite::TYPE_BOOL>(
+                 input, &interested_)));
+        } else {
+          goto handle_unusual;
+        }
+        break;
+      }
+
+      default: {
+      handle_unusual:
+        if (tag == 0) {
+          goto success;
+        }
+        DO_(::google::protobuf::internal::WireFormat::SkipField(
+              input, tag, _internal_metadata_.mutable_unknown_fields()));
+        break;
+      }
+    }
   }
-  // @@protoc_insertion_point(field_set_allocated:newsfeed.proto.req_envelope.post_req)
+success:
+  // @@protoc_insertion_point(parse_success:newsfeed.proto.peer_ack)
+  return true;
+failure:
+  // @@protoc_insertion_point(parse_failure:newsfeed.proto.peer_ack)
+  return false;
+#undef DO_
 }
 
-// optional .newsfeed.proto.post_news_response post_resp = 7;
-bool req_envelope::has_post_resp() const {
-  return (_has_bits_[0] & 0x00000020u) != 0;
-}
-void req_envelope::set_has_post_resp() {
-  _has_bits_[0] |= 0x00000020u;
+void peer_ack::SerializeWithCachedSizes(
+    ::google::protobuf::io::CodedOutputStream* output) const {
+  // @@protoc_insertion_point(serialize_start:newsfeed.proto.peer_ack)
+  ::google::protobuf::uint32 cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  cached_has_bits = _has_bits_[0];
+  // required bool interested = 1;
+  if (cached_has_bits & 0x00000001u) {
+    ::google::protobuf::internal::WireFormatLite::WriteBool(1, this->interested(), output);
+  }
+
+  if (_internal_metadata_.have_unknown_fields()) {
+    ::google::protobuf::internal::WireFormat::SerializeUnknownFields(
+        _internal_metadata_.unknown_fields(), output);
+  }
+  // @@protoc_insertion_point(serialize_end:newsfeed.proto.peer_ack)
 }
-void req_envelope::clear_has_post_resp() {
-  _has_bits_[0] &= ~0x00000020u;
+
+::google::protobuf::uint8* peer_ack::InternalSerializeWithCachedSizesToArray(
+    bool deterministic, ::google::protobuf::uint8* target) const {
+  (void)deterministic; // Unused
+  // @@protoc_insertion_point(serialize_to_array_start:newsfeed.proto.peer_ack)
+  ::google::protobuf::uint32 cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  cached_has_bits = _has_bits_[0];
+  // required bool interested = 1;
+  if (cached_has_bits & 0x00000001u) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(1, this->interested(), target);
+  }
+
+  if (_internal_metadata_.have_unknown_fields()) {
+    target = ::google::protobuf::internal::WireFormat::SerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields(), target);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:newsfeed.proto.peer_ack)
+  return target;
 }
-void req_envelope::clear_post_resp() {
-  if (post_resp_ != NULL) post_resp_->::newsfeed::proto::post_news_response::Clear();
-  clear_has_post_resp();
+
+size_t peer_ack::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:newsfeed.proto.peer_ack)
+  size_t total_size = 0;
+
+  if (_internal_metadata_.have_unknown_fields()) {
+    total_size +=
+      ::google::protobuf::internal::WireFormat::ComputeUnknownFieldsSize(
+        _internal_metadata_.unknown_fields());
+  }
+  // required bool interested = 1;
+  if (has_interested()) {
+    total_size += 1 + 1;
+  }
+  int cached_size = ::google::protobuf::internal::ToCachedSize(total_size);
+  GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
+  _cached_size_ = cached_size;
+  GOOGLE_SAFE_CONCURRENT_WRITES_END();
+  return total_size;
 }
-const ::newsfeed::proto::post_news_response& req_envelope::post_resp() const {
-  const ::newsfeed::proto::post_news_response* p = post_resp_;
-  // @@protoc_insertion_point(field_get:newsfeed.proto.req_envelope.post_resp)
-  return p != NULL ? *p : *reinterpret_cast<const ::newsfeed::proto::post_news_response*>(
-      &::newsfeed::proto::_post_news_response_default_instance_);
+
+void peer_ack::MergeFrom(const ::google::protobuf::Message& from) {
+// @@protoc_insertion_point(generalized_merge_from_start:newsfeed.proto.peer_ack)
+  GOOGLE_DCHECK_NE(&from, this);
+  const peer_ack* source =
+      ::google::protobuf::internal::DynamicCastToGenerated<const peer_ack>(
+          &from);
+  if (source == NULL) {
+  // @@protoc_insertion_point(generalized_merge_from_cast_fail:newsfeed.proto.peer_ack)
+    ::google::protobuf::internal::ReflectionOps::Merge(from, this);
+  } else {
+  // @@protoc_insertion_point(generalized_merge_from_cast_success:newsfeed.proto.peer_ack)
+    MergeFrom(*source);
+  }
 }
-::newsfeed::proto::post_news_response* req_envelope::mutable_post_resp() {
-  set_has_post_resp();
-  if (post_resp_ == NULL) {
-    post_resp_ = new ::newsfeed::proto::post_news_response;
+
+void peer_ack::MergeFrom(const peer_ack& from) {
+// @@protoc_insertion_point(class_specific_merge_from_start:newsfeed.proto.peer_ack)
+  GOOGLE_DCHECK_NE(&from, this);
+  _internal_metadata_.MergeFrom(from._internal_metadata_);
+  ::google::protobuf::uint32 cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  if (from.has_interested()) {
+    set_interested(from.interested());
   }
-  // @@protoc_insertion_point(field_mutable:newsfeed.proto.req_envelope.post_resp)
-  return post_resp_;
 }
-::newsfeed::proto::post_news_response* req_envelope::release_post_resp() {
-  // @@protoc_insertion_point(field_release:newsfeed.proto.req_envelope.post_resp)
-  clear_has_post_resp();
-  ::newsfeed::proto::post_news_response* temp = post_resp_;
-  post_resp_ = NULL;
-  return temp;
+
+void peer_ack::CopyFrom(const ::google::protobuf::Message& from) {
+// @@protoc_insertion_point(generalized_copy_from_start:newsfeed.proto.peer_ack)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
 }
-void req_envelope::set_allocated_post_resp(::newsfeed::proto::post_news_response* post_resp) {
-  delete post_resp_;
-  post_resp_ = post_resp;
-  if (post_resp) {
-    set_has_post_resp();
-  } else {
-    clear_has_post_resp();
-  }
-  // @@protoc_insertion_point(field_set_allocated:newsfeed.proto.req_envelope.post_resp)
+
+void peer_ack::CopyFrom(const peer_ack& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:newsfeed.proto.peer_ack)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
 }
 
-// optional .newsfeed.proto.news news_data = 8;
-bool req_envelope::has_news_data() const {
-  return (_has_bits_[0] & 0x00000040u) != 0;
+bool peer_ack::IsInitialized() const {
+  if ((_has_bits_[0] & 0x00000001) != 0x00000001) return false;
+  return true;
 }
-void req_envelope::set_has_news_data() {
-  _has_bits_[0] |= 0x00000040u;
+
+void peer_ack::Swap(peer_ack* other) {
+  if (other == this) return;
+  InternalSwap(other);
 }
-void req_envelope::clear_has_news_data() {
-  _has_bits_[0] &= ~0x00000040u;
+void peer_ack::InternalSwap(peer_ack* other) {
+  using std::swap;
+  swap(interested_, other->interested_);
+  swap(_has_bits_[0], other->_has_bits_[0]);
+  _internal_metadata_.Swap(&other->_internal_metadata_);
+  swap(_cached_size_, other->_cached_size_);
 }
-void req_envelope::clear_news_data() {
-  if (news_data_ != NULL) news_data_->::newsfeed::proto::news::Clear();
-  clear_has_news_data();
+
+::google::protobuf::Metadata peer_ack::GetMetadata() const {
+  protobuf_newsfeed_5fmessages_2eproto::protobuf_AssignDescriptorsOnce();
+  return protobuf_newsfeed_5fmessages_2eproto::file_level_metadata[kIndexInFileMessages];
 }
-const ::newsfeed::proto::news& req_envelope::news_data() const {
-  const ::newsfeed::proto::news* p = news_data_;
-  // @@protoc_insertion_point(field_get:newsfeed.proto.req_envelope.news_data)
-  return p != NULL ? *p : *reinterpret_cast<const ::newsfeed::proto::news*>(
-      &::newsfeed::proto::_news_default_instance_);
+
+#if PROTOBUF_INLINE_NOT_IN_HEADERS
+// peer_ack
+
+// required bool interested = 1;
+bool peer_ack::has_interested() const {
+  return (_has_bits_[0] & 0x00000001u) != 0;
 }
-::newsfeed::proto::news* req_envelope::mutable_news_data() {
-  set_has_news_data();
-  if (news_data_ == NULL) {
-    news_data_ = new ::newsfeed::proto::news;
-  }
-  // @@protoc_insertion_point(field_mutable:newsfeed.proto.req_envelope.news_data)
-  return news_data_;
+void peer_ack::set_has_interested() {
+  _has_bits_[0] |= 0x00000001u;
 }
-::newsfeed::proto::news* req_envelope::release_news_data() {
-  // @@protoc_insertion_point(field_release:newsfeed.proto.req_envelope.news_data)
-  clear_has_news_data();
-  ::newsfeed::proto::news* temp = news_data_;
-  news_data_ = NULL;
-  return temp;
+void peer_ack::clear_has_interested() {
+  _has_bits_[0] &= ~0x00000001u;
 }
-void req_envelope::set_allocated_news_data(::newsfeed::proto::news* news_data) {
-  delete news_data_;
-  news_data_ = news_data;
-  if (news_data) {
-    set_has_news_data();
-  } else {
-    clear_has_news_data();
-  }
-  // @@protoc_insertion_point(field_set_allocated:newsfeed.proto.req_envelope.news_data)
+void peer_ack::clear_interested() {
+  interested_ = false;
+  clear_has_interested();
+}
+bool peer_ack::interested() const {
+  // @@protoc_insertion_point(field_get:newsfeed.proto.peer_ack.interested)
+  return interested_;
+}
+void peer_ack::set_interested(bool value) {
+  set_has_interested();
+  interested_ = value;
+  // @@protoc_insertion_point(field_set:newsfeed.proto.peer_ack.interested)
 }
 
 #endif  // PROTOBUF_INLINE_NOT_IN_HEADERS
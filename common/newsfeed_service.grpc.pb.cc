@@ -54,6 +54,44 @@ Newsfeed::Service::~Service() {
   return ::grpc::Status(::grpc::StatusCode::UNIMPLEMENTED, "");
 }
 
+static const char* NewsfeedPeering_method_names[] = {
+  "/newsfeed.proto.NewsfeedPeering/Forward",
+};
+
+std::unique_ptr< NewsfeedPeering::Stub> NewsfeedPeering::NewStub(const std::shared_ptr< ::grpc::ChannelInterface>& channel, const ::grpc::StubOptions& options) {
+  std::unique_ptr< NewsfeedPeering::Stub> stub(new NewsfeedPeering::Stub(channel));
+  return stub;
+}
+
+NewsfeedPeering::Stub::Stub(const std::shared_ptr< ::grpc::ChannelInterface>& channel)
+  : channel_(channel), rpcmethod_Forward_(NewsfeedPeering_method_names[0], ::grpc::RpcMethod::NORMAL_RPC, channel)
+  {}
+
+::grpc::Status NewsfeedPeering::Stub::Forward(::grpc::ClientContext* context, const ::newsfeed::proto::peer_news& request, ::newsfeed::proto::peer_ack* response) {
+  return ::grpc::BlockingUnaryCall(channel_.get(), rpcmethod_Forward_, context, request, response);
+}
+
+::grpc::ClientAsyncResponseReader< ::newsfeed::proto::peer_ack>* NewsfeedPeering::Stub::AsyncForwardRaw(::grpc::ClientContext* context, const ::newsfeed::proto::peer_news& request, ::grpc::CompletionQueue* cq) {
+  return ::grpc::ClientAsyncResponseReader< ::newsfeed::proto::peer_ack>::Create(channel_.get(), cq, rpcmethod_Forward_, context, request);
+}
+
+NewsfeedPeering::Service::Service() {
+  AddMethod(new ::grpc::RpcServiceMethod(
+      NewsfeedPeering_method_names[0],
+      ::grpc::RpcMethod::NORMAL_RPC,
+      new ::grpc::RpcMethodHandler< NewsfeedPeering::Service, ::newsfeed::proto::peer_news, ::newsfeed::proto::peer_ack>(
+          std::mem_fn(&NewsfeedPeering::Service::Forward), this)));
+}
+
+NewsfeedPeering::Service::~Service() {
+}
+
+::grpc::Status NewsfeedPeering::Service::Forward(::grpc::ServerContext* context, const ::newsfeed::proto::peer_news* request, ::newsfeed::proto::peer_ack* response) {
+  (void) context;
+  (void) request;
+  (void) response;
+  return ::grpc::Status(::grpc::StatusCode::UNIMPLEMENTED, "");
+}
 
 }  // namespace newsfeed
 }  // namespace proto
@@ -191,6 +191,22 @@ namespace newsfeed
                     m_callbackOnNews(response.news_data().data());
                     break;
 
+                case proto::req_envelope_msg_type_news_batch_t:
+
+                    if ((uncompliantPayload = !response.has_news_batch_data()))
+                        break;
+
+                    if (response.news_batch_data().missed() > 0)
+                    {
+                        InterleavedConsole::Get().EnqueueLine("warning! %lld news have been missed, because this client did not keep up",
+                                                              static_cast<long long> (response.news_batch_data().missed()));
+                    }
+
+                    for (auto &item : response.news_batch_data().items())
+                        m_callbackOnNews(item.data());
+
+                    break;
+
                 case proto::req_envelope_msg_type_register_request_t:
                 case proto::req_envelope_msg_type_topic_request_t:
                 case proto::req_envelope_msg_type_post_news_request_t:
@@ -1,4 +1,5 @@
 #include "DDBAccess.h"
+#include "NewsCache.h"
 #include "common.h"
 #include "configuration.h"
 #include <aws/core/Aws.h>
@@ -12,25 +13,36 @@
 #include <aws/dynamodb/model/DeleteItemResult.h>
 #include <aws/dynamodb/model/QueryRequest.h>
 #include <aws/dynamodb/model/QueryResult.h>
+#include <aws/dynamodb/model/ScanRequest.h>
+#include <aws/dynamodb/model/ScanResult.h>
 #include <aws/dynamodb/model/BatchWriteItemRequest.h>
 #include <aws/dynamodb/model/BatchWriteItemResult.h>
 #include <aws/core/utils/Outcome.h>
 #include <sstream>
+#include <unordered_set>
 #include <iostream>
 #include <functional>
 #include <thread>
 #include <chrono>
 #include <array>
+#include <future>
+#include <limits>
+#include <algorithm>
+#include <queue>
+#include <atomic>
 
 #define DDB_TABNAME_TOPIC_BY_USER "newsfeed_topic_by_user"
 #define DDB_TABATTR_TBU_PK_USER   "user_id"
 #define DDB_TABATTR_TBU_TOPIC     "topic"
 #define DDB_TABATTR_TBU_LFTIME    "last_feed_time"
+#define DDB_TABATTR_TBU_LFKEY     "last_feed_key"
 
 #define DDB_TABNAME_NEWS_BY_TOPIC "newsfeed_news_by_topic"
 #define DDB_TABATTR_NBT_PK_TOPIC  "topic"
 #define DDB_TABATTR_NBT_SK_BINTB  "bin_time_based_sk"
 #define DDB_TABATTR_NBT_NEWS      "news"
+#define DDB_TABATTR_NBT_SHARDS    "shard_count"
+#define DDB_TABATTR_NBT_SHARDS_AT "shards_active_from"
 
 
 namespace newsfeed
@@ -83,58 +95,215 @@ namespace newsfeed
 
 
     /// <summary>
-    /// Makes a binary time-based sort key composed of (time) + (hash of user ID).
+    /// Copies a binary attribute into a string.
     /// </summary>
-    /// <param name="epochTime">The time (seconds since epoch).</param>
-    /// <param name="userId">The user ID. Its hash is appended to the
-    /// end of the sort key, unless the ID is an empty string.</param>
-    /// <returns>A buffer with the generated sort key.</returns>
-    static Aws::Utils::ByteBuffer MakeBinTimeBasedSortKey(time_t epochTime, const string &userId = "")
+    /// <param name="buffer">The buffer with the binary attribute.</param>
+    /// <returns>A string with the same bytes of the given buffer.</returns>
+    static string ToString(const Aws::Utils::ByteBuffer &buffer)
+    {
+        return string(reinterpret_cast<const char *> (buffer.GetUnderlyingData()), buffer.GetLength());
+    }
+
+
+    /// <summary>
+    /// Copies a string into a binary attribute.
+    /// </summary>
+    /// <param name="str">The string.</param>
+    /// <returns>A buffer with the same bytes of the given string.</returns>
+    static Aws::Utils::ByteBuffer ToByteBuffer(const string &str)
     {
-        Aws::Utils::ByteBuffer buffer(sizeof (time_t) + sizeof (size_t));
+        return Aws::Utils::ByteBuffer(reinterpret_cast<const unsigned char *> (str.data()), str.length());
+    }
 
-        auto nBitsToShift = static_cast<int> ((sizeof(time_t) - 1) * 8);
 
-        int idx(0);
-        while (nBitsToShift >= 0)
+    /// <summary>
+    /// Extracts the news from items retrieved from the table of news.
+    /// </summary>
+    /// <param name="topic">The topic of the news.</param>
+    /// <param name="newsItems">The items retrieved from the table.</param>
+    /// <param name="news">Will receive the news.</param>
+    static void ParseNewsItems(const string &topic,
+                               const Aws::Vector<AwsDdbItem> &newsItems,
+                               std::vector<NewsItem> &news)
+    {
+        news.reserve(news.size() + newsItems.size());
+
+        for (auto &entry : newsItems)
         {
-            buffer[idx++] = static_cast<unsigned char> ((epochTime >> nBitsToShift) & 0xFF);
-            nBitsToShift -= 8;
+            NewsItem newsItem;
+
+            auto iter = entry.find(DDB_TABATTR_NBT_SK_BINTB);
+
+            if (iter == entry.end())
+            {
+                std::ostringstream oss;
+                oss << "Could not find attribute " DDB_TABATTR_NBT_SK_BINTB
+                       " in item retrieved from table " DDB_TABNAME_NEWS_BY_TOPIC
+                       " for topic '" << topic << '\'';
+
+                throw AppException("Cannot recognize schema of news item!", oss.str());
+            }
+
+            newsItem.sortKey = ToString(iter->second.GetB());
+
+            iter = entry.find(DDB_TABATTR_NBT_NEWS);
+
+            if (iter == entry.end())
+            {
+                std::ostringstream oss;
+                oss << "Could not find attribute " DDB_TABATTR_NBT_NEWS
+                       " in item retrieved from table " DDB_TABNAME_NEWS_BY_TOPIC
+                       " for topic '" << topic << '\'';
+
+                throw AppException("Cannot recognize schema of news item!", oss.str());
+            }
+
+            newsItem.data = iter->second.GetS();
+
+            news.push_back(std::move(newsItem));
         }
 
-        size_t hashOfUserId(0);
+        if (!newsItems.empty())
+            NewsStore::ObserveNewsKey(news.back().sortKey);
+    }
+
+
+    /// <summary>
+    /// Makes a cursor in the legacy format of the sort keys, which is (time in seconds)
+    /// + (hash of user ID), the maximum hash here. It sorts after the legacy keys of the
+    /// news posted up to the given second, and before those posted later, as well as
+    /// before every key in the current format, whose time prefix is in microseconds.
+    /// </summary>
+    /// <param name="epochTime">The time (seconds since epoch).</param>
+    /// <returns>The cursor.</returns>
+    static string MakeLegacyNewsCursor(time_t epochTime)
+    {
+        unsigned char data[sizeof (int64_t) + sizeof (uint64_t)];
 
-        if (!userId.empty())
+        auto value = static_cast<uint64_t> (epochTime);
+
+        for (int idx = sizeof (int64_t) - 1; idx >= 0; --idx)
         {
-            std::hash<string> hash;
-            hashOfUserId = hash(userId);
+            data[idx] = static_cast<unsigned char> (value & 0xFF);
+            value >>= 8;
         }
 
-        memcpy(buffer.GetUnderlyingData() + idx,
-               &hashOfUserId,
-               sizeof (size_t));
+        std::fill(data + sizeof (int64_t), data + sizeof data, 0xFF);
 
-        return std::move(buffer);
+        return string(reinterpret_cast<const char *> (data), sizeof data);
     }
 
 
     /// <summary>
-    /// Gets the time (prefix) from the provided sort key.
+    /// Extracts the state of a user from the item retrieved from the table of users.
     /// </summary>
-    /// <param name="key">The sort key whose time prefix will be extracted.</param>
-    /// <returns>The time (from key prefix) as seconds since epoch.</returns>
-    static time_t GetTimeFromSortKey(const Aws::Utils::ByteBuffer &key)
+    /// <param name="userId">The user ID.</param>
+    /// <param name="userItem">The item retrieved from the table.</param>
+    /// <param name="state">Will receive the state of the user.</param>
+    static void ParseUserItem(const string &userId,
+                              const AwsDdbItem &userItem,
+                              UserState &state)
     {
-        time_t value(0);
-        
-        for (int idx = 0; idx < sizeof (time_t); ++idx)
+        auto iter = userItem.find(DDB_TABATTR_TBU_TOPIC);
+
+        if (iter == userItem.end())
+        {
+            std::ostringstream oss;
+            oss << "Could not find attribute " DDB_TABATTR_TBU_TOPIC
+                   " in item retrieved from table " DDB_TABNAME_TOPIC_BY_USER
+                   " for user '" << userId << '\'';
+
+            throw AppException("Cannot recognize schema of user data item!", oss.str());
+        }
+
+        state.topic = iter->second.GetS();
+
+        // the exact key of the last news fed, or else the time of the
+        // last feed, from before the key was kept (legacy format):
+
+        iter = userItem.find(DDB_TABATTR_TBU_LFKEY);
+
+        if (iter != userItem.end() && iter->second.GetB().GetLength() > 0)
+        {
+            state.lastFeedKey = ToString(iter->second.GetB());
+            return;
+        }
+
+        iter = userItem.find(DDB_TABATTR_TBU_LFTIME);
+
+        if (iter == userItem.end())
         {
-            auto byte = key[idx];
-            value <<= 8;
-            value += byte;
+            std::ostringstream oss;
+            oss << "Could not find attribute " DDB_TABATTR_TBU_LFTIME
+                   " in item retrieved from table " DDB_TABNAME_TOPIC_BY_USER
+                   " for user '" << userId << '\'';
+
+            throw AppException("Cannot recognize schema of user data item!", oss.str());
         }
 
-        return value;
+        if (!iter->second.GetN().empty())
+            state.lastFeedKey = MakeLegacyNewsCursor(strtoll(iter->second.GetN().c_str(), nullptr, 10));
+        else
+            state.lastFeedKey.clear();
+    }
+
+
+    /// <summary>
+    /// Tells whether reads from the table of users are strongly consistent.
+    /// </summary>
+    static bool IsUserReadConsistent()
+    {
+        static const bool consistent = (Configuration::Get().settings.dbUserReadConsistency != "eventual");
+        return consistent;
+    }
+
+
+    /// <summary>
+    /// Tells whether reads from the table of news are strongly consistent.
+    /// Eventually consistent reads cost half the capacity, but might not
+    /// see news written less than <see cref="eventualSettleSecs"/> ago.
+    /// </summary>
+    static bool IsNewsReadConsistent()
+    {
+        static const bool consistent = (Configuration::Get().settings.dbNewsReadConsistency != "eventual");
+        return consistent;
+    }
+
+
+    /// <summary>
+    /// Tells whether the last feed of the users is kept in memory and written behind,
+    /// once every interval, rather than at the end of every retrieval of news. Should
+    /// the process crash, the news delivered in the last interval are delivered again.
+    /// </summary>
+    static bool IsLastFeedWrittenBehind()
+    {
+        static const bool writtenBehind = (Configuration::Get().settings.dbFeedCheckpointSecs > 0);
+        return writtenBehind;
+    }
+
+    // how long before news written are surely seen by eventually consistent reads
+    static const time_t eventualSettleSecs(1);
+
+    // sort key of the item that keeps the count of shards of a topic, in the
+    // first shard, which sorts before any news, so the queries start after it
+    static const string shardMarkerKey(1, '\0');
+
+
+    /// <summary>
+    /// Makes a request to read the state of a user.
+    /// </summary>
+    /// <param name="userId">The user ID.</param>
+    /// <returns>The request.</returns>
+    static GetItemRequest MakeUserStateGet(const string &userId)
+    {
+        GetItemRequest getRequest;
+        getRequest
+            .WithTableName(DDB_TABNAME_TOPIC_BY_USER)
+            .AddKey(DDB_TABATTR_TBU_PK_USER, AttributeValue(userId))
+            .WithProjectionExpression(DDB_TABATTR_TBU_TOPIC ", " DDB_TABATTR_TBU_LFTIME ", " DDB_TABATTR_TBU_LFKEY)
+            .WithConsistentRead(IsUserReadConsistent());
+
+        return getRequest;
     }
 
 
@@ -153,7 +322,27 @@ namespace newsfeed
     /// Initializes a new instance of the <see cref="DDBAccess"/> class.
     /// </summary>
     DDBAccess::DDBAccess()
+        : m_retryTimer(std::chrono::milliseconds(
+            std::max(Configuration::Get().settings.dbReqRetryIntervalMs / 10, 1U)
+          ))
+        , m_putBatcher(m_retryTimer, [this](std::vector<PendingNewsPut> &batch) { PutNewsBatch(batch); })
+        , m_checkpointUnits(0.0)
+        , m_lastCheckpointRefill(std::chrono::steady_clock::now())
+        , m_asyncOpsCount(0)
+        , m_readCapacityUsed(0.0)
+        , m_readCapacitySaved(0.0)
+        , m_readCapacityReported(0.0)
     {
+        const auto &settings = Configuration::Get().settings;
+
+        // writing the last feed in a user item (up to 1 KB) takes a write capacity unit:
+        m_checkpointUnitsPerSec = std::max(settings.dbUserTableWriteCapacity * settings.dbFeedCheckpointCapacityPct / 100.0, 1.0);
+        m_maxCheckpointUnits = std::max(m_checkpointUnitsPerSec, 25.0);
+
+        ScheduleReport();
+
+        if (IsLastFeedWrittenBehind())
+            ScheduleCheckpointFlush();
     }
 
 
@@ -221,657 +410,2431 @@ namespace newsfeed
 
 
     /// <summary>
-    /// Gets an item from a DynamoDB table.
+    /// Reports the retries and hedges of requests, the capacity consumed by reads,
+    /// the latency of posts and the hot topics, once in a while. Meanwhile, forgets
+    /// the shards of the topics no longer used.
     /// </summary>
-    /// <param name="actionLabel">The action label (to be used for error/trace report).</param>
-    /// <param name="conn">The database connection.</param>
-    /// <param name="request">The request to issue.</param>
-    /// <param name="item">Will receive the returned item.</param>
-    /// <returns>Whether an userItem has been found.</returns>
-    static bool GetItem(const char *actionLabel,
-                        DbConnection *conn,
-                        const GetItemRequest &request,
-                        AwsDdbItem &item)
+    void DDBAccess::ScheduleReport()
     {
-#   ifndef NDEBUG
-        std::clog << "DynamoDB - GET REQUEST: " << request.SerializePayload() << std::endl;
-#   endif
-        item.clear();
-
-        GetItemOutcome outcome;
+        m_retryTimer.Schedule(std::chrono::minutes(1), [this]()
+        {
+            m_retryPolicy.Report(std::clog);
+            m_hedgePolicy.Report(std::clog);
+            ReportReadCapacity(std::clog);
+            m_putBatcher.Report(std::clog);
+            m_topicShards.Report(std::clog);
+            m_topicShards.Prune();
+            ScheduleReport();
+        });
+    }
 
-        static const auto maxRetry = Configuration::Get().settings.dbReqMaxRetryCount;
 
-        for (uint32_t retryCount = 0; retryCount < maxRetry; ++retryCount)
+    /// <summary>
+    /// Writes the last feed of the users kept in memory once every second,
+    /// as many as the write capacity allows.
+    /// </summary>
+    void DDBAccess::ScheduleCheckpointFlush()
+    {
+        m_retryTimer.Schedule(std::chrono::seconds(1), [this]()
         {
-            outcome = conn->GetItem(request);
-            
-            // error?
-            if (!outcome.IsSuccess())
-            {
-                if (!outcome.GetError().ShouldRetry())
-                    break;
-
-                static const std::chrono::milliseconds retryInterval(
-                    Configuration::Get().settings.dbReqRetryIntervalMs
-                );
+            FlushCheckpoints(false);
+            ScheduleCheckpointFlush();
+        });
+    }
 
-                std::this_thread::sleep_for(retryInterval);
-                continue;
-            }
 
-            item = outcome.GetResult().GetItem();
-            
-            // item not found:
-            if (item.empty())
-            {
-#   ifndef NDEBUG
-                std::clog << "DynamoDB - GET RESULT: (NOT FOUND)\n" << std::endl;
-#   endif
-                return false;
-            }
+    /// <summary>
+    /// Accounts for the capacity consumed by a read.
+    /// </summary>
+    /// <param name="units">The read capacity units consumed.</param>
+    /// <param name="consistent">Whether the read was strongly consistent,
+    /// otherwise it has saved as much as it has consumed.</param>
+    void DDBAccess::AccountReadCapacity(double units, bool consistent)
+    {
+        std::lock_guard<std::mutex> lock(m_capacityMutex);
 
-            // item found:
-#   ifndef NDEBUG
-            std::clog << "DynamoDB - GET RESULT:\n";
-            DumpItem(item, std::clog);
-            std::clog << std::endl;
-#   endif
-            return true;
-        }
+        m_readCapacityUsed += units;
 
-        std::ostringstream oss;
-        oss << "Failed to " << actionLabel;
-        throw AppException(oss.str(), outcome.GetError().GetMessage());
+        if (!consistent)
+            m_readCapacitySaved += units;
     }
 
 
     /// <summary>
-    /// Puts (or replaces) an item into a DynamoDB table.
+    /// Reports the capacity consumed by reads, unless nothing was read since the last report.
     /// </summary>
-    /// <param name="actionLabel">The action label (to be used for error/trace report).</param>
-    /// <param name="conn">The database connection.</param>
-    /// <param name="request">The request to issue.</param>
-    /// <returns>Whether the create/replace operation was successfull with all conditions satisfied.</returns>
-    static bool PutItem(const char *actionLabel,
-                        DbConnection *conn,
-                        PutItemRequest &request)
+    /// <param name="out">The output stream.</param>
+    void DDBAccess::ReportReadCapacity(std::ostream &out)
     {
-#   ifndef NDEBUG
-        std::clog << "DynamoDB - PUT: " << request.SerializePayload() << std::endl;
-#   endif
-        PutItemOutcome outcome;
-
-        static const auto maxRetry = Configuration::Get().settings.dbReqMaxRetryCount;
-
-        for (uint32_t retryCount = 0; retryCount < maxRetry; ++retryCount)
-        {
-            outcome = conn->PutItem(request);
+        std::lock_guard<std::mutex> lock(m_capacityMutex);
 
-            if (outcome.IsSuccess())
-                return true;
-            else if (outcome.GetError().GetErrorType() == Aws::DynamoDB::DynamoDBErrors::CONDITIONAL_CHECK_FAILED)
-                return false;
+        if (m_readCapacityUsed == m_readCapacityReported)
+            return;
 
-            if (!outcome.GetError().ShouldRetry())
-                break;
+        m_readCapacityReported = m_readCapacityUsed;
 
-            static const std::chrono::milliseconds retryInterval(
-                Configuration::Get().settings.dbReqRetryIntervalMs
-            );
+        out << "Database reads have consumed " << m_readCapacityUsed
+            << " read capacity units, and eventually consistent reads have saved "
+            << m_readCapacitySaved << " units\n" << std::endl;
+    }
 
-            std::this_thread::sleep_for(retryInterval);
-        }
 
-        std::ostringstream oss;
-        oss << "Failed to " << actionLabel;
-        throw AppException(oss.str(), outcome.GetError().GetMessage());
+    /// <summary>
+    /// Opens connections to the database before they are needed.
+    /// </summary>
+    void DDBAccess::WarmUp()
+    {
+        m_dbConnPool.WarmUp({ DDB_TABNAME_TOPIC_BY_USER, DDB_TABNAME_NEWS_BY_TOPIC });
     }
 
 
     /// <summary>
-    /// Updates an item into a DynamoDB table.
+    /// Shuts down the asynchronous operations: writes the news still waiting
+    /// for a batch and the last feed of the users kept in memory, waits for the
+    /// operations in flight to finish, then stops the timer of retries.
+    /// This must be called before the SDK is shut down.
     /// </summary>
-    /// <param name="actionLabel">The action label (to be used for error/trace report).</param>
-    /// <param name="conn">The database connection.</param>
-    /// <param name="request">The request to issue.</param>
-    /// <param name="oldItem">When not null, this item will
-    /// be set with the updated attributes (before change).</param>
-    /// <returns>Whether the update/create operation was successfull with all conditions satisfied.</returns>
-    static bool UpdateItem(const char *actionLabel,
-                           DbConnection *conn,
-                           UpdateItemRequest &request,
-                           AwsDdbItem *oldItem)
+    void DDBAccess::Shutdown()
     {
-#   ifndef NDEBUG
-        std::clog << "DynamoDB - UPDATE: " << request.SerializePayload() << std::endl;
-#   endif
-        if (oldItem != nullptr)
-            oldItem->clear();
-        
-        UpdateItemOutcome outcome;
-
-        static const auto maxRetry = Configuration::Get().settings.dbReqMaxRetryCount;
+        m_putBatcher.Flush();
+        FlushCheckpoints(true);
 
-        for (uint32_t retryCount = 0; retryCount < maxRetry; ++retryCount)
         {
-            outcome = conn->UpdateItem(request);
+            std::unique_lock<std::mutex> lock(m_asyncOpsMutex);
+            m_asyncOpsCondition.wait(lock, [this]() { return m_asyncOpsCount == 0; });
+        }
 
-            if (outcome.IsSuccess())
-            {
-                if (oldItem != nullptr)
-                    *oldItem = outcome.GetResult().GetAttributes();
+        m_retryTimer.Shutdown();
+        m_retryPolicy.Report(std::clog);
+        m_hedgePolicy.Report(std::clog);
+        ReportReadCapacity(std::clog);
+        m_putBatcher.Report(std::clog);
+    }
 
-                return true;
-            }
-            else if (outcome.GetError().GetErrorType() == Aws::DynamoDB::DynamoDBErrors::CONDITIONAL_CHECK_FAILED)
-            {
-                return false;
-            }
 
-            if (!outcome.GetError().ShouldRetry())
-                break;
+    ///////////////////////////
+    // Asynchronous requests
+    ///////////////////////////
 
-            static const std::chrono::milliseconds retryInterval(
-                Configuration::Get().settings.dbReqRetryIntervalMs
+    /// <summary>
+    /// Makes a request be aborted, even in the middle of the transfer,
+    /// as soon as the caller no longer wants the result.
+    /// </summary>
+    /// <param name="request">The request to issue.</param>
+    /// <param name="isCancelled">Tells whether the caller has given up.</param>
+    static void SetCancellation(Aws::AmazonWebServiceRequest &request,
+                                const DDBAccess::CancellationCheck &isCancelled)
+    {
+        if (isCancelled)
+        {
+            request.SetContinueRequestHandler(
+                [isCancelled](const Aws::Http::HttpRequest *) { return !isCancelled(); }
             );
-
-            std::this_thread::sleep_for(retryInterval);
         }
-
-        std::ostringstream oss;
-        oss << "Failed to " << actionLabel;
-        throw AppException(oss.str(), outcome.GetError().GetMessage());
     }
 
 
     /// <summary>
-    /// Executes a batch of write operations in a DynamoDB table.
+    /// Throws when the caller has given up on the request.
     /// </summary>
     /// <param name="actionLabel">The action label (to be used for error/trace report).</param>
-    /// <param name="conn">The table to write into.</param>
-    /// <param name="conn">The database connection.</param>
-    /// <param name="requests">The requests to issue.</param>
-    static void WriteItems(const char *actionLabel,
-                           const char *table,
-                           DbConnection *conn,
-                           const Aws::Vector<WriteRequest> &requests)
+    /// <param name="isCancelled">Tells whether the caller has given up.</param>
+    static void ThrowIfCancelled(const char *actionLabel, const DDBAccess::CancellationCheck &isCancelled)
     {
-        BatchWriteItemOutcome outcome;
-
-        uint32_t failCount(0);
-
-        const int maxNumReqsPerBatch(25);
-
-        size_t idxBegin(0);
-
-        while (idxBegin < requests.size())
+        if (isCancelled && isCancelled())
         {
-            auto idxEnd = std::min(requests.size(), idxBegin + maxNumReqsPerBatch);
+            std::ostringstream oss;
+            oss << "Failed to " << actionLabel;
+            throw AppException(oss.str(), "Request cancelled because the client is gone");
+        }
+    }
 
-            BatchWriteItemRequest batchRequest;
-            batchRequest.AddRequestItems(table,
-                Aws::Vector<WriteRequest>(requests.begin() + idxBegin,
-                                          requests.begin() + idxEnd)
-            );
 
-#   ifndef NDEBUG
-            std::clog << "DynamoDB - BATCH WRITE: " << batchRequest.SerializePayload() << std::endl;
-#   endif
-            static const auto maxRetry = Configuration::Get().settings.dbReqMaxRetryCount;
+    /// <summary>
+    /// An asynchronous operation in the database, which might take several
+    /// requests, issued one after another with the same connection. Whatever
+    /// fails along the way is reported to the caller of the operation, which
+    /// is concluded only once. This object lives as long as its requests.
+    /// </summary>
+    class AsyncOperation
+    {
+    private:
 
-            for (uint32_t retryCount = 0; retryCount < maxRetry; ++retryCount)
-            {
-                outcome = conn->BatchWriteItem(batchRequest);
+        DDBAccess &m_owner;
 
-                if (outcome.IsSuccess() || !outcome.GetError().ShouldRetry())
-                    break;
+        DbConnPool::ConnWrapper m_conn;
 
-                static const std::chrono::milliseconds retryInterval(
-                    Configuration::Get().settings.dbReqRetryIntervalMs
-                );
+        DDBAccess::CancellationCheck m_isCancelled;
 
-                std::this_thread::sleep_for(retryInterval);
-            }
+        std::function<void (std::exception_ptr)> m_onFailure;
 
-            // error?
-            if (!outcome.IsSuccess())
-                failCount += outcome.GetResult().GetUnprocessedItems().size();
+        bool m_concluded;
 
-            idxBegin = idxEnd;
-            
-        }// end of outer loop
+    public:
 
-        // any failure?
-        if (failCount > 0)
+        AsyncOperation(DDBAccess &owner,
+                       const DDBAccess::CancellationCheck &isCancelled,
+                       const std::function<void (std::exception_ptr)> &onFailure)
+            : m_owner(owner)
+            , m_conn(owner.m_dbConnPool.Get())
+            , m_isCancelled(isCancelled)
+            , m_onFailure(onFailure)
+            , m_concluded(false)
         {
-            std::ostringstream oss;
-            oss << "Failed to " << actionLabel << " ("
-                << failCount << " items left unprocessed out of "
-                << requests.size() << " in total)";
+            std::lock_guard<std::mutex> lock(m_owner.m_asyncOpsMutex);
+            ++m_owner.m_asyncOpsCount;
+        }
+
+        ~AsyncOperation()
+        {
+            std::lock_guard<std::mutex> lock(m_owner.m_asyncOpsMutex);
 
-            throw AppException(oss.str(), outcome.GetError().GetMessage());
+            if (--m_owner.m_asyncOpsCount == 0)
+                m_owner.m_asyncOpsCondition.notify_all();
         }
-    }
 
+        DbConnection *GetConnection() { return m_conn.Get(); }
 
-    /// <summary>
-    /// Query items from a DynamoDB table.
-    /// </summary>
-    /// <param name="actionLabel">The action label (to be used for error/trace report).</param>
-    /// <param name="conn">The database connection.</param>
-    /// <param name="request">The request to issue.</param>
-    /// <param name="items">Will receive the returned items.</param>
-    static void QueryItems(const char *actionLabel,
-                           DbConnection *conn,
-                           const QueryRequest &request,
-                           Aws::Vector<AwsDdbItem> &items)
-    {
-#   ifndef NDEBUG
-        std::clog << "DynamoDB - QUERY REQUEST: " << request.SerializePayload() << std::endl;
-#   endif
-        items.clear();
+        TaskTimer &GetRetryTimer() { return m_owner.m_retryTimer; }
 
-        QueryOutcome outcome;
+        RetryPolicy &GetRetryPolicy() { return m_owner.m_retryPolicy; }
 
-        static const auto maxRetry = Configuration::Get().settings.dbReqMaxRetryCount;
+        HedgePolicy &GetHedgePolicy() { return m_owner.m_hedgePolicy; }
 
-        for (uint32_t retryCount = 0; retryCount < maxRetry; ++retryCount)
-        {
-            outcome = conn->Query(request);
+        DbConnPool::ConnWrapper BorrowConnection() { return m_owner.m_dbConnPool.Get(); }
 
-            // error?
-            if (!outcome.IsSuccess())
-            {
-                if (outcome.GetError().ShouldRetry())
-                {
-                    static const std::chrono::milliseconds retryInterval(
-                        Configuration::Get().settings.dbReqRetryIntervalMs
-                    );
+        void AccountReadCapacity(double units, bool consistent) { m_owner.AccountReadCapacity(units, consistent); }
 
-                    std::this_thread::sleep_for(retryInterval);
-                    continue;
-                }
-                else
-                    break;
-            }
+        const DDBAccess::CancellationCheck &GetCancellationCheck() const { return m_isCancelled; }
+
+        /// <summary>
+        /// Marks the operation as concluded.
+        /// </summary>
+        /// <returns>Whether the operation was not concluded yet,
+        /// hence the caller must be told about the outcome.</returns>
+        bool Conclude()
+        {
+            if (m_concluded)
+                return false;
 
-            items = outcome.GetResult().GetItems();
+            m_concluded = true;
+            return true;
+        }
 
-            // item not found:
-            if (items.empty())
+        /// <summary>
+        /// Concludes the operation with an error.
+        /// </summary>
+        /// <param name="error">The error.</param>
+        void Fail(std::exception_ptr error)
+        {
+            if (Conclude())
             {
-#   ifndef NDEBUG
-                std::clog << "DynamoDB - QUERY RESULT: (NOT FOUND)\n" << std::endl;
-#   endif
+                m_onFailure(error);
                 return;
             }
 
-            // item found:
-#   ifndef NDEBUG
-            std::clog << "DynamoDB - QUERY RESULT:\n";
-            DumpItems(items, std::clog);
-            std::clog << std::endl;
-#   endif
-            return;
+            // the caller has already been told, so only log it:
+            try
+            {
+                std::rethrow_exception(error);
+            }
+            catch (AppException &ex)
+            {
+                std::cerr << "ERROR - " << ex.what() << " - " << ex.GetDetails() << std::endl;
+            }
+            catch (std::exception &ex)
+            {
+                std::cerr << "ERROR - Generic failure after conclusion of database operation - " << ex.what() << std::endl;
+            }
         }
+    };
 
-        std::ostringstream oss;
-        oss << "Failed to " << actionLabel;
-        throw AppException(oss.str(), outcome.GetError().GetMessage());
-    }
+    typedef std::shared_ptr<AsyncOperation> AsyncOpPtr;
 
 
     /// <summary>
-    /// Gets user data or, if not there, put it.
+    /// A request to DynamoDB issued asynchronously. When it fails
+    /// with an error that can be retried, and the retry policy allows,
+    /// the retry is scheduled in the timer, so no thread is held meanwhile.
+    /// A read might also be hedged: when the first attempt is slower than
+    /// the hedge policy tolerates, a duplicate is sent with another pooled
+    /// connection, and the first to succeed is taken. The completion
+    /// receives the final outcome, and whatever it throws fails
+    /// the operation.
     /// </summary>
-    /// <param name="userId">The user ID.</param>
-    /// <param name="currentTopic">The topic to which the user is currently subscribing.</param>
-    void DDBAccess::GetOrPutUser(const string &userId, string &currentTopic)
+    template <typename RequestType, typename OutcomeType>
+    class AsyncRequest : public std::enable_shared_from_this<AsyncRequest<RequestType, OutcomeType>>
     {
-        currentTopic.clear();
+    public:
 
-        AwsDdbItem item;
+        typedef std::function<void (const DbConnection *,
+                                    const RequestType &,
+                                    const OutcomeType &,
+                                    const std::shared_ptr<const Aws::Client::AsyncCallerContext> &)> Handler;
 
-        GetItemRequest getRequest;
-        getRequest
-            .WithTableName(DDB_TABNAME_TOPIC_BY_USER)
-            .AddKey(DDB_TABATTR_TBU_PK_USER, AttributeValue(userId))
-            .AddAttributesToGet(DDB_TABATTR_TBU_TOPIC);
+        typedef std::function<void (DbConnection *, const RequestType &, const Handler &)> Issuer;
 
-        auto conn = m_dbConnPool.Get();
+        typedef std::function<void (const OutcomeType &)> Completion;
 
-        bool found = GetItem("get user from database table "
-                             DDB_TABNAME_TOPIC_BY_USER,
-                             conn.Get(),
-                             getRequest,
-                             item);
-        if (found)
-        {
-            auto iter = item.find(DDB_TABATTR_TBU_TOPIC);
+    private:
 
-            if (iter == item.end())
-            {
-                std::ostringstream oss;
-                oss << "Could not find attribute " DDB_TABATTR_TBU_TOPIC
-                       " in item retrieved from table " DDB_TABNAME_TOPIC_BY_USER
-                       " for user '" << userId << '\'';
+        AsyncOpPtr m_operation;
 
-                throw AppException("Cannot recognize schema of user data item!", oss.str());
+        const char *m_actionLabel;
+
+        RequestType m_request;
+
+        Issuer m_issue;
+
+        Completion m_onCompletion;
+
+        DDBAccess::CancellationCheck m_isCancelled;
+
+        std::mutex m_mutex; // outcomes of hedged attempts might come at once
+
+        uint32_t m_attemptCount;
+
+        uint32_t m_inFlightCount;
+
+        bool m_concluded;
+
+        bool m_hedged;
+
+        std::chrono::steady_clock::time_point m_issueTime;
+
+        std::chrono::milliseconds m_retryDelay;
+
+        /// <summary>
+        /// Sends the request with the given connection.
+        /// </summary>
+        /// <param name="conn">The connection.</param>
+        /// <param name="isHedge">Whether this is a hedge of the original attempt.</param>
+        /// <param name="hedgeConn">Keeps borrowed the connection of the hedge (if so).</param>
+        void Send(DbConnection *conn, bool isHedge, const std::shared_ptr<DbConnPool::ConnWrapper> &hedgeConn)
+        {
+            auto self = this->shared_from_this();
+
+            try
+            {
+                m_issue(conn, m_request,
+                    [self, isHedge, hedgeConn](const DbConnection *,
+                                               const RequestType &,
+                                               const OutcomeType &outcome,
+                                               const std::shared_ptr<const Aws::Client::AsyncCallerContext> &)
+                    {
+                        self->OnOutcome(outcome, isHedge);
+                    }
+                );
+            }
+            catch (...)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    --m_inFlightCount;
+
+                    if (m_concluded || m_inFlightCount > 0)
+                        return;
+
+                    m_concluded = true;
+                }
+
+                m_operation->Fail(std::current_exception());
+            }
+        }
+
+        /// <summary>
+        /// Sends a duplicate of the first attempt, if it is still in flight
+        /// and the hedge policy allows.
+        /// </summary>
+        void Hedge()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+
+                if (m_concluded || m_attemptCount > 1 || m_inFlightCount == 0)
+                    return;
+            }
+
+            auto &policy = m_operation->GetHedgePolicy();
+
+            if ((m_isCancelled && m_isCancelled()) || !policy.TryHedge())
+                return;
+
+            auto hedgeConn = std::make_shared<DbConnPool::ConnWrapper>(m_operation->BorrowConnection());
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                ++m_inFlightCount;
+            }
+
+            Send(hedgeConn->Get(), true, hedgeConn);
+        }
+
+        /// <summary>
+        /// Handles the outcome of an attempt.
+        /// </summary>
+        /// <param name="outcome">The outcome.</param>
+        /// <param name="isHedge">Whether it comes from a hedge.</param>
+        void OnOutcome(const OutcomeType &outcome, bool isHedge)
+        {
+            static const auto maxRetry = Configuration::Get().settings.dbReqMaxRetryCount;
+
+            bool retry;
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                --m_inFlightCount;
+
+                if (m_hedged && !isHedge && outcome.IsSuccess())
+                {
+                    m_operation->GetHedgePolicy().AddLatency(
+                        std::chrono::steady_clock::now() - m_issueTime
+                    );
+                }
+
+                // the other attempt has been taken, or might still succeed?
+                if (m_concluded || (!outcome.IsSuccess() && m_inFlightCount > 0))
+                    return;
+
+                if (isHedge && outcome.IsSuccess())
+                    m_operation->GetHedgePolicy().OnHedgeWon();
+
+                retry = !outcome.IsSuccess()
+                    && outcome.GetError().ShouldRetry()
+                    && m_attemptCount < maxRetry
+                    && !(m_isCancelled && m_isCancelled())
+                    && m_operation->GetRetryPolicy().TryRetry(m_actionLabel,
+                                                              outcome.GetError().GetExceptionName().c_str(),
+                                                              m_retryDelay);
+                m_concluded = !retry;
+            }
+
+            if (retry)
+            {
+                auto self = this->shared_from_this();
+                m_operation->GetRetryTimer().Schedule(m_retryDelay, [self]() { self->Issue(); });
+                return;
+            }
+
+            try
+            {
+                m_onCompletion(outcome);
+            }
+            catch (...)
+            {
+                m_operation->Fail(std::current_exception());
+            }
+        }
+
+    public:
+
+        AsyncRequest(const AsyncOpPtr &operation,
+                     const char *actionLabel,
+                     RequestType &&request,
+                     const DDBAccess::CancellationCheck &isCancelled,
+                     const Issuer &issue,
+                     const Completion &onCompletion)
+            : m_operation(operation)
+            , m_actionLabel(actionLabel)
+            , m_request(std::move(request))
+            , m_issue(issue)
+            , m_onCompletion(onCompletion)
+            , m_isCancelled(isCancelled)
+            , m_attemptCount(0)
+            , m_inFlightCount(0)
+            , m_concluded(false)
+            , m_hedged(false)
+            , m_retryDelay(operation->GetRetryPolicy().GetBaseDelay())
+        {
+            SetCancellation(m_request, m_isCancelled);
+        }
+
+        /// <summary>
+        /// Lets the request be hedged, as long as the hedge policy is enabled.
+        /// This is only meant for reads, since the request might be processed twice.
+        /// </summary>
+        void EnableHedging()
+        {
+            m_hedged = m_operation->GetHedgePolicy().IsEnabled();
+        }
+
+        /// <summary>
+        /// Issues the request (once more).
+        /// </summary>
+        void Issue()
+        {
+            bool isFirstAttempt;
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                isFirstAttempt = (m_attemptCount++ == 0);
+                ++m_inFlightCount;
+                m_issueTime = std::chrono::steady_clock::now();
+            }
+
+            if (isFirstAttempt)
+            {
+                m_operation->GetRetryPolicy().OnRequest();
+
+                std::chrono::microseconds hedgeDelay;
+
+                if (m_hedged)
+                {
+                    auto &policy = m_operation->GetHedgePolicy();
+                    policy.OnRead();
+
+                    if (policy.GetDelay(hedgeDelay))
+                    {
+                        auto self = this->shared_from_this();
+                        m_operation->GetRetryTimer().Schedule(hedgeDelay, [self]() { self->Hedge(); });
+                    }
+                }
+            }
+
+            Send(m_operation->GetConnection(), false, nullptr);
+        }
+    };
+
+
+    /// <summary>
+    /// Throws the error of a request that failed.
+    /// </summary>
+    /// <param name="actionLabel">The action label (to be used for error/trace report).</param>
+    /// <param name="message">The error message from the SDK.</param>
+    /// <param name="isCancelled">Tells whether the caller has given up (optional).</param>
+    static void ThrowRequestFailure(const char *actionLabel,
+                                    const Aws::String &message,
+                                    const DDBAccess::CancellationCheck &isCancelled = DDBAccess::CancellationCheck())
+    {
+        ThrowIfCancelled(actionLabel, isCancelled);
+
+        std::ostringstream oss;
+        oss << "Failed to " << actionLabel;
+        throw AppException(oss.str(), message);
+    }
+
+
+    /// <summary>
+    /// Gets an item from a DynamoDB table.
+    /// </summary>
+    /// <param name="actionLabel">The action label (to be used for error/trace report).</param>
+    /// <param name="op">The operation issuing the request.</param>
+    /// <param name="request">The request to issue.</param>
+    /// <param name="onItem">Receives the returned item, which is empty when not found.</param>
+    static void GetItem(const char *actionLabel,
+                        const AsyncOpPtr &op,
+                        GetItemRequest &&request,
+                        const std::function<void (AwsDdbItem &)> &onItem)
+    {
+#   ifndef NDEBUG
+        std::clog << "DynamoDB - GET REQUEST: " << request.SerializePayload() << std::endl;
+#   endif
+        typedef AsyncRequest<GetItemRequest, GetItemOutcome> Request;
+
+        request.SetReturnConsumedCapacity(ReturnConsumedCapacity::TOTAL);
+        bool consistent = request.GetConsistentRead();
+
+        auto asyncRequest = std::make_shared<Request>(op, actionLabel, std::move(request), op->GetCancellationCheck(),
+            [](DbConnection *conn, const GetItemRequest &request, const Request::Handler &handler)
+            {
+                conn->GetItemAsync(request, handler);
+            },
+            [actionLabel, op, consistent, onItem](const GetItemOutcome &outcome)
+            {
+                if (!outcome.IsSuccess())
+                    ThrowRequestFailure(actionLabel, outcome.GetError().GetMessage(), op->GetCancellationCheck());
+
+                op->AccountReadCapacity(outcome.GetResult().GetConsumedCapacity().GetCapacityUnits(), consistent);
+
+                AwsDdbItem item = outcome.GetResult().GetItem();
+#   ifndef NDEBUG
+                if (item.empty())
+                    std::clog << "DynamoDB - GET RESULT: (NOT FOUND)\n" << std::endl;
+                else
+                {
+                    std::clog << "DynamoDB - GET RESULT:\n";
+                    DumpItem(item, std::clog);
+                    std::clog << std::endl;
+                }
+#   endif
+                onItem(item);
+            }
+        );
+
+        asyncRequest->EnableHedging();
+        asyncRequest->Issue();
+    }
+
+
+    /// <summary>
+    /// Puts (or replaces) an item into a DynamoDB table.
+    /// </summary>
+    /// <param name="actionLabel">The action label (to be used for error/trace report).</param>
+    /// <param name="op">The operation issuing the request.</param>
+    /// <param name="request">The request to issue.</param>
+    /// <param name="onDone">Receives whether the create/replace operation
+    /// was successfull with all conditions satisfied.</param>
+    static void PutItem(const char *actionLabel,
+                        const AsyncOpPtr &op,
+                        PutItemRequest &&request,
+                        const std::function<void (bool)> &onDone)
+    {
+#   ifndef NDEBUG
+        std::clog << "DynamoDB - PUT: " << request.SerializePayload() << std::endl;
+#   endif
+        typedef AsyncRequest<PutItemRequest, PutItemOutcome> Request;
+
+        auto asyncRequest = std::make_shared<Request>(op, actionLabel, std::move(request), DDBAccess::CancellationCheck(),
+            [](DbConnection *conn, const PutItemRequest &request, const Request::Handler &handler)
+            {
+                conn->PutItemAsync(request, handler);
+            },
+            [actionLabel, onDone](const PutItemOutcome &outcome)
+            {
+                if (outcome.IsSuccess())
+                    onDone(true);
+                else if (outcome.GetError().GetErrorType() == Aws::DynamoDB::DynamoDBErrors::CONDITIONAL_CHECK_FAILED)
+                    onDone(false);
+                else
+                    ThrowRequestFailure(actionLabel, outcome.GetError().GetMessage());
+            }
+        );
+
+        asyncRequest->Issue();
+    }
+
+
+    /// <summary>
+    /// Updates an item into a DynamoDB table.
+    /// </summary>
+    /// <param name="actionLabel">The action label (to be used for error/trace report).</param>
+    /// <param name="op">The operation issuing the request.</param>
+    /// <param name="request">The request to issue.</param>
+    /// <param name="onDone">Receives whether the update/create operation was successfull
+    /// with all conditions satisfied, and the updated attributes (before change).</param>
+    static void UpdateItem(const char *actionLabel,
+                           const AsyncOpPtr &op,
+                           UpdateItemRequest &&request,
+                           const std::function<void (bool, AwsDdbItem &)> &onDone)
+    {
+#   ifndef NDEBUG
+        std::clog << "DynamoDB - UPDATE: " << request.SerializePayload() << std::endl;
+#   endif
+        typedef AsyncRequest<UpdateItemRequest, UpdateItemOutcome> Request;
+
+        auto asyncRequest = std::make_shared<Request>(op, actionLabel, std::move(request), DDBAccess::CancellationCheck(),
+            [](DbConnection *conn, const UpdateItemRequest &request, const Request::Handler &handler)
+            {
+                conn->UpdateItemAsync(request, handler);
+            },
+            [actionLabel, onDone](const UpdateItemOutcome &outcome)
+            {
+                AwsDdbItem oldItem;
+
+                if (outcome.IsSuccess())
+                {
+                    oldItem = outcome.GetResult().GetAttributes();
+                    onDone(true, oldItem);
+                }
+                else if (outcome.GetError().GetErrorType() == Aws::DynamoDB::DynamoDBErrors::CONDITIONAL_CHECK_FAILED)
+                    onDone(false, oldItem);
+                else
+                    ThrowRequestFailure(actionLabel, outcome.GetError().GetMessage());
+            }
+        );
+
+        asyncRequest->Issue();
+    }
+
+
+    /// <summary>
+    /// Executes a batch of write operations in a DynamoDB table, no more than the
+    /// maximum size allowed in a single request. The items the database leaves
+    /// unprocessed (for lack of write capacity) are resubmitted after a backoff,
+    /// for as long as the retry policy allows.
+    /// </summary>
+    /// <param name="actionLabel">The action label (to be used for error/trace report).</param>
+    /// <param name="table">The table to write into.</param>
+    /// <param name="op">The operation issuing the requests.</param>
+    /// <param name="batch">The requests to issue.</param>
+    /// <param name="attemptCount">How many times the batch has been submitted so far.</param>
+    /// <param name="delay">The delay before the last resubmission.</param>
+    /// <param name="onDone">Receives how many items were left unprocessed in the end,
+    /// and the error message, if any.</param>
+    static void WriteBatch(const char *actionLabel,
+                           const char *table,
+                           const AsyncOpPtr &op,
+                           Aws::Vector<WriteRequest> &&batch,
+                           uint32_t attemptCount,
+                           std::chrono::milliseconds delay,
+                           const std::function<void (size_t, const string &)> &onDone)
+    {
+        auto batchSize = batch.size();
+
+        BatchWriteItemRequest batchRequest;
+        batchRequest.AddRequestItems(table, std::move(batch));
+
+#   ifndef NDEBUG
+        std::clog << "DynamoDB - BATCH WRITE: " << batchRequest.SerializePayload() << std::endl;
+#   endif
+        typedef AsyncRequest<BatchWriteItemRequest, BatchWriteItemOutcome> Request;
+
+        auto asyncRequest = std::make_shared<Request>(op, actionLabel, std::move(batchRequest), DDBAccess::CancellationCheck(),
+            [](DbConnection *conn, const BatchWriteItemRequest &request, const Request::Handler &handler)
+            {
+                conn->BatchWriteItemAsync(request, handler);
+            },
+            [actionLabel, table, op, batchSize, attemptCount, delay, onDone](const BatchWriteItemOutcome &outcome)
+            {
+                static const auto maxRetry = Configuration::Get().settings.dbReqMaxRetryCount;
+
+                // error?
+                if (!outcome.IsSuccess())
+                {
+                    onDone(batchSize, outcome.GetError().GetMessage().c_str());
+                    return;
+                }
+
+                auto &unprocessedItems = outcome.GetResult().GetUnprocessedItems();
+                auto iter = unprocessedItems.find(table);
+
+                if (iter == unprocessedItems.end() || iter->second.empty())
+                {
+                    onDone(0, string());
+                    return;
+                }
+
+                auto nextDelay = delay;
+
+                if (attemptCount >= maxRetry
+                    || !op->GetRetryPolicy().TryRetry(actionLabel, "UnprocessedItems", nextDelay))
+                {
+                    onDone(iter->second.size(), "Write capacity exhausted");
+                    return;
+                }
+
+                auto unprocessed = std::make_shared<Aws::Vector<WriteRequest>>(iter->second);
+
+                op->GetRetryTimer().Schedule(nextDelay,
+                    [actionLabel, table, op, unprocessed, attemptCount, nextDelay, onDone]()
+                    {
+                        try
+                        {
+                            WriteBatch(actionLabel, table, op, std::move(*unprocessed),
+                                       attemptCount + 1, nextDelay, onDone);
+                        }
+                        catch (...)
+                        {
+                            op->Fail(std::current_exception());
+                        }
+                    }
+                );
+            }
+        );
+
+        asyncRequest->Issue();
+    }
+
+
+    /// <summary>
+    /// Executes a batch of write operations in a DynamoDB table,
+    /// in chunks of the maximum size allowed, one after another.
+    /// </summary>
+    /// <param name="actionLabel">The action label (to be used for error/trace report).</param>
+    /// <param name="table">The table to write into.</param>
+    /// <param name="op">The operation issuing the requests.</param>
+    /// <param name="requests">The requests to issue.</param>
+    /// <param name="idxBegin">Where the next chunk begins in the requests.</param>
+    /// <param name="failCount">How many items have been left unprocessed so far.</param>
+    /// <param name="onDone">Called once all the requests have been processed.</param>
+    static void WriteItems(const char *actionLabel,
+                           const char *table,
+                           const AsyncOpPtr &op,
+                           const std::shared_ptr<Aws::Vector<WriteRequest>> &requests,
+                           size_t idxBegin,
+                           size_t failCount,
+                           const std::function<void ()> &onDone)
+    {
+        const int maxNumReqsPerBatch(25);
+
+        auto idxEnd = std::min(requests->size(), idxBegin + maxNumReqsPerBatch);
+
+        WriteBatch(actionLabel, table, op,
+            Aws::Vector<WriteRequest>(requests->begin() + idxBegin,
+                                      requests->begin() + idxEnd),
+            0,
+            op->GetRetryPolicy().GetBaseDelay(),
+            [actionLabel, table, op, requests, idxEnd, failCount, onDone](size_t batchFailCount, const string &error)
+            {
+                auto totalFailCount = failCount + batchFailCount;
+
+                if (idxEnd < requests->size())
+                {
+                    WriteItems(actionLabel, table, op, requests, idxEnd, totalFailCount, onDone);
+                    return;
+                }
+
+                // any failure?
+                if (totalFailCount > 0)
+                {
+                    std::ostringstream oss;
+                    oss << "Failed to " << actionLabel << " ("
+                        << totalFailCount << " items left unprocessed out of "
+                        << requests->size() << " in total)";
+
+                    throw AppException(oss.str(), error);
+                }
+
+                onDone();
+            }
+        );
+    }
+
+
+    /// <summary>
+    /// Reads a page of items from a DynamoDB table, with a query or a scan.
+    /// </summary>
+    /// <param name="actionLabel">The action label (to be used for error/trace report).</param>
+    /// <param name="traceLabel">The kind of read (to be used for trace report).</param>
+    /// <param name="op">The operation issuing the request.</param>
+    /// <param name="request">The request for the page.</param>
+    /// <param name="issue">Issues the request with a given connection.</param>
+    /// <param name="hedged">Whether the request might be hedged.</param>
+    /// <param name="onPage">Receives the items of the page, and the last evaluated key,
+    /// which is empty when there is no page left.</param>
+    template <typename RequestType, typename OutcomeType>
+    static void ReadPage(const char *actionLabel,
+                         const char *traceLabel,
+                         const AsyncOpPtr &op,
+                         RequestType &&request,
+                         const typename AsyncRequest<RequestType, OutcomeType>::Issuer &issue,
+                         bool hedged,
+                         const std::function<void (Aws::Vector<AwsDdbItem> &, const AwsDdbItem &)> &onPage)
+    {
+        request.SetReturnConsumedCapacity(ReturnConsumedCapacity::TOTAL);
+        bool consistent = request.GetConsistentRead();
+
+#   ifndef NDEBUG
+        std::clog << "DynamoDB - " << traceLabel << " REQUEST: " << request.SerializePayload() << std::endl;
+#   endif
+        typedef AsyncRequest<RequestType, OutcomeType> Request;
+
+        auto asyncRequest = std::make_shared<Request>(op, actionLabel, std::move(request), op->GetCancellationCheck(), issue,
+            [actionLabel, traceLabel, op, consistent, onPage](const OutcomeType &outcome)
+            {
+                if (!outcome.IsSuccess())
+                    ThrowRequestFailure(actionLabel, outcome.GetError().GetMessage(), op->GetCancellationCheck());
+
+                op->AccountReadCapacity(outcome.GetResult().GetConsumedCapacity().GetCapacityUnits(), consistent);
+
+                Aws::Vector<AwsDdbItem> items = outcome.GetResult().GetItems();
+#   ifndef NDEBUG
+                if (items.empty())
+                    std::clog << "DynamoDB - " << traceLabel << " RESULT: (NOT FOUND)\n" << std::endl;
+                else
+                {
+                    std::clog << "DynamoDB - " << traceLabel << " RESULT:\n";
+                    DumpItems(items, std::clog);
+                    std::clog << std::endl;
+                }
+#   endif
+                onPage(items, outcome.GetResult().GetLastEvaluatedKey());
+            }
+        );
+
+        if (hedged)
+            asyncRequest->EnableHedging();
+
+        asyncRequest->Issue();
+    }
+
+
+    /// <summary>
+    /// Queries the news of a topic from all of its shards, page by page, and merges
+    /// them in order of sort key. Every round reads in parallel the next page of the
+    /// shards whose news have all been handed over, then hands over the news up to
+    /// the lowest of the last keys read from the shards not over yet, because none
+    /// of those can have news before that (k-way merge). So the news arrive in order,
+    /// with no more than a page per shard in memory.
+    /// </summary>
+    class ShardedNewsQuery : public std::enable_shared_from_this<ShardedNewsQuery>
+    {
+    public:
+
+        typedef std::function<void (std::vector<NewsItem> &, bool)> PageCallback;
+
+    private:
+
+        /// <summary>
+        /// Progress of the query in a shard.
+        /// </summary>
+        struct Shard
+        {
+            string partitionKey;
+            AwsDdbItem startKey; // of the next page
+            string lastReadKey;
+            std::vector<NewsItem> news; // read, but not handed over yet
+            size_t nextIdx;
+            bool isOver;
+        };
+
+        DDBAccess &m_owner;
+
+        const char *m_actionLabel;
+
+        AsyncOpPtr m_op;
+
+        string m_topic;
+
+        QueryRequest m_request;
+
+        std::vector<Shard> m_shards;
+
+        std::mutex m_mutex;
+
+        size_t m_pendingReadCount;
+
+        bool m_failed;
+
+        PageCallback m_onPage;
+
+        void ReadRound();
+
+        void OnShardPage(size_t idx, Aws::Vector<AwsDdbItem> &items, const AwsDdbItem &lastKey);
+
+        void OnShardFailure(std::exception_ptr error);
+
+        void HandOver();
+
+    public:
+
+        ShardedNewsQuery(DDBAccess &owner,
+                         const char *actionLabel,
+                         const AsyncOpPtr &op,
+                         const string &topic,
+                         uint32_t shardCount,
+                         QueryRequest &&request,
+                         const string &afterKey,
+                         const PageCallback &onPage);
+
+        void Start() { ReadRound(); }
+    };
+
+
+    /// <summary>
+    /// Initializes a new instance of the <see cref="ShardedNewsQuery"/> class.
+    /// </summary>
+    /// <param name="owner">The data access.</param>
+    /// <param name="actionLabel">The action label (to be used for error/trace report).</param>
+    /// <param name="op">The operation issuing the query.</param>
+    /// <param name="topic">The topic.</param>
+    /// <param name="shardCount">How many shards the topic has.</param>
+    /// <param name="request">The request for the first page, whose key condition
+    /// takes the partition key in ":topic", and whose start key is set here.</param>
+    /// <param name="afterKey">The sort key after which the news are wanted,
+    /// or an empty string to have them all.</param>
+    /// <param name="onPage">Receives the news of each page, and whether it is the last one.</param>
+    ShardedNewsQuery::ShardedNewsQuery(DDBAccess &owner,
+                                       const char *actionLabel,
+                                       const AsyncOpPtr &op,
+                                       const string &topic,
+                                       uint32_t shardCount,
+                                       QueryRequest &&request,
+                                       const string &afterKey,
+                                       const PageCallback &onPage)
+        : m_owner(owner)
+        , m_actionLabel(actionLabel)
+        , m_op(op)
+        , m_topic(topic)
+        , m_request(std::move(request))
+        , m_shards(std::max(shardCount, 1U))
+        , m_pendingReadCount(0)
+        , m_failed(false)
+        , m_onPage(onPage)
+    {
+        static const auto pageSize = static_cast<int> (
+            std::max(Configuration::Get().settings.dbQueryPageSize, 1U)
+        );
+
+        m_request.SetLimit(pageSize);
+
+        const string &startKey = afterKey.empty() ? shardMarkerKey : afterKey;
+
+        for (uint32_t idx = 0; idx < m_shards.size(); ++idx)
+        {
+            auto &shard = m_shards[idx];
+            shard.partitionKey = TopicShards::GetPartitionKey(topic, idx);
+            shard.startKey[DDB_TABATTR_NBT_PK_TOPIC] = AttributeValue(shard.partitionKey);
+            shard.startKey[DDB_TABATTR_NBT_SK_BINTB] = AttributeValue().SetB(ToByteBuffer(startKey));
+            shard.lastReadKey = startKey;
+            shard.nextIdx = 0;
+            shard.isOver = false;
+        }
+    }
+
+
+    /// <summary>
+    /// Reads the next page of the shards whose news have all been handed over.
+    /// </summary>
+    void ShardedNewsQuery::ReadRound()
+    {
+        typedef AsyncRequest<QueryRequest, QueryOutcome> Request;
+
+        std::vector<size_t> toRead;
+
+        for (size_t idx = 0; idx < m_shards.size(); ++idx)
+        {
+            if (!m_shards[idx].isOver && m_shards[idx].nextIdx == m_shards[idx].news.size())
+                toRead.push_back(idx);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_pendingReadCount = toRead.size();
+        }
+
+        auto self = shared_from_this();
+
+        for (auto idx : toRead)
+        {
+            auto &shard = m_shards[idx];
+
+            QueryRequest request(m_request);
+            request.AddExpressionAttributeValues(":topic", AttributeValue(shard.partitionKey));
+            request.SetExclusiveStartKey(shard.startKey);
+
+            // each shard is read in its own operation, so their conclusions do not race:
+            auto readOp = std::make_shared<AsyncOperation>(m_owner, m_op->GetCancellationCheck(),
+                [self](std::exception_ptr error) { self->OnShardFailure(error); }
+            );
+
+            ReadPage<QueryRequest, QueryOutcome>(m_actionLabel, "QUERY", readOp, std::move(request),
+                [](DbConnection *conn, const QueryRequest &request, const Request::Handler &handler)
+                {
+                    conn->QueryAsync(request, handler);
+                },
+                true,
+                [self, readOp, idx](Aws::Vector<AwsDdbItem> &items, const AwsDdbItem &lastKey)
+                {
+                    self->OnShardPage(idx, items, lastKey);
+                    readOp->Conclude();
+                }
+            );
+        }
+    }
+
+
+    /// <summary>
+    /// Keeps a page read from a shard, and hands over the news once the round is complete.
+    /// </summary>
+    /// <param name="idx">The index of the shard.</param>
+    /// <param name="items">The items of the page.</param>
+    /// <param name="lastKey">The last evaluated key, which is empty when the shard is over.</param>
+    void ShardedNewsQuery::OnShardPage(size_t idx, Aws::Vector<AwsDdbItem> &items, const AwsDdbItem &lastKey)
+    {
+        std::vector<NewsItem> news;
+        ParseNewsItems(m_topic, items, news);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (m_failed)
+                return;
+
+            auto &shard = m_shards[idx];
+
+            if (!news.empty())
+                shard.lastReadKey = news.back().sortKey;
+
+            shard.news.swap(news);
+            shard.nextIdx = 0;
+            shard.startKey = lastKey;
+            shard.isOver = lastKey.empty();
+
+            if (--m_pendingReadCount > 0)
+                return;
+        }
+
+        ThrowIfCancelled(m_actionLabel, m_op->GetCancellationCheck());
+        HandOver();
+    }
+
+
+    /// <summary>
+    /// Fails the query when the read of a shard fails, once.
+    /// </summary>
+    /// <param name="error">The error.</param>
+    void ShardedNewsQuery::OnShardFailure(std::exception_ptr error)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (m_failed)
+                return;
+
+            m_failed = true;
+        }
+
+        m_op->Fail(error);
+    }
+
+
+    /// <summary>
+    /// Hands over the news read that cannot be preceded by any other yet to be read,
+    /// in order, then starts the next round, unless all the shards are over.
+    /// </summary>
+    void ShardedNewsQuery::HandOver()
+    {
+        const string *upToKey(nullptr);
+
+        for (auto &shard : m_shards)
+        {
+            if (!shard.isOver && (upToKey == nullptr || shard.lastReadKey < *upToKey))
+                upToKey = &shard.lastReadKey;
+        }
+
+        auto isLater = [this](size_t left, size_t right)
+        {
+            return m_shards[left].news[m_shards[left].nextIdx].sortKey
+                > m_shards[right].news[m_shards[right].nextIdx].sortKey;
+        };
+
+        std::priority_queue<size_t, std::vector<size_t>, decltype(isLater)> heads(isLater);
+
+        for (size_t idx = 0; idx < m_shards.size(); ++idx)
+        {
+            if (m_shards[idx].nextIdx < m_shards[idx].news.size())
+                heads.push(idx);
+        }
+
+        std::vector<NewsItem> page;
+
+        while (!heads.empty())
+        {
+            auto idx = heads.top();
+            auto &shard = m_shards[idx];
+
+            if (upToKey != nullptr && shard.news[shard.nextIdx].sortKey > *upToKey)
+                break;
+
+            heads.pop();
+            page.push_back(std::move(shard.news[shard.nextIdx]));
+
+            if (++shard.nextIdx < shard.news.size())
+                heads.push(idx);
+        }
+
+        for (auto &shard : m_shards)
+        {
+            if (shard.nextIdx == shard.news.size())
+            {
+                shard.news.clear();
+                shard.nextIdx = 0;
             }
+        }
+
+        bool isLastPage = (upToKey == nullptr);
+
+        if (isLastPage || !page.empty())
+            m_onPage(page, isLastPage);
+
+        if (!isLastPage)
+            ReadRound();
+    }
+
+
+    /// <summary>
+    /// Gets how many shards of a topic must be read, from memory when recent enough,
+    /// otherwise from the item that keeps it in the first shard of the topic.
+    /// </summary>
+    /// <param name="topicShards">What is known about the shards of the topics.</param>
+    /// <param name="op">The operation issuing the requests.</param>
+    /// <param name="topic">The topic.</param>
+    /// <param name="onCount">Receives the count of shards.</param>
+    static void GetShardCount(TopicShards &topicShards,
+                              const AsyncOpPtr &op,
+                              const string &topic,
+                              const std::function<void (uint32_t)> &onCount)
+    {
+        uint32_t shardCount;
+
+        if (topicShards.GetShardCount(topic, shardCount))
+        {
+            onCount(shardCount);
+            return;
+        }
+
+        // strongly consistent, so a raise is seen by all the instances before it takes effect:
+        GetItemRequest getRequest;
+        getRequest
+            .WithTableName(DDB_TABNAME_NEWS_BY_TOPIC)
+            .AddKey(DDB_TABATTR_NBT_PK_TOPIC, AttributeValue(topic))
+            .AddKey(DDB_TABATTR_NBT_SK_BINTB, AttributeValue().SetB(ToByteBuffer(shardMarkerKey)))
+            .WithProjectionExpression(DDB_TABATTR_NBT_SHARDS ", " DDB_TABATTR_NBT_SHARDS_AT)
+            .WithConsistentRead(true);
+
+        auto topicShardsPtr = &topicShards;
+
+        GetItem("get shards of topic from database table "
+                DDB_TABNAME_NEWS_BY_TOPIC,
+                op,
+                std::move(getRequest),
+                [topicShardsPtr, topic, onCount](AwsDdbItem &item)
+        {
+            uint32_t shardCount(0);
+            time_t activeFrom(0);
+
+            auto iter = item.find(DDB_TABATTR_NBT_SHARDS);
+
+            if (iter != item.end())
+                shardCount = static_cast<uint32_t> (strtoul(iter->second.GetN().c_str(), nullptr, 10));
+
+            iter = item.find(DDB_TABATTR_NBT_SHARDS_AT);
+
+            if (iter != item.end())
+                activeFrom = static_cast<time_t> (strtoll(iter->second.GetN().c_str(), nullptr, 10));
+
+            topicShardsPtr->SetShardCount(topic, shardCount, activeFrom);
+            topicShardsPtr->GetShardCount(topic, shardCount);
+
+            onCount(shardCount);
+        });
+    }
+
+
+    /// <summary>
+    /// Queries the news of a topic from all of its shards, page by page, in order of sort key.
+    /// </summary>
+    /// <param name="topicShards">What is known about the shards of the topics.</param>
+    /// <param name="actionLabel">The action label (to be used for error/trace report).</param>
+    /// <param name="op">The operation issuing the requests.</param>
+    /// <param name="topic">The topic.</param>
+    /// <param name="request">The request for the first page, whose key condition
+    /// takes the partition key in ":topic".</param>
+    /// <param name="afterKey">The sort key after which the news are wanted,
+    /// or an empty string to have them all.</param>
+    /// <param name="onPage">Receives the news of each page, and whether it is the last one.</param>
+    static void QueryTopicNews(TopicShards &topicShards,
+                               const char *actionLabel,
+                               const AsyncOpPtr &op,
+                               const string &topic,
+                               QueryRequest &&request,
+                               const string &afterKey,
+                               const ShardedNewsQuery::PageCallback &onPage)
+    {
+        auto requestPtr = std::make_shared<QueryRequest>(std::move(request));
+
+        GetShardCount(topicShards, op, topic,
+            [actionLabel, op, topic, requestPtr, afterKey, onPage](uint32_t shardCount)
+            {
+                auto query = std::make_shared<ShardedNewsQuery>(DDBAccess::GetInstance(),
+                                                                actionLabel,
+                                                                op,
+                                                                topic,
+                                                                shardCount,
+                                                                std::move(*requestPtr),
+                                                                afterKey,
+                                                                onPage);
+                query->Start();
+            }
+        );
+    }
+
+
+    /// <summary>
+    /// Reads the keys of news from the table of news, page by page, with a query or
+    /// a scan. Unlike the asynchronous reads, each page is handed over in the thread
+    /// of the caller, which is held meanwhile, and decides whether to read the next.
+    /// </summary>
+    /// <param name="owner">The data access.</param>
+    /// <param name="actionLabel">The action label (to be used for error/trace report).</param>
+    /// <param name="traceLabel">The kind of read (to be used for trace report).</param>
+    /// <param name="request">The request, which must project both key attributes.</param>
+    /// <param name="issue">Issues the request with a given connection.</param>
+    /// <param name="onPage">Receives the keys of each page, and returns whether to go on.</param>
+    template <typename RequestType, typename OutcomeType>
+    static void ReadNewsKeys(DDBAccess &owner,
+                             const char *actionLabel,
+                             const char *traceLabel,
+                             RequestType &request,
+                             const typename AsyncRequest<RequestType, OutcomeType>::Issuer &issue,
+                             const NewsStore::KeyPageCallback &onPage)
+    {
+        static const auto pageSize = static_cast<int> (
+            std::max(Configuration::Get().settings.dbQueryPageSize, 1U)
+        );
+
+        typedef std::function<void (std::vector<NewsKey> &, std::exception_ptr)> DoneCallback;
+
+        request.SetLimit(pageSize);
+
+        AwsDdbItem startKey;
+
+        do
+        {
+            if (!startKey.empty())
+                request.SetExclusiveStartKey(startKey);
+
+            auto keys = NewsStore::Wait<std::vector<NewsKey>>([&owner, actionLabel, traceLabel, &request, &issue, &startKey](const DoneCallback &callback)
+            {
+                auto op = std::make_shared<AsyncOperation>(owner, DDBAccess::CancellationCheck(),
+                    [callback](std::exception_ptr error) { std::vector<NewsKey> none; callback(none, error); }
+                );
+
+                ReadPage<RequestType, OutcomeType>(actionLabel, traceLabel, op, RequestType(request), issue, false,
+                    [op, callback, &startKey](Aws::Vector<AwsDdbItem> &items, const AwsDdbItem &lastKey)
+                    {
+                        std::vector<NewsKey> keys;
+                        keys.reserve(items.size());
+
+                        for (auto &item : items)
+                        {
+                            auto &sortKey = item[DDB_TABATTR_NBT_SK_BINTB].GetB();
+
+                            // not news, but the count of shards of the topic?
+                            if (sortKey.GetLength() == shardMarkerKey.length())
+                                continue;
+
+                            keys.push_back(NewsKey{
+                                item[DDB_TABATTR_NBT_PK_TOPIC].GetS(),
+                                ToString(sortKey)
+                            });
+                        }
+
+                        startKey = lastKey;
+
+                        if (op->Conclude())
+                            callback(keys, nullptr);
+                    }
+                );
+            });
+
+            if (!onPage(keys))
+                return;
+
+        } while (!startKey.empty());
+    }
+
+
+    /// <summary>
+    /// Gets user data or, if not there, put it.
+    /// </summary>
+    /// <param name="userId">The user ID.</param>
+    /// <param name="callback">Receives the topic to which the user is currently subscribing.</param>
+    /// <param name="isCancelled">Tells whether the caller has given up (optional).</param>
+    void DDBAccess::GetOrPutUserAsync(const string &userId,
+                                      const StringCallback &callback,
+                                      const CancellationCheck &isCancelled)
+    {
+        try
+        {
+            auto op = std::make_shared<AsyncOperation>(*this, isCancelled,
+                [callback](std::exception_ptr error) { string none; callback(none, error); }
+            );
+
+            auto getRequest = MakeUserStateGet(userId);
+
+            // the user (re)connects, so refresh the cache from the source of truth:
+            GetItem("get user from database table "
+                    DDB_TABNAME_TOPIC_BY_USER,
+                    op,
+                    std::move(getRequest),
+                    [this, op, userId, callback](AwsDdbItem &item)
+            {
+                if (!item.empty())
+                {
+                    UserState state;
+                    ParseUserItem(userId, item, state);
+                    m_userCache.Put(userId, state);
+
+                    if (op->Conclude())
+                        callback(state.topic, nullptr);
+
+                    return;
+                }
+
+                PutItemRequest putRequest;
+                putRequest
+                    .WithTableName(DDB_TABNAME_TOPIC_BY_USER)
+                    .WithConditionExpression("attribute_not_exists(" DDB_TABATTR_TBU_PK_USER ")") // do insert, not replace
+                    .AddItem(DDB_TABATTR_TBU_PK_USER, AttributeValue(userId))
+                    .AddItem(DDB_TABATTR_TBU_TOPIC, AttributeValue().SetNull(true))
+                    .AddItem(DDB_TABATTR_TBU_LFTIME, AttributeValue().SetNull(true))
+                    .AddItem(DDB_TABATTR_TBU_LFKEY, AttributeValue().SetNull(true));
+
+                PutItem("put new user into database table "
+                        DDB_TABNAME_TOPIC_BY_USER,
+                        op,
+                        std::move(putRequest),
+                        [this, op, userId, callback](bool putDone)
+                {
+                    if (!putDone)
+                    {
+                        throw AppException("Failed to create new user on table " DDB_TABNAME_TOPIC_BY_USER,
+                                           "Record with same key already existed");
+                    }
+
+                    m_userCache.Put(userId, UserState{ string(), string() });
+
+                    string noTopic;
+
+                    if (op->Conclude())
+                        callback(noTopic, nullptr);
+                });
+            });
+        }
+        catch (...)
+        {
+            string none;
+            callback(none, std::current_exception());
+        }
+    }
+
+
+    /// <summary>
+    /// Updates the user.
+    /// </summary>
+    /// <param name="userId">The user ID.</param>
+    /// <param name="topic">The topic.</param>
+    /// <param name="callback">Tells when the user has been updated.</param>
+    void DDBAccess::UpdateUserAsync(const string &userId,
+                                    const string &topic,
+                                    const Callback &callback)
+    {
+        try
+        {
+            auto op = std::make_shared<AsyncOperation>(*this, CancellationCheck(), callback);
+
+            // the last feed in the previous topic no longer matters:
+            {
+                std::lock_guard<std::mutex> lock(m_checkpointsMutex);
+                m_checkpoints.erase(userId);
+            }
+
+            // the feed starts over from now, with a cursor sorted before any news written next:
+            auto lastKey = NewsStore::MakeFeedCursor();
+            auto cursor = ToByteBuffer(lastKey);
+
+            char strEpochTime[21];
+            snprintf(strEpochTime, sizeof strEpochTime, "%lld",
+                     static_cast<long long> (NewsStore::GetNewsTime(lastKey)));
+
+            UpdateItemRequest updateRequest;
+            updateRequest
+                .WithTableName(DDB_TABNAME_TOPIC_BY_USER)
+                .AddKey(DDB_TABATTR_TBU_PK_USER, AttributeValue(userId))
+                .AddAttributeUpdates(DDB_TABATTR_TBU_TOPIC,
+                    AttributeValueUpdate()
+                        .WithAction(AttributeAction::PUT)
+                        .WithValue(!topic.empty() ? AttributeValue(topic) : AttributeValue().SetNull(true))
+                )
+                .AddAttributeUpdates(DDB_TABATTR_TBU_LFTIME,
+                    AttributeValueUpdate()
+                        .WithAction(AttributeAction::PUT)
+                        .WithValue(AttributeValue().SetN(strEpochTime))
+                )
+                .AddAttributeUpdates(DDB_TABATTR_TBU_LFKEY,
+                    AttributeValueUpdate()
+                        .WithAction(AttributeAction::PUT)
+                        .WithValue(AttributeValue().SetB(cursor))
+                );
+
+            UpdateItem("update user data in table "
+                       DDB_TABNAME_TOPIC_BY_USER,
+                       op,
+                       std::move(updateRequest),
+                       [this, op, userId, topic, lastKey, callback](bool updateDone, AwsDdbItem &)
+            {
+                if (updateDone)
+                    m_userCache.Put(userId, UserState{ topic, lastKey });
+                else
+                    m_userCache.Remove(userId);
+
+                // the old news are purged in background by the retention worker
+                if (op->Conclude())
+                    callback(nullptr);
+            });
+        }
+        catch (...)
+        {
+            callback(std::current_exception());
+        }
+    }
+
+
+    /// <summary>
+    /// Writes a batch of news with a single request, which cannot be conditional, and
+    /// acknowledges each news as soon as it is written. The news the database leaves
+    /// unprocessed (for lack of write capacity) are resubmitted after a backoff, for as
+    /// long as the retry policy allows, otherwise they fail along with the operation.
+    /// </summary>
+    /// <param name="op">The operation issuing the requests.</param>
+    /// <param name="puts">The news not acknowledged yet.</param>
+    /// <param name="attemptCount">How many times the batch has been submitted so far.</param>
+    /// <param name="delay">The delay before the last resubmission.</param>
+    static void WriteNewsBatch(const AsyncOpPtr &op,
+                               const std::shared_ptr<std::vector<PendingNewsPut>> &puts,
+                               uint32_t attemptCount,
+                               std::chrono::milliseconds delay)
+    {
+        static const char *actionLabel("put news in database table " DDB_TABNAME_NEWS_BY_TOPIC);
+
+        Aws::Vector<WriteRequest> writeRequests;
+        writeRequests.reserve(puts->size());
+
+        for (auto &put : *puts)
+        {
+            writeRequests.push_back(WriteRequest().WithPutRequest(
+                PutRequest()
+                    .AddItem(DDB_TABATTR_NBT_PK_TOPIC, AttributeValue(put.topic))
+                    .AddItem(DDB_TABATTR_NBT_SK_BINTB, AttributeValue().SetB(ToByteBuffer(put.sortKey)))
+                    .AddItem(DDB_TABATTR_NBT_NEWS, AttributeValue(put.news))
+            ));
+        }
+
+        BatchWriteItemRequest batchRequest;
+        batchRequest.AddRequestItems(DDB_TABNAME_NEWS_BY_TOPIC, std::move(writeRequests));
+
+#   ifndef NDEBUG
+        std::clog << "DynamoDB - BATCH WRITE: " << batchRequest.SerializePayload() << std::endl;
+#   endif
+        typedef AsyncRequest<BatchWriteItemRequest, BatchWriteItemOutcome> Request;
+
+        auto asyncRequest = std::make_shared<Request>(op, actionLabel, std::move(batchRequest), DDBAccess::CancellationCheck(),
+            [](DbConnection *conn, const BatchWriteItemRequest &request, const Request::Handler &handler)
+            {
+                conn->BatchWriteItemAsync(request, handler);
+            },
+            [op, puts, attemptCount, delay](const BatchWriteItemOutcome &outcome)
+            {
+                static const auto maxRetry = Configuration::Get().settings.dbReqMaxRetryCount;
+
+                if (!outcome.IsSuccess())
+                    ThrowRequestFailure(actionLabel, outcome.GetError().GetMessage());
+
+                std::unordered_set<string> unprocessedKeys;
+
+                auto &unprocessedItems = outcome.GetResult().GetUnprocessedItems();
+                auto iter = unprocessedItems.find(DDB_TABNAME_NEWS_BY_TOPIC);
+
+                if (iter != unprocessedItems.end())
+                {
+                    for (auto &request : iter->second)
+                    {
+                        auto &item = request.GetPutRequest().GetItem();
+
+                        string key = item.at(DDB_TABATTR_NBT_PK_TOPIC).GetS();
+                        key.push_back('\0');
+                        key += ToString(item.at(DDB_TABATTR_NBT_SK_BINTB).GetB());
+                        unprocessedKeys.insert(std::move(key));
+                    }
+                }
+
+                // acknowledge the news written, and keep the others:
+                std::vector<PendingNewsPut> unprocessed;
+
+                for (auto &put : *puts)
+                {
+                    string key = put.topic;
+                    key.push_back('\0');
+                    key += put.sortKey;
+
+                    if (unprocessedKeys.count(key) > 0)
+                        unprocessed.push_back(std::move(put));
+                    else
+                        put.callback(put.sortKey, nullptr);
+                }
+
+                puts->swap(unprocessed);
+
+                if (puts->empty())
+                {
+                    op->Conclude();
+                    return;
+                }
+
+                auto nextDelay = delay;
+
+                if (attemptCount >= maxRetry
+                    || !op->GetRetryPolicy().TryRetry(actionLabel, "UnprocessedItems", nextDelay))
+                {
+                    std::ostringstream oss;
+                    oss << "Failed to " << actionLabel << " ("
+                        << puts->size() << " news left unprocessed)";
+
+                    throw AppException(oss.str(), "Write capacity exhausted");
+                }
+
+                op->GetRetryTimer().Schedule(nextDelay, [op, puts, attemptCount, nextDelay]()
+                {
+                    try
+                    {
+                        WriteNewsBatch(op, puts, attemptCount + 1, nextDelay);
+                    }
+                    catch (...)
+                    {
+                        op->Fail(std::current_exception());
+                    }
+                });
+            }
+        );
+
+        asyncRequest->Issue();
+    }
+
+
+    /// <summary>
+    /// Writes a batch of news gathered by the batcher.
+    /// </summary>
+    /// <param name="batch">The news, which are moved away from here.</param>
+    void DDBAccess::PutNewsBatch(std::vector<PendingNewsPut> &batch)
+    {
+        auto puts = std::make_shared<std::vector<PendingNewsPut>>(std::move(batch));
+
+        try
+        {
+            // whatever fails, fails the news not acknowledged yet:
+            auto op = std::make_shared<AsyncOperation>(*this, CancellationCheck(),
+                [puts](std::exception_ptr error)
+                {
+                    for (auto &put : *puts)
+                    {
+                        string none;
+                        put.callback(none, error);
+                    }
+                }
+            );
+
+            WriteNewsBatch(op, puts, 0, m_retryPolicy.GetBaseDelay());
+        }
+        catch (...)
+        {
+            for (auto &put : *puts)
+            {
+                string none;
+                put.callback(none, std::current_exception());
+            }
+        }
+    }
+
+
+    /// <summary>
+    /// Puts news in a given topic. When batching is enabled, the news waits
+    /// for others posted at about the same time, to be written together.
+    /// </summary>
+    /// <param name="topic">The topic.</param>
+    /// <param name="userId">The ID of the user posting the news.</param>
+    /// <param name="news">The news.</param>
+    /// <param name="callback">Receives the sort key of the news in the topic.</param>
+    void DDBAccess::PutNewsAsync(const string &topic,
+                                 const string &userId,
+                                 const string &news,
+                                 const StringCallback &callback)
+    {
+        auto startTime = std::chrono::steady_clock::now();
+
+        StringCallback timedCallback = [this, startTime, callback](string &sortKey, std::exception_ptr error)
+        {
+            if (!error)
+                m_putBatcher.AddLatency(std::chrono::steady_clock::now() - startTime);
+
+            callback(sortKey, error);
+        };
+
+        try
+        {
+            // unique across instances, so the conditional put does not fail but for a bug:
+            auto sortKey = ToByteBuffer(NewsStore::MakeNewsKey());
+
+            uint32_t raiseTo;
+            auto partitionKey = TopicShards::GetPartitionKey(topic, m_topicShards.PickWriteShard(topic, raiseTo));
+
+            if (raiseTo > 0)
+                RaiseTopicShards(topic, raiseTo);
+
+            if (m_putBatcher.IsEnabled())
+            {
+                m_putBatcher.Add(PendingNewsPut{ partitionKey, ToString(sortKey), news, timedCallback });
+                return;
+            }
+
+            auto op = std::make_shared<AsyncOperation>(*this, CancellationCheck(),
+                [timedCallback](std::exception_ptr error) { string none; timedCallback(none, error); }
+            );
+
+            PutItemRequest putRequest;
+            putRequest
+                .WithTableName(DDB_TABNAME_NEWS_BY_TOPIC)
+                .WithConditionExpression("attribute_not_exists(" DDB_TABATTR_NBT_PK_TOPIC ")") // do insert, not replace
+                .AddItem(DDB_TABATTR_NBT_PK_TOPIC, AttributeValue(partitionKey))
+                .AddItem(DDB_TABATTR_NBT_SK_BINTB, AttributeValue().SetB(sortKey))
+                .AddItem(DDB_TABATTR_NBT_NEWS, AttributeValue(news));
+
+            PutItem("put news in database table "
+                    DDB_TABATTR_NBT_NEWS,
+                    op,
+                    std::move(putRequest),
+                    [op, sortKey, timedCallback](bool putDone)
+            {
+                if (!putDone)
+                {
+                    throw AppException("Failed to create new user on table " DDB_TABNAME_NEWS_BY_TOPIC,
+                                       "Record with same key already existed");
+                }
+
+                string key = ToString(sortKey);
+
+                if (op->Conclude())
+                    timedCallback(key, nullptr);
+            });
+        }
+        catch (...)
+        {
+            string none;
+            timedCallback(none, std::current_exception());
+        }
+    }
+
+
+    /// <summary>
+    /// Makes the request to update the last feed of a user, as
+    /// long as the user is still subscribing to the given topic.
+    /// </summary>
+    /// <param name="userId">The user ID.</param>
+    /// <param name="topic">The topic where the news were fed from.</param>
+    /// <param name="lastKey">The sort key of the last news fed to the user.</param>
+    /// <returns>The request.</returns>
+    static UpdateItemRequest MakeLastFeedTimeUpdate(const string &userId,
+                                                    const string &topic,
+                                                    const string &lastKey)
+    {
+        char strLFTime[21];
+        snprintf(strLFTime, sizeof strLFTime, "%lld",
+                 static_cast<long long> (NewsStore::GetNewsTime(lastKey)));
+
+        UpdateItemRequest updateRequest;
+        updateRequest
+            .WithTableName(DDB_TABNAME_TOPIC_BY_USER)
+            .AddKey(DDB_TABATTR_TBU_PK_USER, AttributeValue(userId))
+            .WithConditionExpression(DDB_TABATTR_TBU_TOPIC " = :topic")
+            .AddExpressionAttributeValues(":topic", AttributeValue(topic))
+            .WithUpdateExpression("SET " DDB_TABATTR_TBU_LFKEY " = :lfkey, " DDB_TABATTR_TBU_LFTIME " = :lftime")
+            .AddExpressionAttributeValues(":lfkey", AttributeValue().SetB(ToByteBuffer(lastKey)))
+            .AddExpressionAttributeValues(":lftime", AttributeValue().SetN(strLFTime));
+
+        return updateRequest;
+    }
+
+
+    /// <summary>
+    /// Warns that the last feed time of a user could not be updated
+    /// because the user is no longer subscribing to the topic.
+    /// </summary>
+    /// <param name="userId">The user ID.</param>
+    static void WarnLastFeedTimeNotUpdated(const string &userId)
+    {
+        std::clog << "WARNING - UPDATE operation on database was expected to update 'last feed time' of user '"
+                  << userId << "' on table " DDB_TABNAME_TOPIC_BY_USER
+                     ", but the record was found with an unexpected topic!" << std::endl;
+    }
+
+
+    /// <summary>
+    /// Gets how long it might take since the key of news is made until the news can
+    /// be read. The key is made when the news is posted, but the news is written
+    /// once its batch window closes, maybe after a few retries, each of which might
+    /// take as long as the timeout of the request. The clock of the instance that
+    /// made the key might be ahead, too. And eventually consistent reads might not
+    /// see the news for a little longer.
+    /// </summary>
+    /// <returns>The time (seconds).</returns>
+    static time_t GetNewsSettleSecs()
+    {
+        static const time_t settleSecs = []()
+        {
+            const auto &settings = Configuration::Get().settings;
+
+            uint64_t millisecs = settings.dbNewsPutBatchWindowMs
+                + (settings.dbReqMaxRetryCount + 1ULL) * settings.dbRequestTimeoutMs
+                + static_cast<uint64_t> (settings.dbReqMaxRetryCount) * settings.dbReqRetryMaxIntervalMs
+                + settings.dbMaxClockSkewMs;
+
+            if (!IsNewsReadConsistent())
+                millisecs += eventualSettleSecs * 1000;
+
+            return static_cast<time_t> ((millisecs + 999) / 1000);
+        }();
+
+        return settleSecs;
+    }
+
+
+    /// <summary>
+    /// Gets the key up to which the news are read, when the read moves a cursor
+    /// forward. News whose key has been made a short while ago might not be written
+    /// yet (or seen by the read) while later ones are, and the reader would move past
+    /// the missing ones, so the most recent news are left for a later read.
+    /// </summary>
+    /// <returns>The key of the last news that can be read.</returns>
+    static string GetSettledNewsKey()
+    {
+        return NewsStore::MakeNewsCursor(time(nullptr) - GetNewsSettleSecs());
+    }
+
+
+    /// <summary>
+    /// Sets the key condition of a query of news in a topic, up to a given key.
+    /// </summary>
+    /// <param name="request">The query.</param>
+    /// <param name="settledKey">The key of the last news to read,
+    /// as given by <see cref="GetSettledNewsKey"/>.</param>
+    static void SetNewsKeyCondition(QueryRequest &request, const string &settledKey)
+    {
+        request
+            .WithKeyConditionExpression(
+                DDB_TABATTR_NBT_PK_TOPIC " = :topic AND "
+                DDB_TABATTR_NBT_SK_BINTB " <= :settledsk"
+            )
+            .AddExpressionAttributeValues(":settledsk", AttributeValue().SetB(ToByteBuffer(settledKey)));
+    }
+
+
+    /// <summary>
+    /// Gets the news in the topic of a user since the last feed, page by page,
+    /// then moves the last feed of the user to the key of the last one (or keeps
+    /// it in memory, to be written behind). The query starts right after the key
+    /// of the last news fed, so no news is skipped nor delivered twice.
+    /// </summary>
+    /// <param name="userCache">The cache of user state, to be kept up to date.</param>
+    /// <param name="topicShards">What is known about the shards of the topics.</param>
+    /// <param name="op">The operation issuing the requests.</param>
+    /// <param name="userId">The ID of the user requesting the news.</param>
+    /// <param name="state">The state of the user.</param>
+    /// <param name="callback">Receives the news found since last feed, page by page.</param>
+    static void GetNewsSince(UserStateCache &userCache,
+                             TopicShards &topicShards,
+                             const AsyncOpPtr &op,
+                             const string &userId,
+                             const UserState &state,
+                             const DDBAccess::NewsPageCallback &callback)
+    {
+        const string &topic = state.topic;
+
+        if (topic.empty())
+        {
+            std::vector<NewsItem> none;
+
+            if (op->Conclude())
+                callback(none, true, nullptr);
 
-            currentTopic = iter->second.GetS();
             return;
         }
 
-        PutItemRequest putRequest;
-        putRequest
-            .WithTableName(DDB_TABNAME_TOPIC_BY_USER)
-            .WithConditionExpression("attribute_not_exists(" DDB_TABATTR_TBU_PK_USER ")") // do insert, not replace
-            .AddItem(DDB_TABATTR_TBU_PK_USER, AttributeValue(userId))
-            .AddItem(DDB_TABATTR_TBU_TOPIC, AttributeValue().SetNull(true))
-            .AddItem(DDB_TABATTR_TBU_LFTIME, AttributeValue().SetNull(true));
+        auto userCachePtr = &userCache;
+        auto lastKey = std::make_shared<string>(); // of the news found so far
 
-        bool putDone = PutItem("put new user into database table "
-                               DDB_TABNAME_TOPIC_BY_USER,
-                               conn.Get(),
-                               putRequest);
+        /* Hand over each page of news as it comes, and after the last one update
+           the last feed time: (runs in the thread that has found the news) */
 
-        if (!putDone)
+        auto onPage = [userCachePtr, op, userId, topic, lastKey, callback](std::vector<NewsItem> &news, bool isLastPage)
         {
-            throw AppException("Failed to create new user on table " DDB_TABNAME_TOPIC_BY_USER,
-                               "Record with same key already existed");
-        }
-    }
+            // nobody will receive the news? then do not move past them:
+            ThrowIfCancelled("get news from database table", op->GetCancellationCheck());
 
+            if (!news.empty())
+                *lastKey = news.back().sortKey;
 
-    /// <summary>
-    /// Updates the user.
-    /// </summary>
-    /// <param name="userId">The user identifier.</param>
-    /// <param name="topic">The topic.</param>
-    void DDBAccess::UpdateUser(const string &userId, const string &topic)
-    {
-        char strEpochTime[21];
-        snprintf(strEpochTime, sizeof strEpochTime, "%ld", time(nullptr));
+            if (!isLastPage)
+            {
+                callback(news, false, nullptr);
+                return;
+            }
 
-        UpdateItemRequest updateRequest;
-        updateRequest
-            .WithTableName(DDB_TABNAME_TOPIC_BY_USER)
-            .AddKey(DDB_TABATTR_TBU_PK_USER, AttributeValue(userId))
-            .AddAttributeUpdates(DDB_TABATTR_TBU_TOPIC,
-                AttributeValueUpdate()
-                    .WithAction(AttributeAction::PUT)
-                    .WithValue(!topic.empty() ? AttributeValue(topic) : AttributeValue().SetNull(true))
-            )
-            .AddAttributeUpdates(DDB_TABATTR_TBU_LFTIME,
-                AttributeValueUpdate()
-                    .WithAction(AttributeAction::PUT)
-                    .WithValue(AttributeValue().SetN(strEpochTime))
-            )
-            .WithReturnValues(ReturnValue::UPDATED_OLD);
+            if (lastKey->empty())
+            {
+                if (op->Conclude())
+                    callback(news, true, nullptr);
+
+                return;
+            }
 
-        AwsDdbItem oldUpdAttrs;
+            if (IsLastFeedWrittenBehind())
+            {
+                DDBAccess::GetInstance().CheckpointLastFeed(userId, topic, *lastKey);
 
-        auto conn = m_dbConnPool.Get();
+                if (op->Conclude())
+                    callback(news, true, nullptr);
 
-        bool updateDone = UpdateItem("update user data in table "
-                                     DDB_TABNAME_TOPIC_BY_USER,
-                                     conn.Get(),
-                                     updateRequest,
-                                     &oldUpdAttrs);
-        
-        /* no unsubscription has been carried out?
-           then we are done here: */
-        if (!updateDone || !topic.empty())
-            return;
+                return;
+            }
 
-        ///////////////////////////////////////////////////////////////
-        // Upon unsubscription, delete the news old enough to purge:
+            auto lastPage = std::make_shared<std::vector<NewsItem>>(std::move(news));
 
-        static const auto oldNewsPurgeAgeSecs = Configuration::Get().settings.dbOldNewsPurgeAgeSecs;
+            UpdateItem("update user data in table "
+                       DDB_TABNAME_TOPIC_BY_USER,
+                       op,
+                       MakeLastFeedTimeUpdate(userId, topic, *lastKey),
+                       [userCachePtr, op, userId, topic, lastKey, lastPage, callback](bool updateDone, AwsDdbItem &)
+            {
+                if (updateDone)
+                    userCachePtr->SetLastFeedKey(userId, topic, *lastKey);
+                else
+                {
+                    WarnLastFeedTimeNotUpdated(userId);
+                    userCachePtr->Remove(userId);
+                }
 
-        auto prevTopic = oldUpdAttrs[DDB_TABATTR_TBU_TOPIC].GetS();
+                if (op->Conclude())
+                    callback(*lastPage, true, nullptr);
+            });
+        };
 
-        QueryRequest queryRequest;
-        queryRequest
-            .WithTableName(DDB_TABNAME_NEWS_BY_TOPIC)
-            .WithKeyConditionExpression(
-                DDB_TABATTR_NBT_PK_TOPIC " = :topic AND "
-                DDB_TABATTR_NBT_SK_BINTB " < :bintbsk"
-            )
-            .AddExpressionAttributeValues(":topic", AttributeValue(prevTopic))
-            .AddExpressionAttributeValues(":bintbsk",
-                AttributeValue().SetB(
-                    MakeBinTimeBasedSortKey(time(nullptr) - oldNewsPurgeAgeSecs)
-                )
-            );
+        const string &cursor = state.lastFeedKey; // empty when never fed
 
-        Aws::Vector<AwsDdbItem> newsItems;
+        auto settledKey = GetSettledNewsKey();
 
-        QueryItems("get expired news from database table",
-                   conn.Get(),
-                   queryRequest,
-                   newsItems);
+        // nothing settled after the last feed? (the start key must be within the range of the query)
+        if (cursor >= settledKey)
+        {
+            std::vector<NewsItem> none;
+
+            if (op->Conclude())
+                callback(none, true, nullptr);
 
-        if (newsItems.empty())
             return;
+        }
 
-        Aws::Vector<WriteRequest> writeRequests(newsItems.size());
+        // recent news of the topic in memory? (only up to the last poll, which the cut below may narrow)
+        std::vector<NewsItem> cachedNews;
 
-        for (int idx = 0; idx < newsItems.size(); ++idx)
+        if (NewsCache::GetInstance().GetNewsAfter(topic, cursor, cachedNews))
         {
-            writeRequests[idx].WithDeleteRequest(
-                DeleteRequest()
-                    .AddKey(DDB_TABATTR_NBT_PK_TOPIC, AttributeValue(prevTopic))
-                    .AddKey(DDB_TABATTR_NBT_SK_BINTB, newsItems[idx][DDB_TABATTR_NBT_SK_BINTB])
+            cachedNews.erase(
+                std::upper_bound(cachedNews.begin(), cachedNews.end(), settledKey,
+                    [](const string &key, const NewsItem &item) { return key < item.sortKey; }
+                ),
+                cachedNews.end()
             );
+
+            try
+            {
+                onPage(cachedNews, true);
+            }
+            catch (...)
+            {
+                op->Fail(std::current_exception());
+            }
+
+            return;
         }
 
-        WriteItems("purge expired news from database",
-                   DDB_TABNAME_NEWS_BY_TOPIC,
-                   conn.Get(),
-                   writeRequests);
+        //////////////////
+        // Get the news:
+
+        QueryRequest queryRequest;
+        queryRequest
+            .WithTableName(DDB_TABNAME_NEWS_BY_TOPIC)
+            .WithProjectionExpression(DDB_TABATTR_NBT_SK_BINTB ", #news")
+            .AddExpressionAttributeNames("#news", DDB_TABATTR_NBT_NEWS)
+            .WithConsistentRead(IsNewsReadConsistent());
+
+        SetNewsKeyCondition(queryRequest, settledKey);
+
+        QueryTopicNews(topicShards,
+                       "get news from database table",
+                       op,
+                       topic,
+                       std::move(queryRequest),
+                       cursor,
+                       onPage);
     }
 
 
     /// <summary>
-    /// Puts news in a given topic.
+    /// Gets the news in a given topic.
     /// </summary>
-    /// <param name="topic">The topic.</param>
-    /// <param name="news">The news.</param>
-    void DDBAccess::PutNews(const string &topic,
-                            const string &userId,
-                            const string &news)
+    /// <param name="userId">The ID of the user requesting the news.</param>
+    /// <param name="callback">Receives the news found since last feed, one page after another,
+    /// as they arrive. An error or the last page (which might be empty) ends the calls.</param>
+    /// <param name="isCancelled">Tells whether the caller has given up (optional).
+    /// Once cancelled, the last feed time is left untouched, so the news are not lost.</param>
+    void DDBAccess::GetNewsAsync(const string &userId,
+                                 const NewsPageCallback &callback,
+                                 const CancellationCheck &isCancelled)
     {
-        PutItemRequest putRequest;
-        putRequest
-            .WithTableName(DDB_TABNAME_NEWS_BY_TOPIC)
-            .WithConditionExpression("attribute_not_exists(" DDB_TABATTR_NBT_PK_TOPIC ")") // do insert, not replace
-            .AddItem(DDB_TABATTR_NBT_PK_TOPIC, AttributeValue(topic))
-            .AddItem(DDB_TABATTR_NBT_SK_BINTB,
-                AttributeValue().SetB(
-                    MakeBinTimeBasedSortKey(time(nullptr), userId)
-                )
-            )
-            .AddItem(DDB_TABATTR_NBT_NEWS, AttributeValue(news));
+        try
+        {
+            auto op = std::make_shared<AsyncOperation>(*this, isCancelled,
+                [callback](std::exception_ptr error) { std::vector<NewsItem> none; callback(none, true, error); }
+            );
+
+            ///////////////////
+            // Get user info:
+
+            UserState state;
 
-        auto conn = m_dbConnPool.Get();
+            if (m_userCache.Get(userId, state))
+            {
+                GetNewsSince(m_userCache, m_topicShards, op, userId, state, callback);
+                return;
+            }
+
+            auto getRequest = MakeUserStateGet(userId);
+
+            GetItem("get user from database table "
+                    DDB_TABNAME_TOPIC_BY_USER,
+                    op,
+                    std::move(getRequest),
+                    [this, op, userId, callback](AwsDdbItem &userItem)
+            {
+                if (userItem.empty())
+                {
+                    std::ostringstream oss;
+                    oss << "User '" << userId << "' not found in database table " DDB_TABNAME_TOPIC_BY_USER << '!';
+                    throw AppException("Could not retrieve news for user topic!", oss.str());
+                }
 
-        bool putDone = PutItem("put news in database table "
-                               DDB_TABATTR_NBT_NEWS,
-                               conn.Get(),
-                               putRequest);
+                UserState state;
+                ParseUserItem(userId, userItem, state);
+                m_userCache.Put(userId, state);
 
-        if (!putDone)
+                GetNewsSince(m_userCache, m_topicShards, op, userId, state, callback);
+            });
+        }
+        catch (...)
         {
-            throw AppException("Failed to create new user on table " DDB_TABNAME_NEWS_BY_TOPIC,
-                               "Record with same key already existed");
+            std::vector<NewsItem> none;
+            callback(none, true, std::current_exception());
         }
     }
 
 
     /// <summary>
-    /// Gets the news in a given topic.
+    /// Gets the news posted in a topic after a given point.
     /// </summary>
-    /// <param name="userId">The ID of the user requesting the news.</param>
-    /// <param name="news">All the news found since last feed.</param>
-    void DDBAccess::GetNews(const string &userId, std::vector<string> &news)
+    /// <param name="topic">The topic.</param>
+    /// <param name="afterKey">The sort key of the last news already seen
+    /// in the topic, or a cursor made by <see cref="MakeNewsCursor"/>.</param>
+    /// <param name="callback">Receives the news found after the given key,
+    /// in the same order they have been posted.</param>
+    void DDBAccess::GetTopicNewsAsync(const string &topic,
+                                      const string &afterKey,
+                                      const NewsCallback &callback)
     {
-        news.clear();
+        try
+        {
+            auto op = std::make_shared<AsyncOperation>(*this, CancellationCheck(),
+                [callback](std::exception_ptr error) { std::vector<NewsItem> none; callback(none, error); }
+            );
 
-        ///////////////////
-        // Get user info:
+            QueryRequest queryRequest;
+            queryRequest
+                .WithTableName(DDB_TABNAME_NEWS_BY_TOPIC)
+                .WithProjectionExpression(DDB_TABATTR_NBT_SK_BINTB ", #news")
+                .AddExpressionAttributeNames("#news", DDB_TABATTR_NBT_NEWS)
+                .WithConsistentRead(IsNewsReadConsistent());
 
-        AwsDdbItem userItem;
+            auto settledKey = GetSettledNewsKey();
 
-        GetItemRequest getRequest;
-        getRequest
-            .WithTableName(DDB_TABNAME_TOPIC_BY_USER)
-            .AddKey(DDB_TABATTR_TBU_PK_USER, AttributeValue(userId))
-            .AddAttributesToGet(DDB_TABATTR_TBU_TOPIC)
-            .AddAttributesToGet(DDB_TABATTR_TBU_LFTIME);
+            // nothing settled after the key? (the start key must be within the range of the query)
+            if (afterKey >= settledKey)
+            {
+                std::vector<NewsItem> none;
+
+                if (op->Conclude())
+                    callback(none, nullptr);
+
+                return;
+            }
 
-        auto conn = m_dbConnPool.Get();
+            SetNewsKeyCondition(queryRequest, settledKey);
 
-        bool found = GetItem("get user from database table "
-                             DDB_TABNAME_TOPIC_BY_USER,
-                             conn.Get(),
-                             getRequest,
-                             userItem);
-        if (!found)
+            auto allNews = std::make_shared<std::vector<NewsItem>>();
+
+            QueryTopicNews(m_topicShards,
+                           "get news of topic from database table",
+                           op,
+                           topic,
+                           std::move(queryRequest),
+                           afterKey,
+                           [op, allNews, callback](std::vector<NewsItem> &news, bool isLastPage)
+            {
+                if (allNews->empty())
+                    allNews->swap(news);
+                else
+                    std::move(news.begin(), news.end(), std::back_inserter(*allNews));
+
+                if (isLastPage && op->Conclude())
+                    callback(*allNews, nullptr);
+            });
+        }
+        catch (...)
         {
-            std::ostringstream oss;
-            oss << "User '" << userId << "' not found in database table " DDB_TABNAME_TOPIC_BY_USER << '!';
-            throw AppException("Could not retrieve news for user topic!", oss.str());
+            std::vector<NewsItem> none;
+            callback(none, std::current_exception());
         }
+    }
 
-        auto iter = userItem.find(DDB_TABATTR_TBU_TOPIC);
 
-        if (iter == userItem.end())
+    /// <summary>
+    /// Updates the last feed time of a user, as long as
+    /// the user is still subscribing to the given topic.
+    /// </summary>
+    /// <param name="userId">The user ID.</param>
+    /// <param name="topic">The topic where the news were fed from.</param>
+    /// <param name="lastKey">The sort key of the last news fed to the user.</param>
+    /// <param name="callback">Tells when the update is over.</param>
+    void DDBAccess::SetLastFeedTimeAsync(const string &userId,
+                                         const string &topic,
+                                         const string &lastKey,
+                                         const Callback &callback)
+    {
+        try
         {
-            std::ostringstream oss;
-            oss << "Could not find attribute " DDB_TABATTR_TBU_TOPIC
-                   " in item retrieved from table " DDB_TABNAME_TOPIC_BY_USER
-                   " for user '" << userId << '\'';
+            DiscardCheckpoint(userId, topic, lastKey);
 
-            throw AppException("Cannot recognize schema of user data item!", oss.str());
+            auto op = std::make_shared<AsyncOperation>(*this, CancellationCheck(), callback);
+
+            UpdateItem("update user data in table "
+                       DDB_TABNAME_TOPIC_BY_USER,
+                       op,
+                       MakeLastFeedTimeUpdate(userId, topic, lastKey),
+                       [this, op, userId, topic, lastKey, callback](bool updateDone, AwsDdbItem &)
+            {
+                if (updateDone)
+                    m_userCache.SetLastFeedKey(userId, topic, lastKey);
+                else
+                {
+                    WarnLastFeedTimeNotUpdated(userId);
+                    m_userCache.Remove(userId);
+                }
+
+                if (op->Conclude())
+                    callback(nullptr);
+            });
+        }
+        catch (...)
+        {
+            callback(std::current_exception());
         }
+    }
 
-        string topic = iter->second.GetS();
 
-        if (topic.empty())
+    /// <summary>
+    /// Keeps in memory the last feed of a user, to be written behind, unless
+    /// the last feed time is written at the end of every retrieval of news.
+    /// </summary>
+    /// <param name="userId">The user ID.</param>
+    /// <param name="topic">The topic where the news were fed from.</param>
+    /// <param name="lastKey">The sort key of the last news fed to the user.</param>
+    void DDBAccess::CheckpointLastFeed(const string &userId,
+                                       const string &topic,
+                                       const string &lastKey)
+    {
+        if (!IsLastFeedWrittenBehind())
             return;
 
-        iter = userItem.find(DDB_TABATTR_TBU_LFTIME);
-
-        if (iter == userItem.end())
         {
-            std::ostringstream oss;
-            oss << "Could not find attribute " DDB_TABATTR_TBU_LFTIME
-                   " in item retrieved from table " DDB_TABNAME_TOPIC_BY_USER
-                   " for user '" << userId << '\'';
+            std::lock_guard<std::mutex> lock(m_checkpointsMutex);
 
-            throw AppException("Cannot recognize schema of user data item!", oss.str());
+            auto result = m_checkpoints.emplace(userId, FeedCheckpoint());
+            auto &checkpoint = result.first->second;
+
+            if (result.second)
+            {
+                checkpoint.since = std::chrono::steady_clock::now();
+                m_checkpointOrder.emplace_back(userId, checkpoint.since);
+            }
+            else if (checkpoint.topic == topic && checkpoint.lastKey >= lastKey)
+                return;
+
+            checkpoint.topic = topic;
+            checkpoint.lastKey = lastKey;
         }
 
-        time_t lastFeedTime;
+        m_userCache.SetLastFeedKey(userId, topic, lastKey);
+    }
 
-        if (!iter->second.GetN().empty())
-            lastFeedTime = strtoll(iter->second.GetN().c_str(), nullptr, 10);
-        else
-            lastFeedTime = std::numeric_limits<time_t>::min();
 
-        //////////////////
-        // Get the news:
+    /// <summary>
+    /// Forgets the last feed of a user kept in memory,
+    /// because a later one is being written.
+    /// </summary>
+    /// <param name="userId">The user ID.</param>
+    /// <param name="topic">The topic where the news were fed from.</param>
+    /// <param name="lastKey">The sort key of the last news fed to the user.</param>
+    void DDBAccess::DiscardCheckpoint(const string &userId,
+                                      const string &topic,
+                                      const string &lastKey)
+    {
+        std::lock_guard<std::mutex> lock(m_checkpointsMutex);
 
-        QueryRequest queryRequest;
-        queryRequest
-            .WithTableName(DDB_TABNAME_NEWS_BY_TOPIC)
-            .WithKeyConditionExpression(
-                DDB_TABATTR_NBT_PK_TOPIC " = :topic AND "
-                DDB_TABATTR_NBT_SK_BINTB " >= :bintbsk"
-            )
-            .AddExpressionAttributeValues(":topic", AttributeValue(topic))
-            .AddExpressionAttributeValues(":bintbsk",
-                AttributeValue().SetB(
-                    MakeBinTimeBasedSortKey(lastFeedTime + 1)
-                )
-            );
+        auto iter = m_checkpoints.find(userId);
 
-        Aws::Vector<AwsDdbItem> newsItems;
+        if (iter != m_checkpoints.end()
+            && iter->second.topic == topic
+            && iter->second.lastKey <= lastKey)
+        {
+            m_checkpoints.erase(iter);
+        }
+    }
 
-        QueryItems("get news from database table",
-                   conn.Get(),
-                   queryRequest,
-                   newsItems);
 
-        if (newsItems.empty())
-            return;
+    /// <summary>
+    /// Writes the last feed of the users kept in memory, oldest first. Each one is an
+    /// update conditioned on the topic of the user, which a batch write cannot carry,
+    /// but only the latest feed of each user is written, however many came before.
+    /// A last feed waits for the checkpoint interval, then for a token of the write
+    /// capacity given to checkpoints, so a crowd of users catching up at once does not
+    /// throttle the other writes in the table: the excess just waits longer in memory.
+    /// </summary>
+    /// <param name="all">Whether to write them all now, regardless of interval and capacity.</param>
+    void DDBAccess::FlushCheckpoints(bool all)
+    {
+        static const std::chrono::seconds interval(Configuration::Get().settings.dbFeedCheckpointSecs);
 
-        news.reserve(newsItems.size());
+        std::vector<std::pair<string, FeedCheckpoint>> checkpoints;
 
-        for (auto &entry : newsItems)
         {
-            iter = entry.find(DDB_TABATTR_NBT_SK_BINTB);
+            std::lock_guard<std::mutex> lock(m_checkpointsMutex);
 
-            if (iter == userItem.end())
+            auto now = std::chrono::steady_clock::now();
+            m_checkpointUnits = std::min(m_checkpointUnits + m_checkpointUnitsPerSec
+                                         * std::chrono::duration<double>(now - m_lastCheckpointRefill).count(),
+                                         m_maxCheckpointUnits);
+            m_lastCheckpointRefill = now;
+
+            while (!m_checkpointOrder.empty())
             {
-                std::ostringstream oss;
-                oss << "Could not find attribute " DDB_TABATTR_NBT_SK_BINTB
-                       " in item retrieved from table " DDB_TABNAME_NEWS_BY_TOPIC
-                       " for topic '" << topic << '\'';
+                auto &oldest = m_checkpointOrder.front();
+                auto iter = m_checkpoints.find(oldest.first);
 
-                throw AppException("Cannot recognize schema of news item!", oss.str());
+                // unless already written or discarded since then:
+                if (iter != m_checkpoints.end() && iter->second.since == oldest.second)
+                {
+                    if (!all && (oldest.second + interval > now || m_checkpointUnits < 1.0))
+                        break;
+
+                    checkpoints.emplace_back(*iter);
+                    m_checkpoints.erase(iter);
+                    m_checkpointUnits -= 1.0;
+                }
+
+                m_checkpointOrder.pop_front();
             }
+        }
 
-            time_t lftime = GetTimeFromSortKey(iter->second.GetB());
+        for (auto &entry : checkpoints)
+        {
+            SetLastFeedTimeAsync(entry.first, entry.second.topic, entry.second.lastKey, [](std::exception_ptr error)
+            {
+                if (!error)
+                    return;
 
-            // get the latest feed time:
-            if (lftime >= lastFeedTime)
-                lastFeedTime = lftime;
+                try
+                {
+                    std::rethrow_exception(error);
+                }
+                catch (AppException &ex)
+                {
+                    std::cerr << "ERROR - " << ex.what() << " - " << ex.GetDetails() << std::endl;
+                }
+                catch (std::exception &ex)
+                {
+                    std::cerr << "ERROR - Generic failure when saving last feed time - " << ex.what() << std::endl;
+                }
+            });
+        }
+    }
 
-            iter = entry.find(DDB_TABATTR_NBT_NEWS);
 
-            if (iter == userItem.end())
-            {
-                std::ostringstream oss;
-                oss << "Could not find attribute " DDB_TABATTR_NBT_NEWS
-                       " in item retrieved from table " DDB_TABNAME_NEWS_BY_TOPIC
-                       " for topic '" << topic << '\'';
+    /// <summary>
+    /// Raises the shards of a hot topic in the item that keeps their count, unless
+    /// already raised as much by another instance. The new shards are written once
+    /// every instance has had the time to refresh the count, so their reads see them.
+    /// This does not wait for the update to complete.
+    /// </summary>
+    /// <param name="topic">The topic.</param>
+    /// <param name="shardCount">The new count of shards.</param>
+    void DDBAccess::RaiseTopicShards(const string &topic, uint32_t shardCount)
+    {
+        try
+        {
+            auto op = std::make_shared<AsyncOperation>(*this, CancellationCheck(),
+                [this, topic](std::exception_ptr error)
+                {
+                    m_topicShards.EndRaise(topic);
+
+                    try
+                    {
+                        std::rethrow_exception(error);
+                    }
+                    catch (AppException &ex)
+                    {
+                        std::cerr << "ERROR - " << ex.what() << " - " << ex.GetDetails() << std::endl;
+                    }
+                    catch (std::exception &ex)
+                    {
+                        std::cerr << "ERROR - Generic failure when raising shards of topic - " << ex.what() << std::endl;
+                    }
+                }
+            );
 
-                throw AppException("Cannot recognize schema of news item!", oss.str());
-            }
+            auto activeFrom = time(nullptr) + m_topicShards.GetRefreshInterval().count() + 1;
+
+            char strShardCount[11];
+            snprintf(strShardCount, sizeof strShardCount, "%u", shardCount);
+
+            char strActiveFrom[21];
+            snprintf(strActiveFrom, sizeof strActiveFrom, "%lld", static_cast<long long> (activeFrom));
+
+            UpdateItemRequest updateRequest;
+            updateRequest
+                .WithTableName(DDB_TABNAME_NEWS_BY_TOPIC)
+                .AddKey(DDB_TABATTR_NBT_PK_TOPIC, AttributeValue(topic))
+                .AddKey(DDB_TABATTR_NBT_SK_BINTB, AttributeValue().SetB(ToByteBuffer(shardMarkerKey)))
+                .WithConditionExpression("attribute_not_exists(" DDB_TABATTR_NBT_SHARDS ") OR "
+                                         DDB_TABATTR_NBT_SHARDS " < :shards")
+                .WithUpdateExpression("SET " DDB_TABATTR_NBT_SHARDS " = :shards, "
+                                      DDB_TABATTR_NBT_SHARDS_AT " = :activefrom")
+                .AddExpressionAttributeValues(":shards", AttributeValue().SetN(strShardCount))
+                .AddExpressionAttributeValues(":activefrom", AttributeValue().SetN(strActiveFrom));
+
+            UpdateItem("raise shards of topic in database table "
+                       DDB_TABNAME_NEWS_BY_TOPIC,
+                       op,
+                       std::move(updateRequest),
+                       [this, op, topic, shardCount, activeFrom](bool updateDone, AwsDdbItem &)
+            {
+                // raised even further by another instance? then learn how much:
+                if (updateDone)
+                    m_topicShards.SetShardCount(topic, shardCount, activeFrom);
+                else
+                    m_topicShards.Invalidate(topic);
 
-            news.push_back(iter->second.GetS());
+                m_topicShards.EndRaise(topic);
+                op->Conclude();
+            });
         }
+        catch (AppException &ex)
+        {
+            m_topicShards.EndRaise(topic);
+            std::cerr << "ERROR - " << ex.what() << " - " << ex.GetDetails() << std::endl;
+        }
+    }
 
-        ///////////////////////////
-        // Update last feed time:
-        
-        char strLFTime[21];
-        snprintf(strLFTime, sizeof strLFTime, "%ld", lastFeedTime);
 
-        UpdateItemRequest updateRequest;
-        updateRequest
-            .WithTableName(DDB_TABNAME_TOPIC_BY_USER)
-            .AddKey(DDB_TABATTR_TBU_PK_USER, AttributeValue(userId))
-            .WithConditionExpression(DDB_TABATTR_TBU_TOPIC " = :topic")
+    /// <summary>
+    /// Scans the keys of every news in the database, page by page.
+    /// The pages are handed over in the calling thread.
+    /// </summary>
+    /// <param name="onPage">Receives the keys of each page, and returns whether to go on.</param>
+    void DDBAccess::ScanNewsKeys(const KeyPageCallback &onPage)
+    {
+        typedef AsyncRequest<ScanRequest, ScanOutcome> Request;
+
+        ScanRequest scanRequest;
+        scanRequest
+            .WithTableName(DDB_TABNAME_NEWS_BY_TOPIC)
+            .WithProjectionExpression(DDB_TABATTR_NBT_PK_TOPIC ", " DDB_TABATTR_NBT_SK_BINTB)
+            .WithConsistentRead(false);
+
+        ReadNewsKeys<ScanRequest, ScanOutcome>(*this,
+            "scan news keys in database table " DDB_TABNAME_NEWS_BY_TOPIC,
+            "SCAN",
+            scanRequest,
+            [](DbConnection *conn, const ScanRequest &request, const Request::Handler &handler)
+            {
+                conn->ScanAsync(request, handler);
+            },
+            onPage
+        );
+    }
+
+
+    /// <summary>
+    /// Gets the keys of the news in a shard of a topic, from the oldest on, page
+    /// by page. The pages are handed over in the calling thread.
+    /// </summary>
+    /// <param name="topic">The partition key of the shard.</param>
+    /// <param name="onPage">Receives the keys of each page, and returns whether to go on.</param>
+    void DDBAccess::GetOldestNewsKeys(const string &topic,
+                                      const KeyPageCallback &onPage)
+    {
+        typedef AsyncRequest<QueryRequest, QueryOutcome> Request;
+
+        QueryRequest queryRequest;
+        queryRequest
+            .WithTableName(DDB_TABNAME_NEWS_BY_TOPIC)
+            .WithKeyConditionExpression(DDB_TABATTR_NBT_PK_TOPIC " = :topic")
             .AddExpressionAttributeValues(":topic", AttributeValue(topic))
-            .WithUpdateExpression("SET " DDB_TABATTR_TBU_LFTIME " = :lftime")
-            .AddExpressionAttributeValues(":lftime", AttributeValue().SetN(strLFTime));
+            .WithProjectionExpression(DDB_TABATTR_NBT_PK_TOPIC ", " DDB_TABATTR_NBT_SK_BINTB)
+            .WithScanIndexForward(true)
+            .WithConsistentRead(false)
+            .AddExclusiveStartKey(DDB_TABATTR_NBT_PK_TOPIC, AttributeValue(topic))
+            .AddExclusiveStartKey(DDB_TABATTR_NBT_SK_BINTB, AttributeValue().SetB(ToByteBuffer(shardMarkerKey)));
+
+        ReadNewsKeys<QueryRequest, QueryOutcome>(*this,
+            "get oldest news keys from database table " DDB_TABNAME_NEWS_BY_TOPIC,
+            "QUERY",
+            queryRequest,
+            [](DbConnection *conn, const QueryRequest &request, const Request::Handler &handler)
+            {
+                conn->QueryAsync(request, handler);
+            },
+            onPage
+        );
+    }
+
+
+    /// <summary>
+    /// Deletes news from the database. The items left unprocessed for lack of
+    /// write capacity are resubmitted with backoff.
+    /// </summary>
+    /// <param name="keys">The keys of the news to delete.</param>
+    /// <param name="callback">Tells when the news have been deleted.</param>
+    void DDBAccess::DeleteNewsAsync(const std::vector<NewsKey> &keys, const Callback &callback)
+    {
+        try
+        {
+            auto op = std::make_shared<AsyncOperation>(*this, CancellationCheck(), callback);
+
+            auto writeRequests = std::make_shared<Aws::Vector<WriteRequest>>(keys.size());
+
+            for (size_t idx = 0; idx < keys.size(); ++idx)
+            {
+                (*writeRequests)[idx].WithDeleteRequest(
+                    DeleteRequest()
+                        .AddKey(DDB_TABATTR_NBT_PK_TOPIC, AttributeValue(keys[idx].topic))
+                        .AddKey(DDB_TABATTR_NBT_SK_BINTB, AttributeValue().SetB(ToByteBuffer(keys[idx].sortKey)))
+                );
+            }
 
-        bool updateDone = UpdateItem("update user data in table "
-                                     DDB_TABNAME_TOPIC_BY_USER,
-                                     conn.Get(),
-                                     updateRequest,
-                                     nullptr);
-        if (!updateDone)
+            WriteItems("purge expired news from database",
+                       DDB_TABNAME_NEWS_BY_TOPIC,
+                       op,
+                       writeRequests, 0, 0,
+                       [op, callback]()
+            {
+                if (op->Conclude())
+                    callback(nullptr);
+            });
+        }
+        catch (...)
         {
-            std::clog << "WARNING - UPDATE operation on database was expected to update 'last feed time' of user '"
-                         DDB_TABATTR_TBU_PK_USER "' on table " DDB_TABNAME_TOPIC_BY_USER
-                         ", but the record was found with an unexpected topic!" << std::endl;
+            callback(std::current_exception());
         }
     }
 
+
+    /// <summary>
+    /// Gets how long news might take to be read since their key was made.
+    /// The news are only read (by the polls and the catch-ups) once settled.
+    /// </summary>
+    /// <returns>The time (seconds).</returns>
+    time_t DDBAccess::GetSettleSecs()
+    {
+        return GetNewsSettleSecs();
+    }
+
 }// end of namespace newsfeed
@@ -1,22 +1,65 @@
 #include "DbConnPool.h"
 #include "configuration.h"
 #include "common.h"
-#include <cmath>
-#include <aws/core/auth/AWSCredentialsProvider.h>
+#include <algorithm>
+#include <cassert>
+#include <sstream>
+#include <future>
+#include <aws/core/auth/AWSCredentialsProviderChain.h>
+#include <aws/core/client/DefaultRetryStrategy.h>
+#include <aws/dynamodb/model/DescribeTableRequest.h>
+#include <aws/dynamodb/model/DescribeTableResult.h>
+#include <aws/core/utils/Outcome.h>
 
 namespace newsfeed
 {
+    using namespace std::chrono;
+
+
     /// <summary>
-    /// Initializes a new instance of the <see cref="DbConnPool"/> class.
+    /// Initializes a new instance of the <see cref="DbConnPool"/> class,
+    /// which sets up the configuration shared by all clients. Clients are
+    /// only created upon demand, unless the pool is warmed up.
     /// </summary>
     DbConnPool::DbConnPool()
-        : m_connections(256)
-        , m_poolCtionTime(time(nullptr))
-        , m_lastAddTime(0)
-        , m_totalConnsCount(0)
-        , m_activeConnsCount(0)
-        , m_twAvgNumActConns(0)
-    {}
+        : m_creatingCount(0)
+    {
+        const auto &settings = Configuration::Get().settings;
+
+        m_maxClientsCount = std::max(settings.dbConnPoolMaxClients, 1U);
+        m_minClientsCount = std::min(settings.dbConnPoolMinClients, m_maxClientsCount);
+        m_maxBorrowersPerClient = std::max(settings.dbClientMaxConnections, 1U);
+        m_maxIdleTime = seconds(settings.dbConnPoolIdleSecs);
+
+        m_executor = Aws::MakeShared<Aws::Utils::Threading::PooledThreadExecutor>("ALLOC_TAG",
+            std::max(settings.dbAsyncThreadCount, 1U)
+        );
+
+        /* No keys defined in configuration file? Then assume that access will be
+        granted by a role associated to the EC2 instance running this application: */
+
+        if (settings.awsAccessKeyId.empty() && settings.awsSecretKey.empty())
+        {
+            m_credentialsProvider = Aws::MakeShared<Aws::Auth::DefaultAWSCredentialsProviderChain>("ALLOC_TAG");
+        }
+        else
+        {
+            m_credentialsProvider = Aws::MakeShared<Aws::Auth::SimpleAWSCredentialsProvider>("ALLOC_TAG",
+                settings.awsAccessKeyId.c_str(), settings.awsSecretKey.c_str()
+            );
+        }
+
+        m_clientConfig.region = settings.awsRegion;
+        m_clientConfig.executor = m_executor;
+        m_clientConfig.maxConnections = m_maxBorrowersPerClient;
+        m_clientConfig.connectTimeoutMs = settings.dbConnectTimeoutMs;
+        m_clientConfig.requestTimeoutMs = settings.dbRequestTimeoutMs;
+
+        // retries are up to the data access layer, which has them share a budget:
+        m_clientConfig.retryStrategy = Aws::MakeShared<Aws::Client::DefaultRetryStrategy>("ALLOC_TAG", 0);
+
+        m_clients.reserve(m_maxClientsCount);
+    }
 
 
     /// <summary>
@@ -24,108 +67,152 @@ namespace newsfeed
     /// </summary>
     DbConnPool::~DbConnPool()
     {
-        m_connections.consume_all([](DbConnection *conn) { Aws::Delete<DbConnection>(conn); });
+        for (auto &client : m_clients)
+            Aws::Delete(client.connection);
     }
 
 
     /// <summary>
-    /// Increments the stats after delivering a connection.
+    /// Creates a new connection.
     /// </summary>
-    /// <param name="isNew">Whether a new connection will be created.</param>
-    void DbConnPool::IncrementStats(bool isNew)
+    /// <returns>The database connection.</returns>
+    DbConnection *DbConnPool::CreateConnection()
     {
-        time_t now = time(nullptr);
-
-        // acquire semantics
-        auto activeConnsCount = m_activeConnsCount.fetch_add(1, std::memory_order_acquire);
-
-        // update time-weighted average number of active connections:
-        m_twAvgNumActConns = static_cast<float> (
-            m_twAvgNumActConns
-            * (m_lastAddTime - m_poolCtionTime)
-            + activeConnsCount
-            * (now - m_lastAddTime)
-        ) / (now - m_poolCtionTime);
-
-        m_lastAddTime = now;
-
-        // release semantics
-        m_totalConnsCount.fetch_add(1, std::memory_order_release);
+        return Aws::New<DbConnection>("ALLOC_TAG", m_credentialsProvider, m_clientConfig);
     }
-    
+
 
     /// <summary>
-    /// Gets a connection from the pool.
+    /// Creates the minimum amount of clients, in parallel, and has each of them
+    /// describe the given tables, so credentials are resolved and connections
+    /// to the database are open before the first request needs them.
     /// </summary>
-    /// <returns>A database connection.</returns>
-    DbConnPool::ConnWrapper DbConnPool::Get()
+    /// <param name="tables">The tables to describe.</param>
+    void DbConnPool::WarmUp(const std::vector<const char *> &tables)
     {
-        DbConnection *conn;
-        
-        if (m_connections.pop(conn))
+        std::vector<std::future<DbConnection *>> futures;
+
+        for (uint32_t idx = 0; idx < m_minClientsCount; ++idx)
+        {
+            futures.push_back(std::async(std::launch::async, [this, &tables]()
+            {
+                auto conn = CreateConnection();
+
+                for (auto table : tables)
+                {
+                    auto outcome = conn->DescribeTable(
+                        Aws::DynamoDB::Model::DescribeTableRequest().WithTableName(table)
+                    );
+
+                    if (!outcome.IsSuccess())
+                    {
+                        Aws::Delete(conn);
+
+                        std::ostringstream oss;
+                        oss << "Failed to describe table " << table;
+                        throw AppException(oss.str(), outcome.GetError().GetMessage());
+                    }
+                }
+
+                return conn;
+            }));
+        }
+
+        std::exception_ptr error;
+
+        for (auto &future : futures)
         {
-            IncrementStats(false);
-            return ConnWrapper(*this, conn);
+            try
+            {
+                auto conn = future.get();
+
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_clients.push_back(PooledClient{ conn, 0, steady_clock::now() });
+            }
+            catch (...)
+            {
+                if (!error)
+                    error = std::current_exception();
+            }
         }
 
-        IncrementStats(true);
+        if (error)
+            std::rethrow_exception(error);
+    }
 
-        Aws::Client::ClientConfiguration config;
-        config.region = Configuration::Get().settings.awsRegion;
 
-        const auto &awsAccessKeyId = Configuration::Get().settings.awsAccessKeyId;
-        const auto &awsSecretKey = Configuration::Get().settings.awsSecretKey;
+    /// <summary>
+    /// Takes from the pool the clients idle for too long, as long as
+    /// the minimum amount remains. The lock must be held by the caller.
+    /// </summary>
+    /// <param name="evicted">Receives the evicted clients, to delete outside the lock.</param>
+    void DbConnPool::EvictIdle(std::vector<DbConnection *> &evicted)
+    {
+        auto oldest = steady_clock::now() - m_maxIdleTime;
 
-        /* No keys defined in configuration file? Then assume that access will be
-        granted by a role associated to the EC2 instance running this application: */
+        size_t idx(0);
 
-        if (awsAccessKeyId.empty() && awsSecretKey.empty())
+        while (idx < m_clients.size() && m_clients.size() > m_minClientsCount)
         {
-            conn = Aws::New<DbConnection>("ALLOC_TAG", Aws::DynamoDB::DynamoDBClient(config));
+            auto &client = m_clients[idx];
+
+            if (client.borrowersCount == 0 && client.idleSince < oldest)
+            {
+                evicted.push_back(client.connection);
+                m_clients.erase(m_clients.begin() + idx);
+            }
+            else
+                ++idx;
         }
-        else
-        {
-            conn = Aws::New<DbConnection>("ALLOC_TAG",
-                Aws::DynamoDB::DynamoDBClient(Aws::Auth::AWSCredentials(awsAccessKeyId, awsSecretKey), config)
-            );
-        }
-
-        return ConnWrapper(*this, conn);
     }
 
 
     /// <summary>
-    /// Decrements the stats after receiving back a connection.
+    /// Gets a connection from the pool, which is the least busy client,
+    /// unless all of them are busy and the maximum allows for a new one.
     /// </summary>
-    /// <param name="discard">Set to <c>true</c> whenever
-    /// the update on stats indicates the returned connection
-    /// should be deleted rather than kept on the pool.</param>
-    void DbConnPool::DecrementStats(bool &discard)
+    /// <returns>A database connection.</returns>
+    DbConnPool::ConnWrapper DbConnPool::Get()
     {
-        time_t now = time(nullptr);
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        auto iter = std::min_element(m_clients.begin(), m_clients.end(),
+            [](const PooledClient &a, const PooledClient &b)
+            {
+                return a.borrowersCount < b.borrowersCount;
+            }
+        );
 
-        auto activeConnsCount = m_activeConnsCount.fetch_sub(1, std::memory_order_acquire);
+        bool canCreate = (m_clients.size() + m_creatingCount < m_maxClientsCount);
+
+        if (iter != m_clients.end() && (iter->borrowersCount < m_maxBorrowersPerClient || !canCreate))
+        {
+            ++iter->borrowersCount;
+            return ConnWrapper(*this, iter->connection);
+        }
 
-        // update time-weighted average number of active connections:
-        m_twAvgNumActConns = static_cast<float> (
-            m_twAvgNumActConns
-            * (m_lastAddTime - m_poolCtionTime)
-            + activeConnsCount
-            * (now - m_lastAddTime)
-        ) / (now - m_poolCtionTime);
+        // create the client outside the lock:
+        ++m_creatingCount;
+        lock.unlock();
 
-        m_lastAddTime = now;
+        DbConnection *conn;
 
-        if (m_totalConnsCount > static_cast<uint32_t> (1.2F * m_twAvgNumActConns + 0.5))
+        try
         {
-            discard = true;
-            m_totalConnsCount.fetch_sub(1, std::memory_order_release); // release semantics
+            conn = CreateConnection();
         }
-        else
+        catch (...)
         {
-            discard = false;
-            atomic_thread_fence(std::memory_order_release); // release semantics
+            lock.lock();
+            --m_creatingCount;
+            throw;
         }
+
+        lock.lock();
+        --m_creatingCount;
+        m_clients.push_back(PooledClient{ conn, 1, steady_clock::now() });
+
+        return ConnWrapper(*this, conn);
     }
 
 
@@ -137,17 +224,26 @@ namespace newsfeed
     {
         assert(conn != nullptr);
 
-        bool discard;
-        DecrementStats(discard);
+        std::vector<DbConnection *> evicted;
 
-        if (discard)
         {
-            Aws::Delete(conn);
-            return;
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            auto iter = std::find_if(m_clients.begin(), m_clients.end(),
+                [conn](const PooledClient &client) { return client.connection == conn; }
+            );
+
+            if (iter == m_clients.end())
+                throw AppException("Failed to return database connection back to the pool!");
+
+            if (--iter->borrowersCount == 0)
+                iter->idleSince = steady_clock::now();
+
+            EvictIdle(evicted);
         }
 
-        if (!m_connections.push(conn))
-            throw AppException("Failed to return database connection back to the pool!");
+        for (auto evictedConn : evicted)
+            Aws::Delete(evictedConn);
     }
 
 }// end of namespace newsfeed
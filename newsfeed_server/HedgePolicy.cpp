@@ -0,0 +1,148 @@
+#include "HedgePolicy.h"
+#include "configuration.h"
+#include <algorithm>
+#include <iostream>
+#include <limits>
+
+namespace newsfeed
+{
+    using namespace std::chrono;
+
+    // how many of the latest samples make the percentile
+    static const size_t maxLatencySamples(1000);
+
+    // how many new samples before the percentile is updated
+    static const uint32_t samplesPerUpdate(100);
+
+
+    /// <summary>
+    /// Initializes a new instance of the <see cref="HedgePolicy"/> class.
+    /// </summary>
+    HedgePolicy::HedgePolicy()
+        : m_nextSampleIdx(0)
+        , m_samplesSinceUpdate(0)
+        , m_delay(microseconds::max())
+        , m_readCount(0)
+        , m_hedgeCount(0)
+        , m_hedgeWonCount(0)
+        , m_lastReportedCount(0)
+    {
+        const auto &settings = Configuration::Get().settings;
+
+        m_percentile = std::min(settings.dbReadHedgePercentile, 99U);
+        m_tokensPerRead = settings.dbReadHedgeMaxPct / 100.0;
+        m_maxTokens = 10.0;
+        m_tokens = 0.0;
+
+        m_latencies.reserve(maxLatencySamples);
+    }
+
+
+    /// <summary>
+    /// Accounts for a read issued, which adds to the budget of hedges.
+    /// </summary>
+    void HedgePolicy::OnRead()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_readCount;
+        m_tokens = std::min(m_tokens + m_tokensPerRead, m_maxTokens);
+    }
+
+
+    /// <summary>
+    /// Adds a sample of how long a read took to complete.
+    /// </summary>
+    /// <param name="latency">The latency.</param>
+    void HedgePolicy::AddLatency(steady_clock::duration latency)
+    {
+        auto sample = static_cast<uint32_t> (
+            std::min<microseconds::rep>(duration_cast<microseconds>(latency).count(),
+                                        std::numeric_limits<uint32_t>::max())
+        );
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_latencies.size() < maxLatencySamples)
+            m_latencies.push_back(sample);
+        else
+            m_latencies[m_nextSampleIdx] = sample;
+
+        m_nextSampleIdx = (m_nextSampleIdx + 1) % maxLatencySamples;
+
+        if (++m_samplesSinceUpdate < samplesPerUpdate)
+            return;
+
+        m_samplesSinceUpdate = 0;
+
+        auto samples = m_latencies;
+        auto nth = samples.begin() + samples.size() * m_percentile / 100;
+        std::nth_element(samples.begin(), nth, samples.end());
+        m_delay = microseconds(*nth);
+    }
+
+
+    /// <summary>
+    /// Gets how long to wait for a read before hedging it.
+    /// </summary>
+    /// <param name="delay">Receives the delay.</param>
+    /// <returns>Whether there are enough samples for the delay to be known.</returns>
+    bool HedgePolicy::GetDelay(microseconds &delay)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_delay == microseconds::max())
+            return false;
+
+        delay = m_delay;
+        return true;
+    }
+
+
+    /// <summary>
+    /// Tries to spend the budget on a hedge.
+    /// </summary>
+    /// <returns>Whether the hedge is allowed by the budget.</returns>
+    bool HedgePolicy::TryHedge()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_tokens < 1.0)
+            return false;
+
+        m_tokens -= 1.0;
+        ++m_hedgeCount;
+        return true;
+    }
+
+
+    /// <summary>
+    /// Accounts for a hedge that answered before the original request.
+    /// </summary>
+    void HedgePolicy::OnHedgeWon()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_hedgeWonCount;
+    }
+
+
+    /// <summary>
+    /// Reports the rate of hedges, unless no hedge was sent since the last report.
+    /// </summary>
+    /// <param name="out">The output stream.</param>
+    void HedgePolicy::Report(std::ostream &out)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_hedgeCount == m_lastReportedCount)
+            return;
+
+        m_lastReportedCount = m_hedgeCount;
+
+        out << "Database reads: " << m_readCount << " issued, "
+            << m_hedgeCount << " hedged ("
+            << (100.0 * m_hedgeCount / std::max(m_readCount, uint64_t(1))) << "%) after p"
+            << m_percentile << " = " << m_delay.count() << " us, "
+            << m_hedgeWonCount << " won by the hedge\n" << std::endl;
+    }
+
+}// end of namespace newsfeed
@@ -0,0 +1,531 @@
+#include "MemoryNewsStore.h"
+#include "common.h"
+#include "configuration.h"
+#include <algorithm>
+#include <sstream>
+#include <iostream>
+
+namespace newsfeed
+{
+    /// <summary>
+    /// Gets how many news keys make a page, as they do in the database.
+    /// </summary>
+    /// <returns>The size of a page.</returns>
+    static size_t GetPageSize()
+    {
+        static const size_t pageSize(std::max(Configuration::Get().settings.dbQueryPageSize, 1U));
+        return pageSize;
+    }
+
+
+    /// <summary>
+    /// Copies the news of a topic posted after a given key.
+    /// </summary>
+    /// <param name="topicNews">The news of the topic, by sort key.</param>
+    /// <param name="afterKey">The sort key of the last news already seen (empty = none).</param>
+    /// <returns>The news found after the given key, in the order they have been posted.</returns>
+    static std::vector<NewsItem> GetNewsAfter(const std::map<string, string> &topicNews, const string &afterKey)
+    {
+        std::vector<NewsItem> news;
+
+        for (auto iter = topicNews.upper_bound(afterKey); iter != topicNews.end(); ++iter)
+            news.push_back(NewsItem{ iter->first, iter->second });
+
+        return news;
+    }
+
+
+    ///////////////////////////
+    // Class MemoryNewsStore
+    ///////////////////////////
+
+    std::unique_ptr<MemoryNewsStore> MemoryNewsStore::singleton;
+
+    std::atomic<MemoryNewsStore *> MemoryNewsStore::singletonAtomicPtr;
+
+    std::mutex MemoryNewsStore::singletonCreationMutex;
+
+
+    /// <summary>
+    /// Initializes a new instance of the <see cref="MemoryNewsStore"/> class.
+    /// </summary>
+    MemoryNewsStore::MemoryNewsStore()
+        : m_stopRequested(false)
+    {
+        m_thread = std::thread(&MemoryNewsStore::RunCallbacks, this);
+
+        std::clog << "Storage in memory: nothing will be persisted\n" << std::endl;
+    }
+
+
+    /// <summary>
+    /// Finalizes an instance of the <see cref="MemoryNewsStore"/> class.
+    /// </summary>
+    MemoryNewsStore::~MemoryNewsStore()
+    {
+        try
+        {
+            Shutdown();
+        }
+        catch (std::system_error &ex)
+        {
+            std::cerr << "\nERROR - News feed server - System error when finalizing storage in memory: "
+                      << StdLibExt::GetDetailsFromSystemError(ex);
+        }
+    }
+
+
+    /// <summary>
+    /// Gets the singleton.
+    /// </summary>
+    /// <returns>A reference to the singleton</returns>
+    MemoryNewsStore & MemoryNewsStore::GetInstance()
+    {
+        try
+        {
+            auto *ptr = singletonAtomicPtr.load(std::memory_order_relaxed);
+
+            if (ptr != nullptr)
+                return *ptr;
+
+            std::lock_guard<std::mutex> lock(singletonCreationMutex);
+
+            if (static_cast<MemoryNewsStore *> (singletonAtomicPtr) == nullptr)
+            {
+                singleton.reset(new MemoryNewsStore());
+                singletonAtomicPtr.store(singleton.get(), std::memory_order_relaxed);
+            }
+
+            return *singleton;
+        }
+        catch (std::system_error &ex)
+        {
+            std::ostringstream oss;
+            oss << "System error when initializing storage in memory: " << StdLibExt::GetDetailsFromSystemError(ex);
+            throw AppException(oss.str());
+        }
+    }
+
+
+    /// <summary>
+    /// Hands a callback over to the thread of the store, so it never runs in the
+    /// thread of the caller, the same as with a database. Once the store is shut
+    /// down, it runs right away.
+    /// </summary>
+    /// <param name="task">The callback to run.</param>
+    void MemoryNewsStore::Post(const Task &task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+
+            if (!m_stopRequested)
+            {
+                m_queue.push_back(task);
+                m_queueCondition.notify_one();
+                return;
+            }
+        }
+
+        task();
+    }
+
+
+    /// <summary>
+    /// Runs the callbacks in the order they have been posted,
+    /// until the store is shut down and none is left.
+    /// </summary>
+    void MemoryNewsStore::RunCallbacks()
+    {
+        std::unique_lock<std::mutex> lock(m_queueMutex);
+
+        while (true)
+        {
+            m_queueCondition.wait(lock, [this]() { return m_stopRequested || !m_queue.empty(); });
+
+            if (m_queue.empty())
+                return;
+
+            auto task = std::move(m_queue.front());
+            m_queue.pop_front();
+
+            lock.unlock();
+
+            try
+            {
+                task();
+            }
+            catch (std::exception &ex)
+            {
+                std::cerr << "\nERROR - News feed server - Callback of storage in memory failed: " << ex.what() << std::endl;
+            }
+
+            lock.lock();
+        }
+    }
+
+
+    /// <summary>
+    /// Does nothing, for there is no connection to open.
+    /// </summary>
+    void MemoryNewsStore::WarmUp()
+    {
+    }
+
+
+    /// <summary>
+    /// Runs the callbacks still waiting, then stops the thread of the store.
+    /// </summary>
+    void MemoryNewsStore::Shutdown()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            m_stopRequested = true;
+            m_queueCondition.notify_one();
+        }
+
+        if (m_thread.joinable())
+            m_thread.join();
+    }
+
+
+    /// <summary>
+    /// Gets user data or, if not there, put it.
+    /// </summary>
+    /// <param name="userId">The user ID.</param>
+    /// <param name="callback">Receives the topic to which the user is currently subscribing.</param>
+    /// <param name="isCancelled">Not used, because there is no request to abort.</param>
+    void MemoryNewsStore::GetOrPutUserAsync(const string &userId,
+                                            const StringCallback &callback,
+                                            const CancellationCheck &)
+    {
+        string topic;
+
+        {
+            std::lock_guard<std::mutex> lock(m_dataMutex);
+            topic = m_users[userId].topic;
+        }
+
+        Post([topic, callback]() mutable { callback(topic, nullptr); });
+    }
+
+
+    /// <summary>
+    /// Updates the user.
+    /// </summary>
+    /// <param name="userId">The user ID.</param>
+    /// <param name="topic">The topic.</param>
+    /// <param name="callback">Tells when the user has been updated.</param>
+    void MemoryNewsStore::UpdateUserAsync(const string &userId,
+                                          const string &topic,
+                                          const Callback &callback)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_dataMutex);
+
+            // the feed starts over from now:
+            auto &state = m_users[userId];
+            state.topic = topic;
+            state.lastFeedKey = MakeFeedCursor();
+        }
+
+        Post([callback]() { callback(nullptr); });
+    }
+
+
+    /// <summary>
+    /// Puts news in a topic.
+    /// </summary>
+    /// <param name="topic">The topic.</param>
+    /// <param name="userId">The ID of the user who posted the news.</param>
+    /// <param name="news">The news.</param>
+    /// <param name="callback">Receives the sort key of the news.</param>
+    void MemoryNewsStore::PutNewsAsync(const string &topic,
+                                       const string &,
+                                       const string &news,
+                                       const StringCallback &callback)
+    {
+        string sortKey;
+
+        // made under the lock, so no read sees a later key before this one is there:
+        {
+            std::lock_guard<std::mutex> lock(m_dataMutex);
+            sortKey = MakeNewsKey();
+            m_news[topic].emplace(sortKey, news);
+        }
+
+        Post([sortKey, callback]() mutable { callback(sortKey, nullptr); });
+    }
+
+
+    /// <summary>
+    /// Gets the news of a user since the last feed, then moves the last feed past them.
+    /// </summary>
+    /// <param name="userId">The ID of the user requesting the news.</param>
+    /// <param name="callback">Receives the news found since last feed, one page after another.
+    /// An error or the last page (which might be empty) ends the calls.</param>
+    /// <param name="isCancelled">Tells whether the caller has given up (optional).
+    /// Once cancelled, the last feed time is left untouched, so the news are not lost.</param>
+    void MemoryNewsStore::GetNewsAsync(const string &userId,
+                                       const NewsPageCallback &callback,
+                                       const CancellationCheck &isCancelled)
+    {
+        UserState state;
+        auto news = std::make_shared<std::vector<NewsItem>>();
+
+        {
+            std::lock_guard<std::mutex> lock(m_dataMutex);
+
+            auto userIter = m_users.find(userId);
+
+            if (userIter == m_users.end())
+            {
+                std::ostringstream oss;
+                oss << "User '" << userId << "' not found in storage";
+                auto error = std::make_exception_ptr(AppException("Could not retrieve news for user topic!", oss.str()));
+
+                Post([callback, error]() { std::vector<NewsItem> none; callback(none, true, error); });
+                return;
+            }
+
+            state = userIter->second;
+
+            auto topicIter = m_news.find(state.topic);
+
+            if (!state.topic.empty() && topicIter != m_news.end())
+                *news = GetNewsAfter(topicIter->second, state.lastFeedKey);
+        }
+
+        Post([this, userId, state, news, callback, isCancelled]()
+        {
+            auto pageSize = GetPageSize();
+            auto iter = news->begin();
+
+            do
+            {
+                // nobody will receive the news? then do not move past them:
+                if (isCancelled && isCancelled())
+                {
+                    std::vector<NewsItem> none;
+                    callback(none, true, std::make_exception_ptr(
+                        AppException("Failed to get news from storage", "Request cancelled because the client is gone")
+                    ));
+                    return;
+                }
+
+                auto pageEnd = iter + std::min<ptrdiff_t>(news->end() - iter, pageSize);
+                std::vector<NewsItem> page(std::make_move_iterator(iter), std::make_move_iterator(pageEnd));
+                iter = pageEnd;
+
+                bool isLastPage = (iter == news->end());
+
+                if (isLastPage && !news->empty())
+                    SetLastFeedKey(userId, state.topic, news->back().sortKey);
+
+                callback(page, isLastPage, nullptr);
+            }
+            while (iter != news->end());
+        });
+    }
+
+
+    /// <summary>
+    /// Gets the news posted in a topic after a given point.
+    /// </summary>
+    /// <param name="topic">The topic.</param>
+    /// <param name="afterKey">The sort key of the last news already seen
+    /// in the topic, or a cursor made by <see cref="MakeNewsCursor"/>.</param>
+    /// <param name="callback">Receives the news found after the given key,
+    /// in the same order they have been posted.</param>
+    void MemoryNewsStore::GetTopicNewsAsync(const string &topic,
+                                            const string &afterKey,
+                                            const NewsCallback &callback)
+    {
+        auto news = std::make_shared<std::vector<NewsItem>>();
+
+        {
+            std::lock_guard<std::mutex> lock(m_dataMutex);
+
+            auto iter = m_news.find(topic);
+
+            if (iter != m_news.end())
+                *news = GetNewsAfter(iter->second, afterKey);
+        }
+
+        Post([news, callback]() { callback(*news, nullptr); });
+    }
+
+
+    /// <summary>
+    /// Moves the last feed of a user forward, as long as the user
+    /// is still subscribing to the given topic.
+    /// </summary>
+    /// <param name="userId">The user ID.</param>
+    /// <param name="topic">The topic where the news were fed from.</param>
+    /// <param name="lastKey">The sort key of the last news fed to the user.</param>
+    void MemoryNewsStore::SetLastFeedKey(const string &userId,
+                                         const string &topic,
+                                         const string &lastKey)
+    {
+        std::lock_guard<std::mutex> lock(m_dataMutex);
+
+        auto iter = m_users.find(userId);
+
+        if (iter != m_users.end()
+            && iter->second.topic == topic
+            && iter->second.lastFeedKey < lastKey)
+        {
+            iter->second.lastFeedKey = lastKey;
+        }
+    }
+
+
+    /// <summary>
+    /// Updates the last feed time of a user, as long as
+    /// the user is still subscribing to the given topic.
+    /// </summary>
+    /// <param name="userId">The user ID.</param>
+    /// <param name="topic">The topic where the news were fed from.</param>
+    /// <param name="lastKey">The sort key of the last news fed to the user.</param>
+    /// <param name="callback">Tells when the update is over.</param>
+    void MemoryNewsStore::SetLastFeedTimeAsync(const string &userId,
+                                               const string &topic,
+                                               const string &lastKey,
+                                               const Callback &callback)
+    {
+        SetLastFeedKey(userId, topic, lastKey);
+        Post([callback]() { callback(nullptr); });
+    }
+
+
+    /// <summary>
+    /// Updates the last feed of a user right away, for there is nothing to write behind.
+    /// </summary>
+    /// <param name="userId">The user ID.</param>
+    /// <param name="topic">The topic where the news were fed from.</param>
+    /// <param name="lastKey">The sort key of the last news fed to the user.</param>
+    void MemoryNewsStore::CheckpointLastFeed(const string &userId,
+                                             const string &topic,
+                                             const string &lastKey)
+    {
+        SetLastFeedKey(userId, topic, lastKey);
+    }
+
+
+    /// <summary>
+    /// Scans the keys of every news in storage, page by page.
+    /// The pages are handed over in the calling thread.
+    /// </summary>
+    /// <param name="onPage">Receives the keys of each page, and returns whether to go on.</param>
+    void MemoryNewsStore::ScanNewsKeys(const KeyPageCallback &onPage)
+    {
+        auto pageSize = GetPageSize();
+        NewsKey lastKey;
+
+        while (true)
+        {
+            std::vector<NewsKey> keys;
+
+            {
+                std::lock_guard<std::mutex> lock(m_dataMutex);
+
+                // resume right after the last key of the previous page:
+                for (auto topicIter = m_news.lower_bound(lastKey.topic);
+                     topicIter != m_news.end() && keys.size() < pageSize;
+                     ++topicIter)
+                {
+                    auto &topicNews = topicIter->second;
+
+                    auto newsIter = (topicIter->first == lastKey.topic)
+                        ? topicNews.upper_bound(lastKey.sortKey)
+                        : topicNews.begin();
+
+                    for (; newsIter != topicNews.end() && keys.size() < pageSize; ++newsIter)
+                        keys.push_back(NewsKey{ topicIter->first, newsIter->first });
+                }
+            }
+
+            if (keys.empty())
+                return;
+
+            lastKey = keys.back();
+            bool isLastPage = (keys.size() < pageSize);
+
+            if (!onPage(keys) || isLastPage)
+                return;
+        }
+    }
+
+
+    /// <summary>
+    /// Gets the keys of the news in a topic, from the oldest on, page
+    /// by page. The pages are handed over in the calling thread.
+    /// </summary>
+    /// <param name="topic">The topic.</param>
+    /// <param name="onPage">Receives the keys of each page, and returns whether to go on.</param>
+    void MemoryNewsStore::GetOldestNewsKeys(const string &topic, const KeyPageCallback &onPage)
+    {
+        auto pageSize = GetPageSize();
+        string lastKey;
+
+        while (true)
+        {
+            std::vector<NewsKey> keys;
+
+            {
+                std::lock_guard<std::mutex> lock(m_dataMutex);
+
+                auto topicIter = m_news.find(topic);
+
+                if (topicIter == m_news.end())
+                    return;
+
+                auto &topicNews = topicIter->second;
+
+                for (auto newsIter = topicNews.upper_bound(lastKey);
+                     newsIter != topicNews.end() && keys.size() < pageSize;
+                     ++newsIter)
+                {
+                    keys.push_back(NewsKey{ topic, newsIter->first });
+                }
+            }
+
+            if (keys.empty())
+                return;
+
+            lastKey = keys.back().sortKey;
+            bool isLastPage = (keys.size() < pageSize);
+
+            if (!onPage(keys) || isLastPage)
+                return;
+        }
+    }
+
+
+    /// <summary>
+    /// Deletes news.
+    /// </summary>
+    /// <param name="keys">The keys of the news to delete.</param>
+    /// <param name="callback">Tells when the news have been deleted.</param>
+    void MemoryNewsStore::DeleteNewsAsync(const std::vector<NewsKey> &keys, const Callback &callback)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_dataMutex);
+
+            for (auto &key : keys)
+            {
+                auto iter = m_news.find(key.topic);
+
+                if (iter == m_news.end())
+                    continue;
+
+                iter->second.erase(key.sortKey);
+
+                if (iter->second.empty())
+                    m_news.erase(iter);
+            }
+        }
+
+        Post([callback]() { callback(nullptr); });
+    }
+
+}// end of namespace newsfeed
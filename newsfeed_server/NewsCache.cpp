@@ -0,0 +1,328 @@
+#include "NewsCache.h"
+#include "common.h"
+#include "configuration.h"
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <ctime>
+
+namespace newsfeed
+{
+    //////////////////////////
+    // NewsCache Class
+    //////////////////////////
+
+    std::unique_ptr<NewsCache> NewsCache::singleton;
+
+    std::atomic<NewsCache *> NewsCache::singletonAtomicPtr;
+
+    std::mutex NewsCache::singletonCreationMutex;
+
+
+    /// <summary>
+    /// Initializes a new instance of the <see cref="NewsCache"/> class.
+    /// </summary>
+    NewsCache::NewsCache()
+        : m_totalBytes(0)
+        , m_hitCount(0)
+        , m_missCount(0)
+        , m_evictionCount(0)
+    {
+        const auto &settings = Configuration::Get().settings;
+
+        m_maxNewsPerTopic = std::max(settings.newsCacheMaxNewsPerTopic, 1U);
+        m_maxAgeSecs = settings.newsCacheMaxAgeSecs;
+        m_maxBytes = settings.newsCacheMaxBytes;
+    }
+
+
+    /// <summary>
+    /// Gets the singleton.
+    /// </summary>
+    /// <returns>A reference to the singleton</returns>
+    NewsCache & NewsCache::GetInstance()
+    {
+        try
+        {
+            auto *ptr = singletonAtomicPtr.load(std::memory_order_acquire);
+
+            if (ptr != nullptr)
+                return *ptr;
+
+            std::lock_guard<std::mutex> lock(singletonCreationMutex);
+
+            if (static_cast<NewsCache *> (singletonAtomicPtr) == nullptr)
+            {
+                singleton.reset(new NewsCache());
+                singletonAtomicPtr.store(singleton.get(), std::memory_order_release);
+            }
+
+            return *singleton;
+        }
+        catch (std::system_error &ex)
+        {
+            std::ostringstream oss;
+            oss << "System error when initializing news cache: " << StdLibExt::GetDetailsFromSystemError(ex);
+            throw AppException(oss.str());
+        }
+        catch (std::exception &ex)
+        {
+            std::ostringstream oss;
+            oss << "Generic error when initializing news cache: " << ex.what();
+            throw AppException(oss.str());
+        }
+    }
+
+
+    /// <summary>
+    /// Gets the entry of a topic, created if not there, as the most recently used.
+    /// The lock must be held by the caller.
+    /// </summary>
+    /// <param name="topic">The topic.</param>
+    /// <returns>The entry of the topic.</returns>
+    NewsCache::TopicNews &NewsCache::Touch(const string &topic)
+    {
+        auto iter = m_topics.find(topic);
+
+        if (iter == m_topics.end())
+        {
+            m_lru.push_front(topic);
+            iter = m_topics.emplace(topic, TopicNews()).first;
+            iter->second.bytes = 0;
+            iter->second.lruPos = m_lru.begin();
+        }
+        else
+            m_lru.splice(m_lru.begin(), m_lru, iter->second.lruPos);
+
+        return iter->second;
+    }
+
+
+    /// <summary>
+    /// Inserts news in the buffer of a topic, in order, unless already there.
+    /// The lock must be held by the caller.
+    /// </summary>
+    /// <param name="entry">The entry of the topic.</param>
+    /// <param name="news">The news.</param>
+    void NewsCache::Insert(TopicNews &entry, const NewsItem &news)
+    {
+        if (news.sortKey <= entry.coverFrom)
+            return;
+
+        auto pos = std::lower_bound(entry.news.begin(), entry.news.end(), news.sortKey,
+            [](const NewsItem &item, const string &key) { return item.sortKey < key; }
+        );
+
+        if (pos != entry.news.end() && pos->sortKey == news.sortKey)
+            return;
+
+        entry.news.insert(pos, news);
+
+        auto size = news.sortKey.size() + news.data.size();
+        entry.bytes += size;
+        m_totalBytes += size;
+    }
+
+
+    /// <summary>
+    /// Drops the oldest news of a topic beyond the limits of count and age,
+    /// moving the coverage of the buffer forward accordingly.
+    /// The lock must be held by the caller.
+    /// </summary>
+    /// <param name="entry">The entry of the topic.</param>
+    void NewsCache::Trim(TopicNews &entry)
+    {
+        auto oldestTime = time(nullptr) - m_maxAgeSecs;
+
+        while (!entry.news.empty()
+               && (entry.news.size() > m_maxNewsPerTopic
+                   || NewsStore::GetNewsTime(entry.news.front().sortKey) < oldestTime))
+        {
+            auto &front = entry.news.front();
+            auto size = front.sortKey.size() + front.data.size();
+            entry.bytes -= size;
+            m_totalBytes -= size;
+
+            entry.coverFrom = std::move(front.sortKey);
+            entry.news.pop_front();
+        }
+    }
+
+
+    /// <summary>
+    /// Erases the entry of a topic. The lock must be held by the caller.
+    /// </summary>
+    /// <param name="iter">Points to the entry.</param>
+    void NewsCache::Erase(std::map<string, TopicNews>::iterator iter)
+    {
+        m_totalBytes -= iter->second.bytes;
+        m_lru.erase(iter->second.lruPos);
+        m_topics.erase(iter);
+    }
+
+
+    /// <summary>
+    /// Evicts the least recently used topics while the memory limit is exceeded.
+    /// The lock must be held by the caller.
+    /// </summary>
+    /// <param name="keep">The topic being written, which is not evicted.</param>
+    void NewsCache::EvictWhileOverLimit(const string &keep)
+    {
+        while (m_totalBytes > m_maxBytes && !m_lru.empty() && m_lru.back() != keep)
+        {
+            Erase(m_topics.find(m_lru.back()));
+            ++m_evictionCount;
+        }
+    }
+
+
+    /// <summary>
+    /// Starts over the news of a topic, which is polled from the given key on.
+    /// </summary>
+    /// <param name="topic">The topic.</param>
+    /// <param name="afterKey">The key after which the topic is polled.</param>
+    void NewsCache::Reset(const string &topic, const string &afterKey)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto &entry = Touch(topic);
+        m_totalBytes -= entry.bytes;
+        entry.bytes = 0;
+        entry.news.clear();
+        entry.coverFrom = afterKey;
+        entry.coverTo = afterKey;
+    }
+
+
+    /// <summary>
+    /// Appends what a poll has found in a topic. When the poll does not start where
+    /// the coverage of the buffer ends, the buffer starts over from the poll.
+    /// </summary>
+    /// <param name="topic">The topic.</param>
+    /// <param name="afterKey">The key after which the topic was polled.</param>
+    /// <param name="news">All the news found after that key, ordered by sort key.</param>
+    void NewsCache::Append(const string &topic, const string &afterKey, const std::vector<NewsItem> &news)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto &entry = Touch(topic);
+
+        if (entry.coverTo != afterKey)
+        {
+            m_totalBytes -= entry.bytes;
+            entry.bytes = 0;
+            entry.news.clear();
+            entry.coverFrom = afterKey;
+        }
+
+        for (auto &item : news)
+            Insert(entry, item);
+
+        if (!news.empty())
+            entry.coverTo = news.back().sortKey;
+        else
+            entry.coverTo = afterKey;
+
+        Trim(entry);
+        EvictWhileOverLimit(topic);
+    }
+
+
+    /// <summary>
+    /// Adds news posted in a topic, as long as the topic is in the cache.
+    /// This does not extend the coverage, which only the polls do.
+    /// </summary>
+    /// <param name="topic">The topic.</param>
+    /// <param name="news">The news.</param>
+    void NewsCache::Add(const string &topic, const NewsItem &news)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto iter = m_topics.find(topic);
+
+        if (iter == m_topics.end())
+            return;
+
+        auto &entry = Touch(topic);
+        Insert(entry, news);
+        Trim(entry);
+        EvictWhileOverLimit(topic);
+    }
+
+
+    /// <summary>
+    /// Drops the news of a topic, which is no longer polled.
+    /// </summary>
+    /// <param name="topic">The topic.</param>
+    void NewsCache::Drop(const string &topic)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto iter = m_topics.find(topic);
+
+        if (iter != m_topics.end())
+            Erase(iter);
+    }
+
+
+    /// <summary>
+    /// Gets the news in a topic after a given key, up to where the polls cover the
+    /// topic. The news added past that point are left out, since older news might
+    /// be missing before them. This is meant for a caller who subscribes to the
+    /// topic beforehand, hence receives the news from the next polls anyway.
+    /// </summary>
+    /// <param name="topic">The topic.</param>
+    /// <param name="afterKey">The key after which the news are wanted.</param>
+    /// <param name="news">Receives the news, ordered by sort key.</param>
+    /// <returns>Whether the cache covers the requested range. If not,
+    /// the news must be retrieved from the database.</returns>
+    bool NewsCache::GetNewsAfter(const string &topic, const string &afterKey, std::vector<NewsItem> &news)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto iter = m_topics.find(topic);
+
+        if (iter == m_topics.end() || afterKey < iter->second.coverFrom)
+        {
+            ++m_missCount;
+            return false;
+        }
+
+        auto &entry = Touch(topic);
+        Trim(entry);
+
+        // the trim might have moved the coverage past the requested range:
+        if (afterKey < entry.coverFrom)
+        {
+            ++m_missCount;
+            return false;
+        }
+
+        auto keyBefore = [](const string &key, const NewsItem &item) { return key < item.sortKey; };
+        auto begin = std::upper_bound(entry.news.begin(), entry.news.end(), afterKey, keyBefore);
+        auto end = std::upper_bound(begin, entry.news.end(), entry.coverTo, keyBefore);
+
+        news.assign(begin, end);
+        ++m_hitCount;
+        return true;
+    }
+
+
+    /// <summary>
+    /// Reports the effectiveness of the cache.
+    /// </summary>
+    /// <param name="out">The output stream.</param>
+    void NewsCache::Report(std::ostream &out)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_hitCount + m_missCount == 0)
+            return;
+
+        out << "News cache has " << m_topics.size() << " topics in "
+            << m_totalBytes << " bytes, and served "
+            << m_hitCount << " reads (hits) out of " << (m_hitCount + m_missCount)
+            << " (" << m_evictionCount << " topics evicted for lack of memory)\n" << std::endl;
+    }
+
+}// end of namespace newsfeed
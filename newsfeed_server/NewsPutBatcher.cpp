@@ -0,0 +1,155 @@
+#include "NewsPutBatcher.h"
+#include "common.h"
+#include "configuration.h"
+#include <algorithm>
+#include <iterator>
+#include <iostream>
+#include <limits>
+
+namespace newsfeed
+{
+    using namespace std::chrono;
+
+    // how many of the latest samples make the percentile
+    static const size_t maxLatencySamples(1000);
+
+
+    /// <summary>
+    /// Initializes a new instance of the <see cref="NewsPutBatcher"/> class.
+    /// </summary>
+    /// <param name="timer">The timer to close the windows.</param>
+    /// <param name="writeBatch">Writes a batch of news to the database.</param>
+    NewsPutBatcher::NewsPutBatcher(TaskTimer &timer, const BatchWriter &writeBatch)
+        : m_timer(timer)
+        , m_writeBatch(writeBatch)
+        , m_window(Configuration::Get().settings.dbNewsPutBatchWindowMs)
+        , m_flushScheduled(false)
+        , m_nextSampleIdx(0)
+        , m_putCount(0)
+        , m_batchedPutCount(0)
+        , m_batchCount(0)
+        , m_lastReportedCount(0)
+    {
+        m_pending.reserve(maxBatchSize);
+        m_latencies.reserve(maxLatencySamples);
+    }
+
+
+    /// <summary>
+    /// Adds news to the batch in the current window.
+    /// </summary>
+    /// <param name="put">The news, and the callback to acknowledge once written.</param>
+    void NewsPutBatcher::Add(PendingNewsPut &&put)
+    {
+        std::vector<PendingNewsPut> batch;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            m_pending.push_back(std::move(put));
+
+            if (m_pending.size() >= maxBatchSize)
+            {
+                batch.swap(m_pending);
+                m_pending.reserve(maxBatchSize);
+                m_batchedPutCount += batch.size();
+                ++m_batchCount;
+            }
+            else if (!m_flushScheduled)
+            {
+                m_flushScheduled = true;
+                m_timer.Schedule(m_window, [this]() { Flush(); });
+            }
+        }
+
+        if (!batch.empty())
+            m_writeBatch(batch);
+    }
+
+
+    /// <summary>
+    /// Closes the current window, and writes what has been gathered so far.
+    /// </summary>
+    void NewsPutBatcher::Flush()
+    {
+        std::vector<PendingNewsPut> pending;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_flushScheduled = false;
+
+            if (m_pending.empty())
+                return;
+
+            pending.swap(m_pending);
+            m_pending.reserve(maxBatchSize);
+            m_batchedPutCount += pending.size();
+            m_batchCount += (pending.size() + maxBatchSize - 1) / maxBatchSize;
+        }
+
+        for (size_t idx = 0; idx < pending.size(); idx += maxBatchSize)
+        {
+            auto idxEnd = std::min(pending.size(), idx + maxBatchSize);
+
+            std::vector<PendingNewsPut> batch(std::make_move_iterator(pending.begin() + idx),
+                                              std::make_move_iterator(pending.begin() + idxEnd));
+            m_writeBatch(batch);
+        }
+    }
+
+
+    /// <summary>
+    /// Adds a sample of how long a post took to be written.
+    /// </summary>
+    /// <param name="latency">The latency.</param>
+    void NewsPutBatcher::AddLatency(steady_clock::duration latency)
+    {
+        auto sample = static_cast<uint32_t> (
+            std::min<microseconds::rep>(duration_cast<microseconds>(latency).count(),
+                                        std::numeric_limits<uint32_t>::max())
+        );
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        ++m_putCount;
+
+        if (m_latencies.size() < maxLatencySamples)
+            m_latencies.push_back(sample);
+        else
+            m_latencies[m_nextSampleIdx] = sample;
+
+        m_nextSampleIdx = (m_nextSampleIdx + 1) % maxLatencySamples;
+    }
+
+
+    /// <summary>
+    /// Reports the latency of the posts, and how well they were batched,
+    /// unless nothing was posted since the last report.
+    /// </summary>
+    /// <param name="out">The output stream.</param>
+    void NewsPutBatcher::Report(std::ostream &out)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_putCount == m_lastReportedCount)
+            return;
+
+        m_lastReportedCount = m_putCount;
+
+        auto samples = m_latencies;
+        auto nth = samples.begin() + samples.size() * 99 / 100;
+        std::nth_element(samples.begin(), nth, samples.end());
+
+        out << "News posts: " << m_putCount << " written, p99 latency = " << *nth << " us";
+
+        if (IsEnabled())
+        {
+            out << ", in " << m_batchCount << " batch writes (average of "
+                << (static_cast<double> (m_batchedPutCount) / std::max(m_batchCount, uint64_t(1)))
+                << " news per batch)";
+        }
+
+        out << '\n' << std::endl;
+    }
+
+}// end of namespace newsfeed
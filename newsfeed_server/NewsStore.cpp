@@ -0,0 +1,356 @@
+#include "NewsStore.h"
+#include "DDBAccess.h"
+#include "MemoryNewsStore.h"
+#include "common.h"
+#include "configuration.h"
+#include <sstream>
+#include <chrono>
+#include <atomic>
+#include <random>
+#include <limits>
+#include <algorithm>
+
+namespace newsfeed
+{
+    // the time prefix of a sort key in the legacy format is in seconds rather than microseconds,
+    // hence way below this (which is 1970-01-12 in microseconds, or year 33658 in seconds)
+    static const int64_t legacyKeyTimeLimit(1000000000000LL);
+
+    // latest time of the hybrid logical clock (microseconds since epoch)
+    static std::atomic<int64_t> hlcLastMicros(0);
+
+    // sequence of the sort keys generated by this process
+    static std::atomic<uint32_t> sortKeySequence(0);
+
+
+    /// <summary>
+    /// Ticks the hybrid logical clock of the process, which follows the wall clock,
+    /// but never goes back nor repeats itself, and never falls behind the time of
+    /// the news seen in the database (see <see cref="ObserveHybridClock"/>).
+    /// </summary>
+    /// <returns>The time in microseconds since epoch.</returns>
+    static int64_t TickHybridClock()
+    {
+        using namespace std::chrono;
+
+        int64_t now = duration_cast<microseconds>(system_clock::now().time_since_epoch()).count();
+        int64_t last = hlcLastMicros.load(std::memory_order_relaxed);
+        int64_t next;
+
+        do
+        {
+            next = std::max(now, last + 1);
+        }
+        while (!hlcLastMicros.compare_exchange_weak(last, next, std::memory_order_relaxed));
+
+        return next;
+    }
+
+
+    /// <summary>
+    /// Moves the hybrid logical clock forward to the time of news written by
+    /// another instance, whose clock might be ahead, so the keys generated next
+    /// are sorted after those news.
+    /// </summary>
+    /// <param name="micros">The time of the news (microseconds since epoch).</param>
+    static void ObserveHybridClock(int64_t micros)
+    {
+        int64_t last = hlcLastMicros.load(std::memory_order_relaxed);
+
+        while (last < micros
+               && !hlcLastMicros.compare_exchange_weak(last, micros, std::memory_order_relaxed));
+    }
+
+
+    /// <summary>
+    /// Gets the ID of this instance in the sort keys it generates.
+    /// Unless configured, this is drawn at random on the first call.
+    /// </summary>
+    /// <returns>The node ID, never zero.</returns>
+    static uint32_t GetNodeId()
+    {
+        static const uint32_t nodeId = []()
+        {
+            auto configured = Configuration::Get().settings.dbNodeId;
+
+            if (configured != 0)
+                return configured;
+
+            std::random_device seed;
+            std::uniform_int_distribution<uint32_t> distribution(1, std::numeric_limits<uint32_t>::max());
+            return distribution(seed);
+        }();
+
+        return nodeId;
+    }
+
+
+    /// <summary>
+    /// Writes an unsigned integer in big-endian order, so the bytes compare as the integer does.
+    /// </summary>
+    /// <param name="value">The value to write.</param>
+    /// <param name="nBytes">How many bytes to write.</param>
+    /// <param name="dest">Where to write.</param>
+    static void WriteBigEndian(uint64_t value, int nBytes, unsigned char *dest)
+    {
+        for (int idx = nBytes - 1; idx >= 0; --idx)
+        {
+            dest[idx] = static_cast<unsigned char> (value & 0xFF);
+            value >>= 8;
+        }
+    }
+
+
+    /// <summary>
+    /// Makes a binary time-based sort key composed of (time) + (node ID) + (sequence),
+    /// all of them big-endian, so the keys are ordered by time, and never collide.
+    /// </summary>
+    /// <param name="micros">The time (microseconds since epoch).</param>
+    /// <param name="nodeId">The ID of the instance generating the key.</param>
+    /// <param name="sequence">The sequence of the key in that instance.</param>
+    /// <returns>The generated sort key.</returns>
+    static string MakeBinTimeBasedSortKey(int64_t micros, uint32_t nodeId = 0, uint32_t sequence = 0)
+    {
+        unsigned char data[sizeof micros + sizeof nodeId + sizeof sequence];
+
+        WriteBigEndian(micros, sizeof micros, data);
+        WriteBigEndian(nodeId, sizeof nodeId, data + sizeof micros);
+        WriteBigEndian(sequence, sizeof sequence, data + sizeof micros + sizeof nodeId);
+
+        return string(reinterpret_cast<const char *> (data), sizeof data);
+    }
+
+
+    /// <summary>
+    /// Gets the time (prefix) from the provided sort key. Keys in the legacy format,
+    /// whose prefix is in seconds, are supported as well.
+    /// </summary>
+    /// <param name="key">The sort key whose time prefix will be extracted.</param>
+    /// <returns>The time (from key prefix) as microseconds since epoch.</returns>
+    static int64_t GetTimeFromSortKey(const string &key)
+    {
+        int64_t value(0);
+
+        for (size_t idx = 0; idx < sizeof value && idx < key.length(); ++idx)
+        {
+            value <<= 8;
+            value += static_cast<unsigned char> (key[idx]);
+        }
+
+        if (value < legacyKeyTimeLimit)
+            value *= 1000000;
+
+        return value;
+    }
+
+
+    /// <summary>
+    /// Gets the store of the backend chosen in the configuration.
+    /// </summary>
+    /// <returns>The singleton of the chosen backend.</returns>
+    NewsStore &NewsStore::GetInstance()
+    {
+        static NewsStore &instance = []() -> NewsStore &
+        {
+            const auto &backend = Configuration::Get().settings.storeBackend;
+
+            if (backend == "dynamodb")
+                return DDBAccess::GetInstance();
+
+            if (backend == "memory")
+                return MemoryNewsStore::GetInstance();
+
+            std::ostringstream oss;
+            oss << "Storage backend '" << backend << "' is unknown (must be 'dynamodb' or 'memory')";
+            throw AppException(oss.str());
+        }();
+
+        return instance;
+    }
+
+
+    /// <summary>
+    /// Gets user data or, if not there, put it.
+    /// </summary>
+    /// <param name="userId">The user ID.</param>
+    /// <param name="currentTopic">The topic to which the user is currently subscribing.</param>
+    /// <param name="isCancelled">Tells whether the caller has given up (optional).</param>
+    void NewsStore::GetOrPutUser(const string &userId,
+                                 string &currentTopic,
+                                 const CancellationCheck &isCancelled)
+    {
+        currentTopic = Wait<string>([this, &userId, &isCancelled](const StringCallback &callback)
+        {
+            GetOrPutUserAsync(userId, callback, isCancelled);
+        });
+    }
+
+
+    /// <summary>
+    /// Updates the user.
+    /// </summary>
+    /// <param name="userId">The user ID.</param>
+    /// <param name="topic">The topic.</param>
+    void NewsStore::UpdateUser(const string &userId, const string &topic)
+    {
+        typedef std::function<void (bool &, std::exception_ptr)> DoneCallback;
+
+        Wait<bool>([this, &userId, &topic](const DoneCallback &callback)
+        {
+            UpdateUserAsync(userId, topic, [callback](std::exception_ptr error)
+            {
+                bool done(true);
+                callback(done, error);
+            });
+        });
+    }
+
+
+    /// <summary>
+    /// Puts news in a given topic.
+    /// </summary>
+    /// <param name="topic">The topic.</param>
+    /// <param name="userId">The ID of the user posting the news.</param>
+    /// <param name="news">The news.</param>
+    /// <returns>The sort key of the news in the topic.</returns>
+    string NewsStore::PutNews(const string &topic,
+                              const string &userId,
+                              const string &news)
+    {
+        return Wait<string>([this, &topic, &userId, &news](const StringCallback &callback)
+        {
+            PutNewsAsync(topic, userId, news, callback);
+        });
+    }
+
+
+    /// <summary>
+    /// Gets the news in a given topic.
+    /// </summary>
+    /// <param name="userId">The ID of the user requesting the news.</param>
+    /// <param name="news">All the news found since last feed.</param>
+    /// <param name="isCancelled">Tells whether the caller has given up (optional).
+    /// Once cancelled, the last feed time is left untouched, so the news are not lost.</param>
+    void NewsStore::GetNews(const string &userId,
+                            std::vector<NewsItem> &news,
+                            const CancellationCheck &isCancelled)
+    {
+        news.clear();
+
+        auto allNews = &news;
+
+        Wait<std::vector<NewsItem>>([this, &userId, &isCancelled, allNews](const NewsCallback &callback)
+        {
+            GetNewsAsync(userId,
+                [allNews, callback](std::vector<NewsItem> &page, bool isLastPage, std::exception_ptr error)
+                {
+                    allNews->insert(allNews->end(), page.begin(), page.end());
+
+                    if (isLastPage)
+                        callback(page, error);
+                },
+                isCancelled
+            );
+        });
+    }
+
+
+    /// <summary>
+    /// Gets the news posted in a topic after a given point.
+    /// </summary>
+    /// <param name="topic">The topic.</param>
+    /// <param name="afterKey">The sort key of the last news already seen
+    /// in the topic, or a cursor made by <see cref="MakeNewsCursor"/>.</param>
+    /// <param name="news">Will receive the news found after the given key,
+    /// in the same order they have been posted.</param>
+    void NewsStore::GetTopicNews(const string &topic,
+                                 const string &afterKey,
+                                 std::vector<NewsItem> &news)
+    {
+        news = Wait<std::vector<NewsItem>>([this, &topic, &afterKey](const NewsCallback &callback)
+        {
+            GetTopicNewsAsync(topic, afterKey, callback);
+        });
+    }
+
+
+    /// <summary>
+    /// Updates the last feed time of a user, as long as
+    /// the user is still subscribing to the given topic.
+    /// </summary>
+    /// <param name="userId">The user ID.</param>
+    /// <param name="topic">The topic where the news were fed from.</param>
+    /// <param name="lastKey">The sort key of the last news fed to the user.</param>
+    void NewsStore::SetLastFeedTime(const string &userId,
+                                    const string &topic,
+                                    const string &lastKey)
+    {
+        typedef std::function<void (bool &, std::exception_ptr)> DoneCallback;
+
+        Wait<bool>([this, &userId, &topic, &lastKey](const DoneCallback &callback)
+        {
+            SetLastFeedTimeAsync(userId, topic, lastKey, [callback](std::exception_ptr error)
+            {
+                bool done(true);
+                callback(done, error);
+            });
+        });
+    }
+
+
+    /// <summary>
+    /// Makes the sort key for news being written now by this instance.
+    /// </summary>
+    /// <returns>The generated sort key, which no other news ever has.</returns>
+    string NewsStore::MakeNewsKey()
+    {
+        return MakeBinTimeBasedSortKey(TickHybridClock(),
+                                       GetNodeId(),
+                                       sortKeySequence.fetch_add(1, std::memory_order_relaxed));
+    }
+
+
+    /// <summary>
+    /// Makes a cursor for a feed that starts now.
+    /// </summary>
+    /// <returns>A key that sorts before any news written next by this instance.</returns>
+    string NewsStore::MakeFeedCursor()
+    {
+        return MakeBinTimeBasedSortKey(TickHybridClock());
+    }
+
+
+    /// <summary>
+    /// Makes a cursor that points to a moment in the time line of a topic.
+    /// </summary>
+    /// <param name="epochTime">The time (seconds since epoch).</param>
+    /// <returns>A key that sorts before any news posted in the given
+    /// second, hence usable as <c>afterKey</c> in <see cref="GetTopicNews"/>.</returns>
+    string NewsStore::MakeNewsCursor(time_t epochTime)
+    {
+        return MakeBinTimeBasedSortKey(static_cast<int64_t> (epochTime) * 1000000);
+    }
+
+
+    /// <summary>
+    /// Gets the time when news have been posted.
+    /// </summary>
+    /// <param name="sortKey">The sort key of the news.</param>
+    /// <returns>The time (seconds since epoch).</returns>
+    time_t NewsStore::GetNewsTime(const string &sortKey)
+    {
+        return static_cast<time_t> (GetTimeFromSortKey(sortKey) / 1000000);
+    }
+
+
+    /// <summary>
+    /// Takes notice of news read from the store, possibly written by another
+    /// instance, so the keys made next by this one are sorted after them.
+    /// </summary>
+    /// <param name="sortKey">The sort key of the news.</param>
+    void NewsStore::ObserveNewsKey(const string &sortKey)
+    {
+        ObserveHybridClock(GetTimeFromSortKey(sortKey));
+    }
+
+}// end of namespace newsfeed
@@ -0,0 +1,237 @@
+#include "OutboundQueue.h"
+#include "Session.h"
+#include "configuration.h"
+#include <iostream>
+
+namespace newsfeed
+{
+    /// <summary>
+    /// Parses the slow consumer policy from the configuration.
+    /// </summary>
+    /// <param name="name">The name of the policy.</param>
+    /// <returns>The policy. Unknown names fall back to disconnection.</returns>
+    static OutboundQueue::SlowConsumerPolicy ParsePolicy(const string &name)
+    {
+        if (name == "block")
+            return OutboundQueue::SlowConsumerPolicy::Block;
+        else if (name == "drop-oldest")
+            return OutboundQueue::SlowConsumerPolicy::DropOldest;
+        else if (name == "collapse")
+            return OutboundQueue::SlowConsumerPolicy::Collapse;
+        else
+            return OutboundQueue::SlowConsumerPolicy::Disconnect;
+    }
+
+
+    /// <summary>
+    /// Initializes a new instance of the <see cref="OutboundQueue"/> class.
+    /// </summary>
+    OutboundQueue::OutboundQueue()
+        : m_newsBytes(0)
+        , m_missed(0)
+        , m_closed(false)
+        , m_counters()
+    {
+        const auto &settings = Configuration::Get().settings;
+        m_policy = ParsePolicy(settings.slowConsumerPolicy);
+        m_maxNews = settings.sessionOutQueueMaxNews;
+        m_maxBytes = settings.sessionOutQueueMaxBytes;
+    }
+
+
+    /// <summary>
+    /// Determines whether news fit in the queue. The lock must be held by the caller.
+    /// </summary>
+    /// <param name="news">The news.</param>
+    /// <returns>Whether the news can be enqueued without exceeding the limits.
+    /// An empty queue always takes news, no matter their size.</returns>
+    bool OutboundQueue::HasRoomFor(const NewsItem &news) const
+    {
+        if (m_news.empty())
+            return true;
+
+        if (m_maxNews > 0 && m_news.size() >= m_maxNews)
+            return false;
+
+        if (m_maxBytes > 0 && m_newsBytes + news.data.size() > m_maxBytes)
+            return false;
+
+        return true;
+    }
+
+
+    /// <summary>
+    /// Enqueues a response to send to the client. Responses are not bounded
+    /// here, because there is at most one for each request read.
+    /// </summary>
+    /// <param name="message">The message.</param>
+    void OutboundQueue::PushMessage(proto::req_envelope &&message)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (!m_closed)
+            m_messages.push_back(std::move(message));
+    }
+
+
+    /// <summary>
+    /// Enqueues news to send to the client. When the queue is full, the slow
+    /// consumer policy decides what happens. This never blocks, because the
+    /// producer serves other clients as well.
+    /// </summary>
+    /// <param name="news">The news.</param>
+    /// <returns>Whether the news has been enqueued, or else why not.</returns>
+    OutboundQueue::PushResult OutboundQueue::PushNews(const NewsItem &news)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        if (m_closed)
+            return PushResult::Closed;
+
+        if (!HasRoomFor(news))
+        {
+            ++m_counters.timesFull;
+
+            switch (m_policy)
+            {
+            case SlowConsumerPolicy::DropOldest:
+
+                {
+                    // an empty queue always has room, so this ends:
+                    size_t count(0);
+
+                    do
+                    {
+                        m_newsBytes -= m_news[count].data.size();
+                        ++count;
+                    }
+                    while (count < m_news.size()
+                           && ((m_maxNews > 0 && m_news.size() - count >= m_maxNews)
+                               || (m_maxBytes > 0 && m_newsBytes + news.data.size() > m_maxBytes)));
+
+                    m_news.erase(m_news.begin(), m_news.begin() + count);
+                    m_counters.newsDropped += count;
+                }
+
+                break;
+
+            case SlowConsumerPolicy::Block:
+
+                ++m_counters.timesHeldBack;
+                return PushResult::HeldBack;
+
+            case SlowConsumerPolicy::Collapse:
+
+                m_missed += m_news.size();
+                m_counters.newsCollapsed += m_news.size();
+                m_news.clear();
+                m_newsBytes = 0;
+                break;
+
+            default:
+
+                ++m_counters.disconnects;
+                return PushResult::Disconnect;
+            }
+        }
+
+        m_news.push_back(news);
+        m_newsBytes += news.data.size();
+        ++m_counters.newsEnqueued;
+        return PushResult::Enqueued;
+    }
+
+
+    /// <summary>
+    /// Takes the next message to write. Responses go first,
+    /// then the news waiting, packed together in a batch.
+    /// </summary>
+    /// <param name="message">Will receive the message.</param>
+    /// <param name="newsDone">Will receive how many of the news enqueued so far are
+    /// done with once this message is written, counting those discarded by policy.</param>
+    /// <returns>Whether there was anything to write.</returns>
+    bool OutboundQueue::Pop(proto::req_envelope &message, uint64_t &newsDone)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (!m_messages.empty())
+        {
+            message.Clear();
+            message.Swap(&m_messages.front());
+            m_messages.pop_front();
+            newsDone = m_counters.newsEnqueued - m_news.size();
+            return true;
+        }
+
+        if (m_news.empty() && m_missed == 0)
+            return false;
+
+        auto next = Session::PackNews(m_news, 0, m_missed, message);
+
+        for (size_t idx = 0; idx < next; ++idx)
+            m_newsBytes -= m_news[idx].data.size();
+
+        m_news.erase(m_news.begin(), m_news.begin() + next);
+        m_missed = 0;
+        newsDone = m_counters.newsEnqueued - m_news.size();
+        return true;
+    }
+
+
+    /// <summary>
+    /// Determines whether the queue is empty.
+    /// </summary>
+    /// <returns><c>true</c> if nothing is waiting to be written.</returns>
+    bool OutboundQueue::IsEmpty()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_messages.empty() && m_news.empty() && m_missed == 0;
+    }
+
+
+    /// <summary>
+    /// Discards everything in the queue and ignores whatever comes next.
+    /// </summary>
+    void OutboundQueue::Close()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = true;
+        m_messages.clear();
+        m_news.clear();
+        m_newsBytes = 0;
+        m_missed = 0;
+    }
+
+
+    /// <summary>
+    /// Gets the counters of slow consumer events.
+    /// </summary>
+    /// <returns>A copy of the counters.</returns>
+    OutboundQueue::Counters OutboundQueue::GetCounters()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_counters;
+    }
+
+
+    /// <summary>
+    /// Reports the slow consumer events, if any, in the log.
+    /// </summary>
+    /// <param name="userId">The ID of the user in the session.</param>
+    void OutboundQueue::ReportCounters(const string &userId)
+    {
+        auto counters = GetCounters();
+
+        if (counters.timesFull == 0)
+            return;
+
+        std::clog << "Slow consumer report for user '" << userId << "': "
+                  << counters.newsEnqueued << " news enqueued, "
+                  << "queue full " << counters.timesFull << " times, "
+                  << "news held back " << counters.timesHeldBack << " times, "
+                  << counters.newsDropped << " news dropped, "
+                  << counters.newsCollapsed << " news collapsed, "
+                  << counters.disconnects << " disconnection(s)\n" << std::endl;
+    }
+
+}// end of namespace newsfeed
@@ -0,0 +1,278 @@
+#include "PeerFanout.h"
+#include "TopicPoller.h"
+#include "Session.h"
+#include "common.h"
+#include "configuration.h"
+#include <grpc++/create_channel.h>
+#include <grpc++/security/credentials.h>
+#include <iostream>
+#include <sstream>
+
+namespace newsfeed
+{
+    using namespace std::chrono;
+
+
+    //////////////////////////
+    // PeerFanout Class
+    //////////////////////////
+
+    std::unique_ptr<PeerFanout> PeerFanout::singleton;
+
+    std::atomic<PeerFanout *> PeerFanout::singletonAtomicPtr;
+
+    std::mutex PeerFanout::singletonCreationMutex;
+
+
+    /// <summary>
+    /// Initializes a new instance of the <see cref="PeerFanout"/> class,
+    /// which opens channels to the configured peers. When there are any,
+    /// a thread is started to collect their replies.
+    /// </summary>
+    PeerFanout::PeerFanout()
+        : m_shutdown(false)
+    {
+        for (auto &endpoint : Configuration::Get().settings.peerEndpoints)
+        {
+            Peer peer;
+            peer.endpoint = endpoint;
+            peer.stub = proto::NewsfeedPeering::NewStub(
+                grpc::CreateChannel(endpoint, grpc::InsecureChannelCredentials())
+            );
+
+            m_peers.push_back(std::move(peer));
+        }
+
+        if (!m_peers.empty())
+            m_thread = std::thread(&PeerFanout::CollectReplies, this);
+    }
+
+
+    /// <summary>
+    /// Finalizes an instance of the <see cref="PeerFanout"/> class.
+    /// </summary>
+    PeerFanout::~PeerFanout()
+    {
+        try
+        {
+            Shutdown();
+        }
+        catch (std::system_error &ex)
+        {
+            std::cerr << "\nERROR - System error when finalizing news forwarding to peers: "
+                      << StdLibExt::GetDetailsFromSystemError(ex);
+        }
+        catch (std::exception &ex)
+        {
+            std::cerr << "\nERROR - Generic error when finalizing news forwarding to peers: " << ex.what();
+        }
+    }
+
+
+    /// <summary>
+    /// Gets the singleton.
+    /// </summary>
+    /// <returns>A reference to the singleton</returns>
+    PeerFanout & PeerFanout::GetInstance()
+    {
+        try
+        {
+            auto *ptr = singletonAtomicPtr.load(std::memory_order_acquire);
+
+            if (ptr != nullptr)
+                return *ptr;
+
+            std::lock_guard<std::mutex> lock(singletonCreationMutex);
+
+            if (static_cast<PeerFanout *> (singletonAtomicPtr) == nullptr)
+            {
+                singleton.reset(new PeerFanout());
+                singletonAtomicPtr.store(singleton.get(), std::memory_order_release);
+            }
+
+            return *singleton;
+        }
+        catch (std::system_error &ex)
+        {
+            std::ostringstream oss;
+            oss << "System error when initializing news forwarding to peers: " << StdLibExt::GetDetailsFromSystemError(ex);
+            throw AppException(oss.str());
+        }
+        catch (std::exception &ex)
+        {
+            std::ostringstream oss;
+            oss << "Generic error when initializing news forwarding to peers: " << ex.what();
+            throw AppException(oss.str());
+        }
+    }
+
+
+    /// <summary>
+    /// Forwards news just posted in this process to every peer that
+    /// might have subscribers for the topic. Does not wait for replies.
+    /// </summary>
+    /// <param name="topic">The topic.</param>
+    /// <param name="news">The news, already stored in the database.</param>
+    void PeerFanout::Forward(const string &topic, const NewsItem &news)
+    {
+        if (m_peers.empty())
+            return;
+
+        proto::peer_news message;
+        message.set_topic(topic);
+        message.set_sort_key(news.sortKey);
+        message.set_data(news.data);
+
+        const auto now = steady_clock::now();
+
+        const auto deadline = system_clock::now()
+            + milliseconds(Configuration::Get().settings.peerForwardTimeoutMs);
+
+        std::lock_guard<std::mutex> lock(m_peersMutex);
+
+        if (m_shutdown)
+            return;
+
+        for (size_t idx = 0; idx < m_peers.size(); ++idx)
+        {
+            auto &peer = m_peers[idx];
+
+            auto iter = peer.uninterested.find(topic);
+
+            if (iter != peer.uninterested.end())
+            {
+                if (now < iter->second)
+                    continue;
+
+                peer.uninterested.erase(iter);
+            }
+
+            std::unique_ptr<ForwardCall> call(new ForwardCall);
+            call->peerIdx = idx;
+            call->topic = topic;
+            call->context.set_deadline(deadline);
+            call->reader = peer.stub->AsyncForward(&call->context, message, &m_completionQueue);
+            call->reader->Finish(&call->reply, &call->status, call.get());
+            call.release(); // owned by the completion queue until the reply arrives
+        }
+    }
+
+
+    /// <summary>
+    /// Takes note of a reply from a peer. Peers that are not interested in
+    /// the topic, or failed to answer, are spared of it for a while.
+    /// </summary>
+    /// <param name="call">The finished call.</param>
+    /// <param name="ok">Whether the call completed.</param>
+    void PeerFanout::OnReply(ForwardCall &call, bool ok)
+    {
+        std::lock_guard<std::mutex> lock(m_peersMutex);
+
+        auto &peer = m_peers[call.peerIdx];
+
+        if (ok && call.status.ok() && call.reply.interested())
+            return;
+
+        if (!ok || !call.status.ok())
+        {
+            std::ostringstream oss;
+            oss << "Peer " << peer.endpoint << " - " << call.status.error_message();
+            LogError("Failed to forward news!", oss.str());
+        }
+
+        peer.uninterested[call.topic] = steady_clock::now()
+            + seconds(Configuration::Get().settings.newsPollingIntervalSecs);
+    }
+
+
+    /// <summary>
+    /// Collects the replies from peers until the completion queue is shut down.
+    /// </summary>
+    void PeerFanout::CollectReplies()
+    {
+        void *tag;
+        bool ok;
+
+        while (m_completionQueue.Next(&tag, &ok))
+        {
+            std::unique_ptr<ForwardCall> call(static_cast<ForwardCall *> (tag));
+
+            try
+            {
+                OnReply(*call, ok);
+            }
+            catch (std::exception &ex)
+            {
+                LogError("Failure when collecting reply from peer", ex.what());
+            }
+        }
+    }
+
+
+    /// <summary>
+    /// Stops forwarding news and waits for the outstanding calls to finish.
+    /// </summary>
+    void PeerFanout::Shutdown()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_peersMutex);
+
+            if (m_shutdown)
+                return;
+
+            m_shutdown = true;
+        }
+
+        m_completionQueue.Shutdown();
+
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+        else
+        {
+            void *tag;
+            bool ok;
+            while (m_completionQueue.Next(&tag, &ok));
+        }
+    }
+
+
+    //////////////////////////
+    // PeerServiceImpl Class
+    //////////////////////////
+
+    /// <summary>
+    /// Receives news forwarded by a peer and pushes them to the local subscribers.
+    /// </summary>
+    /// <param name="context">The server context.</param>
+    /// <param name="request">The news.</param>
+    /// <param name="response">Tells whether this instance has subscribers for the topic.</param>
+    /// <returns>The operation status.</returns>
+    grpc::Status PeerServiceImpl::Forward(grpc::ServerContext *context,
+                                          const proto::peer_news *request,
+                                          proto::peer_ack *response)
+    {
+        try
+        {
+            NewsItem news;
+            news.sortKey = request->sort_key();
+            news.data = request->data();
+
+            response->set_interested(
+                TopicPoller::GetInstance().Publish(request->topic(), news)
+            );
+
+            return grpc::Status::OK;
+        }
+        catch (AppException &ex)
+        {
+            return ErrorStatus(grpc::StatusCode::INTERNAL, ex.what(), ex.GetDetails());
+        }
+        catch (std::exception &ex)
+        {
+            return ErrorStatus(grpc::StatusCode::INTERNAL, "Failed to receive news from peer", ex.what());
+        }
+    }
+
+}// end of namespace newsfeed
@@ -0,0 +1,450 @@
+#include "RetentionWorker.h"
+#include "Session.h"
+#include "common.h"
+#include "configuration.h"
+#include "NewsStore.h"
+#include "TopicShards.h"
+#include <algorithm>
+#include <iterator>
+#include <iostream>
+#include <sstream>
+
+namespace newsfeed
+{
+    using namespace std::chrono;
+
+
+    //////////////////////////
+    // RetentionWorker Class
+    //////////////////////////
+
+    std::unique_ptr<RetentionWorker> RetentionWorker::singleton;
+
+    std::atomic<RetentionWorker *> RetentionWorker::singletonAtomicPtr;
+
+    std::mutex RetentionWorker::singletonCreationMutex;
+
+
+    /// <summary>
+    /// Initializes a new instance of the <see cref="RetentionWorker"/> class,
+    /// which immediately starts its thread, unless retention is disabled.
+    /// </summary>
+    RetentionWorker::RetentionWorker()
+        : m_stopRequested(false)
+        , m_writesInFlight(0)
+        , m_writeUnits(0.0)
+        , m_lastRefill(steady_clock::now())
+        , m_purgedCount(0)
+        , m_failedCount(0)
+    {
+        const auto &settings = Configuration::Get().settings;
+
+        m_defaultPolicy.maxAgeSecs = settings.retentionMaxAgeSecs;
+        m_defaultPolicy.maxNews = settings.retentionMaxNewsPerTopic;
+        ParsePolicies(settings.retentionTopicPolicies);
+
+        m_sweepInterval = seconds(settings.retentionSweepIntervalSecs);
+        m_maxWritesInFlight = std::max(settings.retentionMaxWritesInFlight, 1U);
+
+        // deleting a news item (up to 1 KB) takes a write capacity unit:
+        m_writeUnitsPerSec = std::max(settings.dbNewsTableWriteCapacity * settings.retentionWriteCapacityPct / 100.0, 1.0);
+        m_maxWriteUnits = std::max(m_writeUnitsPerSec, 25.0);
+
+        if (m_sweepInterval.count() > 0)
+            m_thread = std::thread(&RetentionWorker::Run, this);
+    }
+
+
+    /// <summary>
+    /// Finalizes an instance of the <see cref="RetentionWorker"/> class.
+    /// </summary>
+    RetentionWorker::~RetentionWorker()
+    {
+        try
+        {
+            Shutdown();
+        }
+        catch (std::system_error &ex)
+        {
+            std::cerr << "\nERROR - System error when finalizing retention worker: "
+                      << StdLibExt::GetDetailsFromSystemError(ex);
+        }
+        catch (std::exception &ex)
+        {
+            std::cerr << "\nERROR - Generic error when finalizing retention worker: " << ex.what();
+        }
+    }
+
+
+    /// <summary>
+    /// Gets the singleton.
+    /// </summary>
+    /// <returns>A reference to the singleton</returns>
+    RetentionWorker & RetentionWorker::GetInstance()
+    {
+        try
+        {
+            auto *ptr = singletonAtomicPtr.load(std::memory_order_acquire);
+
+            if (ptr != nullptr)
+                return *ptr;
+
+            std::lock_guard<std::mutex> lock(singletonCreationMutex);
+
+            if (static_cast<RetentionWorker *> (singletonAtomicPtr) == nullptr)
+            {
+                singleton.reset(new RetentionWorker());
+                singletonAtomicPtr.store(singleton.get(), std::memory_order_release);
+            }
+
+            return *singleton;
+        }
+        catch (AppException &)
+        {
+            throw;
+        }
+        catch (std::system_error &ex)
+        {
+            std::ostringstream oss;
+            oss << "System error when initializing retention worker: " << StdLibExt::GetDetailsFromSystemError(ex);
+            throw AppException(oss.str());
+        }
+        catch (std::exception &ex)
+        {
+            std::ostringstream oss;
+            oss << "Generic error when initializing retention worker: " << ex.what();
+            throw AppException(oss.str());
+        }
+    }
+
+
+    /// <summary>
+    /// Parses the retention policies of specific topics.
+    /// </summary>
+    /// <param name="policies">The policies, formatted as "topic:maxAgeSecs:maxNews",
+    /// separated by semicolon.</param>
+    void RetentionWorker::ParsePolicies(const string &policies)
+    {
+        std::istringstream iss(policies);
+        string entry;
+
+        while (std::getline(iss, entry, ';'))
+        {
+            if (entry.empty())
+                continue;
+
+            auto sep2 = entry.rfind(':');
+            auto sep1 = (sep2 != string::npos && sep2 > 0) ? entry.rfind(':', sep2 - 1) : string::npos;
+
+            if (sep1 == string::npos || sep1 == 0)
+                throw AppException("Invalid retention policy in configuration", entry);
+
+            auto maxAgeSecs = entry.substr(sep1 + 1, sep2 - sep1 - 1);
+            auto maxNews = entry.substr(sep2 + 1);
+
+            if (maxAgeSecs.empty() || maxAgeSecs.find_first_not_of("0123456789") != string::npos
+                || maxNews.empty() || maxNews.find_first_not_of("0123456789") != string::npos)
+            {
+                throw AppException("Invalid retention policy in configuration", entry);
+            }
+
+            m_topicPolicies[entry.substr(0, sep1)] = Policy{
+                static_cast<time_t> (std::stoull(maxAgeSecs)),
+                std::stoull(maxNews)
+            };
+        }
+    }
+
+
+    /// <summary>
+    /// Gets the retention policy of a topic.
+    /// </summary>
+    /// <param name="topic">The topic.</param>
+    /// <returns>The policy of the topic, if configured, otherwise the default one.</returns>
+    const RetentionWorker::Policy &RetentionWorker::GetPolicy(const string &topic) const
+    {
+        auto iter = m_topicPolicies.find(topic);
+        return (iter != m_topicPolicies.end()) ? iter->second : m_defaultPolicy;
+    }
+
+
+    /// <summary>
+    /// Sweeps the database once every interval, until shutdown is requested.
+    /// </summary>
+    void RetentionWorker::Run()
+    {
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_condition.wait_for(lock, m_sweepInterval, [this]() { return m_stopRequested; });
+
+                if (m_stopRequested)
+                    return;
+            }
+
+            try
+            {
+                Sweep();
+            }
+            catch (AppException &ex)
+            {
+                LogError(ex.what(), ex.GetDetails());
+            }
+            catch (std::system_error &ex)
+            {
+                std::ostringstream oss;
+                oss << "System error when purging old news: " << StdLibExt::GetDetailsFromSystemError(ex);
+                LogError("Retention worker failure", oss.str());
+            }
+            catch (std::exception &ex)
+            {
+                LogError("Retention worker failure", ex.what());
+            }
+
+            // the next sweep only starts once the deletes in flight are done:
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() { return m_writesInFlight == 0; });
+        }
+    }
+
+
+    /// <summary>
+    /// Scans the keys of the news in the database, and purges those beyond the
+    /// age limit of their topic. Meanwhile, counts the news left in each shard of
+    /// the topics, so the oldest ones in excess of the limit are purged afterwards.
+    /// The limit of a topic is split among its shards, which are written in turns.
+    /// </summary>
+    void RetentionWorker::Sweep()
+    {
+        auto &dal = NewsStore::GetInstance();
+
+        auto startTime = steady_clock::now();
+        auto now = time(nullptr);
+
+        uint64_t purgedCountBefore, failedCountBefore;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            purgedCountBefore = m_purgedCount;
+            failedCountBefore = m_failedCount;
+        }
+
+        auto isExpired = [this, now](const NewsKey &key)
+        {
+            auto &policy = GetPolicy(TopicShards::GetTopic(key.topic));
+            return policy.maxAgeSecs > 0 && NewsStore::GetNewsTime(key.sortKey) < now - policy.maxAgeSecs;
+        };
+
+        uint64_t scannedCount(0);
+        std::map<string, uint64_t> keptCounts; // by shard, only where the count is limited
+        std::vector<NewsKey> expired;
+        bool stopped(false);
+
+        dal.ScanNewsKeys([this, &isExpired, &scannedCount, &keptCounts, &expired, &stopped](std::vector<NewsKey> &keys)
+        {
+            scannedCount += keys.size();
+
+            for (auto &key : keys)
+            {
+                if (isExpired(key))
+                    expired.push_back(std::move(key));
+                else if (GetPolicy(TopicShards::GetTopic(key.topic)).maxNews > 0)
+                    ++keptCounts[key.topic];
+            }
+
+            stopped = !Purge(expired, false);
+            return !stopped;
+        });
+
+        std::map<string, uint64_t> shardCounts; // by topic
+
+        for (auto &entry : keptCounts)
+            ++shardCounts[TopicShards::GetTopic(entry.first)];
+
+        for (auto &entry : keptCounts)
+        {
+            auto topic = TopicShards::GetTopic(entry.first);
+            auto shardCount = shardCounts[topic];
+            auto maxNews = (GetPolicy(topic).maxNews + shardCount - 1) / shardCount;
+
+            if (stopped)
+                break;
+
+            if (entry.second <= maxNews)
+                continue;
+
+            auto excess = entry.second - maxNews;
+
+            dal.GetOldestNewsKeys(entry.first, [this, &isExpired, &excess, &expired, &stopped](std::vector<NewsKey> &keys)
+            {
+                for (auto &key : keys)
+                {
+                    if (excess == 0)
+                        break;
+
+                    // already purged for its age?
+                    if (isExpired(key))
+                        continue;
+
+                    expired.push_back(std::move(key));
+                    --excess;
+                }
+
+                stopped = !Purge(expired, false);
+                return !stopped && excess > 0;
+            });
+        }
+
+        if (!stopped)
+            Purge(expired, true);
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [this]() { return m_writesInFlight == 0; });
+
+        auto purgedCount = m_purgedCount - purgedCountBefore;
+        auto failedCount = m_failedCount - failedCountBefore;
+
+        if (purgedCount + failedCount > 0)
+        {
+            std::clog << "Retention worker has scanned " << scannedCount << " news in database, and purged "
+                      << purgedCount << " of them (" << failedCount << " failed) in "
+                      << duration_cast<seconds>(steady_clock::now() - startTime).count() << " secs\n" << std::endl;
+        }
+    }
+
+
+    /// <summary>
+    /// Deletes expired news from the database, in batches, within the share of write
+    /// capacity allowed for the purge, and without waiting for the deletes to complete.
+    /// </summary>
+    /// <param name="keys">The keys of the news to delete. The ones deleted are removed from here.</param>
+    /// <param name="flush">Whether to delete also the keys that do not fill a batch.</param>
+    /// <returns>Whether to go on, because shutdown has not been requested.</returns>
+    bool RetentionWorker::Purge(std::vector<NewsKey> &keys, bool flush)
+    {
+        const size_t maxBatchSize(25); // as much as a batch write takes
+
+        size_t idx(0);
+
+        while (keys.size() - idx >= maxBatchSize || (flush && idx < keys.size()))
+        {
+            auto count = std::min(keys.size() - idx, maxBatchSize);
+
+            if (!AcquireWriteCapacity(count))
+            {
+                keys.clear();
+                return false;
+            }
+
+            std::vector<NewsKey> batch(std::make_move_iterator(keys.begin() + idx),
+                                       std::make_move_iterator(keys.begin() + idx + count));
+            idx += count;
+
+            NewsStore::GetInstance().DeleteNewsAsync(batch, [this, count](std::exception_ptr error)
+            {
+                OnPurgeDone(count, error);
+            });
+        }
+
+        keys.erase(keys.begin(), keys.begin() + idx);
+        return true;
+    }
+
+
+    /// <summary>
+    /// Waits until a batch of deletes is allowed, which takes a free slot for
+    /// writes in flight, and enough tokens of write capacity in the bucket.
+    /// </summary>
+    /// <param name="units">How many units of write capacity the batch takes.</param>
+    /// <returns>Whether the batch can go, because shutdown has not been requested.</returns>
+    bool RetentionWorker::AcquireWriteCapacity(size_t units)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        while (!m_stopRequested)
+        {
+            auto now = steady_clock::now();
+            m_writeUnits = std::min(m_writeUnits + m_writeUnitsPerSec * duration<double>(now - m_lastRefill).count(),
+                                    m_maxWriteUnits);
+            m_lastRefill = now;
+
+            if (m_writeUnits >= units && m_writesInFlight < m_maxWritesInFlight)
+            {
+                m_writeUnits -= units;
+                ++m_writesInFlight;
+                return true;
+            }
+
+            // wait for a write in flight to complete, or for the bucket to refill:
+            if (m_writeUnits >= units)
+                m_condition.wait(lock);
+            else
+            {
+                auto refillTime = duration<double>((units - m_writeUnits) / m_writeUnitsPerSec);
+                m_condition.wait_for(lock, std::max(duration_cast<milliseconds>(refillTime), milliseconds(1)));
+            }
+        }
+
+        return false;
+    }
+
+
+    /// <summary>
+    /// Accounts for the completion of a batch of deletes.
+    /// </summary>
+    /// <param name="count">How many news the batch had.</param>
+    /// <param name="error">The error, if the batch failed.</param>
+    void RetentionWorker::OnPurgeDone(size_t count, std::exception_ptr error)
+    {
+        if (error)
+        {
+            try
+            {
+                std::rethrow_exception(error);
+            }
+            catch (AppException &ex)
+            {
+                LogError(ex.what(), ex.GetDetails());
+            }
+            catch (std::exception &ex)
+            {
+                LogError("Generic failure when purging old news", ex.what());
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_writesInFlight;
+
+            if (error)
+                m_failedCount += count;
+            else
+                m_purgedCount += count;
+        }
+
+        m_condition.notify_all();
+    }
+
+
+    /// <summary>
+    /// Stops purging and waits for the thread, as well
+    /// as the deletes in flight, to finish.
+    /// </summary>
+    void RetentionWorker::Shutdown()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopRequested = true;
+        }
+
+        m_condition.notify_all();
+
+        if (m_thread.joinable())
+            m_thread.join();
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [this]() { return m_writesInFlight == 0; });
+    }
+
+}// end of namespace newsfeed
@@ -0,0 +1,104 @@
+#include "RetryPolicy.h"
+#include "configuration.h"
+#include <algorithm>
+#include <iostream>
+
+namespace newsfeed
+{
+    using namespace std::chrono;
+
+
+    /// <summary>
+    /// Initializes a new instance of the <see cref="RetryPolicy"/> class.
+    /// </summary>
+    RetryPolicy::RetryPolicy()
+        : m_randomGenerator(std::random_device()())
+        , m_requestCount(0)
+        , m_deniedCount(0)
+        , m_lastReportedCount(0)
+    {
+        const auto &settings = Configuration::Get().settings;
+
+        m_baseDelay = milliseconds(std::max(settings.dbReqRetryIntervalMs, 1U));
+        m_maxDelay = std::max(m_baseDelay, milliseconds(settings.dbReqRetryMaxIntervalMs));
+        m_tokensPerRequest = settings.dbReqRetryBudgetPct / 100.0;
+        m_maxTokens = std::max(settings.dbReqRetryBudgetBurst, 1U);
+        m_tokens = m_maxTokens;
+    }
+
+
+    /// <summary>
+    /// Accounts for a request issued for the first time, which adds to the budget of retries.
+    /// </summary>
+    void RetryPolicy::OnRequest()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_requestCount;
+        m_tokens = std::min(m_tokens + m_tokensPerRequest, m_maxTokens);
+    }
+
+
+    /// <summary>
+    /// Tries to spend the budget on a retry.
+    /// </summary>
+    /// <param name="operation">The operation whose request has failed.</param>
+    /// <param name="error">The name of the error.</param>
+    /// <param name="delay">Receives the delay before the retry, computed
+    /// from the previous one, which is what it holds when the call is made.</param>
+    /// <returns>Whether the retry is allowed by the budget.</returns>
+    bool RetryPolicy::TryRetry(const char *operation,
+                               const string &error,
+                               milliseconds &delay)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        string key(operation);
+        key += " / ";
+        key += error.empty() ? string("unknown error") : error;
+        ++m_retryCounts[key];
+
+        if (m_tokens < 1.0)
+        {
+            ++m_deniedCount;
+            return false;
+        }
+
+        m_tokens -= 1.0;
+
+        // decorrelated jitter: random between base and 3x the previous delay, capped
+        auto upperBound = std::max(m_baseDelay, std::min(delay * 3, m_maxDelay));
+        std::uniform_int_distribution<milliseconds::rep> distribution(m_baseDelay.count(), upperBound.count());
+        delay = milliseconds(distribution(m_randomGenerator));
+        return true;
+    }
+
+
+    /// <summary>
+    /// Reports the retries counted so far, unless nothing has changed since the last report.
+    /// </summary>
+    /// <param name="out">The output stream.</param>
+    void RetryPolicy::Report(std::ostream &out)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        uint64_t totalCount(0);
+
+        for (auto &entry : m_retryCounts)
+            totalCount += entry.second;
+
+        if (totalCount == m_lastReportedCount)
+            return;
+
+        m_lastReportedCount = totalCount;
+
+        out << "Database requests: " << m_requestCount << " issued, "
+            << totalCount << " failed and eligible for retry ("
+            << m_deniedCount << " denied by the retry budget):\n";
+
+        for (auto &entry : m_retryCounts)
+            out << "  " << entry.first << ": " << entry.second << '\n';
+
+        out << std::endl;
+    }
+
+}// end of namespace newsfeed
@@ -0,0 +1,891 @@
+#include "Session.h"
+#include "common.h"
+#include "TopicPoller.h"
+#include "PeerFanout.h"
+#include "TopicShards.h"
+#include "configuration.h"
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <ctime>
+#include <chrono>
+#include <atomic>
+
+namespace newsfeed
+{
+    using namespace std::chrono;
+
+#   ifndef NDEBUG
+    static const auto processStartTime = steady_clock::now();
+#   endif
+
+
+    ///////////////////
+    // Helpers
+    ///////////////////
+
+    static void DumpMessage(const proto::register_request &msg)
+    {
+        std::clog << "Received register_request message: { userid = '"
+                  << msg.userid() << "' }\n" << std::endl;
+    }
+
+    static void DumpMessage(const proto::topic_request &msg)
+    {
+        std::clog << "Received topic_request message: { action = " << msg.action()
+                  << ", topic = '" << msg.topic() << "' }\n" << std::endl;
+    }
+
+    static void DumpMessage(const proto::post_news_request &msg)
+    {
+        std::clog << "Received post_news_request message: { news = '"
+                  << msg.news() << "' }\n" << std::endl;
+    }
+
+
+    /// <summary>
+    /// Logs server error information.
+    /// </summary>
+    /// <param name="message">The error main message.</param>
+    /// <param name="details">The error details.</param>
+    void LogError(const char *message, const string &details)
+    {
+        std::cerr << "ERROR - " << message;
+
+        if (!details.empty())
+            std::cerr << " - " << details;
+
+        std::cerr << std::endl;
+    }
+
+
+    /// <summary>
+    /// Makes a <c>grpc::Status</c> object for an error situation.
+    /// </summary>
+    /// <param name="code">The status code.</param>
+    /// <param name="message">The error message.</param>
+    /// <param name="details">The error details.</param>
+    /// <returns>The constructed <c>grpc::Status</c> object.</returns>
+    Status ErrorStatus(StatusCode code, const char *message, const string &details)
+    {
+        LogError(message, details);
+        return Status(code, message, details);
+    }
+
+
+    /// <summary>
+    /// Makes a <c>grpc::Status</c> object for the error that concluded an asynchronous operation.
+    /// </summary>
+    /// <param name="code">The status code.</param>
+    /// <param name="error">The error.</param>
+    /// <param name="genericMessage">The error message for an unexpected kind of failure.</param>
+    /// <returns>The constructed <c>grpc::Status</c> object.</returns>
+    static Status ErrorStatus(StatusCode code, std::exception_ptr error, const char *genericMessage)
+    {
+        try
+        {
+            std::rethrow_exception(error);
+        }
+        catch (AppException &ex)
+        {
+            return ErrorStatus(code, ex.what(), ex.GetDetails());
+        }
+        catch (std::exception &ex)
+        {
+            return ErrorStatus(code, genericMessage, ex.what());
+        }
+    }
+
+
+    //////////////////////////
+    // Session Class
+    //////////////////////////
+
+    /// <summary>
+    /// Initializes a new instance of the <see cref="Session"/> class.
+    /// </summary>
+    Session::Session()
+        : m_sentCount(0)
+        , m_doneCount(0)
+        , m_caughtUp(true)
+        , m_checkpointPending(false)
+        , m_heldBack(false)
+        , m_closed(false)
+        , m_followCount(0)
+    {
+    }
+
+
+    /// <summary>
+    /// Sends news to the client, skipping those already delivered. The last one
+    /// becomes the checkpoint of the user, to be written behind, once the writer
+    /// is done with every news enqueued up to it. When the client can take no
+    /// more, the rest are held back, and so is the checkpoint, until the news
+    /// are read again from the store (see <see cref="ReadHeldBackNews"/>).
+    /// The feed lock must be held by the caller.
+    /// </summary>
+    /// <param name="news">The news, in the order they have been posted.</param>
+    void Session::Deliver(const std::vector<NewsItem> &news)
+    {
+        // a gap would follow the news held back:
+        if (m_heldBack)
+            return;
+
+        auto prevLastKey = m_lastKey;
+
+        for (auto &item : news)
+        {
+            if (item.sortKey <= m_lastKey)
+                continue;
+
+            // not already pushed when posted in this process?
+            if (m_pushedKeys.erase(item.sortKey) == 0)
+            {
+                if (!SendNews(item))
+                {
+                    m_heldBack = true;
+                    break;
+                }
+
+                ++m_sentCount;
+            }
+
+            m_lastKey = item.sortKey;
+        }
+
+        // forget the pushed news the poller can no longer bring:
+        m_pushedKeys.erase(m_pushedKeys.begin(), m_pushedKeys.upper_bound(m_lastKey));
+
+        if (m_lastKey != prevLastKey)
+            m_unwrittenKeys.push_back(std::make_pair(m_sentCount, m_lastKey));
+    }
+
+
+    /// <summary>
+    /// Accounts for the news the writer is done with, because they have been
+    /// written to the stream (or discarded by the slow consumer policy), and
+    /// moves the checkpoint of the user as far as the news delivered in order.
+    /// </summary>
+    /// <param name="doneCount">How many of the news sent in this session are done with.</param>
+    void Session::OnNewsWritten(uint64_t doneCount)
+    {
+        std::unique_lock<std::mutex> lock(m_feedMutex);
+
+        m_doneCount = std::max(m_doneCount, doneCount);
+
+        auto prevWrittenKey = m_writtenKey;
+
+        while (!m_unwrittenKeys.empty() && m_unwrittenKeys.front().first <= doneCount)
+        {
+            m_writtenKey = std::move(m_unwrittenKeys.front().second);
+            m_unwrittenKeys.pop_front();
+        }
+
+        if (m_writtenKey != prevWrittenKey && m_writtenKey > m_savedKey)
+        {
+            m_checkpointPending = true;
+
+            // once closed, the last feed is saved right away:
+            if (!m_closed)
+                NewsStore::GetInstance().CheckpointLastFeed(m_userId, m_feedTopic, m_writtenKey);
+        }
+
+        ReadHeldBackNews(lock);
+    }
+
+
+    /// <summary>
+    /// Reads again from the store the news held back, once the writer is done with
+    /// every news enqueued, so the client has room for them. What the poller brings
+    /// meanwhile is held back as in a catch-up. This is how a slow client is made to
+    /// wait without losing news, nor holding back the threads that deliver them.
+    /// </summary>
+    /// <param name="lock">The feed lock, held by the caller, which this releases.</param>
+    void Session::ReadHeldBackNews(std::unique_lock<std::mutex> &lock)
+    {
+        if (!m_heldBack || !m_caughtUp || m_closed || m_doneCount < m_sentCount || IsCancelled())
+            return;
+
+        m_heldBack = false;
+        m_caughtUp = false;
+
+        auto followCount = m_followCount;
+        auto topic = m_feedTopic;
+        auto afterKey = m_lastKey;
+        auto self = shared_from_this();
+
+        lock.unlock();
+
+        // held back before the first news of the catch-up? then catch up again:
+        if (afterKey.empty())
+        {
+            NewsStore::GetInstance().GetNewsAsync(m_userId,
+                [self, followCount](std::vector<NewsItem> &news, bool isLastPage, std::exception_ptr error)
+                {
+                    self->OnCatchUp(followCount, news, isLastPage, error);
+                },
+                [self]() { return self->IsCancelled(); }
+            );
+
+            return;
+        }
+
+        NewsStore::GetInstance().GetTopicNewsAsync(topic, afterKey,
+            [self, followCount](std::vector<NewsItem> &news, std::exception_ptr error)
+            {
+                self->OnHeldBackNews(followCount, news, error);
+            }
+        );
+    }
+
+
+    /// <summary>
+    /// Packs news into a message to send to the client. When more than one is
+    /// available, they go together in a batch (up to the configured maximum),
+    /// so a burst of news costs a single write on the stream.
+    /// </summary>
+    /// <param name="news">The news waiting to be sent. Their content is moved into the message.</param>
+    /// <param name="first">The position in the list of the first news to pack.</param>
+    /// <param name="missed">How many news the client has missed before these,
+    /// because it did not keep up. When not zero, a batch is always made.</param>
+    /// <param name="message">Will receive the message to send.</param>
+    /// <returns>The position in the list of the first news NOT packed.</returns>
+    size_t Session::PackNews(std::vector<NewsItem> &news, size_t first, int64_t missed, proto::req_envelope &message)
+    {
+        message.Clear();
+
+        const auto maxBatchSize = std::max<size_t>(Configuration::Get().settings.newsBatchMaxSize, 1);
+
+        const auto count = std::min(news.size() - first, maxBatchSize);
+
+        if (count == 1 && missed == 0)
+        {
+            auto &item = news[first];
+            message.set_type(proto::req_envelope_msg_type::req_envelope_msg_type_news_t);
+            message.mutable_news_data()->set_data(std::move(item.data));
+            message.mutable_news_data()->set_timestamp(NewsStore::GetNewsTime(item.sortKey));
+            return first + 1;
+        }
+
+        message.set_type(proto::req_envelope_msg_type::req_envelope_msg_type_news_batch_t);
+        auto *batch = message.mutable_news_batch_data();
+        batch->mutable_items()->Reserve(static_cast<int> (count));
+
+        if (missed > 0)
+            batch->set_missed(missed);
+
+        for (size_t idx = first; idx < first + count; ++idx)
+        {
+            auto &item = news[idx];
+            auto *entry = batch->add_items();
+            entry->set_data(std::move(item.data));
+            entry->set_timestamp(NewsStore::GetNewsTime(item.sortKey));
+        }
+
+        return first + count;
+    }
+
+
+    /// <summary>
+    /// Makes the news of the current topic start flowing to the client,
+    /// and stops the news of the topic previously followed, if any.
+    /// The catch-up, if required, takes place asynchronously.
+    /// </summary>
+    /// <param name="catchUp">Whether the news posted since the last
+    /// feed of the user must be sent first.</param>
+    void Session::FollowTopic(bool catchUp)
+    {
+        std::unique_lock<std::mutex> lock(m_feedMutex);
+
+        if (m_closed)
+            return;
+
+        if (!m_feedTopic.empty())
+            TopicPoller::GetInstance().Unsubscribe(m_feedTopic, this);
+
+        m_feedTopic = m_topic;
+        m_pendingNews.clear();
+        m_pushedKeys.clear();
+        m_unwrittenKeys.clear();
+        m_heldBack = false;
+        m_writtenKey.clear();
+        m_savedKey.clear();
+        m_checkpointPending = false;
+        m_caughtUp = true;
+        ++m_followCount;
+
+        if (m_feedTopic.empty())
+            return;
+
+        if (catchUp)
+        {
+            m_lastKey.clear();
+            m_caughtUp = false;
+        }
+        else
+            m_lastKey = NewsStore::MakeNewsCursor(time(nullptr));
+
+        /* Subscribe before catching up, so nothing posted meanwhile is
+           lost. What the poller delivers until then is held back, then
+           sent after the catch-up, skipping the repeated ones: */
+        TopicPoller::GetInstance().Subscribe(m_feedTopic, shared_from_this());
+
+        if (m_caughtUp)
+            return;
+
+        auto followCount = m_followCount;
+        auto self = shared_from_this();
+
+        lock.unlock();
+
+        NewsStore::GetInstance().GetNewsAsync(m_userId,
+            [self, followCount](std::vector<NewsItem> &news, bool isLastPage, std::exception_ptr error)
+            {
+                self->OnCatchUp(followCount, news, isLastPage, error);
+            },
+            [self]() { return self->IsCancelled(); }
+        );
+    }
+
+
+    /// <summary>
+    /// Logs the failure to retrieve news to catch up, unless the client is gone anyway.
+    /// </summary>
+    /// <param name="error">The error.</param>
+    void Session::LogCatchUpError(std::exception_ptr error)
+    {
+        try
+        {
+            std::rethrow_exception(error);
+        }
+        catch (AppException &ex)
+        {
+            if (!IsCancelled())
+                LogError(ex.what(), ex.GetDetails());
+        }
+        catch (std::exception &ex)
+        {
+            LogError("Generic failure when catching up with news", ex.what());
+        }
+    }
+
+
+    /// <summary>
+    /// Sends the news retrieved to catch up, page by page as they arrive. After
+    /// the last page, sends those held back meanwhile, then lets the news flow normally.
+    /// </summary>
+    /// <param name="followCount">Identifies the topic followed when the catch-up started.</param>
+    /// <param name="news">A page of the news posted since the last feed of the user.</param>
+    /// <param name="isLastPage">Whether this is the last page, which ends the catch-up.</param>
+    /// <param name="error">The error in the retrieval of the news, if any.</param>
+    void Session::OnCatchUp(uint64_t followCount, std::vector<NewsItem> &news, bool isLastPage, std::exception_ptr error)
+    {
+        if (error)
+            LogCatchUpError(error);
+
+        std::unique_lock<std::mutex> lock(m_feedMutex);
+
+        // closed or changed topic meanwhile?
+        if (m_closed || followCount != m_followCount)
+            return;
+
+        Deliver(news);
+
+        if (!isLastPage)
+            return;
+
+        // retrieval of news has already updated last feed time (unless it failed halfway):
+        if (!error)
+            m_savedKey = m_lastKey;
+
+        EndCatchUp(lock);
+    }
+
+
+    /// <summary>
+    /// Sends the news held back, once read again from the store, then those the
+    /// poller has brought meanwhile, and lets the news flow normally.
+    /// </summary>
+    /// <param name="followCount">Identifies the topic followed when the news were read.</param>
+    /// <param name="news">The news posted after the last one delivered.</param>
+    /// <param name="error">The error in the retrieval of the news, if any.</param>
+    void Session::OnHeldBackNews(uint64_t followCount, std::vector<NewsItem> &news, std::exception_ptr error)
+    {
+        if (error)
+            LogCatchUpError(error);
+
+        std::unique_lock<std::mutex> lock(m_feedMutex);
+
+        // closed or changed topic meanwhile?
+        if (m_closed || followCount != m_followCount)
+            return;
+
+        Deliver(news);
+
+        EndCatchUp(lock);
+    }
+
+
+    /// <summary>
+    /// Sends the news the poller has brought during a catch-up, then lets the
+    /// news flow normally, unless the client has been found full meanwhile.
+    /// </summary>
+    /// <param name="lock">The feed lock, held by the caller, which this might release.</param>
+    void Session::EndCatchUp(std::unique_lock<std::mutex> &lock)
+    {
+        Deliver(m_pendingNews);
+        m_pendingNews.clear();
+        m_caughtUp = true;
+
+        ReadHeldBackNews(lock);
+    }
+
+
+    /// <summary>
+    /// Delivers news found by the poller in a topic.
+    /// </summary>
+    /// <param name="topic">The topic.</param>
+    /// <param name="news">The news, in the order they have been posted.</param>
+    void Session::DeliverNews(const string &topic, const std::vector<NewsItem> &news)
+    {
+        std::lock_guard<std::mutex> lock(m_feedMutex);
+
+        // closed, changed topic since the poller took the list of subscribers, or holding back?
+        if (m_closed || topic != m_feedTopic || m_heldBack)
+            return;
+
+        if (m_caughtUp)
+            Deliver(news);
+        else
+            m_pendingNews.insert(m_pendingNews.end(), news.begin(), news.end());
+    }
+
+
+    /// <summary>
+    /// Delivers news just posted in this process to a topic, ahead of the poller.
+    /// This leaves the last feed of the user alone, because news posted in other
+    /// instances with lower keys might not have settled yet: the poller moves it
+    /// once it brings this news too, in order.
+    /// </summary>
+    /// <param name="topic">The topic.</param>
+    /// <param name="news">The news.</param>
+    void Session::PushNews(const string &topic, const NewsItem &news)
+    {
+        std::lock_guard<std::mutex> lock(m_feedMutex);
+
+        // catching up, or holding back? then the poller will bring it in order later:
+        if (m_closed || topic != m_feedTopic || !m_caughtUp || m_heldBack)
+            return;
+
+        // already delivered by the poller?
+        if (news.sortKey <= m_lastKey)
+            return;
+
+        if (m_pushedKeys.count(news.sortKey) == 0 && SendNews(news))
+        {
+            m_pushedKeys.insert(news.sortKey);
+            ++m_sentCount;
+        }
+    }
+
+
+    /// <summary>
+    /// Stops the news feed for this session. No news are sent to the client
+    /// after this call returns, but those enqueued might still be written.
+    /// </summary>
+    void Session::Close()
+    {
+        std::lock_guard<std::mutex> lock(m_feedMutex);
+
+        if (m_closed)
+            return;
+
+        m_closed = true;
+
+        if (!m_feedTopic.empty())
+            TopicPoller::GetInstance().Unsubscribe(m_feedTopic, this);
+    }
+
+
+    /// <summary>
+    /// Saves the last feed time of the user right away, rather than behind,
+    /// as far as the news the writer is done with. This must be called once
+    /// the session is closed and the writer will write nothing else.
+    /// </summary>
+    void Session::SaveLastFeed()
+    {
+        string topic;
+        string lastKey;
+
+        {
+            std::lock_guard<std::mutex> lock(m_feedMutex);
+
+            /* Only as far as the news delivered in order, because pushed news
+               might be ahead of others not settled yet, which would be skipped: */
+            if (m_checkpointPending)
+            {
+                topic = m_feedTopic;
+                lastKey = m_writtenKey;
+                m_checkpointPending = false;
+            }
+        }
+
+        if (lastKey.empty())
+            return;
+
+        // no need to hold the caller until it is saved:
+        NewsStore::GetInstance().SetLastFeedTimeAsync(m_userId, topic, lastKey, [](std::exception_ptr error)
+        {
+            if (!error)
+                return;
+
+            try
+            {
+                std::rethrow_exception(error);
+            }
+            catch (AppException &ex)
+            {
+                LogError(ex.what(), ex.GetDetails());
+            }
+            catch (std::exception &ex)
+            {
+                LogError("Generic failure when saving last feed time", ex.what());
+            }
+        });
+    }
+
+
+    /// <summary>
+    /// Responds a register request message. The user is looked up in the
+    /// database asynchronously, so the response is given by the callback.
+    /// </summary>
+    /// <param name="message">The message in the request.</param>
+    /// <param name="error">The error to notify the client, if one happened.</param>
+    /// <param name="callback">Will receive the response.</param>
+    void Session::Respond(const proto::register_request &message,
+                          proto::global_error_t error,
+                          const ResponseCallback &callback)
+    {
+#   ifndef NDEBUG
+        DumpMessage(message);
+#   endif
+        if (error != proto::global_error_t::ok)
+        {
+            proto::req_envelope response;
+            response.set_type(proto::req_envelope_msg_type_register_response_t);
+            response.mutable_reg_resp()->set_error(error);
+            callback(Status::OK, response);
+            return;
+        }
+
+        auto self = shared_from_this();
+        auto userId = message.userid();
+
+        NewsStore::GetInstance().GetOrPutUserAsync(userId,
+            [self, userId, callback](string &topic, std::exception_ptr error)
+            {
+                Status status(Status::OK);
+
+                proto::req_envelope response;
+                response.set_type(proto::req_envelope_msg_type_register_response_t);
+                auto *regResp = response.mutable_reg_resp();
+
+                if (error)
+                {
+                    status = ErrorStatus(StatusCode::INTERNAL, error, "Generic failure when registering user");
+                    regResp->set_error(proto::global_error_t::internal);
+                }
+                else
+                {
+                    self->m_topic = topic;
+                    self->m_userId = userId;
+
+                    self->FollowTopic(true);
+
+                    regResp->set_error(proto::global_error_t::ok);
+                }
+
+                *regResp->mutable_topic() = self->m_topic;
+
+                callback(status, response);
+            },
+            [self]() { return self->IsCancelled(); }
+        );
+    }
+
+
+    /// <summary>
+    /// Responds a topic request message. The user is updated in the
+    /// database asynchronously, so the response is given by the callback.
+    /// </summary>
+    /// <param name="message">The message.</param>
+    /// <param name="error">The error to notify the client, if one happened.</param>
+    /// <param name="callback">Will receive the response.</param>
+    void Session::Respond(const proto::topic_request &message,
+                          proto::global_error_t error,
+                          const ResponseCallback &callback)
+    {
+#   ifndef NDEBUG
+        DumpMessage(message);
+#   endif
+        if (error == proto::global_error_t::ok)
+        {
+            // user not registered?
+            if (m_userId.empty())
+            {
+                error = proto::global_error_t::not_registered;
+                LogError("Failed to change topic!", "User is not registered");
+            }
+            // no topic specified for subscription?
+            else if (message.action() == proto::topic_action_t::subscribe
+                     && message.topic().empty())
+            {
+                error = proto::global_error_t::internal;
+                LogError("Failed to change topic!", "No topic has been specified");
+            }
+            // topic would be mistaken for a shard of another one?
+            else if (message.action() == proto::topic_action_t::subscribe
+                     && !TopicShards::IsValidTopic(message.topic()))
+            {
+                error = proto::global_error_t::internal;
+                LogError("Failed to change topic!", "Topic must not contain '#'");
+            }
+            // topic specified for unsubscription?
+            else if (message.action() == proto::topic_action_t::unsubscribe
+                     && !message.topic().empty())
+            {
+                error = proto::global_error_t::internal;
+                LogError("Failed to change topic!", "Must not specify topic when unsubscribing");
+            }
+        }
+
+        auto action = message.action();
+
+        if (error != proto::global_error_t::ok)
+        {
+            proto::req_envelope response;
+            response.set_type(proto::req_envelope_msg_type_topic_response_t);
+            response.mutable_topic_resp()->set_action(action);
+            response.mutable_topic_resp()->set_error(error);
+            callback(Status::OK, response);
+            return;
+        }
+
+        string newTopic;
+
+        if (action == proto::topic_action_t::subscribe)
+            newTopic = message.topic();
+
+        auto self = shared_from_this();
+
+        NewsStore::GetInstance().UpdateUserAsync(m_userId, newTopic,
+            [self, action, newTopic, callback](std::exception_ptr error)
+            {
+                proto::req_envelope response;
+                response.set_type(proto::req_envelope_msg_type_topic_response_t);
+                response.mutable_topic_resp()->set_action(action);
+
+                if (error)
+                {
+                    ErrorStatus(StatusCode::INTERNAL, error, "Generic failure when changing topic");
+                    response.mutable_topic_resp()->set_error(proto::global_error_t::internal);
+                }
+                else
+                {
+                    self->m_topic = newTopic;
+
+                    self->FollowTopic(false);
+
+                    response.mutable_topic_resp()->set_error(proto::global_error_t::ok);
+                }
+
+                callback(Status::OK, response);
+            }
+        );
+    }
+
+
+    /// <summary>
+    /// Responds a post news request message. The news is written in the
+    /// database asynchronously, so the response is given by the callback.
+    /// </summary>
+    /// <param name="message">The message.</param>
+    /// <param name="error">The error to notify the client, if one happened.</param>
+    /// <param name="callback">Will receive the response.</param>
+    void Session::Respond(const proto::post_news_request &message,
+                          proto::global_error_t error,
+                          const ResponseCallback &callback)
+    {
+#   ifndef NDEBUG
+        DumpMessage(message);
+#   endif
+        if (error == proto::global_error_t::ok)
+        {
+            // user not registered?
+            if (m_userId.empty())
+            {
+                error = proto::global_error_t::not_registered;
+                LogError("Failed to post news!", "User is not registered");
+            }
+            // not subscribing to any topic?
+            else if (m_topic.empty())
+            {
+                error = proto::global_error_t::internal;
+                LogError("Failed to post news!", "User is not subscribing to any topic");
+            }
+            // subscribed before such topics were rejected? then it would post in a shard of another:
+            else if (!TopicShards::IsValidTopic(m_topic))
+            {
+                error = proto::global_error_t::internal;
+                LogError("Failed to post news!", "Topic must not contain '#'");
+            }
+        }
+
+        if (error != proto::global_error_t::ok)
+        {
+            proto::req_envelope response;
+            response.set_type(proto::req_envelope_msg_type_post_news_response_t);
+            response.mutable_post_resp()->set_error(error);
+            callback(Status::OK, response);
+            return;
+        }
+
+        auto topic = m_topic;
+        auto data = message.news();
+
+        NewsStore::GetInstance().PutNewsAsync(topic, m_userId, data,
+            [topic, data, callback](string &sortKey, std::exception_ptr error)
+            {
+                proto::req_envelope response;
+                response.set_type(proto::req_envelope_msg_type_post_news_response_t);
+
+                if (error)
+                {
+                    ErrorStatus(StatusCode::INTERNAL, error, "Generic failure when posting news");
+                    response.mutable_post_resp()->set_error(proto::global_error_t::internal);
+                }
+                else
+                {
+                    NewsItem news;
+                    news.sortKey = std::move(sortKey);
+                    news.data = data;
+
+                    // subscribers in this process do not need to wait for the poller:
+                    TopicPoller::GetInstance().Publish(topic, news);
+
+                    // ... and neither do those connected to other instances of the service:
+                    PeerFanout::GetInstance().Forward(topic, news);
+
+                    response.mutable_post_resp()->set_error(proto::global_error_t::ok);
+                }
+
+                callback(Status::OK, response);
+            }
+        );
+    }
+
+
+    /// <summary>
+    /// Handles a request from the client. Requests that need the database are
+    /// responded asynchronously, so the caller must not handle another request
+    /// of this session until the callback receives the response.
+    /// </summary>
+    /// <param name="request">The request.</param>
+    /// <param name="callback">Will receive the response to send back
+    /// to the client, either from this call or from a thread of the store,
+    /// but never both. When the request does not deserve an answer, the
+    /// response is left with no type set.</param>
+    void Session::HandleRequest(const proto::req_envelope &request, const ResponseCallback &callback)
+    {
+        bool uncompliantPayload(false);
+
+        auto reqType = request.type();
+
+        switch (reqType)
+        {
+        case proto::req_envelope_msg_type_register_request_t:
+            uncompliantPayload = !request.has_reg_req();
+            break;
+
+        case proto::req_envelope_msg_type_topic_request_t:
+            uncompliantPayload = !request.has_topic_req();
+            break;
+
+        case proto::req_envelope_msg_type_post_news_request_t:
+            uncompliantPayload = !request.has_post_req();
+            break;
+
+        case proto::req_envelope_msg_type_register_response_t:
+        case proto::req_envelope_msg_type_topic_response_t:
+        case proto::req_envelope_msg_type_post_news_response_t:
+            {
+                std::ostringstream oss;
+                oss << "News feed server has received a request whose type is unexpected: " << reqType;
+                proto::req_envelope response;
+                callback(ErrorStatus(StatusCode::DO_NOT_USE, "Unexpected message type!", oss.str()), response);
+                return;
+            }
+
+        default:
+            {
+                std::ostringstream oss;
+                oss << "News feed server has received a request whose type is unknown: " << reqType;
+                proto::req_envelope response;
+                callback(ErrorStatus(StatusCode::UNIMPLEMENTED, "Unknown message type!", oss.str()), response);
+                return;
+            }
+        }
+
+        auto respond = [callback, reqType, uncompliantPayload](const Status &status, proto::req_envelope &response)
+        {
+            // any trouble giving the first response?
+
+            if (uncompliantPayload)
+            {
+                std::ostringstream oss;
+                oss << "Request payload is uncompliant with message type " << reqType;
+                callback(ErrorStatus(StatusCode::INVALID_ARGUMENT, "Invalid request!", oss.str()), response);
+                return;
+            }
+
+#   ifndef NDEBUG
+            // time to first successful response after startup:
+            static std::atomic<bool> firstResponseSent(false);
+
+            if (status.ok() && !firstResponseSent.exchange(true))
+            {
+                std::clog << "First response sent "
+                          << duration_cast<milliseconds>(steady_clock::now() - processStartTime).count()
+                          << " ms after startup" << std::endl;
+            }
+#   endif
+
+            callback(status, response);
+        };
+
+        auto error = uncompliantPayload ? proto::global_error_t::internal : proto::global_error_t::ok;
+
+        switch (reqType)
+        {
+        case proto::req_envelope_msg_type_register_request_t:
+
+            if (!m_userId.empty())
+            {
+                error = proto::global_error_t::internal;
+                LogError("Could not register user!", "Only one registration per session is allowed");
+            }
+
+            Respond(request.reg_req(), error, respond);
+            break;
+
+        case proto::req_envelope_msg_type_topic_request_t:
+            Respond(request.topic_req(), error, respond);
+            break;
+
+        default:
+            Respond(request.post_req(), error, respond);
+            break;
+        }
+    }
+
+}// end of namespace newsfeed
@@ -0,0 +1,129 @@
+#include "TaskTimer.h"
+#include "Session.h"
+#include "common.h"
+#include <iostream>
+#include <vector>
+
+namespace newsfeed
+{
+    using namespace std::chrono;
+
+
+    /// <summary>
+    /// Initializes a new instance of the <see cref="TaskTimer"/> class.
+    /// </summary>
+    /// <param name="resolution">How precisely the tasks are timed.</param>
+    TaskTimer::TaskTimer(steady_clock::duration resolution)
+        : m_timers(resolution)
+        , m_stopRequested(false)
+    {
+        m_thread = std::thread(&TaskTimer::RunTasks, this);
+    }
+
+
+    /// <summary>
+    /// Finalizes an instance of the <see cref="TaskTimer"/> class.
+    /// </summary>
+    TaskTimer::~TaskTimer()
+    {
+        try
+        {
+            Shutdown();
+        }
+        catch (std::system_error &ex)
+        {
+            std::cerr << "\nERROR - System error when finalizing task timer: "
+                      << StdLibExt::GetDetailsFromSystemError(ex);
+        }
+        catch (std::exception &ex)
+        {
+            std::cerr << "\nERROR - Generic error when finalizing task timer: " << ex.what();
+        }
+    }
+
+
+    /// <summary>
+    /// Schedules a task to run after a delay.
+    /// </summary>
+    /// <param name="delay">The delay.</param>
+    /// <param name="task">The task.</param>
+    void TaskTimer::Schedule(steady_clock::duration delay, const Task &task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_timers.Schedule(steady_clock::now() + delay, task);
+        }
+
+        m_wakeCondition.notify_one();
+    }
+
+
+    /// <summary>
+    /// Runs the tasks as they come due, until shutdown.
+    /// </summary>
+    void TaskTimer::RunTasks()
+    {
+        std::vector<Task> dueTasks;
+
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+
+                if (m_stopRequested)
+                    return;
+
+                dueTasks.clear();
+                m_timers.Advance(steady_clock::now(), dueTasks);
+
+                if (dueTasks.empty())
+                {
+                    /* Wake up when something happens in the wheel, or when a
+                       task is scheduled, since it might come due earlier: */
+                    auto nextEventTime = m_timers.GetNextEventTime();
+
+                    if (nextEventTime == steady_clock::time_point::max())
+                        m_wakeCondition.wait(lock);
+                    else
+                        m_wakeCondition.wait_until(lock, nextEventTime);
+
+                    continue;
+                }
+            }
+
+            for (auto &task : dueTasks)
+            {
+                try
+                {
+                    task();
+                }
+                catch (AppException &ex)
+                {
+                    LogError(ex.what(), ex.GetDetails());
+                }
+                catch (std::exception &ex)
+                {
+                    LogError("Generic failure when running delayed task", ex.what());
+                }
+            }
+        }
+    }
+
+
+    /// <summary>
+    /// Stops the timer. The tasks not yet due are discarded.
+    /// </summary>
+    void TaskTimer::Shutdown()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopRequested = true;
+        }
+
+        m_wakeCondition.notify_all();
+
+        if (m_thread.joinable())
+            m_thread.join();
+    }
+
+}// end of namespace newsfeed
@@ -0,0 +1,473 @@
+#include "TopicPoller.h"
+#include "Session.h"
+#include "common.h"
+#include "configuration.h"
+#include "NewsStore.h"
+#include "NewsCache.h"
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <ctime>
+
+namespace newsfeed
+{
+    using namespace std::chrono;
+
+
+    //////////////////////////
+    // TopicPoller Class
+    //////////////////////////
+
+    std::unique_ptr<TopicPoller> TopicPoller::singleton;
+
+    std::atomic<TopicPoller *> TopicPoller::singletonAtomicPtr;
+
+    std::mutex TopicPoller::singletonCreationMutex;
+
+
+    /// <summary>
+    /// Initializes a new instance of the <see cref="TopicPoller"/> class,
+    /// which immediately starts its polling thread.
+    /// </summary>
+    TopicPoller::TopicPoller()
+        : m_timers(milliseconds(Configuration::Get().settings.newsPollingMinIntervalMs / 10)) // steps of 1/10 the shortest interval
+        , m_stopRequested(false)
+        , m_scheduleChanged(false)
+        , m_queriesMade(0)
+        , m_queriesWithNews(0)
+        , m_queriesSaved(0.0)
+        , m_pollsInFlight(0)
+    {
+        const auto &settings = Configuration::Get().settings;
+
+        m_fixedInterval = seconds(std::max(settings.newsPollingIntervalSecs, 1U));
+        m_minInterval = milliseconds(std::max(settings.newsPollingMinIntervalMs, 1U));
+        m_maxInterval = std::max(milliseconds(settings.newsPollingMaxIntervalMs), m_minInterval);
+
+        m_thread = std::thread(&TopicPoller::PollTopics, this);
+    }
+
+
+    /// <summary>
+    /// Finalizes an instance of the <see cref="TopicPoller"/> class.
+    /// </summary>
+    TopicPoller::~TopicPoller()
+    {
+        try
+        {
+            Shutdown();
+        }
+        catch (std::system_error &ex)
+        {
+            std::cerr << "\nERROR - System error when finalizing news poller: "
+                      << StdLibExt::GetDetailsFromSystemError(ex);
+        }
+        catch (std::exception &ex)
+        {
+            std::cerr << "\nERROR - Generic error when finalizing news poller: " << ex.what();
+        }
+    }
+
+
+    /// <summary>
+    /// Gets the singleton.
+    /// </summary>
+    /// <returns>A reference to the singleton</returns>
+    TopicPoller & TopicPoller::GetInstance()
+    {
+        try
+        {
+            auto *ptr = singletonAtomicPtr.load(std::memory_order_acquire);
+
+            if (ptr != nullptr)
+                return *ptr;
+
+            std::lock_guard<std::mutex> lock(singletonCreationMutex);
+
+            if (static_cast<TopicPoller *> (singletonAtomicPtr) == nullptr)
+            {
+                singleton.reset(new TopicPoller());
+                singletonAtomicPtr.store(singleton.get(), std::memory_order_release);
+            }
+
+            return *singleton;
+        }
+        catch (std::system_error &ex)
+        {
+            std::ostringstream oss;
+            oss << "System error when initializing news poller: " << StdLibExt::GetDetailsFromSystemError(ex);
+            throw AppException(oss.str());
+        }
+        catch (std::exception &ex)
+        {
+            std::ostringstream oss;
+            oss << "Generic error when initializing news poller: " << ex.what();
+            throw AppException(oss.str());
+        }
+    }
+
+
+    /// <summary>
+    /// Schedules the next poll of a topic, replacing the one scheduled before.
+    /// The lock must be held by the caller.
+    /// </summary>
+    /// <param name="topic">The topic.</param>
+    /// <param name="state">The polling state of the topic.</param>
+    /// <param name="when">When to poll.</param>
+    void TopicPoller::SchedulePoll(const string &topic, TopicState &state, steady_clock::time_point when)
+    {
+        m_timers.Cancel(state.timer);
+        state.timer = m_timers.Schedule(when, topic);
+        state.nextPoll = when;
+
+        m_scheduleChanged = true;
+        m_wakeCondition.notify_one();
+    }
+
+
+    /// <summary>
+    /// Subscribes a session to the news of a topic.
+    /// </summary>
+    /// <param name="topic">The topic.</param>
+    /// <param name="session">The session to receive the news.</param>
+    void TopicPoller::Subscribe(const string &topic, const std::shared_ptr<Session> &session)
+    {
+        std::lock_guard<std::mutex> lock(m_topicsMutex);
+
+        auto iter = m_topics.find(topic);
+
+        /* First local subscriber? Start polling from now on, or rather from the
+           point the store reads up to, which the catch-up of the subscriber reaches,
+           so nothing falls in between. Sessions skip what they have already seen: */
+        if (iter == m_topics.end())
+        {
+            iter = m_topics.emplace(topic, TopicState()).first;
+
+            auto &state = iter->second;
+            state.cursor = NewsStore::MakeNewsCursor(time(nullptr) - NewsStore::GetInstance().GetSettleSecs());
+            state.interval = m_minInterval;
+            state.lastPoll = steady_clock::now();
+            state.nextPoll = state.lastPoll + m_minInterval;
+            state.timer = m_timers.Schedule(state.nextPoll, topic);
+            state.polling = false;
+
+            NewsCache::GetInstance().Reset(topic, state.cursor);
+
+            m_scheduleChanged = true;
+            m_wakeCondition.notify_one();
+        }
+
+        iter->second.subscribers.push_back(session);
+    }
+
+
+    /// <summary>
+    /// Unsubscribes a session from the news of a topic.
+    /// When a topic is left with no subscribers, it is no longer polled.
+    /// </summary>
+    /// <param name="topic">The topic.</param>
+    /// <param name="session">The session to stop receiving the news.</param>
+    void TopicPoller::Unsubscribe(const string &topic, const Session *session)
+    {
+        std::lock_guard<std::mutex> lock(m_topicsMutex);
+
+        auto iter = m_topics.find(topic);
+
+        if (iter == m_topics.end())
+            return;
+
+        auto &subscribers = iter->second.subscribers;
+
+        subscribers.erase(
+            std::remove_if(subscribers.begin(), subscribers.end(),
+                [session](const std::shared_ptr<Session> &entry)
+                {
+                    return entry.get() == session;
+                }),
+            subscribers.end()
+        );
+
+        if (subscribers.empty())
+        {
+            m_timers.Cancel(iter->second.timer);
+            m_topics.erase(iter);
+
+            // no longer polled, so the recent news would go stale:
+            NewsCache::GetInstance().Drop(topic);
+        }
+    }
+
+
+    /// <summary>
+    /// Pushes news just posted in this process (or forwarded by a peer instance)
+    /// to the local subscribers of its topic, without waiting for the next poll.
+    /// The poll will find them later, but sessions recognize them by sort key
+    /// and do not deliver them again. Because more news are likely to follow,
+    /// the topic goes back to being polled at the minimum interval.
+    /// </summary>
+    /// <param name="topic">The topic.</param>
+    /// <param name="news">The news, already stored in the database.</param>
+    /// <returns>Whether the topic has local subscribers.</returns>
+    bool TopicPoller::Publish(const string &topic, const NewsItem &news)
+    {
+        std::vector<std::shared_ptr<Session>> subscribers;
+
+        {
+            std::lock_guard<std::mutex> lock(m_topicsMutex);
+
+            auto iter = m_topics.find(topic);
+
+            if (iter == m_topics.end())
+                return false;
+
+            auto &state = iter->second;
+            state.interval = m_minInterval;
+
+            NewsCache::GetInstance().Add(topic, news);
+
+            auto nextPoll = steady_clock::now() + m_minInterval;
+
+            if (nextPoll < state.nextPoll)
+                SchedulePoll(topic, state, nextPoll);
+
+            subscribers = state.subscribers;
+        }
+
+        for (auto &session : subscribers)
+            session->PushNews(topic, news);
+
+        return true;
+    }
+
+
+    /// <summary>
+    /// Queries the database for news in a topic, without waiting for the result.
+    /// </summary>
+    /// <param name="topic">The topic.</param>
+    /// <param name="cursor">The sort key of the last news seen in the topic.</param>
+    void TopicPoller::PollTopic(const string &topic, const string &cursor)
+    {
+        NewsStore::GetInstance().GetTopicNewsAsync(topic, cursor,
+            [this, topic, cursor](std::vector<NewsItem> &news, std::exception_ptr error)
+            {
+                bool failed(false);
+
+                if (error)
+                {
+                    try
+                    {
+                        std::rethrow_exception(error);
+                    }
+                    catch (AppException &ex)
+                    {
+                        LogError(ex.what(), ex.GetDetails());
+                    }
+                    catch (std::exception &ex)
+                    {
+                        LogError("Generic failure when polling news", ex.what());
+                    }
+
+                    failed = true;
+                }
+
+                OnPollDone(topic, cursor, news, failed);
+            }
+        );
+    }
+
+
+    /// <summary>
+    /// Delivers the news found by a poll to the subscribers
+    /// of the topic and schedules the next poll of the topic.
+    /// </summary>
+    /// <param name="topic">The topic.</param>
+    /// <param name="cursor">The sort key after which the topic was polled.</param>
+    /// <param name="news">The news found.</param>
+    /// <param name="failed">Whether the poll has failed.</param>
+    void TopicPoller::OnPollDone(const string &topic, const string &cursor, std::vector<NewsItem> &news, bool failed)
+    {
+        std::vector<std::shared_ptr<Session>> subscribers;
+
+        {
+            std::lock_guard<std::mutex> lock(m_topicsMutex);
+
+            if (--m_pollsInFlight == 0)
+                m_wakeCondition.notify_all();
+
+            auto iter = m_topics.find(topic);
+
+            // nobody is following the topic anymore?
+            if (iter == m_topics.end())
+                return;
+
+            auto &state = iter->second;
+            state.polling = false;
+            auto now = steady_clock::now();
+
+            // a fixed schedule would have queried this many times since the last poll:
+            m_queriesSaved += duration<double>(now - state.lastPoll) / m_fixedInterval - 1.0;
+            state.lastPoll = now;
+            ++m_queriesMade;
+
+            /* Keep the recent news in memory before the subscribers are taken,
+               so a session subscribing meanwhile finds them there, if not here: */
+            if (!failed)
+                NewsCache::GetInstance().Append(topic, cursor, news);
+
+            if (!news.empty())
+            {
+                ++m_queriesWithNews;
+                state.interval = m_minInterval;
+                state.cursor = news.back().sortKey;
+                subscribers = state.subscribers;
+            }
+            else if (!failed)
+            {
+                state.interval = std::min(state.interval * 2, m_maxInterval);
+            }
+
+            SchedulePoll(topic, state, now + state.interval);
+        }
+
+        if (news.empty())
+            return;
+
+        // deliver outside the lock, so sessions can (un)subscribe meanwhile:
+        for (auto &session : subscribers)
+            session->DeliverNews(topic, news);
+    }
+
+
+    /// <summary>
+    /// Reports in the log how many queries to the database have been made by
+    /// the poller, and how many have been saved by the adaptive schedule, in
+    /// comparison to polling every topic at a fixed interval.
+    /// </summary>
+    void TopicPoller::ReportSavings()
+    {
+        std::lock_guard<std::mutex> lock(m_topicsMutex);
+
+        // a query that reads nothing still consumes half a read capacity unit:
+        std::clog << "News poller has made " << m_queriesMade << " queries to database ("
+                  << m_queriesWithNews << " found news), and saved about "
+                  << static_cast<int64_t> (m_queriesSaved) << " queries (>= "
+                  << static_cast<int64_t> (m_queriesSaved / 2) << " read capacity units) "
+                     "in comparison to polling every "
+                  << duration_cast<seconds>(m_fixedInterval).count() << " secs\n" << std::endl;
+    }
+
+
+    /// <summary>
+    /// Polls the news in every topic with local subscribers, as each one
+    /// becomes due in its own schedule, until shutdown is requested.
+    /// </summary>
+    void TopicPoller::PollTopics()
+    {
+        const minutes reportInterval(1);
+
+        auto nextReport = steady_clock::now() + reportInterval;
+        uint64_t queriesReported(0);
+
+        std::vector<string> dueTopics;
+        std::vector<std::pair<string, string>> topics;
+
+        while (true)
+        {
+            try
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_topicsMutex);
+
+                    if (m_stopRequested)
+                        return;
+
+                    auto now = steady_clock::now();
+
+                    dueTopics.clear();
+                    m_timers.Advance(now, dueTopics);
+
+                    topics.clear();
+
+                    for (auto &topic : dueTopics)
+                    {
+                        auto &state = m_topics.at(topic);
+
+                        /* In case the poll fails badly, the topic is polled again
+                           later. Otherwise this is replaced after the poll: */
+                        state.timer = m_timers.Schedule(now + state.interval, topic);
+                        state.nextPoll = now + state.interval;
+
+                        // the previous query is still going on?
+                        if (state.polling)
+                            continue;
+
+                        state.polling = true;
+                        ++m_pollsInFlight;
+
+                        topics.emplace_back(topic, state.cursor);
+                    }
+                }
+
+                for (auto &entry : topics)
+                    PollTopic(entry.first, entry.second);
+
+                if (steady_clock::now() >= nextReport)
+                {
+                    nextReport = steady_clock::now() + reportInterval;
+
+                    if (m_queriesMade != queriesReported)
+                    {
+                        ReportSavings();
+                        NewsCache::GetInstance().Report(std::clog);
+                        queriesReported = m_queriesMade;
+                    }
+                }
+            }
+            catch (std::system_error &ex)
+            {
+                std::ostringstream oss;
+                oss << "System error when polling news: " << StdLibExt::GetDetailsFromSystemError(ex);
+                LogError("News poller failure", oss.str());
+            }
+            catch (std::exception &ex)
+            {
+                LogError("News poller failure", ex.what());
+            }
+
+            std::unique_lock<std::mutex> lock(m_topicsMutex);
+
+            // sleep until the next topic is due, or the schedule changes:
+            auto wakeTime = std::min(m_timers.GetNextEventTime(), steady_clock::now() + m_maxInterval);
+
+            m_wakeCondition.wait_until(lock, wakeTime, [this]() { return m_stopRequested || m_scheduleChanged; });
+
+            if (m_stopRequested)
+                return;
+
+            m_scheduleChanged = false;
+        }
+    }
+
+
+    /// <summary>
+    /// Stops polling news and waits for the polling thread,
+    /// as well as the queries in flight, to finish.
+    /// </summary>
+    void TopicPoller::Shutdown()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_topicsMutex);
+            m_stopRequested = true;
+        }
+
+        m_wakeCondition.notify_all();
+
+        if (m_thread.joinable())
+            m_thread.join();
+
+        std::unique_lock<std::mutex> lock(m_topicsMutex);
+        m_wakeCondition.wait(lock, [this]() { return m_pollsInFlight == 0; });
+    }
+
+}// end of namespace newsfeed
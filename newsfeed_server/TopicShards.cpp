@@ -0,0 +1,266 @@
+#include "TopicShards.h"
+#include "configuration.h"
+#include <algorithm>
+#include <iostream>
+
+namespace newsfeed
+{
+    using namespace std::chrono;
+
+    // how long the shards of a topic are remembered since last used, in refresh intervals
+    static const int idleIntervalsBeforePrune(10);
+
+    // separates the topic from the shard in a partition key
+    static const char shardSeparator('#');
+
+
+    /// <summary>
+    /// Initializes a new instance of the <see cref="TopicShards"/> class.
+    /// </summary>
+    TopicShards::TopicShards()
+        : m_raiseCount(0)
+    {
+        const auto &settings = Configuration::Get().settings;
+
+        m_baseShardCount = std::max(settings.dbNewsWriteShards, 1U);
+        m_maxShardCount = std::max(settings.dbHotTopicMaxShards, m_baseShardCount);
+        m_hotPostsPerSec = settings.dbHotTopicPostsPerSec;
+        m_refreshInterval = seconds(std::max(settings.dbTopicShardsRefreshSecs, 1U));
+    }
+
+
+    /// <summary>
+    /// Gets the entry of a topic, created if not there. The lock must be held by the caller.
+    /// </summary>
+    /// <param name="topic">The topic.</param>
+    /// <returns>The entry of the topic.</returns>
+    TopicShards::Entry &TopicShards::Touch(const string &topic)
+    {
+        auto iter = m_entries.find(topic);
+
+        if (iter == m_entries.end())
+        {
+            Entry entry;
+            entry.shardCount = m_baseShardCount;
+            entry.writtenShardCount = m_baseShardCount;
+            entry.activeFrom = 0;
+            entry.isRaising = false;
+            entry.nextShard = 0;
+            entry.rateSecond = 0;
+            entry.postsInSecond = 0;
+
+            iter = m_entries.emplace(topic, entry).first;
+        }
+
+        auto &entry = iter->second;
+        entry.usedAt = steady_clock::now();
+
+        // a raise has had the time to reach the other instances?
+        if (entry.writtenShardCount < entry.shardCount && entry.activeFrom <= time(nullptr))
+            entry.writtenShardCount = entry.shardCount;
+
+        return entry;
+    }
+
+
+    /// <summary>
+    /// Gets how many shards of a topic must be read.
+    /// </summary>
+    /// <param name="topic">The topic.</param>
+    /// <param name="shardCount">Receives the count of shards, as far as known.</param>
+    /// <returns>Whether the count is recent enough. If not, it must be
+    /// refreshed from the database, then set with <see cref="SetShardCount"/>.</returns>
+    bool TopicShards::GetShardCount(const string &topic, uint32_t &shardCount)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto &entry = Touch(topic);
+        shardCount = entry.shardCount;
+
+        // no topic is ever raised, hence nothing to refresh?
+        if (m_hotPostsPerSec == 0)
+            return true;
+
+        return steady_clock::now() - entry.refreshedAt < m_refreshInterval;
+    }
+
+
+    /// <summary>
+    /// Sets how many shards a topic has, as refreshed from (or written to) the database.
+    /// </summary>
+    /// <param name="topic">The topic.</param>
+    /// <param name="shardCount">The count of shards.</param>
+    /// <param name="activeFrom">Since when the shards can be written.</param>
+    void TopicShards::SetShardCount(const string &topic, uint32_t shardCount, time_t activeFrom)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto &entry = Touch(topic);
+        entry.refreshedAt = steady_clock::now();
+
+        if (shardCount <= entry.shardCount)
+            return;
+
+        entry.shardCount = shardCount;
+        entry.activeFrom = activeFrom;
+    }
+
+
+    /// <summary>
+    /// Forgets how recent the count of shards of a topic is, so it is refreshed next time.
+    /// </summary>
+    /// <param name="topic">The topic.</param>
+    void TopicShards::Invalidate(const string &topic)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto iter = m_entries.find(topic);
+
+        if (iter != m_entries.end())
+            iter->second.refreshedAt = steady_clock::time_point();
+    }
+
+
+    /// <summary>
+    /// Picks the shard where to write news posted in a topic, in turns, and accounts
+    /// for the rate of posts in the topic. When the rate exceeds the limit of a hot
+    /// topic, the caller is asked to raise the shards (which only one caller is).
+    /// </summary>
+    /// <param name="topic">The topic.</param>
+    /// <param name="raiseTo">Receives the count of shards to raise the topic to,
+    /// or zero when there is no need. The caller must then call <see cref="EndRaise"/>.</param>
+    /// <returns>The shard where to write the news.</returns>
+    uint32_t TopicShards::PickWriteShard(const string &topic, uint32_t &raiseTo)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto &entry = Touch(topic);
+
+        auto now = time(nullptr);
+
+        if (entry.rateSecond != now)
+        {
+            entry.rateSecond = now;
+            entry.postsInSecond = 0;
+        }
+
+        ++entry.postsInSecond;
+
+        raiseTo = 0;
+
+        if (m_hotPostsPerSec > 0
+            && entry.postsInSecond > m_hotPostsPerSec
+            && entry.shardCount < m_maxShardCount
+            && !entry.isRaising)
+        {
+            entry.isRaising = true;
+            raiseTo = std::min(entry.shardCount * 2, m_maxShardCount);
+            ++m_raiseCount;
+        }
+
+        return entry.nextShard++ % entry.writtenShardCount;
+    }
+
+
+    /// <summary>
+    /// Tells that the raise of shards requested by <see cref="PickWriteShard"/> is over.
+    /// </summary>
+    /// <param name="topic">The topic.</param>
+    void TopicShards::EndRaise(const string &topic)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto iter = m_entries.find(topic);
+
+        if (iter != m_entries.end())
+            iter->second.isRaising = false;
+    }
+
+
+    /// <summary>
+    /// Forgets the topics not used for a while. Their shards are read from the database again.
+    /// </summary>
+    void TopicShards::Prune()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto oldest = steady_clock::now() - m_refreshInterval * idleIntervalsBeforePrune;
+
+        for (auto iter = m_entries.begin(); iter != m_entries.end();)
+        {
+            if (iter->second.usedAt < oldest && !iter->second.isRaising)
+                iter = m_entries.erase(iter);
+            else
+                ++iter;
+        }
+    }
+
+
+    /// <summary>
+    /// Reports the hot topics, unless there has been none.
+    /// </summary>
+    /// <param name="out">The output stream.</param>
+    void TopicShards::Report(std::ostream &out)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_raiseCount == 0)
+            return;
+
+        auto hotCount = std::count_if(m_entries.begin(), m_entries.end(),
+            [this](const std::pair<const string, Entry> &entry) { return entry.second.shardCount > m_baseShardCount; }
+        );
+
+        out << "Topic shards: " << m_raiseCount << " raises for hot topics so far, "
+            << hotCount << " topics in use with more than " << m_baseShardCount << " shards\n" << std::endl;
+    }
+
+
+    /// <summary>
+    /// Tells whether a topic can be told apart from the shards of the others,
+    /// which is not the case when its name has the separator of the shards.
+    /// </summary>
+    /// <param name="topic">The topic.</param>
+    /// <returns>Whether the topic is valid.</returns>
+    bool TopicShards::IsValidTopic(const string &topic)
+    {
+        return topic.find(shardSeparator) == string::npos;
+    }
+
+
+    /// <summary>
+    /// Gets the partition key of a shard of a topic.
+    /// </summary>
+    /// <param name="topic">The topic.</param>
+    /// <param name="shard">The shard. The first one is the topic itself.</param>
+    /// <returns>The partition key.</returns>
+    string TopicShards::GetPartitionKey(const string &topic, uint32_t shard)
+    {
+        if (shard == 0)
+            return topic;
+
+        return topic + shardSeparator + std::to_string(shard);
+    }
+
+
+    /// <summary>
+    /// Gets the topic from the partition key of one of its shards.
+    /// </summary>
+    /// <param name="partitionKey">The partition key.</param>
+    /// <returns>The topic.</returns>
+    string TopicShards::GetTopic(const string &partitionKey)
+    {
+        auto pos = partitionKey.rfind(shardSeparator);
+
+        if (pos == string::npos
+            || pos + 1 == partitionKey.length()
+            || partitionKey[pos + 1] == '0'
+            || partitionKey.find_first_not_of("0123456789", pos + 1) != string::npos)
+        {
+            return partitionKey;
+        }
+
+        return partitionKey.substr(0, pos);
+    }
+
+}// end of namespace newsfeed
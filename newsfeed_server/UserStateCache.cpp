@@ -0,0 +1,106 @@
+#include "UserStateCache.h"
+#include "configuration.h"
+#include <algorithm>
+
+namespace newsfeed
+{
+    /// <summary>
+    /// Initializes a new instance of the <see cref="UserStateCache"/> class.
+    /// </summary>
+    UserStateCache::UserStateCache()
+        : m_maxEntries(std::max(Configuration::Get().settings.dbUserCacheMaxEntries, 1U))
+    {
+    }
+
+
+    /// <summary>
+    /// Gets the state of a user.
+    /// </summary>
+    /// <param name="userId">The user ID.</param>
+    /// <param name="state">Receives the state of the user.</param>
+    /// <returns>Whether the user was found in the cache.</returns>
+    bool UserStateCache::Get(const string &userId, UserState &state)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto iter = m_index.find(userId);
+
+        if (iter == m_index.end())
+            return false;
+
+        m_entries.splice(m_entries.begin(), m_entries, iter->second);
+        state = iter->second->second;
+        return true;
+    }
+
+
+    /// <summary>
+    /// Puts (or replaces) the state of a user.
+    /// </summary>
+    /// <param name="userId">The user ID.</param>
+    /// <param name="state">The state of the user, as written to the database.</param>
+    void UserStateCache::Put(const string &userId, const UserState &state)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto iter = m_index.find(userId);
+
+        if (iter != m_index.end())
+        {
+            m_entries.splice(m_entries.begin(), m_entries, iter->second);
+            iter->second->second = state;
+            return;
+        }
+
+        m_entries.emplace_front(userId, state);
+        m_index[userId] = m_entries.begin();
+
+        if (m_entries.size() > m_maxEntries)
+        {
+            m_index.erase(m_entries.back().first);
+            m_entries.pop_back();
+        }
+    }
+
+
+    /// <summary>
+    /// Updates the last feed of a user in the cache, as long as the user
+    /// is there, subscribing to the given topic, and was fed earlier news.
+    /// </summary>
+    /// <param name="userId">The user ID.</param>
+    /// <param name="topic">The topic where the news were fed from.</param>
+    /// <param name="lastKey">The sort key of the last news fed to the user.</param>
+    void UserStateCache::SetLastFeedKey(const string &userId, const string &topic, const string &lastKey)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto iter = m_index.find(userId);
+
+        if (iter == m_index.end())
+            return;
+
+        auto &state = iter->second->second;
+
+        if (state.topic == topic && state.lastFeedKey < lastKey)
+            state.lastFeedKey = lastKey;
+    }
+
+
+    /// <summary>
+    /// Removes a user from the cache, so the next read goes to the database.
+    /// </summary>
+    /// <param name="userId">The user ID.</param>
+    void UserStateCache::Remove(const string &userId)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto iter = m_index.find(userId);
+
+        if (iter == m_index.end())
+            return;
+
+        m_entries.erase(iter->second);
+        m_index.erase(iter);
+    }
+
+}// end of namespace newsfeed
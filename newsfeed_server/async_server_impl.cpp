@@ -0,0 +1,644 @@
+#include "async_server_impl.h"
+#include "Session.h"
+#include "OutboundQueue.h"
+#include "common.h"
+#include <grpc++/alarm.h>
+#include <exception>
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <atomic>
+
+namespace newsfeed
+{
+    using namespace std::chrono;
+
+
+    ////////////////////////////
+    // AsyncTalkSession Class
+    ////////////////////////////
+
+    /// <summary>
+    /// State machine for a conversation with a client in the asynchronous engine.
+    /// Every asynchronous operation in the call posts a tag that brings it back here.
+    /// Responses and news wait in an outbound queue, from which the next message is
+    /// written upon completion of the former, so the stream has a single writer. When
+    /// news are delivered by the poller, an alarm that expires immediately wakes up
+    /// the session in its completion queue to start writing them. Likewise, requests
+    /// that need the database are responded from a thread of the store through an
+    /// alarm, so the threads of the completion queues never wait for the database,
+    /// and the next request is not read until the response to the former is written.
+    /// </summary>
+    class AsyncTalkSession : public Session
+    {
+    public:
+
+        enum Event { Started, ReadDone, WriteDone, NewsReady, ResponseReady, FinishDone, CallDone, NumEvents };
+
+        /// <summary>
+        /// A tag for the completion queue, which dispatches an event to its session.
+        /// </summary>
+        class Tag
+        {
+        private:
+
+            AsyncTalkSession *m_session;
+            Event m_event;
+
+        public:
+
+            void Set(AsyncTalkSession *session, Event event)
+            {
+                m_session = session;
+                m_event = event;
+            }
+
+            void Proceed(bool ok)
+            {
+                m_session->OnEvent(m_event, ok);
+            }
+        };
+
+    private:
+
+        proto::Newsfeed::AsyncService &m_service;
+
+        ServerCompletionQueue *m_cq;
+
+        ServerContext m_context;
+
+        AsyncIOStream m_stream;
+
+        std::shared_ptr<AsyncTalkSession> m_self; // keeps this alive while the call goes on
+
+        std::mutex m_mutex;
+
+        proto::req_envelope m_request;
+
+        proto::req_envelope m_outMessage; // being written
+
+        uint64_t m_outNewsDone; // once the message is written
+
+        OutboundQueue m_outQueue;
+
+        std::mutex m_alarmMutex;
+
+        std::unique_ptr<Alarm> m_newsAlarm;
+
+        bool m_newsAlarmPending;
+
+        std::unique_ptr<Alarm> m_responseAlarm;
+
+        proto::req_envelope m_response; // waiting for the alarm
+
+        Status m_responseStatus;
+
+        bool m_tooSlow;
+
+        Status m_finalStatus;
+
+        Tag m_tags[NumEvents];
+
+        bool m_readPending;
+        bool m_requestPending;
+        bool m_writePending;
+        bool m_finishPending;
+        bool m_noMoreReads;
+        bool m_finished;
+        bool m_callDone;
+
+        std::atomic<bool> m_callOver; // set without the lock, so work in progress can see it
+
+        void StartRead();
+
+        void Write(proto::req_envelope &&message);
+
+        void WriteNext();
+
+        void SendAvailableNews();
+
+        void FinishWhenDrained();
+
+        void OnResponse(const Status &status, proto::req_envelope &response);
+
+        void SendResponse(bool ok);
+
+        bool OnStarted(bool ok);
+
+        void OnReadDone(bool ok);
+
+        void OnWriteDone(bool ok);
+
+        void OnEvent(Event event, bool ok);
+
+        AsyncTalkSession(proto::Newsfeed::AsyncService &service, ServerCompletionQueue *cq);
+
+    protected:
+
+        virtual bool SendNews(const NewsItem &news) override;
+
+        virtual bool IsCancelled() const override { return m_callOver.load(std::memory_order_acquire); }
+
+    public:
+
+        static void Spawn(proto::Newsfeed::AsyncService &service, ServerCompletionQueue *cq);
+    };
+
+
+    /// <summary>
+    /// Initializes a new instance of the <see cref="AsyncTalkSession"/> class.
+    /// </summary>
+    /// <param name="service">The asynchronous service.</param>
+    /// <param name="cq">The completion queue that will drive this session.</param>
+    AsyncTalkSession::AsyncTalkSession(proto::Newsfeed::AsyncService &service, ServerCompletionQueue *cq)
+        : m_service(service)
+        , m_cq(cq)
+        , m_stream(&m_context)
+        , m_outNewsDone(0)
+        , m_newsAlarmPending(false)
+        , m_responseStatus(Status::OK)
+        , m_tooSlow(false)
+        , m_finalStatus(Status::OK)
+        , m_readPending(false)
+        , m_requestPending(false)
+        , m_writePending(false)
+        , m_finishPending(false)
+        , m_noMoreReads(false)
+        , m_finished(false)
+        , m_callDone(false)
+        , m_callOver(false)
+    {
+        for (int idx = 0; idx < NumEvents; ++idx)
+            m_tags[idx].Set(this, static_cast<Event> (idx));
+    }
+
+
+    /// <summary>
+    /// Creates a new session, which immediately waits for a client to start a conversation.
+    /// </summary>
+    /// <param name="service">The asynchronous service.</param>
+    /// <param name="cq">The completion queue that will drive the session.</param>
+    void AsyncTalkSession::Spawn(proto::Newsfeed::AsyncService &service, ServerCompletionQueue *cq)
+    {
+        std::shared_ptr<AsyncTalkSession> session(new AsyncTalkSession(service, cq));
+        session->m_self = session;
+
+        session->m_context.AsyncNotifyWhenDone(&session->m_tags[CallDone]);
+
+        service.RequestTalk(&session->m_context, &session->m_stream, cq, cq, &session->m_tags[Started]);
+    }
+
+
+    /// <summary>
+    /// Issues the reading of the next request from the client.
+    /// </summary>
+    void AsyncTalkSession::StartRead()
+    {
+        m_readPending = true;
+        m_stream.Read(&m_request, &m_tags[ReadDone]);
+    }
+
+
+    /// <summary>
+    /// Enqueues a message to send to the client. Because only one write can
+    /// be pending at a time, the next write is issued upon completion of the former.
+    /// </summary>
+    /// <param name="message">The message to send.</param>
+    void AsyncTalkSession::Write(proto::req_envelope &&message)
+    {
+        if (m_finished || m_finishPending)
+            return;
+
+        m_outQueue.PushMessage(std::move(message));
+
+        if (!m_writePending)
+            WriteNext();
+    }
+
+
+    /// <summary>
+    /// Issues the write of the next message waiting in the outbound queue, if any.
+    /// </summary>
+    void AsyncTalkSession::WriteNext()
+    {
+        if (m_finished || m_finishPending || !m_outQueue.Pop(m_outMessage, m_outNewsDone))
+            return;
+
+        m_writePending = true;
+        m_stream.Write(m_outMessage, &m_tags[WriteDone]);
+    }
+
+
+    /// <summary>
+    /// Receives news delivered by the poller and wakes up the session
+    /// in its completion queue, so they can be sent to the client.
+    /// When the client does not keep up with the news, the slow consumer
+    /// policy of the queue might require the call to be cancelled, so the
+    /// client can reconnect and catch up.
+    /// </summary>
+    /// <param name="news">The news.</param>
+    /// <returns>Whether the news has been enqueued.</returns>
+    bool AsyncTalkSession::SendNews(const NewsItem &news)
+    {
+        if (m_tooSlow)
+            return false;
+
+        switch (m_outQueue.PushNews(news))
+        {
+        case OutboundQueue::PushResult::Enqueued:
+            break;
+
+        case OutboundQueue::PushResult::Disconnect:
+            m_tooSlow = true;
+            LogError("Client is too slow to receive news!", "Call will be cancelled");
+            m_context.TryCancel();
+            return false;
+
+        default:
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(m_alarmMutex);
+
+        if (!m_newsAlarmPending)
+        {
+            m_newsAlarmPending = true;
+            m_newsAlarm.reset(new Alarm(m_cq, system_clock::now(), &m_tags[NewsReady]));
+        }
+
+        return true;
+    }
+
+
+    /// <summary>
+    /// Starts sending back to the client the news waiting in the outbound queue.
+    /// If a write is already pending, they will follow upon its completion.
+    /// </summary>
+    void AsyncTalkSession::SendAvailableNews()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_alarmMutex);
+            m_newsAlarmPending = false;
+        }
+
+        if (m_callDone)
+            return;
+
+        if (!m_writePending)
+            WriteNext();
+    }
+
+
+    /// <summary>
+    /// Finishes the call as soon as there are no more requests
+    /// to read and every enqueued message has been written.
+    /// </summary>
+    void AsyncTalkSession::FinishWhenDrained()
+    {
+        if (!m_noMoreReads || m_readPending || m_writePending || m_finishPending || m_finished)
+            return;
+
+        m_finishPending = true;
+        m_stream.Finish(m_finalStatus, &m_tags[FinishDone]);
+    }
+
+
+    /// <summary>
+    /// Handles the start of a conversation with a client.
+    /// </summary>
+    /// <param name="ok">Whether the call has actually started.</param>
+    /// <returns>Whether the call has started.</returns>
+    bool AsyncTalkSession::OnStarted(bool ok)
+    {
+        // server is shutting down?
+        if (!ok)
+            return false;
+
+        // be ready for the next client:
+        Spawn(m_service, m_cq);
+
+        StartRead();
+        return true;
+    }
+
+
+    /// <summary>
+    /// Handles the arrival of a request from the client.
+    /// </summary>
+    /// <param name="ok">Whether a request has been read.</param>
+    void AsyncTalkSession::OnReadDone(bool ok)
+    {
+        m_readPending = false;
+
+        // client has closed its side of the stream (or the connection broke)?
+        if (!ok || m_noMoreReads)
+        {
+            m_noMoreReads = true;
+            FinishWhenDrained();
+            return;
+        }
+
+        auto self = std::static_pointer_cast<AsyncTalkSession> (shared_from_this());
+
+        // the next request is read once this one is responded:
+        m_requestPending = true;
+
+        HandleRequest(m_request, [self](const Status &status, proto::req_envelope &response)
+        {
+            self->OnResponse(status, response);
+        });
+
+        m_request.Clear();
+    }
+
+
+    /// <summary>
+    /// Receives the response to a request, maybe in a thread of the store, and
+    /// wakes up the session in its completion queue, so it can be sent to the client.
+    /// </summary>
+    /// <param name="status">The operation status.</param>
+    /// <param name="response">The response.</param>
+    void AsyncTalkSession::OnResponse(const Status &status, proto::req_envelope &response)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_alarmMutex);
+
+            m_responseStatus = status;
+            m_response = std::move(response);
+
+            if (!m_callOver.load(std::memory_order_acquire))
+            {
+                m_responseAlarm.reset(new Alarm(m_cq, system_clock::now(), &m_tags[ResponseReady]));
+                return;
+            }
+        }
+
+        // client gone? then the response goes nowhere, and the completion queue might be shutting down:
+        OnEvent(ResponseReady, false);
+    }
+
+
+    /// <summary>
+    /// Sends back to the client the response to the request in progress,
+    /// then reads the next request, unless the conversation must end.
+    /// </summary>
+    /// <param name="ok">Whether the alarm has expired, rather than being cancelled.</param>
+    void AsyncTalkSession::SendResponse(bool ok)
+    {
+        proto::req_envelope response;
+        Status status;
+
+        {
+            std::lock_guard<std::mutex> lock(m_alarmMutex);
+            response.Swap(&m_response);
+            status = m_responseStatus;
+        }
+
+        m_requestPending = false;
+
+        if (!ok || m_callDone)
+            return;
+
+        if (response.has_type())
+            Write(std::move(response));
+
+        if (!status.ok())
+        {
+            m_finalStatus = status;
+            m_noMoreReads = true;
+            FinishWhenDrained();
+            return;
+        }
+
+        StartRead();
+    }
+
+
+    /// <summary>
+    /// Handles the completion of a write in the stream.
+    /// </summary>
+    /// <param name="ok">Whether the message has been written.</param>
+    void AsyncTalkSession::OnWriteDone(bool ok)
+    {
+        m_writePending = false;
+
+        if (!ok)
+        {
+            /* The stream is broken, hence the pending read
+               will fail as well and take the call to its end */
+            m_outQueue.Close();
+
+            m_finalStatus = ErrorStatus(StatusCode::UNKNOWN,
+                                        "Failed to write message on stream!",
+                                        "Attempted to send message to client");
+            m_noMoreReads = true;
+            return;
+        }
+
+        if (m_outNewsDone > 0)
+            OnNewsWritten(m_outNewsDone);
+
+        WriteNext();
+        FinishWhenDrained();
+    }
+
+
+    /// <summary>
+    /// Dispatches an event to its handler, then deletes this
+    /// session when no more events are expected for it.
+    /// </summary>
+    /// <param name="event">The event.</param>
+    /// <param name="ok">Whether the operation has been successful.</param>
+    void AsyncTalkSession::OnEvent(Event event, bool ok)
+    {
+        bool isOver(false);
+
+        /* The client is gone, so tell right away whoever is working on its
+           behalf (maybe holding the lock) to give up, and release producers: */
+        if (event == CallDone)
+        {
+            m_callOver.store(true, std::memory_order_release);
+            m_outQueue.Close();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            try
+            {
+                switch (event)
+                {
+                case Started:
+                    isOver = !OnStarted(ok);
+                    break;
+
+                case ReadDone:
+                    OnReadDone(ok);
+                    break;
+
+                case WriteDone:
+                    OnWriteDone(ok);
+                    break;
+
+                case NewsReady:
+                    SendAvailableNews();
+                    break;
+
+                case ResponseReady:
+                    SendResponse(ok);
+                    break;
+
+                case FinishDone:
+                    m_finishPending = false;
+                    m_finished = true;
+                    break;
+
+                case CallDone:
+                    m_callDone = true;
+                    break;
+
+                default:
+                    break;
+                }
+            }
+            catch (std::system_error &ex)
+            {
+                std::ostringstream oss;
+                oss << "News feed service host had a system error: " << StdLibExt::GetDetailsFromSystemError(ex);
+                m_finalStatus = ErrorStatus(StatusCode::INTERNAL, "Server error", oss.str());
+                m_noMoreReads = true;
+                FinishWhenDrained();
+            }
+            catch (std::exception &ex)
+            {
+                std::ostringstream oss;
+                oss << "News feed service host had a generic failure: " << ex.what();
+                m_finalStatus = ErrorStatus(StatusCode::INTERNAL, "Server error", oss.str());
+                m_noMoreReads = true;
+                FinishWhenDrained();
+            }
+
+            if (!isOver)
+            {
+                isOver = m_callDone
+                    && !m_readPending
+                    && !m_requestPending
+                    && !m_writePending
+                    && !m_finishPending;
+            }
+        }
+
+        /* Stop the news feed out of the lock, because the poller
+           might be delivering news to this session right now: */
+        if (event == CallDone)
+            Close();
+
+        if (isOver)
+        {
+            std::lock_guard<std::mutex> lock(m_alarmMutex);
+            isOver = !m_newsAlarmPending;
+        }
+
+        if (!isOver)
+            return;
+
+        // with no request nor write in progress, the user and the news written can no longer change:
+        if (m_callDone)
+        {
+            SaveLastFeed();
+            m_outQueue.ReportCounters(GetUserId());
+        }
+
+        // the poller might still hold a reference, but no longer delivers news:
+        m_self.reset();
+    }
+
+
+    ///////////////////////////////
+    // AsyncServiceHostImpl Class
+    ///////////////////////////////
+
+    /// <summary>
+    /// Registers the service on the server builder and creates the completion queues.
+    /// This must be called before the server is built.
+    /// </summary>
+    /// <param name="builder">The server builder.</param>
+    /// <param name="numThreads">How many threads will poll the completion queues.</param>
+    void AsyncServiceHostImpl::RegisterOn(ServerBuilder &builder, unsigned int numThreads)
+    {
+        builder.RegisterService(&m_service);
+
+        if (numThreads == 0)
+            numThreads = 1;
+
+        for (unsigned int idx = 0; idx < numThreads; ++idx)
+            m_completionQueues.push_back(builder.AddCompletionQueue());
+    }
+
+
+    /// <summary>
+    /// Waits on a completion queue for events and dispatches them to their sessions.
+    /// </summary>
+    /// <param name="cq">The completion queue.</param>
+    void AsyncServiceHostImpl::PollCompletionQueue(ServerCompletionQueue *cq)
+    {
+        void *tag;
+        bool ok;
+
+        while (cq->Next(&tag, &ok))
+            static_cast<AsyncTalkSession::Tag *> (tag)->Proceed(ok);
+    }
+
+
+    /// <summary>
+    /// Starts accepting conversations and polling the completion queues.
+    /// This must be called after the server is built and started.
+    /// </summary>
+    void AsyncServiceHostImpl::Start()
+    {
+        try
+        {
+            for (auto &cq : m_completionQueues)
+            {
+                AsyncTalkSession::Spawn(m_service, cq.get());
+                m_threads.push_back(std::thread(&PollCompletionQueue, cq.get()));
+            }
+        }
+        catch (std::system_error &ex)
+        {
+            std::ostringstream oss;
+            oss << "System error when starting asynchronous engine: " << StdLibExt::GetDetailsFromSystemError(ex);
+            throw AppException(oss.str());
+        }
+    }
+
+
+    /// <summary>
+    /// Shuts down the completion queues and waits for their threads to finish.
+    /// This must be called after the server has been shut down.
+    /// </summary>
+    void AsyncServiceHostImpl::Shutdown()
+    {
+        for (auto &cq : m_completionQueues)
+            cq->Shutdown();
+
+        // never started? then drain the queues here:
+        if (m_threads.empty())
+        {
+            void *tag;
+            bool ok;
+
+            for (auto &cq : m_completionQueues)
+                while (cq->Next(&tag, &ok));
+        }
+
+        for (auto &thread : m_threads)
+            thread.join();
+
+        m_threads.clear();
+        m_completionQueues.clear();
+    }
+
+}// end of namespace newsfeed
@@ -2,6 +2,7 @@
 #include <exception>
 #include <sstream>
 #include <Poco/AutoPtr.h>
+#include <Poco/StringTokenizer.h>
 #include <Poco/Util/XMLConfiguration.h>
 
 namespace newsfeed
@@ -20,14 +21,67 @@ namespace newsfeed
         // Load the configurations in the file
         AutoPtr<XMLConfiguration> config(new XMLConfiguration("./newsfeed_server.config"));
 
-        settings.serviceEndpoint         = config->getString("entry[@key='serviceEndpoint'][@value]", "0.0.0.0:8080");
-        settings.awsRegion               = config->getString("entry[@key='awsRegion'][@value]", "us-east-1");
-        settings.awsAccessKeyId          = config->getString("entry[@key='awsAccessKeyId'][@value]", "");
-        settings.awsSecretKey            = config->getString("entry[@key='awsSecretKey'][@value]", "");
-        settings.dbReqMaxRetryCount      = config->getUInt("entry[@key='dbReqMaxRetryCount'][@value]", 2);
-        settings.dbReqRetryIntervalMs    = config->getUInt("entry[@key='dbReqRetryIntervalMs'][@value]", 30);
-        settings.dbOldNewsPurgeAgeSecs   = config->getUInt("entry[@key='dbOldNewsPurgeAgeSecs'][@value]", 60);
-        settings.newsPollingIntervalSecs = config->getUInt("entry[@key='newsPollingIntervalSecs'][@value]", 5);
+        settings.serviceEndpoint             = config->getString("entry[@key='serviceEndpoint'][@value]", "0.0.0.0:8080");
+        settings.serverEngine                = config->getString("entry[@key='serverEngine'][@value]", "sync");
+        settings.asyncEngineThreadCount      = config->getUInt("entry[@key='asyncEngineThreadCount'][@value]", 4);
+        settings.syncEngineWriterThreadCount = config->getUInt("entry[@key='syncEngineWriterThreadCount'][@value]", 4);
+        settings.sessionOutQueueMaxNews      = config->getUInt("entry[@key='sessionOutQueueMaxNews'][@value]", 1000);
+        settings.sessionOutQueueMaxBytes     = config->getUInt("entry[@key='sessionOutQueueMaxBytes'][@value]", 1048576);
+        settings.slowConsumerPolicy          = config->getString("entry[@key='slowConsumerPolicy'][@value]", "disconnect");
+        settings.storeBackend                = config->getString("entry[@key='storeBackend'][@value]", "dynamodb");
+        settings.awsRegion                   = config->getString("entry[@key='awsRegion'][@value]", "us-east-1");
+        settings.awsAccessKeyId              = config->getString("entry[@key='awsAccessKeyId'][@value]", "");
+        settings.awsSecretKey                = config->getString("entry[@key='awsSecretKey'][@value]", "");
+        settings.dbReqMaxRetryCount          = config->getUInt("entry[@key='dbReqMaxRetryCount'][@value]", 2);
+        settings.dbReqRetryIntervalMs        = config->getUInt("entry[@key='dbReqRetryIntervalMs'][@value]", 30);
+        settings.dbReqRetryMaxIntervalMs     = config->getUInt("entry[@key='dbReqRetryMaxIntervalMs'][@value]", 1000);
+        settings.dbReqRetryBudgetPct         = config->getUInt("entry[@key='dbReqRetryBudgetPct'][@value]", 10);
+        settings.dbReqRetryBudgetBurst       = config->getUInt("entry[@key='dbReqRetryBudgetBurst'][@value]", 20);
+        settings.dbReadHedgePercentile       = config->getUInt("entry[@key='dbReadHedgePercentile'][@value]", 0);
+        settings.dbReadHedgeMaxPct           = config->getUInt("entry[@key='dbReadHedgeMaxPct'][@value]", 5);
+        settings.dbUserCacheMaxEntries       = config->getUInt("entry[@key='dbUserCacheMaxEntries'][@value]", 100000);
+        settings.dbAsyncThreadCount          = config->getUInt("entry[@key='dbAsyncThreadCount'][@value]", 16);
+        settings.dbConnPoolMinClients        = config->getUInt("entry[@key='dbConnPoolMinClients'][@value]", 2);
+        settings.dbConnPoolMaxClients        = config->getUInt("entry[@key='dbConnPoolMaxClients'][@value]", 16);
+        settings.dbConnPoolIdleSecs          = config->getUInt("entry[@key='dbConnPoolIdleSecs'][@value]", 300);
+        settings.dbClientMaxConnections      = config->getUInt("entry[@key='dbClientMaxConnections'][@value]", 25);
+        settings.dbConnectTimeoutMs          = config->getUInt("entry[@key='dbConnectTimeoutMs'][@value]", 1000);
+        settings.dbRequestTimeoutMs          = config->getUInt("entry[@key='dbRequestTimeoutMs'][@value]", 3000);
+        settings.dbQueryPageSize             = config->getUInt("entry[@key='dbQueryPageSize'][@value]", 100);
+        settings.dbNodeId                    = config->getUInt("entry[@key='dbNodeId'][@value]", 0);
+        settings.dbMaxClockSkewMs            = config->getUInt("entry[@key='dbMaxClockSkewMs'][@value]", 500);
+        settings.dbNewsWriteShards           = config->getUInt("entry[@key='dbNewsWriteShards'][@value]", 1);
+        settings.dbHotTopicPostsPerSec       = config->getUInt("entry[@key='dbHotTopicPostsPerSec'][@value]", 0);
+        settings.dbHotTopicMaxShards         = config->getUInt("entry[@key='dbHotTopicMaxShards'][@value]", 8);
+        settings.dbTopicShardsRefreshSecs    = config->getUInt("entry[@key='dbTopicShardsRefreshSecs'][@value]", 10);
+        settings.dbNewsPutBatchWindowMs      = config->getUInt("entry[@key='dbNewsPutBatchWindowMs'][@value]", 0);
+        settings.dbFeedCheckpointSecs        = config->getUInt("entry[@key='dbFeedCheckpointSecs'][@value]", 0);
+        settings.dbUserTableWriteCapacity    = config->getUInt("entry[@key='dbUserTableWriteCapacity'][@value]", 100);
+        settings.dbFeedCheckpointCapacityPct = config->getUInt("entry[@key='dbFeedCheckpointCapacityPct'][@value]", 50);
+        settings.dbUserReadConsistency       = config->getString("entry[@key='dbUserReadConsistency'][@value]", "strong");
+        settings.dbNewsReadConsistency       = config->getString("entry[@key='dbNewsReadConsistency'][@value]", "eventual");
+        settings.retentionSweepIntervalSecs  = config->getUInt("entry[@key='retentionSweepIntervalSecs'][@value]", 300);
+        settings.retentionMaxAgeSecs         = config->getUInt("entry[@key='retentionMaxAgeSecs'][@value]", 0);
+        settings.retentionMaxNewsPerTopic    = config->getUInt("entry[@key='retentionMaxNewsPerTopic'][@value]", 0);
+        settings.retentionTopicPolicies      = config->getString("entry[@key='retentionTopicPolicies'][@value]", "");
+        settings.retentionMaxWritesInFlight  = config->getUInt("entry[@key='retentionMaxWritesInFlight'][@value]", 4);
+        settings.dbNewsTableWriteCapacity    = config->getUInt("entry[@key='dbNewsTableWriteCapacity'][@value]", 100);
+        settings.retentionWriteCapacityPct   = config->getUInt("entry[@key='retentionWriteCapacityPct'][@value]", 20);
+        settings.newsPollingIntervalSecs     = config->getUInt("entry[@key='newsPollingIntervalSecs'][@value]", 5);
+        settings.newsPollingMinIntervalMs    = config->getUInt("entry[@key='newsPollingMinIntervalMs'][@value]", 500);
+        settings.newsPollingMaxIntervalMs    = config->getUInt("entry[@key='newsPollingMaxIntervalMs'][@value]", 30000);
+        settings.newsBatchMaxSize            = config->getUInt("entry[@key='newsBatchMaxSize'][@value]", 100);
+        settings.newsCacheMaxNewsPerTopic    = config->getUInt("entry[@key='newsCacheMaxNewsPerTopic'][@value]", 1000);
+        settings.newsCacheMaxAgeSecs         = config->getUInt("entry[@key='newsCacheMaxAgeSecs'][@value]", 600);
+        settings.newsCacheMaxBytes           = config->getUInt("entry[@key='newsCacheMaxBytes'][@value]", 67108864);
+        settings.peerForwardTimeoutMs        = config->getUInt("entry[@key='peerForwardTimeoutMs'][@value]", 500);
+
+        // other instances of the service to forward posted news (comma separated):
+        Poco::StringTokenizer peers(config->getString("entry[@key='peerEndpoints'][@value]", ""),
+                                    ",",
+                                    Poco::StringTokenizer::TOK_IGNORE_EMPTY | Poco::StringTokenizer::TOK_TRIM);
+
+        settings.peerEndpoints.assign(peers.begin(), peers.end());
     }
 
 
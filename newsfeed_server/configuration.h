@@ -2,6 +2,7 @@
 #define CONFIGURATION_H
 
 #include <string>
+#include <vector>
 #include <memory>
 #include <cinttypes>
 
@@ -30,6 +31,20 @@ namespace newsfeed
 
             string serviceEndpoint;
 
+            string serverEngine;
+
+            uint32_t asyncEngineThreadCount;
+
+            uint32_t syncEngineWriterThreadCount;
+
+            uint32_t sessionOutQueueMaxNews;
+
+            uint32_t sessionOutQueueMaxBytes;
+
+            string slowConsumerPolicy;
+
+            string storeBackend;
+
             string awsRegion;
 
             string awsAccessKeyId;
@@ -40,10 +55,90 @@ namespace newsfeed
 
             uint32_t dbReqRetryIntervalMs;
 
-            uint32_t dbOldNewsPurgeAgeSecs;
+            uint32_t dbReqRetryMaxIntervalMs;
+
+            uint32_t dbReqRetryBudgetPct;
+
+            uint32_t dbReqRetryBudgetBurst;
+
+            uint32_t dbReadHedgePercentile;
+
+            uint32_t dbReadHedgeMaxPct;
+
+            uint32_t dbUserCacheMaxEntries;
+
+            uint32_t dbAsyncThreadCount;
+
+            uint32_t dbConnPoolMinClients;
+
+            uint32_t dbConnPoolMaxClients;
+
+            uint32_t dbConnPoolIdleSecs;
+
+            uint32_t dbClientMaxConnections;
+
+            uint32_t dbConnectTimeoutMs;
+
+            uint32_t dbRequestTimeoutMs;
+
+            uint32_t dbQueryPageSize;
+
+            uint32_t dbNodeId;
+
+            uint32_t dbMaxClockSkewMs;
+
+            uint32_t dbNewsWriteShards;
+
+            uint32_t dbHotTopicPostsPerSec;
+
+            uint32_t dbHotTopicMaxShards;
+
+            uint32_t dbTopicShardsRefreshSecs;
+
+            uint32_t dbNewsPutBatchWindowMs;
+
+            uint32_t dbFeedCheckpointSecs;
+
+            uint32_t dbUserTableWriteCapacity;
+
+            uint32_t dbFeedCheckpointCapacityPct;
+
+            string dbUserReadConsistency;
+
+            string dbNewsReadConsistency;
+
+            uint32_t retentionSweepIntervalSecs;
+
+            uint32_t retentionMaxAgeSecs;
+
+            uint32_t retentionMaxNewsPerTopic;
+
+            string retentionTopicPolicies;
+
+            uint32_t retentionMaxWritesInFlight;
+
+            uint32_t dbNewsTableWriteCapacity;
+
+            uint32_t retentionWriteCapacityPct;
 
             uint32_t newsPollingIntervalSecs;
 
+            uint32_t newsPollingMinIntervalMs;
+
+            uint32_t newsPollingMaxIntervalMs;
+
+            uint32_t newsBatchMaxSize;
+
+            uint32_t newsCacheMaxNewsPerTopic;
+
+            uint32_t newsCacheMaxAgeSecs;
+
+            uint32_t newsCacheMaxBytes;
+
+            std::vector<string> peerEndpoints;
+
+            uint32_t peerForwardTimeoutMs;
+
         } settings;
 
         static const Configuration &Get();
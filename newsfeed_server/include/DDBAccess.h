@@ -4,27 +4,104 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <deque>
+#include <unordered_map>
 #include <atomic>
 #include <mutex>
 #include <chrono>
 #include <memory>
+#include <functional>
+#include <exception>
+#include <condition_variable>
+#include <iosfwd>
 #include <boost/lockfree/queue.hpp>
+#include "NewsStore.h"
 #include "DbConnPool.h"
+#include "TaskTimer.h"
+#include "RetryPolicy.h"
+#include "HedgePolicy.h"
+#include "UserStateCache.h"
+#include "NewsPutBatcher.h"
+#include "TopicShards.h"
 
 namespace newsfeed
 {
     using std::string;
 
 
+    class AsyncOperation;
+
+
     /// <summary>
-    /// Provides access to AWS DynamoDB database.
+    /// Stores the users and their news in AWS DynamoDB database. Every operation is
+    /// built on the asynchronous requests of the SDK, so the
+    /// caller is not held while a request is in flight, and failed requests
+    /// are retried upon a timer, as allowed by the retry policy. Slow reads might
+    /// be hedged with a duplicate request, as allowed by the hedge policy. The state
+    /// of the users is cached, so the news of a user take no read of the user. News
+    /// posted at about the same time might be written together in batches, and the
+    /// last feed of the users is kept in memory, then written behind. The news of a
+    /// topic might be spread across several shards, which are read in parallel. The
+    /// callbacks run in a thread of the SDK.
     /// </summary>
-    class DDBAccess
+    class DDBAccess : public NewsStore
     {
     private:
 
+        friend class AsyncOperation;
+
         DbConnPool m_dbConnPool;
 
+        TaskTimer m_retryTimer;
+
+        RetryPolicy m_retryPolicy;
+
+        HedgePolicy m_hedgePolicy;
+
+        UserStateCache m_userCache;
+
+        NewsPutBatcher m_putBatcher;
+
+        TopicShards m_topicShards;
+
+        /// <summary>
+        /// Last feed of a user, not written to the database yet.
+        /// </summary>
+        struct FeedCheckpoint
+        {
+            string topic;
+            string lastKey;
+            std::chrono::steady_clock::time_point since; // when it started to wait
+        };
+
+        std::mutex m_checkpointsMutex;
+
+        std::unordered_map<string, FeedCheckpoint> m_checkpoints; // by user ID
+
+        std::deque<std::pair<string, std::chrono::steady_clock::time_point>> m_checkpointOrder; // user IDs, oldest first
+
+        double m_checkpointUnitsPerSec;
+
+        double m_maxCheckpointUnits;
+
+        double m_checkpointUnits; // tokens available for writes of last feeds
+
+        std::chrono::steady_clock::time_point m_lastCheckpointRefill;
+
+        std::mutex m_asyncOpsMutex;
+
+        std::condition_variable m_asyncOpsCondition;
+
+        uint32_t m_asyncOpsCount; // asynchronous operations in flight
+
+        std::mutex m_capacityMutex;
+
+        double m_readCapacityUsed;
+
+        double m_readCapacitySaved; // by eventually consistent reads
+
+        double m_readCapacityReported;
+
         static std::atomic<DDBAccess *> singletonAtomicPtr;
 
         static std::unique_ptr<DDBAccess> singleton;
@@ -33,19 +110,57 @@ namespace newsfeed
 
         DDBAccess();
 
+        void ScheduleReport();
+
+        void AccountReadCapacity(double units, bool consistent);
+
+        void ReportReadCapacity(std::ostream &out);
+
+        void PutNewsBatch(std::vector<PendingNewsPut> &batch);
+
+        void ScheduleCheckpointFlush();
+
+        void FlushCheckpoints(bool all);
+
+        void DiscardCheckpoint(const string &userId, const string &topic, const string &lastKey);
+
+        void RaiseTopicShards(const string &topic, uint32_t shardCount);
+
     public:
 
         static DDBAccess &GetInstance();
 
         ~DDBAccess();
 
-        void GetOrPutUser(const string &userId, string &currentTopic);
+        virtual void WarmUp() override;
+
+        virtual void Shutdown() override;
+
+        virtual void GetOrPutUserAsync(const string &userId,
+                                       const StringCallback &callback,
+                                       const CancellationCheck &isCancelled = CancellationCheck()) override;
+
+        virtual void UpdateUserAsync(const string &userId, const string &topic, const Callback &callback) override;
+
+        virtual void PutNewsAsync(const string &topic, const string &userId, const string &news, const StringCallback &callback) override;
+
+        virtual void GetNewsAsync(const string &userId,
+                                  const NewsPageCallback &callback,
+                                  const CancellationCheck &isCancelled = CancellationCheck()) override;
+
+        virtual void GetTopicNewsAsync(const string &topic, const string &afterKey, const NewsCallback &callback) override;
+
+        virtual void SetLastFeedTimeAsync(const string &userId, const string &topic, const string &lastKey, const Callback &callback) override;
+
+        virtual void CheckpointLastFeed(const string &userId, const string &topic, const string &lastKey) override;
+
+        virtual void ScanNewsKeys(const KeyPageCallback &onPage) override;
 
-        void UpdateUser(const string &userId, const string &topic);
+        virtual void GetOldestNewsKeys(const string &topic, const KeyPageCallback &onPage) override;
 
-        void PutNews(const string &topic, const string &userId, const string &news);
+        virtual void DeleteNewsAsync(const std::vector<NewsKey> &keys, const Callback &callback) override;
 
-        void GetNews(const string &userId, std::vector<string> &news);
+        virtual time_t GetSettleSecs() override;
     };
 
 }// end of namespace newsfeed
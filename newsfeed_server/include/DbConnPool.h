@@ -3,34 +3,68 @@
 
 #include <ctime>
 #include <cinttypes>
-#include <atomic>
-#include <boost/lockfree/stack.hpp>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <chrono>
 #include <aws/dynamodb/DynamoDBClient.h>
+#include <aws/core/client/ClientConfiguration.h>
+#include <aws/core/auth/AWSCredentialsProvider.h>
+#include <aws/core/utils/threading/Executor.h>
 
 namespace newsfeed
 {
     typedef Aws::DynamoDB::DynamoDBClient DbConnection;
 
     /// <summary>
-    /// Pool of connections for AWS DynamoDB.
-    /// This implementation is thread safe and (mostly) lock-free.
+    /// Pool of connections for AWS DynamoDB. A connection is a client of the SDK,
+    /// which is thread safe and keeps its own pool of HTTP connections, hence it
+    /// is shared by several borrowers at once, up to its amount of HTTP connections.
+    /// Every client is made from the same tuned configuration and credentials
+    /// provider, and asynchronous requests of every client share a single bounded
+    /// pool of threads. The pool keeps between a minimum and a maximum of clients:
+    /// the minimum is created upfront, a new client is only created when all of them
+    /// are busy, and clients idle for too long are evicted as long as the minimum
+    /// remains. Once the maximum is reached, the least busy client is shared anyway.
+    /// This implementation is thread safe.
     /// </summary>
     class DbConnPool
     {
     private:
 
-        boost::lockfree::stack<DbConnection *> m_connections;
+        /// <summary>
+        /// A client in the pool.
+        /// </summary>
+        struct PooledClient
+        {
+            DbConnection *connection;
+            uint32_t borrowersCount;
+            std::chrono::steady_clock::time_point idleSince;
+        };
+
+        std::vector<PooledClient> m_clients;
+
+        std::mutex m_mutex;
+
+        uint32_t m_creatingCount; // clients being created outside the lock
 
-        const time_t m_poolCtionTime;
+        uint32_t m_minClientsCount;
 
-        time_t m_lastAddTime;
-        float m_twAvgNumActConns;
+        uint32_t m_maxClientsCount;
 
-        std::atomic<uint32_t> m_totalConnsCount;
-        std::atomic<uint32_t> m_activeConnsCount;
+        uint32_t m_maxBorrowersPerClient;
 
-        void IncrementStats(bool isNew);
-        void DecrementStats(bool &discard);
+        std::chrono::seconds m_maxIdleTime;
+
+        std::shared_ptr<Aws::Utils::Threading::Executor> m_executor;
+
+        std::shared_ptr<Aws::Auth::AWSCredentialsProvider> m_credentialsProvider;
+
+        Aws::Client::ClientConfiguration m_clientConfig;
+
+        DbConnection *CreateConnection();
+
+        void EvictIdle(std::vector<DbConnection *> &evicted);
 
     public:
 
@@ -71,6 +105,8 @@ namespace newsfeed
 
         ~DbConnPool();
 
+        void WarmUp(const std::vector<const char *> &tables);
+
         ConnWrapper Get();
 
         void Return(DbConnection *conn);
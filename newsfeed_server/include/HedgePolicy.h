@@ -0,0 +1,74 @@
+#ifndef HEDGEPOLICY_H // header guard
+#define HEDGEPOLICY_H
+
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <iosfwd>
+#include <cinttypes>
+
+namespace newsfeed
+{
+    /// <summary>
+    /// Decides when a read from the database is hedged, which means a duplicate
+    /// request is sent when the first one takes too long, and whichever answers
+    /// first is taken. The delay is a percentile of the latencies recently seen,
+    /// so only the slowest reads are hedged. A budget (token bucket) fed by the
+    /// reads caps the rate of hedges to a percentage of them. Hedges sent and
+    /// won are counted for the report.
+    /// This implementation is thread safe.
+    /// </summary>
+    class HedgePolicy
+    {
+    private:
+
+        std::mutex m_mutex;
+
+        std::vector<uint32_t> m_latencies; // recent samples in microseconds
+
+        size_t m_nextSampleIdx;
+
+        uint32_t m_samplesSinceUpdate;
+
+        uint32_t m_percentile;
+
+        std::chrono::microseconds m_delay;
+
+        double m_tokens;
+
+        double m_maxTokens;
+
+        double m_tokensPerRead;
+
+        uint64_t m_readCount;
+
+        uint64_t m_hedgeCount;
+
+        uint64_t m_hedgeWonCount;
+
+        uint64_t m_lastReportedCount;
+
+    public:
+
+        HedgePolicy();
+
+        HedgePolicy(const HedgePolicy &) = delete;
+
+        bool IsEnabled() const { return m_percentile > 0; }
+
+        void OnRead();
+
+        void AddLatency(std::chrono::steady_clock::duration latency);
+
+        bool GetDelay(std::chrono::microseconds &delay);
+
+        bool TryHedge();
+
+        void OnHedgeWon();
+
+        void Report(std::ostream &out);
+    };
+
+}// end of namespace newsfeed
+
+#endif // end of header guard
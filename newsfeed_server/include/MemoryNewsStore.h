@@ -0,0 +1,106 @@
+#ifndef MEMORYNEWSSTORE_H // header guard
+#define MEMORYNEWSSTORE_H
+
+#include "NewsStore.h"
+#include "UserStateCache.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <deque>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <memory>
+#include <functional>
+
+namespace newsfeed
+{
+    using std::string;
+
+
+    /// <summary>
+    /// Keeps the users and their news in memory, hence nothing is persisted and
+    /// nothing is shared with other instances. This is meant for performance tests
+    /// of the service with no access to the cloud, so the latency of the database
+    /// does not hide the cost of the service itself. Like in the other backends,
+    /// the callbacks never run in the calling thread, but in a thread of the store.
+    /// This implementation is thread safe.
+    /// </summary>
+    class MemoryNewsStore : public NewsStore
+    {
+    private:
+
+        typedef std::function<void ()> Task;
+
+        std::mutex m_dataMutex;
+
+        std::unordered_map<string, UserState> m_users; // by user ID
+
+        std::map<string, std::map<string, string>> m_news; // by topic, then by sort key
+
+        std::mutex m_queueMutex;
+
+        std::condition_variable m_queueCondition;
+
+        std::deque<Task> m_queue; // callbacks waiting to run
+
+        bool m_stopRequested;
+
+        std::thread m_thread;
+
+        static std::atomic<MemoryNewsStore *> singletonAtomicPtr;
+
+        static std::unique_ptr<MemoryNewsStore> singleton;
+
+        static std::mutex singletonCreationMutex;
+
+        MemoryNewsStore();
+
+        void Post(const Task &task);
+
+        void RunCallbacks();
+
+        void SetLastFeedKey(const string &userId, const string &topic, const string &lastKey);
+
+    public:
+
+        static MemoryNewsStore &GetInstance();
+
+        ~MemoryNewsStore();
+
+        virtual void WarmUp() override;
+
+        virtual void Shutdown() override;
+
+        virtual void GetOrPutUserAsync(const string &userId,
+                                       const StringCallback &callback,
+                                       const CancellationCheck &isCancelled = CancellationCheck()) override;
+
+        virtual void UpdateUserAsync(const string &userId, const string &topic, const Callback &callback) override;
+
+        virtual void PutNewsAsync(const string &topic, const string &userId, const string &news, const StringCallback &callback) override;
+
+        virtual void GetNewsAsync(const string &userId,
+                                  const NewsPageCallback &callback,
+                                  const CancellationCheck &isCancelled = CancellationCheck()) override;
+
+        virtual void GetTopicNewsAsync(const string &topic, const string &afterKey, const NewsCallback &callback) override;
+
+        virtual void SetLastFeedTimeAsync(const string &userId, const string &topic, const string &lastKey, const Callback &callback) override;
+
+        virtual void CheckpointLastFeed(const string &userId, const string &topic, const string &lastKey) override;
+
+        virtual void ScanNewsKeys(const KeyPageCallback &onPage) override;
+
+        virtual void GetOldestNewsKeys(const string &topic, const KeyPageCallback &onPage) override;
+
+        virtual void DeleteNewsAsync(const std::vector<NewsKey> &keys, const Callback &callback) override;
+
+        virtual time_t GetSettleSecs() override { return 0; }
+    };
+
+}// end of namespace newsfeed
+
+#endif // end of header guard
@@ -0,0 +1,105 @@
+#ifndef NEWSCACHE_H // header guard
+#define NEWSCACHE_H
+
+#include "NewsStore.h"
+#include <string>
+#include <vector>
+#include <deque>
+#include <list>
+#include <map>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <iosfwd>
+#include <cinttypes>
+
+namespace newsfeed
+{
+    using std::string;
+
+
+    /// <summary>
+    /// Keeps the recent news of the topics polled in this process, so sessions
+    /// catching up on a topic read them from memory instead of querying the database
+    /// for the same range over and over. Each topic has a buffer of news ordered by
+    /// sort key, bounded by count and age, which is known to hold every news posted
+    /// after a given key (up to the last poll). The poller fills it with what the
+    /// polls find, and local posts go in as well. A read of the news after a key
+    /// that precedes the coverage of the buffer is a miss, and must go to the database.
+    /// The least recently used topics are evicted as a whole when memory runs short.
+    /// This implementation is thread safe.
+    /// </summary>
+    class NewsCache
+    {
+    private:
+
+        /// <summary>
+        /// Recent news of a topic.
+        /// </summary>
+        struct TopicNews
+        {
+            std::deque<NewsItem> news; // ordered by sort key
+            string coverFrom; // every news after this key is in the buffer...
+            string coverTo; // ...up to the news polled last (news posted here may lie beyond)
+            size_t bytes;
+            std::list<string>::iterator lruPos;
+        };
+
+        std::map<string, TopicNews> m_topics;
+
+        std::list<string> m_lru; // most recently used topic first
+
+        std::mutex m_mutex;
+
+        size_t m_maxNewsPerTopic;
+
+        time_t m_maxAgeSecs;
+
+        size_t m_maxBytes;
+
+        size_t m_totalBytes;
+
+        uint64_t m_hitCount;
+
+        uint64_t m_missCount;
+
+        uint64_t m_evictionCount;
+
+        static std::atomic<NewsCache *> singletonAtomicPtr;
+
+        static std::unique_ptr<NewsCache> singleton;
+
+        static std::mutex singletonCreationMutex;
+
+        NewsCache();
+
+        TopicNews &Touch(const string &topic);
+
+        void Insert(TopicNews &entry, const NewsItem &news);
+
+        void Trim(TopicNews &entry);
+
+        void Erase(std::map<string, TopicNews>::iterator iter);
+
+        void EvictWhileOverLimit(const string &keep);
+
+    public:
+
+        static NewsCache &GetInstance();
+
+        void Reset(const string &topic, const string &afterKey);
+
+        void Append(const string &topic, const string &afterKey, const std::vector<NewsItem> &news);
+
+        void Add(const string &topic, const NewsItem &news);
+
+        void Drop(const string &topic);
+
+        bool GetNewsAfter(const string &topic, const string &afterKey, std::vector<NewsItem> &news);
+
+        void Report(std::ostream &out);
+    };
+
+}// end of namespace newsfeed
+
+#endif // end of header guard
@@ -0,0 +1,93 @@
+#ifndef NEWSPUTBATCHER_H // header guard
+#define NEWSPUTBATCHER_H
+
+#include "TaskTimer.h"
+#include <string>
+#include <vector>
+#include <functional>
+#include <exception>
+#include <mutex>
+#include <chrono>
+#include <iosfwd>
+#include <cinttypes>
+
+namespace newsfeed
+{
+    using std::string;
+
+
+    /// <summary>
+    /// News posted, waiting to be written to the database.
+    /// </summary>
+    struct PendingNewsPut
+    {
+        string topic; // partition key, which is a shard of the topic
+        string sortKey;
+        string news;
+        std::function<void (string &sortKey, std::exception_ptr error)> callback;
+    };
+
+
+    /// <summary>
+    /// Merges the news posted at about the same time into batch writes (group commit).
+    /// The first post to arrive opens a window of a few milliseconds, and the posts
+    /// arriving meanwhile join it, until the window closes or the batch is full, then
+    /// the batch is handed over to be written with a single request. A batch write
+    /// cannot be conditional, which is fine because the sort keys of the news never
+    /// collide. This also samples the latency of the posts, batched or not, for the report.
+    /// This implementation is thread safe.
+    /// </summary>
+    class NewsPutBatcher
+    {
+    public:
+
+        typedef std::function<void (std::vector<PendingNewsPut> &batch)> BatchWriter;
+
+        static const size_t maxBatchSize = 25; // as much as a batch write takes
+
+    private:
+
+        TaskTimer &m_timer;
+
+        BatchWriter m_writeBatch;
+
+        std::chrono::milliseconds m_window;
+
+        std::mutex m_mutex;
+
+        std::vector<PendingNewsPut> m_pending;
+
+        bool m_flushScheduled;
+
+        std::vector<uint32_t> m_latencies; // microseconds
+
+        size_t m_nextSampleIdx;
+
+        uint64_t m_putCount;
+
+        uint64_t m_batchedPutCount;
+
+        uint64_t m_batchCount;
+
+        uint64_t m_lastReportedCount;
+
+    public:
+
+        NewsPutBatcher(TaskTimer &timer, const BatchWriter &writeBatch);
+
+        NewsPutBatcher(const NewsPutBatcher &) = delete;
+
+        bool IsEnabled() const { return m_window.count() > 0; }
+
+        void Add(PendingNewsPut &&put);
+
+        void Flush();
+
+        void AddLatency(std::chrono::steady_clock::duration latency);
+
+        void Report(std::ostream &out);
+    };
+
+}// end of namespace newsfeed
+
+#endif // end of header guard
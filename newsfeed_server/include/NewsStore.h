@@ -0,0 +1,150 @@
+#ifndef NEWSSTORE_H // header guard
+#define NEWSSTORE_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <exception>
+#include <memory>
+#include <future>
+#include <ctime>
+
+namespace newsfeed
+{
+    using std::string;
+
+
+    /// <summary>
+    /// A news item as stored in the database.
+    /// </summary>
+    struct NewsItem
+    {
+        string sortKey; // binary time-based key that sorts the news in the topic
+        string data;
+    };
+
+
+    /// <summary>
+    /// The key of a news item in the database.
+    /// </summary>
+    struct NewsKey
+    {
+        string topic; // partition key, which is a shard of the topic
+        string sortKey;
+    };
+
+
+    /// <summary>
+    /// Storage of the users and their news, whose backend is chosen in the configuration
+    /// (setting "storeBackend"), so the service can run with no access to the cloud, such
+    /// as for performance tests. Every operation is available asynchronously, and the
+    /// outcome is handed to a callback, which might run in a thread of the backend, hence
+    /// it must be short and must not wait for other operations. The synchronous versions
+    /// simply wait for the asynchronous ones. The sort keys of the news are made here,
+    /// the same way for every backend.
+    /// </summary>
+    class NewsStore
+    {
+    public:
+
+        /// <summary>
+        /// Tells whether the caller has given up on a request, so it can be aborted.
+        /// </summary>
+        typedef std::function<bool ()> CancellationCheck;
+
+        typedef std::function<void (std::exception_ptr error)> Callback;
+
+        typedef std::function<void (string &result, std::exception_ptr error)> StringCallback;
+
+        typedef std::function<void (std::vector<NewsItem> &news, std::exception_ptr error)> NewsCallback;
+
+        typedef std::function<void (std::vector<NewsItem> &news, bool isLastPage, std::exception_ptr error)> NewsPageCallback;
+
+        typedef std::function<bool (std::vector<NewsKey> &keys)> KeyPageCallback;
+
+        /// <summary>
+        /// Waits for the conclusion of an asynchronous operation.
+        /// </summary>
+        /// <param name="start">Starts the operation, given the callback to conclude it.</param>
+        /// <returns>The result of the operation. Its error, if any, is thrown.</returns>
+        template <typename ResultType>
+        static ResultType Wait(const std::function<void (const std::function<void (ResultType &, std::exception_ptr)> &)> &start)
+        {
+            auto promise = std::make_shared<std::promise<ResultType>>();
+            auto future = promise->get_future();
+
+            start([promise](ResultType &result, std::exception_ptr error)
+            {
+                if (error)
+                    promise->set_exception(error);
+                else
+                    promise->set_value(std::move(result));
+            });
+
+            return future.get();
+        }
+
+        static NewsStore &GetInstance();
+
+        virtual ~NewsStore() {}
+
+        virtual void WarmUp() = 0;
+
+        virtual void Shutdown() = 0;
+
+        virtual void GetOrPutUserAsync(const string &userId,
+                                       const StringCallback &callback,
+                                       const CancellationCheck &isCancelled = CancellationCheck()) = 0;
+
+        void GetOrPutUser(const string &userId,
+                          string &currentTopic,
+                          const CancellationCheck &isCancelled = CancellationCheck());
+
+        virtual void UpdateUserAsync(const string &userId, const string &topic, const Callback &callback) = 0;
+
+        void UpdateUser(const string &userId, const string &topic);
+
+        virtual void PutNewsAsync(const string &topic, const string &userId, const string &news, const StringCallback &callback) = 0;
+
+        string PutNews(const string &topic, const string &userId, const string &news);
+
+        virtual void GetNewsAsync(const string &userId,
+                                  const NewsPageCallback &callback,
+                                  const CancellationCheck &isCancelled = CancellationCheck()) = 0;
+
+        void GetNews(const string &userId,
+                     std::vector<NewsItem> &news,
+                     const CancellationCheck &isCancelled = CancellationCheck());
+
+        virtual void GetTopicNewsAsync(const string &topic, const string &afterKey, const NewsCallback &callback) = 0;
+
+        void GetTopicNews(const string &topic, const string &afterKey, std::vector<NewsItem> &news);
+
+        virtual void SetLastFeedTimeAsync(const string &userId, const string &topic, const string &lastKey, const Callback &callback) = 0;
+
+        void SetLastFeedTime(const string &userId, const string &topic, const string &lastKey);
+
+        virtual void CheckpointLastFeed(const string &userId, const string &topic, const string &lastKey) = 0;
+
+        virtual void ScanNewsKeys(const KeyPageCallback &onPage) = 0;
+
+        virtual void GetOldestNewsKeys(const string &topic, const KeyPageCallback &onPage) = 0;
+
+        virtual void DeleteNewsAsync(const std::vector<NewsKey> &keys, const Callback &callback) = 0;
+
+        virtual time_t GetSettleSecs() = 0;
+
+        static string MakeNewsKey();
+
+        static string MakeFeedCursor();
+
+        static string MakeNewsCursor(time_t epochTime);
+
+        static time_t GetNewsTime(const string &sortKey);
+
+        static void ObserveNewsKey(const string &sortKey);
+    };
+
+}// end of namespace newsfeed
+
+#endif // end of header guard
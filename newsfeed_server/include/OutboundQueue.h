@@ -0,0 +1,108 @@
+#ifndef OUTBOUNDQUEUE_H // header guard
+#define OUTBOUNDQUEUE_H
+
+#include "newsfeed_messages.pb.h"
+#include "NewsStore.h"
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <cinttypes>
+
+namespace newsfeed
+{
+    /// <summary>
+    /// Messages waiting to be sent to the client of a session. Producers (the
+    /// thread handling requests and the ones delivering news) only enqueue, so
+    /// they never block on the network, while a single writer drains the queue.
+    /// News are kept apart from responses until the writer takes them, so they
+    /// can be batched, and their amount is bounded (by count and by size). What
+    /// happens when a client does not keep up is set by the slow consumer policy.
+    /// The news of a client come from threads shared with every other client, so
+    /// pushing them never blocks: at most, they are refused, for the session to read
+    /// them again from the store once the queue has drained.
+    /// </summary>
+    class OutboundQueue
+    {
+    public:
+
+        /// <summary>
+        /// What to do when news arrive and the queue is full.
+        /// </summary>
+        enum class SlowConsumerPolicy
+        {
+            Block,      // refuse the news, which the session reads again once the queue drains
+            DropOldest, // discard the oldest news waiting
+            Collapse,   // discard all news waiting, and tell the client how many it missed
+            Disconnect  // end the call, so the client can reconnect and catch up
+        };
+
+        /// <summary>
+        /// What became of news pushed in the queue.
+        /// </summary>
+        enum class PushResult
+        {
+            Enqueued,
+            HeldBack,  // the queue is full, so the news must be read again once it drains
+            Closed,    // nothing else goes to the client
+            Disconnect // the call must end, because the client does not keep up
+        };
+
+        /// <summary>
+        /// Counts the slow consumer events in a session.
+        /// </summary>
+        struct Counters
+        {
+            uint64_t newsEnqueued;
+            uint64_t timesFull;
+            uint64_t timesHeldBack;
+            uint64_t newsDropped;
+            uint64_t newsCollapsed;
+            uint64_t disconnects;
+        };
+
+    private:
+
+        std::mutex m_mutex;
+
+        std::deque<proto::req_envelope> m_messages;
+
+        std::vector<NewsItem> m_news;
+
+        size_t m_newsBytes;
+
+        int64_t m_missed;
+
+        bool m_closed;
+
+        SlowConsumerPolicy m_policy;
+
+        size_t m_maxNews;
+
+        size_t m_maxBytes;
+
+        Counters m_counters;
+
+        bool HasRoomFor(const NewsItem &news) const;
+
+    public:
+
+        OutboundQueue();
+
+        void PushMessage(proto::req_envelope &&message);
+
+        PushResult PushNews(const NewsItem &news);
+
+        bool Pop(proto::req_envelope &message, uint64_t &newsDone);
+
+        bool IsEmpty();
+
+        void Close();
+
+        Counters GetCounters();
+
+        void ReportCounters(const string &userId);
+    };
+
+}// end of namespace newsfeed
+
+#endif // end of header guard
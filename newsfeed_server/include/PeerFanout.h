@@ -0,0 +1,107 @@
+#ifndef PEERFANOUT_H // header guard
+#define PEERFANOUT_H
+
+#include "newsfeed_service.grpc.pb.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <memory>
+#include <chrono>
+
+namespace newsfeed
+{
+    using std::string;
+
+    struct NewsItem;
+
+
+    /// <summary>
+    /// Forwards news posted in this process to the other instances of the service
+    /// (peers), so their sessions get them without waiting for the next poll. Calls
+    /// are asynchronous and never hold back the client posting the news. A peer that
+    /// answers to have no subscribers for a topic (or fails to answer) is not bothered
+    /// with that topic again for a polling interval. News lost this way are still
+    /// found in the database by the poller of the peer, as before.
+    /// </summary>
+    class PeerFanout
+    {
+    private:
+
+        /// <summary>
+        /// Connection to a peer.
+        /// </summary>
+        struct Peer
+        {
+            string endpoint;
+            std::unique_ptr<proto::NewsfeedPeering::Stub> stub;
+
+            // topics the peer is not interested in, until the given time:
+            std::map<string, std::chrono::steady_clock::time_point> uninterested;
+        };
+
+        /// <summary>
+        /// State of an outstanding call forwarding news to a peer.
+        /// </summary>
+        struct ForwardCall
+        {
+            size_t peerIdx;
+            string topic;
+            grpc::ClientContext context;
+            proto::peer_ack reply;
+            grpc::Status status;
+            std::unique_ptr<grpc::ClientAsyncResponseReader<proto::peer_ack>> reader;
+        };
+
+        std::vector<Peer> m_peers;
+
+        std::mutex m_peersMutex;
+
+        grpc::CompletionQueue m_completionQueue;
+
+        bool m_shutdown;
+
+        std::thread m_thread;
+
+        static std::atomic<PeerFanout *> singletonAtomicPtr;
+
+        static std::unique_ptr<PeerFanout> singleton;
+
+        static std::mutex singletonCreationMutex;
+
+        PeerFanout();
+
+        void CollectReplies();
+
+        void OnReply(ForwardCall &call, bool ok);
+
+    public:
+
+        static PeerFanout &GetInstance();
+
+        ~PeerFanout();
+
+        void Forward(const string &topic, const NewsItem &news);
+
+        void Shutdown();
+    };
+
+
+    /// <summary>
+    /// Receives the news forwarded by peers and hands them to the local subscribers.
+    /// News received this way are not forwarded any further.
+    /// </summary>
+    class PeerServiceImpl final : public proto::NewsfeedPeering::Service
+    {
+    public:
+
+        grpc::Status Forward(grpc::ServerContext *context,
+                             const proto::peer_news *request,
+                             proto::peer_ack *response) override;
+    };
+
+}// end of namespace newsfeed
+
+#endif // end of header guard
@@ -0,0 +1,109 @@
+#ifndef RETENTIONWORKER_H // header guard
+#define RETENTIONWORKER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <memory>
+#include <chrono>
+#include <ctime>
+#include <cinttypes>
+
+namespace newsfeed
+{
+    using std::string;
+
+    struct NewsKey;
+
+
+    /// <summary>
+    /// Purges the old news from the database in background, so the topics do not
+    /// grow forever and the queries stay fast. Every sweep scans the keys of the news,
+    /// page by page, and deletes those beyond the retention policy of their topic, which
+    /// limits the age of the news and how many of them the topic keeps (the oldest ones
+    /// in excess are deleted). The deletes go in batches, several of them in flight at once,
+    /// and the items the database leaves unprocessed are resubmitted with backoff. A token
+    /// bucket keeps the deletes within a share of the write capacity of the table, so the
+    /// purge does not compete with the posts.
+    /// </summary>
+    class RetentionWorker
+    {
+    private:
+
+        /// <summary>
+        /// Retention policy of a topic. Zero means no limit.
+        /// </summary>
+        struct Policy
+        {
+            time_t maxAgeSecs;
+            uint64_t maxNews;
+        };
+
+        Policy m_defaultPolicy;
+
+        std::map<string, Policy> m_topicPolicies;
+
+        std::chrono::seconds m_sweepInterval;
+
+        std::mutex m_mutex;
+
+        std::condition_variable m_condition;
+
+        bool m_stopRequested;
+
+        uint32_t m_writesInFlight;
+
+        uint32_t m_maxWritesInFlight;
+
+        double m_writeUnitsPerSec;
+
+        double m_maxWriteUnits;
+
+        double m_writeUnits; // tokens available for deletes
+
+        std::chrono::steady_clock::time_point m_lastRefill;
+
+        uint64_t m_purgedCount;
+
+        uint64_t m_failedCount;
+
+        std::thread m_thread;
+
+        static std::atomic<RetentionWorker *> singletonAtomicPtr;
+
+        static std::unique_ptr<RetentionWorker> singleton;
+
+        static std::mutex singletonCreationMutex;
+
+        RetentionWorker();
+
+        void ParsePolicies(const string &policies);
+
+        const Policy &GetPolicy(const string &topic) const;
+
+        void Run();
+
+        void Sweep();
+
+        bool Purge(std::vector<NewsKey> &keys, bool flush);
+
+        bool AcquireWriteCapacity(size_t units);
+
+        void OnPurgeDone(size_t count, std::exception_ptr error);
+
+    public:
+
+        static RetentionWorker &GetInstance();
+
+        ~RetentionWorker();
+
+        void Shutdown();
+    };
+
+}// end of namespace newsfeed
+
+#endif // end of header guard
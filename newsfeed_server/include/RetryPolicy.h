@@ -0,0 +1,72 @@
+#ifndef RETRYPOLICY_H // header guard
+#define RETRYPOLICY_H
+
+#include <string>
+#include <map>
+#include <mutex>
+#include <random>
+#include <chrono>
+#include <iosfwd>
+#include <cinttypes>
+
+namespace newsfeed
+{
+    using std::string;
+
+
+    /// <summary>
+    /// Decides whether and when a failed request to the database is retried.
+    /// The delay grows exponentially with decorrelated jitter, so the retries of
+    /// many requests (and instances) spread out instead of hitting the database
+    /// in lockstep. A process-wide budget (token bucket) is fed by every request
+    /// issued for the first time, and each retry takes a token, hence the retries
+    /// cannot exceed a percentage of the base traffic, no matter how bad the
+    /// throttling gets. The retries are counted per operation and error.
+    /// This implementation is thread safe.
+    /// </summary>
+    class RetryPolicy
+    {
+    private:
+
+        std::mutex m_mutex;
+
+        std::mt19937 m_randomGenerator;
+
+        std::chrono::milliseconds m_baseDelay;
+
+        std::chrono::milliseconds m_maxDelay;
+
+        double m_tokens;
+
+        double m_maxTokens;
+
+        double m_tokensPerRequest;
+
+        std::map<string, uint64_t> m_retryCounts; // by operation & error
+
+        uint64_t m_requestCount;
+
+        uint64_t m_deniedCount;
+
+        uint64_t m_lastReportedCount;
+
+    public:
+
+        RetryPolicy();
+
+        RetryPolicy(const RetryPolicy &) = delete;
+
+        std::chrono::milliseconds GetBaseDelay() const { return m_baseDelay; }
+
+        void OnRequest();
+
+        bool TryRetry(const char *operation,
+                      const string &error,
+                      std::chrono::milliseconds &delay);
+
+        void Report(std::ostream &out);
+    };
+
+}// end of namespace newsfeed
+
+#endif // end of header guard
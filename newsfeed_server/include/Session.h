@@ -0,0 +1,153 @@
+#ifndef SESSION_H // header guard
+#define SESSION_H
+
+#include "newsfeed_service.grpc.pb.h"
+#include "NewsStore.h"
+#include <string>
+#include <vector>
+#include <set>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <exception>
+#include <functional>
+#include <cinttypes>
+
+
+namespace newsfeed
+{
+    using std::string;
+
+    using namespace grpc;
+
+
+    void LogError(const char *message, const string &details);
+
+    Status ErrorStatus(StatusCode code, const char *message, const string &details);
+
+
+    /// <summary>
+    /// Keeps the state of the conversation with a client and implements
+    /// the protocol for its requests, regardless of the server engine.
+    /// Once registered, the session follows the news of its topic by
+    /// means of the <see cref="TopicPoller"/>, hence it must be owned
+    /// by a <c>std::shared_ptr</c>.
+    /// </summary>
+    class Session : public std::enable_shared_from_this<Session>
+    {
+    public:
+
+        /// <summary>
+        /// Receives the response to a request, along with the operation status.
+        /// When the status is NOT okay, the conversation must end.
+        /// </summary>
+        typedef std::function<void (const Status &status, proto::req_envelope &response)> ResponseCallback;
+
+    private:
+
+        string m_userId;
+
+        string m_topic;
+
+        std::mutex m_feedMutex;
+
+        string m_feedTopic; // topic whose news are being delivered
+
+        string m_lastKey; // sort key of the last news delivered by the poller
+
+        string m_writtenKey; // ... and of the last one the writer is done with
+
+        string m_savedKey; // ... and of the last one saved by the catch-up
+
+        uint64_t m_sentCount; // news enqueued for the writer
+
+        uint64_t m_doneCount; // ... and those it is done with
+
+        std::deque<std::pair<uint64_t, string>> m_unwrittenKeys; // delivered up to a key, once so many news are written
+
+        std::set<string> m_pushedKeys; // sort keys of news pushed ahead of the poller
+
+        std::vector<NewsItem> m_pendingNews; // arrived during catch-up
+
+        bool m_caughtUp;
+
+        bool m_checkpointPending; // written key not saved yet
+
+        bool m_heldBack; // the client had no room for news, so they must be read again
+
+        bool m_closed;
+
+        uint64_t m_followCount; // tells apart the catch-ups of consecutive topics
+
+        void FollowTopic(bool catchUp);
+
+        void LogCatchUpError(std::exception_ptr error);
+
+        void OnCatchUp(uint64_t followCount, std::vector<NewsItem> &news, bool isLastPage, std::exception_ptr error);
+
+        void OnHeldBackNews(uint64_t followCount, std::vector<NewsItem> &news, std::exception_ptr error);
+
+        void EndCatchUp(std::unique_lock<std::mutex> &lock);
+
+        void ReadHeldBackNews(std::unique_lock<std::mutex> &lock);
+
+        void Deliver(const std::vector<NewsItem> &news);
+
+        void Respond(const proto::register_request &message,
+                     proto::global_error_t error,
+                     const ResponseCallback &callback);
+
+        void Respond(const proto::topic_request &message,
+                     proto::global_error_t error,
+                     const ResponseCallback &callback);
+
+        void Respond(const proto::post_news_request &message,
+                     proto::global_error_t error,
+                     const ResponseCallback &callback);
+
+    protected:
+
+        /// <summary>
+        /// Sends news to the client. This is called while the session
+        /// holds an internal lock, so it must not block for long.
+        /// </summary>
+        /// <param name="news">The news.</param>
+        /// <returns>Whether the news has been enqueued for the writer,
+        /// which must then report it by <see cref="OnNewsWritten"/>.</returns>
+        virtual bool SendNews(const NewsItem &news) = 0;
+
+        /// <summary>
+        /// Determines whether the client has gone away, so the
+        /// work on its behalf can be abandoned. Must not block.
+        /// </summary>
+        /// <returns><c>true</c> if the call has been cancelled.</returns>
+        virtual bool IsCancelled() const = 0;
+
+    public:
+
+        Session();
+
+        virtual ~Session() {}
+
+        void HandleRequest(const proto::req_envelope &request, const ResponseCallback &callback);
+
+        void DeliverNews(const string &topic, const std::vector<NewsItem> &news);
+
+        void PushNews(const string &topic, const NewsItem &news);
+
+        void OnNewsWritten(uint64_t doneCount);
+
+        void Close();
+
+        void SaveLastFeed();
+
+        static size_t PackNews(std::vector<NewsItem> &news, size_t first, int64_t missed, proto::req_envelope &message);
+
+        const string &GetUserId() const { return m_userId; }
+
+        const string &GetTopic() const { return m_topic; }
+    };
+
+}// end of namespace newsfeed
+
+#endif // end of header guard
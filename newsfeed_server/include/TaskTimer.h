@@ -0,0 +1,54 @@
+#ifndef TASKTIMER_H // header guard
+#define TASKTIMER_H
+
+#include "TimingWheel.h"
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+
+namespace newsfeed
+{
+    /// <summary>
+    /// Runs tasks after a delay, all of them in a single thread, so
+    /// waiting for the time to come does not hold a thread per task.
+    /// The tasks are expected to be short, like issuing a request.
+    /// This implementation is thread safe.
+    /// </summary>
+    class TaskTimer
+    {
+    public:
+
+        typedef std::function<void ()> Task;
+
+    private:
+
+        TimingWheel<Task> m_timers;
+
+        std::mutex m_mutex;
+
+        std::condition_variable m_wakeCondition;
+
+        bool m_stopRequested;
+
+        std::thread m_thread;
+
+        void RunTasks();
+
+    public:
+
+        TaskTimer(std::chrono::steady_clock::duration resolution);
+
+        ~TaskTimer();
+
+        TaskTimer(const TaskTimer &) = delete;
+
+        void Schedule(std::chrono::steady_clock::duration delay, const Task &task);
+
+        void Shutdown();
+    };
+
+}// end of namespace newsfeed
+
+#endif // end of header guard
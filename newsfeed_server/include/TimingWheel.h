@@ -0,0 +1,215 @@
+#ifndef TIMINGWHEEL_H // header guard
+#define TIMINGWHEEL_H
+
+#include <list>
+#include <iterator>
+#include <vector>
+#include <chrono>
+#include <cinttypes>
+
+namespace newsfeed
+{
+    /// <summary>
+    /// Hierarchical timing wheel, which keeps timers in slots of time, so scheduling
+    /// and cancellation take constant time, no matter how many timers are there.
+    /// The first level has one slot per tick, and each slot of the levels above
+    /// spans a whole revolution of the level below. As time advances, the timers
+    /// in a slot of an upper level cascade down to the level below, and the timers
+    /// in the current slot of the first level expire. Deadlines too far ahead are
+    /// clamped to the span of the wheel. This class is NOT THREAD SAFE.
+    /// </summary>
+    template <typename PayloadType>
+    class TimingWheel
+    {
+    private:
+
+        struct Timer;
+
+        typedef std::list<Timer> Slot;
+
+        /// <summary>
+        /// A timer scheduled in the wheel.
+        /// </summary>
+        struct Timer
+        {
+            PayloadType payload;
+            uint64_t deadlineTick;
+            Slot *slot; // where the timer currently is
+        };
+
+        enum { SlotBits = 6, NumSlots = 1 << SlotBits, SlotMask = NumSlots - 1, NumLevels = 3 };
+
+        Slot m_levels[NumLevels][NumSlots];
+
+        std::chrono::steady_clock::time_point m_startTime;
+
+        std::chrono::steady_clock::duration m_tick;
+
+        uint64_t m_currentTick;
+
+        size_t m_count;
+
+        /// <summary>
+        /// Gets the slot where a timer goes, considering the current tick.
+        /// </summary>
+        /// <param name="deadlineTick">The tick when the timer is due.</param>
+        /// <returns>The slot.</returns>
+        Slot &GetSlot(uint64_t deadlineTick)
+        {
+            uint64_t delta = deadlineTick - m_currentTick;
+
+            for (int level = 0; level < NumLevels - 1; ++level)
+            {
+                if (delta < (1ULL << (SlotBits * (level + 1))))
+                    return m_levels[level][(deadlineTick >> (SlotBits * level)) & SlotMask];
+            }
+
+            return m_levels[NumLevels - 1][(deadlineTick >> (SlotBits * (NumLevels - 1))) & SlotMask];
+        }
+
+        /// <summary>
+        /// Moves the timers in a slot of an upper level to the levels below.
+        /// </summary>
+        /// <param name="slot">The slot.</param>
+        void Cascade(Slot &slot)
+        {
+            auto iter = slot.begin();
+
+            while (iter != slot.end())
+            {
+                auto &target = GetSlot(iter->deadlineTick);
+                iter->slot = &target;
+                target.splice(target.end(), slot, iter++);
+            }
+        }
+
+    public:
+
+        typedef typename Slot::iterator Handle;
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="TimingWheel"/> class.
+        /// </summary>
+        /// <param name="tick">The resolution of the wheel.</param>
+        TimingWheel(std::chrono::steady_clock::duration tick)
+            : m_startTime(std::chrono::steady_clock::now())
+            , m_tick(tick.count() > 0 ? tick : std::chrono::steady_clock::duration(1))
+            , m_currentTick(0)
+            , m_count(0)
+        {
+        }
+
+        /// <summary>
+        /// Schedules a timer.
+        /// </summary>
+        /// <param name="deadline">When the timer is due. It expires
+        /// at the first tick that is not before the deadline.</param>
+        /// <param name="payload">The payload, which is handed back upon expiration.</param>
+        /// <returns>A handle to cancel the timer, valid until it expires.</returns>
+        Handle Schedule(std::chrono::steady_clock::time_point deadline, const PayloadType &payload)
+        {
+            const uint64_t maxDelta = (1ULL << (SlotBits * NumLevels)) - 1;
+
+            uint64_t deadlineTick = m_currentTick + 1;
+
+            if (deadline > m_startTime)
+            {
+                auto elapsed = deadline - m_startTime;
+                auto ticks = static_cast<uint64_t> ((elapsed + m_tick - std::chrono::steady_clock::duration(1)) / m_tick);
+
+                if (ticks > deadlineTick)
+                    deadlineTick = ticks;
+            }
+
+            if (deadlineTick - m_currentTick > maxDelta)
+                deadlineTick = m_currentTick + maxDelta;
+
+            auto &slot = GetSlot(deadlineTick);
+            slot.push_back(Timer{ payload, deadlineTick, &slot });
+            ++m_count;
+
+            return std::prev(slot.end());
+        }
+
+        /// <summary>
+        /// Cancels a timer that has not expired yet.
+        /// </summary>
+        /// <param name="handle">The handle of the timer.</param>
+        void Cancel(Handle handle)
+        {
+            handle->slot->erase(handle);
+            --m_count;
+        }
+
+        /// <summary>
+        /// Advances the time in the wheel and collects the timers that expire.
+        /// </summary>
+        /// <param name="now">The current time.</param>
+        /// <param name="expired">Receives the payload of the expired timers.
+        /// Their handles are no longer valid.</param>
+        void Advance(std::chrono::steady_clock::time_point now, std::vector<PayloadType> &expired)
+        {
+            if (now < m_startTime)
+                return;
+
+            const auto targetTick = static_cast<uint64_t> ((now - m_startTime) / m_tick);
+
+            while (m_currentTick < targetTick)
+            {
+                ++m_currentTick;
+
+                // cascade from the upper levels upon completion of a revolution:
+                for (int level = NumLevels - 1; level > 0; --level)
+                {
+                    const uint64_t revolution = (1ULL << (SlotBits * level)) - 1;
+
+                    if ((m_currentTick & revolution) == 0)
+                        Cascade(m_levels[level][(m_currentTick >> (SlotBits * level)) & SlotMask]);
+                }
+
+                auto &slot = m_levels[0][m_currentTick & SlotMask];
+
+                for (auto &timer : slot)
+                    expired.push_back(std::move(timer.payload));
+
+                m_count -= slot.size();
+                slot.clear();
+
+                if (m_count == 0)
+                {
+                    m_currentTick = targetTick;
+                    break;
+                }
+            }
+        }
+
+        /// <summary>
+        /// Gets the time when something might happen in the wheel, either
+        /// the expiration of timers or the cascading of an upper level.
+        /// </summary>
+        /// <returns>The time to advance the wheel again, or the maximum
+        /// time point when there are no timers.</returns>
+        std::chrono::steady_clock::time_point GetNextEventTime() const
+        {
+            if (m_count == 0)
+                return std::chrono::steady_clock::time_point::max();
+
+            uint64_t tick = m_currentTick + 1;
+
+            // the next non-empty slot in this revolution of the first level, if any:
+            while ((tick & SlotMask) != 0 && m_levels[0][tick & SlotMask].empty())
+                ++tick;
+
+            return m_startTime + m_tick * tick;
+        }
+
+        /// <summary>
+        /// Determines whether there are no timers.
+        /// </summary>
+        /// <returns><c>true</c> if the wheel has no timers.</returns>
+        bool IsEmpty() const { return m_count == 0; }
+    };
+
+}// end of namespace newsfeed
+
+#endif // end of header guard
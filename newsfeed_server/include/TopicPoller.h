@@ -0,0 +1,121 @@
+#ifndef TOPICPOLLER_H // header guard
+#define TOPICPOLLER_H
+
+#include "TimingWheel.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <memory>
+#include <chrono>
+#include <cinttypes>
+
+namespace newsfeed
+{
+    using std::string;
+
+    class Session;
+
+    struct NewsItem;
+
+
+    /// <summary>
+    /// Polls the database for news on behalf of every session in the process.
+    /// Each topic followed by at least one local session is queried once per polling
+    /// interval, and the news found are fanned out to all sessions following it, hence
+    /// the load on the database scales with the number of topics, not of users.
+    /// News posted in this process, or forwarded by peer instances of the service, are
+    /// also pushed right away to the local subscribers.
+    /// The polling interval adapts to each topic: right after activity the topic is polled
+    /// at the minimum interval, which doubles on every poll that finds nothing new, up to
+    /// the maximum, so quiet topics cost few reads. Polls are scheduled in a timing
+    /// wheel, and a topic left with no subscribers has its poll cancelled right away.
+    /// The queries are asynchronous, so the topics due are polled concurrently, and
+    /// a slow query does not hold back the others. What the polls find is kept
+    /// in the news cache, which only covers the topics polled here.
+    /// </summary>
+    class TopicPoller
+    {
+    private:
+
+        /// <summary>
+        /// Polling state of a topic.
+        /// </summary>
+        struct TopicState
+        {
+            string cursor; // sort key of the last news seen in the topic
+            std::vector<std::shared_ptr<Session>> subscribers;
+            std::chrono::milliseconds interval; // current polling interval
+            std::chrono::steady_clock::time_point lastPoll;
+            std::chrono::steady_clock::time_point nextPoll;
+            TimingWheel<string>::Handle timer; // next poll
+            bool polling; // whether a query is in flight
+        };
+
+        std::map<string, TopicState> m_topics;
+
+        TimingWheel<string> m_timers;
+
+        std::mutex m_topicsMutex;
+
+        std::condition_variable m_wakeCondition;
+
+        bool m_stopRequested;
+
+        bool m_scheduleChanged;
+
+        std::chrono::milliseconds m_minInterval;
+
+        std::chrono::milliseconds m_maxInterval;
+
+        std::chrono::milliseconds m_fixedInterval; // reference for the savings
+
+        uint64_t m_queriesMade;
+
+        uint64_t m_queriesWithNews;
+
+        double m_queriesSaved;
+
+        uint32_t m_pollsInFlight;
+
+        std::thread m_thread;
+
+        static std::atomic<TopicPoller *> singletonAtomicPtr;
+
+        static std::unique_ptr<TopicPoller> singleton;
+
+        static std::mutex singletonCreationMutex;
+
+        TopicPoller();
+
+        void PollTopics();
+
+        void PollTopic(const string &topic, const string &cursor);
+
+        void OnPollDone(const string &topic, const string &cursor, std::vector<NewsItem> &news, bool failed);
+
+        void ReportSavings();
+
+        void SchedulePoll(const string &topic, TopicState &state, std::chrono::steady_clock::time_point when);
+
+    public:
+
+        static TopicPoller &GetInstance();
+
+        ~TopicPoller();
+
+        void Subscribe(const string &topic, const std::shared_ptr<Session> &session);
+
+        void Unsubscribe(const string &topic, const Session *session);
+
+        bool Publish(const string &topic, const NewsItem &news);
+
+        void Shutdown();
+    };
+
+}// end of namespace newsfeed
+
+#endif // end of header guard
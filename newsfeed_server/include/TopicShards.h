@@ -0,0 +1,95 @@
+#ifndef TOPICSHARDS_H // header guard
+#define TOPICSHARDS_H
+
+#include <string>
+#include <map>
+#include <mutex>
+#include <chrono>
+#include <iosfwd>
+#include <ctime>
+#include <cinttypes>
+
+namespace newsfeed
+{
+    using std::string;
+
+
+    /// <summary>
+    /// Keeps track of how many write shards each topic has. The news of a topic
+    /// are spread across that many partitions in the database ("topic", then
+    /// "topic#1", "topic#2" and so on), so a busy topic does not exceed the write
+    /// throughput of a single partition, and the reads gather them from all of them.
+    /// Hence the name of a topic must not contain the separator of the shards.
+    /// The shards of a topic are raised when its posts exceed a rate, and they are
+    /// never lowered. Because the other instances learn about a raise when they refresh
+    /// what they know, the new shards are only written once they have had the time to.
+    /// This implementation is thread safe.
+    /// </summary>
+    class TopicShards
+    {
+    private:
+
+        /// <summary>
+        /// What is known about the shards of a topic.
+        /// </summary>
+        struct Entry
+        {
+            uint32_t shardCount; // to be read
+            uint32_t writtenShardCount; // to be written, until activeFrom
+            time_t activeFrom;
+            std::chrono::steady_clock::time_point refreshedAt;
+            std::chrono::steady_clock::time_point usedAt;
+            bool isRaising;
+            uint32_t nextShard;
+            time_t rateSecond;
+            uint32_t postsInSecond;
+        };
+
+        std::mutex m_mutex;
+
+        std::map<string, Entry> m_entries; // by topic
+
+        uint32_t m_baseShardCount;
+
+        uint32_t m_maxShardCount;
+
+        uint32_t m_hotPostsPerSec;
+
+        std::chrono::seconds m_refreshInterval;
+
+        uint64_t m_raiseCount;
+
+        Entry &Touch(const string &topic);
+
+    public:
+
+        TopicShards();
+
+        TopicShards(const TopicShards &) = delete;
+
+        std::chrono::seconds GetRefreshInterval() const { return m_refreshInterval; }
+
+        bool GetShardCount(const string &topic, uint32_t &shardCount);
+
+        void SetShardCount(const string &topic, uint32_t shardCount, time_t activeFrom);
+
+        void Invalidate(const string &topic);
+
+        uint32_t PickWriteShard(const string &topic, uint32_t &raiseTo);
+
+        void EndRaise(const string &topic);
+
+        void Prune();
+
+        void Report(std::ostream &out);
+
+        static bool IsValidTopic(const string &topic);
+
+        static string GetPartitionKey(const string &topic, uint32_t shard);
+
+        static string GetTopic(const string &partitionKey);
+    };
+
+}// end of namespace newsfeed
+
+#endif // end of header guard
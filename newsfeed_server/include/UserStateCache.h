@@ -0,0 +1,63 @@
+#ifndef USERSTATECACHE_H // header guard
+#define USERSTATECACHE_H
+
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+
+namespace newsfeed
+{
+    using std::string;
+
+
+    /// <summary>
+    /// State of a user as stored in the database.
+    /// </summary>
+    struct UserState
+    {
+        string topic; // empty when not subscribing
+        string lastFeedKey; // sort key of the last news fed, empty when never fed
+    };
+
+
+    /// <summary>
+    /// Write-through cache of the user state, kept up to date by the data access
+    /// whenever it reads or writes a user, so the news of a user can be retrieved
+    /// without reading the user from the database first. The database remains the
+    /// source of truth: the state is read from there again whenever the user
+    /// connects. The least recently used entries are evicted beyond the capacity.
+    /// This implementation is thread safe.
+    /// </summary>
+    class UserStateCache
+    {
+    private:
+
+        typedef std::list<std::pair<string, UserState>> LruList;
+
+        LruList m_entries; // most recently used first
+
+        std::unordered_map<string, LruList::iterator> m_index;
+
+        std::mutex m_mutex;
+
+        size_t m_maxEntries;
+
+    public:
+
+        UserStateCache();
+
+        UserStateCache(const UserStateCache &) = delete;
+
+        bool Get(const string &userId, UserState &state);
+
+        void Put(const string &userId, const UserState &state);
+
+        void SetLastFeedKey(const string &userId, const string &topic, const string &lastKey);
+
+        void Remove(const string &userId);
+    };
+
+}// end of namespace newsfeed
+
+#endif // end of header guard
@@ -0,0 +1,47 @@
+#ifndef ASYNC_SERVER_IMPL_H // header guard
+#define ASYNC_SERVER_IMPL_H
+
+#include "newsfeed_service.grpc.pb.h"
+#include <grpc++/server_builder.h>
+#include <memory>
+#include <vector>
+#include <thread>
+
+
+namespace newsfeed
+{
+    using namespace grpc;
+
+
+    typedef ServerAsyncReaderWriter<proto::req_envelope, proto::req_envelope> AsyncIOStream;
+
+    /// <summary>
+    /// Implements the Newsfeed web service host upon the asynchronous API of gRPC.
+    /// Every conversation is a state machine driven by events from completion queues,
+    /// which are polled by a small fixed pool of threads, hence the number of threads
+    /// does not grow along with the number of connected clients.
+    /// </summary>
+    class AsyncServiceHostImpl
+    {
+    private:
+
+        proto::Newsfeed::AsyncService m_service;
+
+        std::vector<std::unique_ptr<ServerCompletionQueue>> m_completionQueues;
+
+        std::vector<std::thread> m_threads;
+
+        static void PollCompletionQueue(ServerCompletionQueue *cq);
+
+    public:
+
+        void RegisterOn(ServerBuilder &builder, unsigned int numThreads);
+
+        void Start();
+
+        void Shutdown();
+    };
+
+}// end of namespace newsfeed
+
+#endif // end of header guard
@@ -3,6 +3,12 @@
 
 #include "newsfeed_service.grpc.pb.h"
 #include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
 
 
 namespace newsfeed
@@ -16,38 +22,43 @@ namespace newsfeed
 
     typedef WriterInterface<proto::req_envelope> OutStream;
 
+    class SyncSession;
+
+
     /// <summary>
     /// Implements the Newsfeed web service host.
+    /// Messages to the clients are written by a pool of threads shared by
+    /// all sessions, which take turns with the sessions that have something
+    /// to write, so every stream has a single writer at any time.
     /// </summary>
     /// <seealso cref="proto::Newsfeed::Service" />
     class ServiceHostImpl final : public proto::Newsfeed::Service
     {
+    private:
+
+        std::vector<std::thread> m_writerThreads;
+
+        std::deque<std::shared_ptr<SyncSession>> m_readySessions;
+
+        std::mutex m_readyMutex;
+
+        std::condition_variable m_readyCondition;
+
+        bool m_shutdown;
+
+        void RunWriter();
+
     public:
 
+        ServiceHostImpl();
+
         virtual Status Talk(ServerContext *context, IOStream *stream) override;
 
-    private:
+        void ScheduleWrite(std::shared_ptr<SyncSession> session);
+
+        void Start(unsigned int numWriterThreads);
 
-        Status Respond(const proto::register_request &message,
-                       proto::global_error_t error,
-                       string &userId,
-                       string &topic,
-                       proto::req_envelope &respBuffer,
-                       OutStream &stream);
-
-        Status Respond(const proto::topic_request &message,
-                       proto::global_error_t error,
-                       const string &userId,
-                       string &topic,
-                       proto::req_envelope &respBuffer,
-                       OutStream &stream);
-
-        Status Respond(const proto::post_news_request &message,
-                       proto::global_error_t error,
-                       const string &userId,
-                       const string &topic,
-                       proto::req_envelope &respBuffer,
-                       OutStream &stream);
+        void Shutdown();
     };
 
 }// end of namespace newsfeed
@@ -4,11 +4,18 @@
 #include <iostream>
 #include <memory>
 #include <csignal>
+#include <chrono>
 #include <aws/core/Aws.h>
 #include <grpc++/server_builder.h>
 #include <grpc++/security/server_credentials.h>
 #include <grpc++/server.h>
+#include <grpc++/health_check_service_interface.h>
 #include "server_impl.h"
+#include "async_server_impl.h"
+#include "TopicPoller.h"
+#include "PeerFanout.h"
+#include "RetentionWorker.h"
+#include "NewsStore.h"
 #include "configuration.h"
 
 using std::string;
@@ -66,33 +73,100 @@ int main(int argc, char *argv[])
     try
     {
         using namespace newsfeed;
+        using namespace std::chrono;
+
+        const auto startTime = steady_clock::now();
 
         AwsCppSdk awsFramework;
 
         ServiceHostImpl newsfeedSvcHostImpl;
 
-        const string &svcEndpoint = Configuration::Get().settings.serviceEndpoint;
+        AsyncServiceHostImpl newsfeedAsyncSvcHostImpl;
+
+        PeerServiceImpl peerSvcImpl;
+
+        const auto &settings = Configuration::Get().settings;
+
+        const string &svcEndpoint = settings.serviceEndpoint;
+
+        // which engine will serve the clients?
+        const bool useAsyncEngine = (settings.serverEngine == "async");
+
+        /* Get ready before taking any traffic, so the first clients do
+           not pay for connections to the database or lazy initialization: */
+
+        NewsStore::GetInstance().WarmUp();
+        TopicPoller::GetInstance();
+        PeerFanout::GetInstance();
+        RetentionWorker::GetInstance();
+
+        std::cout << "Connections to the database are warm after "
+                  << duration_cast<milliseconds>(steady_clock::now() - startTime).count() << " ms" << std::endl;
+
+        // let load balancers know when this instance is ready:
+        grpc::EnableDefaultHealthCheckService(true);
 
         grpc::ServerBuilder srvBuilder;
         srvBuilder.AddListeningPort(svcEndpoint, grpc::InsecureServerCredentials());
-        srvBuilder.RegisterService(&newsfeedSvcHostImpl);
+
+        if (useAsyncEngine)
+            newsfeedAsyncSvcHostImpl.RegisterOn(srvBuilder, settings.asyncEngineThreadCount);
+        else
+        {
+            srvBuilder.RegisterService(&newsfeedSvcHostImpl);
+            newsfeedSvcHostImpl.Start(settings.syncEngineWriterThreadCount);
+        }
+
+        // receive news posted in other instances of the service?
+        if (!settings.peerEndpoints.empty())
+            srvBuilder.RegisterService(&peerSvcImpl);
         
         std::unique_ptr<grpc::Server> server = srvBuilder.BuildAndStart();
 
         if (!server)
         {
             std::cerr << "News feed service host could not be started!\n" << std::endl;
+
+            if (useAsyncEngine)
+                newsfeedAsyncSvcHostImpl.Shutdown();
+            else
+                newsfeedSvcHostImpl.Shutdown();
+
             return EXIT_FAILURE;
         }
 
+        if (useAsyncEngine)
+            newsfeedAsyncSvcHostImpl.Start();
+
+        auto healthCheckService = server->GetHealthCheckService();
+
+        if (healthCheckService != nullptr)
+            healthCheckService->SetServingStatus(true);
+
         serverIntfPtr = server.get(); // for global access (signal handling)
 
         signal(SIGINT, &termSignalHandler);
 
-        std::cout << "News feed service host is listening on " << svcEndpoint << '\n' << std::endl;
+        std::cout << "News feed service host is listening on " << svcEndpoint
+                  << " (" << (useAsyncEngine ? "asynchronous" : "synchronous") << " engine), ready after "
+                  << duration_cast<milliseconds>(steady_clock::now() - startTime).count() << " ms\n" << std::endl;
 
         server->Wait();
 
+        // no more news for the sessions still around:
+        TopicPoller::GetInstance().Shutdown();
+        PeerFanout::GetInstance().Shutdown();
+
+        if (useAsyncEngine)
+            newsfeedAsyncSvcHostImpl.Shutdown();
+        else
+            newsfeedSvcHostImpl.Shutdown();
+
+        RetentionWorker::GetInstance().Shutdown();
+
+        // let the last checkpoints of the sessions reach the database:
+        NewsStore::GetInstance().Shutdown();
+
         return EXIT_SUCCESS;
     }
     catch (std::exception &ex)
@@ -1,385 +1,395 @@
 #include "server_impl.h"
+#include "Session.h"
+#include "OutboundQueue.h"
 #include "common.h"
 #include "configuration.h"
-#include "DDBAccess.h"
+#include "NewsStore.h"
 #include <exception>
 #include <iostream>
 #include <sstream>
 #include <chrono>
-#include <atomic>
-#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include <future>
+#include <vector>
+#include <memory>
 
 namespace newsfeed
 {
     using namespace std::chrono;
 
 
-    ///////////////////
-    // Helpers
-    ///////////////////
+    //////////////////////
+    // SyncSession Class
+    //////////////////////
 
-    static void DumpMessage(const proto::register_request &msg)
+    /// <summary>
+    /// Session in the synchronous engine. Responses and news are enqueued
+    /// here, then written to the stream by a writer thread of the service host,
+    /// which is scheduled for this session whenever something is waiting.
+    /// </summary>
+    class SyncSession : public Session
     {
-        std::clog << "Received register_request message: { userid = '"
-                  << msg.userid() << "' }\n" << std::endl;
-    }
+    private:
 
-    static void DumpMessage(const proto::topic_request &msg)
-    {
-        std::clog << "Received topic_request message: { action = " << msg.action()
-                  << ", topic = '" << msg.topic() << "' }\n" << std::endl;
-    }
+        ServiceHostImpl &m_host;
 
-    static void DumpMessage(const proto::post_news_request &msg)
-    {
-        std::clog << "Received post_news_request message: { news = '"
-                  << msg.news() << "' }\n" << std::endl;
-    }
+        ServerContext *m_context;
 
+        IOStream *m_stream;
 
-    /// <summary>
-    /// Logs server error information.
-    /// </summary>
-    /// <param name="message">The error main message.</param>
-    /// <param name="details">The error details.</param>
-    static void LogError(const char *message, const string &details)
-    {
-        std::cerr << "ERROR - " << message;
+        OutboundQueue m_outQueue;
 
-        if (!details.empty())
-            std::cerr << " - " << details;
+        mutable std::mutex m_writerMutex;
 
-        std::cerr << std::endl;
-    }
+        std::condition_variable m_writerIdleCondition;
 
+        bool m_writeScheduled;
 
-    /// <summary>
-    /// Makes a <c>grpc::Status</c> object for an error situation.
-    /// </summary>
-    /// <param name="code">The status code.</param>
-    /// <param name="message">The error message.</param>
-    /// <param name="details">The error details.</param>
-    /// <returns>The constructed <c>grpc::Status</c> object.</returns>
-    static Status ErrorStatus(StatusCode code, const char *message, const string &details)
-    {
-        LogError(message, details);
-        return Status(code, message, details);
-    }
+        bool m_streamBroken;
 
+        bool m_tooSlow;
 
-    ///////////////////////
-    // SimpleSignal Class
-    ///////////////////////
+        void ScheduleWrite();
 
-    /// <summary>
-    /// Simple signal that guarantees
-    /// signalization upon end of scope
-    /// </summary>
-    class SimpleSignal
-    {
-    private:
+    protected:
+
+        virtual bool SendNews(const NewsItem &news) override;
 
-        std::atomic<bool> m_flag;
+        virtual bool IsCancelled() const override;
 
     public:
 
-        SimpleSignal()
-            : m_flag(false) {}
+        SyncSession(ServiceHostImpl &host, ServerContext *context, IOStream *stream);
 
-        ~SimpleSignal()
-        {
-            m_flag.store(true, std::memory_order_relaxed);
-        }
+        void Send(proto::req_envelope &&message);
 
-        void Set()
-        {
-            m_flag.store(true, std::memory_order_relaxed);
-        }
+        void WritePending();
 
-        bool IsSet() const
-        {
-            return m_flag.load(std::memory_order_relaxed);
-        }
+        bool WaitWriterIdle();
 
-        bool IsNotSet() const
-        {
-            return !m_flag.load(std::memory_order_relaxed);
-        }
+        void Detach();
+
+        void ReportCounters();
     };
 
-    
-    //////////////////////////
-    // ServiceHostImpl Class
-    //////////////////////////
 
     /// <summary>
-    /// Responds a register request message.
+    /// How many messages a writer thread sends to a client
+    /// before taking its turn with the other sessions.
+    /// </summary>
+    static const int maxWritesPerTurn(8);
+
+
+    /// <summary>
+    /// Initializes a new instance of the <see cref="SyncSession"/> class.
     /// </summary>
-    /// <param name="message">The message in the request.</param>
-    /// <param name="error">The error to notify the client, if one happened.</param>
-    /// <param name="userId">Will receive the user ID.</param>
-    /// <param name="topic">Will receive the topic to which the customer last subscribed.</param>
-    /// <param name="respBuffer">The response buffer.</param>
-    /// <param name="stream">The output stream.</param>
-    /// <returns>
-    /// The operation status.
-    /// </returns>
-    Status ServiceHostImpl::Respond(const proto::register_request &message,
-                                    proto::global_error_t error,
-                                    string &userId,
-                                    string &topic,
-                                    proto::req_envelope &respBuffer,
-                                    OutStream &stream)
+    /// <param name="host">The service host, whose writer threads serve this session.</param>
+    /// <param name="context">The call context.</param>
+    /// <param name="stream">The server synchronous IO stream.</param>
+    SyncSession::SyncSession(ServiceHostImpl &host, ServerContext *context, IOStream *stream)
+        : m_host(host)
+        , m_context(context)
+        , m_stream(stream)
+        , m_writeScheduled(false)
+        , m_streamBroken(false)
+        , m_tooSlow(false)
     {
-#   ifndef NDEBUG
-        DumpMessage(message);
-#   endif
-        Status status(Status::OK);
+    }
 
-        respBuffer.Clear();
-        respBuffer.set_type(proto::req_envelope_msg_type_register_response_t);
 
-        if (error == proto::global_error_t::ok)
+    /// <summary>
+    /// Makes sure a writer thread will serve this session.
+    /// </summary>
+    void SyncSession::ScheduleWrite()
+    {
         {
-            try
-            {
-                DDBAccess::GetInstance().GetOrPutUser(message.userid(), topic);
-                userId = message.userid();
-            }
-            catch (AppException &ex)
-            {
-                error = proto::global_error_t::internal;
-                status = ErrorStatus(StatusCode::INTERNAL, ex.what(), ex.GetDetails());
-            }
+            std::lock_guard<std::mutex> lock(m_writerMutex);
 
-            *respBuffer.mutable_reg_resp()->mutable_topic() = topic;
+            if (m_writeScheduled)
+                return;
+
+            m_writeScheduled = true;
         }
 
-        respBuffer.mutable_reg_resp()->set_error(error);
+        m_host.ScheduleWrite(std::static_pointer_cast<SyncSession> (shared_from_this()));
+    }
+
+
+    /// <summary>
+    /// Enqueues news delivered by the poller. When the client does not keep up
+    /// with them, the slow consumer policy of the queue might require the call
+    /// to be cancelled, so the client can reconnect and catch up.
+    /// </summary>
+    /// <param name="news">The news.</param>
+    /// <returns>Whether the news has been enqueued.</returns>
+    bool SyncSession::SendNews(const NewsItem &news)
+    {
+        if (m_tooSlow)
+            return false;
 
-        // send response
-        if (!stream.Write(respBuffer))
+        switch (m_outQueue.PushNews(news))
         {
-            status = ErrorStatus(StatusCode::UNKNOWN,
-                                 "Failed to write message on stream!",
-                                 "Attempted to respond registration request");
+        case OutboundQueue::PushResult::Enqueued:
+            ScheduleWrite();
+            return true;
+
+        case OutboundQueue::PushResult::Disconnect:
+            m_tooSlow = true;
+            LogError("Client is too slow to receive news!", "Call will be cancelled");
+            m_context->TryCancel();
+            return false;
+
+        default:
+            return false;
         }
+    }
+
 
-        return status;
+    /// <summary>
+    /// Determines whether the client has gone away. This might be asked by
+    /// asynchronous work that outlives the call, which is then taken as gone.
+    /// </summary>
+    /// <returns><c>true</c> if the call has been cancelled or is over.</returns>
+    bool SyncSession::IsCancelled() const
+    {
+        std::lock_guard<std::mutex> lock(m_writerMutex);
+        return m_context == nullptr || m_context->IsCancelled();
     }
 
 
     /// <summary>
-    /// Responds a topic request message.
+    /// Enqueues a message to send to the client, without waiting for the write.
     /// </summary>
     /// <param name="message">The message.</param>
-    /// <param name="error">The error to notify the client, if one happened.</param>
-    /// <param name="userId">The user ID.</param>
-    /// <param name="topic">Will receive the new topic.</param>
-    /// <param name="respBuffer">The response buffer.</param>
-    /// <param name="stream">The output stream.</param>
-    /// <returns>
-    /// The operation status.
-    /// </returns>
-    Status ServiceHostImpl::Respond(const proto::topic_request &message,
-                                    proto::global_error_t error,
-                                    const string &userId,
-                                    string &topic,
-                                    proto::req_envelope &respBuffer,
-                                    OutStream &stream)
+    void SyncSession::Send(proto::req_envelope &&message)
     {
-#   ifndef NDEBUG
-        DumpMessage(message);
-#   endif
-        respBuffer.Clear();
-        respBuffer.set_type(proto::req_envelope_msg_type_topic_response_t);
+        m_outQueue.PushMessage(std::move(message));
+        ScheduleWrite();
+    }
+
+
+    /// <summary>
+    /// Writes on the stream the messages waiting in the queue, then lets the
+    /// session know how many news are done with. This is only called by a
+    /// writer thread of the service host, one at a time.
+    /// </summary>
+    void SyncSession::WritePending()
+    {
+        bool broken(false);
 
-        if (error == proto::global_error_t::ok)
+        uint64_t newsWritten(0);
+
+        try
         {
-            // user not registered?
-            if (userId.empty())
-            {
-                error = proto::global_error_t::not_registered;
-                LogError("Failed to change topic!", "User is not registered");
-            }
-            // no topic specified for subscription?
-            else if (message.action() == proto::topic_action_t::subscribe
-                     && message.topic().empty())
-            {
-                error = proto::global_error_t::internal;
-                LogError("Failed to change topic!", "No topic has been specified");
-            }
-            // topic specified for unsubscription?
-            else if (message.action() == proto::topic_action_t::unsubscribe
-                     && !message.topic().empty())
+            proto::req_envelope message;
+            uint64_t newsDone;
+
+            for (int count = 0; count < maxWritesPerTurn && m_outQueue.Pop(message, newsDone); ++count)
             {
-                error = proto::global_error_t::internal;
-                LogError("Failed to change topic!", "Must not specify topic when unsubscribing");
+                if (!m_stream->Write(message))
+                {
+                    broken = true;
+                    break;
+                }
+
+                newsWritten = newsDone;
             }
         }
+        catch (std::exception &ex)
+        {
+            LogError("Generic failure when writing message on stream", ex.what());
+            broken = true;
+        }
 
-        respBuffer.mutable_topic_resp()->set_action(message.action());
+        if (newsWritten > 0)
+            OnNewsWritten(newsWritten);
 
-        if (error == proto::global_error_t::ok)
-        {
-            string newTopic;
+        bool hasMore(false);
 
-            if (message.action() == proto::topic_action_t::subscribe)
-                newTopic = message.topic();
+        {
+            std::lock_guard<std::mutex> lock(m_writerMutex);
 
-            try
+            if (broken)
             {
-                DDBAccess::GetInstance().UpdateUser(userId, newTopic);
-                topic = newTopic;
+                m_streamBroken = true;
+                m_outQueue.Close();
             }
-            catch (AppException &ex)
+
+            hasMore = !m_streamBroken && !m_outQueue.IsEmpty();
+
+            if (!hasMore)
             {
-                LogError(ex.what(), ex.GetDetails());
-                error = proto::global_error_t::internal;
+                m_writeScheduled = false;
+                m_writerIdleCondition.notify_all();
             }
         }
 
-        respBuffer.mutable_topic_resp()->set_error(error);
+        // take the turn of other sessions, then come back:
+        if (hasMore)
+            m_host.ScheduleWrite(std::static_pointer_cast<SyncSession> (shared_from_this()));
+    }
 
-        // send response
-        if (stream.Write(respBuffer))
-            return Status::OK;
-        else
-        {
-            return ErrorStatus(StatusCode::UNKNOWN,
-                               "Failed to write message on stream!",
-                               "Attempted to respond topic change request");
-        }
+
+    /// <summary>
+    /// Waits until the writer has nothing else to do for this session.
+    /// When the call has been cancelled, the messages not yet written
+    /// are discarded, so this only waits for the write in progress.
+    /// </summary>
+    /// <returns>Whether every message has been written.</returns>
+    bool SyncSession::WaitWriterIdle()
+    {
+        // client gone? then what is still in the queue will never be read:
+        if (IsCancelled())
+            m_outQueue.Close();
+
+        std::unique_lock<std::mutex> lock(m_writerMutex);
+        m_writerIdleCondition.wait(lock, [this]() { return !m_writeScheduled; });
+        return !m_streamBroken;
     }
 
 
     /// <summary>
-    /// Responds a post news request message.
+    /// Lets go of the call, which is about to end. The session might
+    /// still be referenced by asynchronous work, but no longer by the
+    /// call, so it must be closed and the writer must be idle.
     /// </summary>
-    /// <param name="message">The message.</param>
-    /// <param name="error">The error to notify the client, if one happened.</param>
-    /// <param name="userId">The user ID.</param>
-    /// <param name="topic">The topic where the news will be posted.</param>
-    /// <param name="respBuffer">The response buffer.</param>
-    /// <param name="stream">The output stream.</param>
-    /// <returns>
-    /// The operation status.
-    /// </returns>
-    Status ServiceHostImpl::Respond(const proto::post_news_request &message,
-                                    proto::global_error_t error,
-                                    const string &userId,
-                                    const string &topic,
-                                    proto::req_envelope &respBuffer,
-                                    OutStream &stream)
+    void SyncSession::Detach()
     {
-    #ifndef NDEBUG
-        DumpMessage(message);
-    #endif
+        std::lock_guard<std::mutex> lock(m_writerMutex);
+        m_context = nullptr;
+        m_stream = nullptr;
+    }
 
-        respBuffer.Clear();
-        respBuffer.set_type(proto::req_envelope_msg_type_post_news_response_t);
 
-        if (error == proto::global_error_t::ok)
-        {
-            // user not registered?
-            if (userId.empty())
-            {
-                error = proto::global_error_t::not_registered;
-                LogError("Failed to post news!", "User is not registered");
-            }
-            // not subscribing to any topic?
-            else if (topic.empty())
-            {
-                error = proto::global_error_t::internal;
-                LogError("Failed to post news!", "User is not subscribing to any topic");
-            }
-        }
+    /// <summary>
+    /// Reports in the log how the client coped with the flow of news.
+    /// </summary>
+    void SyncSession::ReportCounters()
+    {
+        m_outQueue.ReportCounters(GetUserId());
+    }
+
+    
+    //////////////////////////
+    // ServiceHostImpl Class
+    //////////////////////////
+
+    /// <summary>
+    /// Initializes a new instance of the <see cref="ServiceHostImpl"/> class.
+    /// </summary>
+    ServiceHostImpl::ServiceHostImpl()
+        : m_shutdown(false)
+    {
+    }
+
+
+    /// <summary>
+    /// Puts a session in line to be served by a writer thread.
+    /// </summary>
+    /// <param name="session">The session.</param>
+    void ServiceHostImpl::ScheduleWrite(std::shared_ptr<SyncSession> session)
+    {
+        std::lock_guard<std::mutex> lock(m_readyMutex);
+        m_readySessions.push_back(std::move(session));
+        m_readyCondition.notify_one();
+    }
 
-        if (error == proto::global_error_t::ok)
+
+    /// <summary>
+    /// Serves the sessions with messages to write, until shutdown.
+    /// </summary>
+    void ServiceHostImpl::RunWriter()
+    {
+        while (true)
         {
-            try
-            {
-                DDBAccess::GetInstance().PutNews(topic, userId, message.news());
-            }
-            catch (AppException &ex)
+            std::shared_ptr<SyncSession> session;
+
             {
-                LogError(ex.what(), ex.GetDetails());
-                error = proto::global_error_t::internal;
+                std::unique_lock<std::mutex> lock(m_readyMutex);
+
+                m_readyCondition.wait(lock, [this]() { return m_shutdown || !m_readySessions.empty(); });
+
+                if (m_readySessions.empty())
+                    return;
+
+                session = std::move(m_readySessions.front());
+                m_readySessions.pop_front();
             }
+
+            session->WritePending();
         }
+    }
 
-        respBuffer.mutable_post_resp()->set_error(error);
 
-        // send response
-        if (stream.Write(respBuffer))
-            return Status::OK;
-        else
+    /// <summary>
+    /// Starts the threads that write messages to the clients.
+    /// This must be called before the server starts taking calls.
+    /// </summary>
+    /// <param name="numWriterThreads">How many writer threads to start.</param>
+    void ServiceHostImpl::Start(unsigned int numWriterThreads)
+    {
+        try
+        {
+            if (numWriterThreads == 0)
+                numWriterThreads = 1;
+
+            for (unsigned int idx = 0; idx < numWriterThreads; ++idx)
+                m_writerThreads.push_back(std::thread(&ServiceHostImpl::RunWriter, this));
+        }
+        catch (std::system_error &ex)
         {
-            return ErrorStatus(StatusCode::UNKNOWN,
-                               "Failed to write message on stream!",
-                               "Attempted to respond post news request");
+            std::ostringstream oss;
+            oss << "System error when starting synchronous engine: " << StdLibExt::GetDetailsFromSystemError(ex);
+            throw AppException(oss.str());
         }
     }
 
 
     /// <summary>
-    /// Sends back to the client any available news in its subcribed topic.
+    /// Stops the writer threads once they have served the sessions in line.
+    /// This must be called after the server has been shut down.
     /// </summary>
-    /// <param name="userId">The user ID.</param>
-    /// <param name="endOfConnection">A signal for end of connection.</param>
-    /// <param name="stream">The output stream.</param>
-    /// <returns>
-    /// The thread final status.
-    /// </returns>
-    Status SendAvailableNews(const string &userId,
-                             const SimpleSignal &endOfConnection,
-                             OutStream &stream)
+    void ServiceHostImpl::Shutdown()
     {
-        try
         {
-            proto::req_envelope buffer;
-            buffer.set_type(proto::req_envelope_msg_type::req_envelope_msg_type_news_t);
+            std::lock_guard<std::mutex> lock(m_readyMutex);
+            m_shutdown = true;
+        }
 
-            std::vector<string> news;
+        m_readyCondition.notify_all();
 
-            while (endOfConnection.IsNotSet())
-            {
-                try
-                {
-                    DDBAccess::GetInstance().GetNews(userId, news);
-                }
-                catch (AppException &ex)
-                {
-                    LogError(ex.what(), ex.GetDetails());
-                }
+        for (auto &thread : m_writerThreads)
+            thread.join();
 
-                for (auto &entry : news)
-                {
-                    buffer.mutable_news_data()->set_data(std::move(entry));
-                    
-                    if (!stream.Write(buffer))
-                    {
-                        return ErrorStatus(StatusCode::UNKNOWN,
-                                           "Failed to write message on stream!",
-                                           "Attempted to send news to client");
-                    }
-                }
+        m_writerThreads.clear();
+    }
 
-                std::this_thread::sleep_for(
-                    seconds(Configuration::Get().settings.newsPollingIntervalSecs)
-                );
-            }
 
-            return Status::OK;
-        }
-        catch (std::exception &ex)
+    /// <summary>
+    /// Guarantees that, upon end of scope, the session stops receiving
+    /// news, the writer threads are done with its stream, and nothing
+    /// else refers to the call.
+    /// </summary>
+    class SessionEndGuard
+    {
+    private:
+
+        SyncSession &m_session;
+
+    public:
+
+        SessionEndGuard(SyncSession &session)
+            : m_session(session) {}
+
+        ~SessionEndGuard()
         {
-            return ErrorStatus(StatusCode::INTERNAL,
-                               "Generic failure in parallel thread",
-                               ex.what());
+            m_session.Close();
+            m_session.WaitWriterIdle();
+            m_session.SaveLastFeed();
+            m_session.Detach();
         }
-    }
+    };
 
 
     /// <summary>
@@ -394,131 +404,57 @@ namespace newsfeed
         {
             Status status(Status::OK);
 
-            SimpleSignal endOfConnection;
-            
-            std::future<Status> writerFuture;
+            auto session = std::make_shared<SyncSession>(*this, context, stream);
 
-            string curUserId;
-            string curTopic;
+            SessionEndGuard sessionEndGuard(*session);
 
-            proto::req_envelope response;
             proto::req_envelope request;
             
             // loop interrupts when the connection is idle for too long
             while (stream->Read(&request))
             {
-                auto error = proto::global_error_t::ok;
-
-                bool uncompliantPayload;
-
-                auto reqType = request.type();
+                /* The response might come from a thread of the store, but this
+                   thread belongs to the call, so it can wait for it right here: */
+                auto responded = std::make_shared<std::promise<Status>>();
+                auto future = responded->get_future();
 
-                switch (reqType)
+                session->HandleRequest(request, [session, responded](const Status &status, proto::req_envelope &response)
                 {
-                case proto::req_envelope_msg_type_register_request_t:
-
-                    if ((uncompliantPayload = !request.has_reg_req()))
-                        error = proto::global_error_t::internal;
-
-                    if (!curUserId.empty())
-                    {
-                        error = proto::global_error_t::internal;
-                        LogError("Could not register user!", "Only one registration per session is allowed");
-                    }
-
-                    status = Respond(request.reg_req(),
-                                     error, 
-                                     curUserId,
-                                     curTopic,
-                                     response,
-                                     *stream);
-
-                    if (!writerFuture.valid())
-                    {
-                        // Start a parallel thread to monitor for news and send back to the client:
-                        writerFuture = std::async(std::launch::async,
-                            [this, &curUserId, &endOfConnection, stream]()
-                            {
-                                return SendAvailableNews(curUserId, endOfConnection, *stream);
-                            });
-                    }
-                    break;
-
-                case proto::req_envelope_msg_type_topic_request_t:
-
-                    if ((uncompliantPayload = !request.has_topic_req()))
-                        error = proto::global_error_t::internal;
+                    // send response (the writer takes it from here)
+                    if (response.has_type())
+                        session->Send(std::move(response));
 
-                    status = Respond(request.topic_req(),
-                                     error,
-                                     curUserId,
-                                     curTopic,
-                                     response,
-                                     *stream);
-                    break;
+                    responded->set_value(status);
+                });
 
-                case proto::req_envelope_msg_type_post_news_request_t:
+                status = future.get();
 
-                    if ((uncompliantPayload = !request.has_post_req()))
-                        error = proto::global_error_t::internal;
+                request.Clear();
 
-                    status = Respond(request.post_req(),
-                                     error,
-                                     curUserId,
-                                     curTopic,
-                                     response,
-                                     *stream);
+                if (!status.ok())
                     break;
 
-                case proto::req_envelope_msg_type_register_response_t:
-                case proto::req_envelope_msg_type_topic_response_t:
-                case proto::req_envelope_msg_type_post_news_response_t:
-                    {
-                        std::ostringstream oss;
-                        oss << "News feed server has received a request whose type is unexpected: " << reqType;
-                        status = ErrorStatus(StatusCode::DO_NOT_USE, "Unexpected message type!", oss.str());
-                        break;
-                    }
-
-                default:
-                    {
-                        std::ostringstream oss;
-                        oss << "News feed server has received a request whose type is unknown: " << reqType;
-                        status = ErrorStatus(StatusCode::UNIMPLEMENTED, "Unknown message type!", oss.str());
-                        break;
-                    }
-                }
+            }// end of loop
 
-                request.Clear();
+            /* We get here when there is no more messages or an error
+               took place, so stop the news and let the writer finish: */
 
-                // any trouble giving the first response?
+            session->Close();
 
-                if (uncompliantPayload)
-                {
-                    std::ostringstream oss;
-                    oss << "Request payload is uncompliant with message type " << reqType;
-                    status = ErrorStatus(StatusCode::INVALID_ARGUMENT, "Invalid request!", oss.str());
-                    break;
-                }
+            bool allWritten = session->WaitWriterIdle();
 
-                if (!status.ok())
-                    break;
-                
-                // any trouble to feed the client with news?
-                if (writerFuture.wait_for(seconds(0)) == std::future_status::ready)
-                    return writerFuture.get();
+            session->SaveLastFeed();
 
-            }// end of loop
+            session->ReportCounters();
 
-            /* We get here when there is no more messages or an error
-               took place, so ask writer loop to finish as well: */
+            if (!allWritten && status.ok())
+            {
+                return ErrorStatus(StatusCode::UNKNOWN,
+                                   "Failed to write message on stream!",
+                                   "Attempted to send message to client");
+            }
 
-            endOfConnection.Set();
-            
-            if (!status.ok())
-                return status;
-            else
-                return writerFuture.get();
+            return status;
         }
         catch (std::system_error &ex)
         {
@@ -526,12 +462,6 @@ namespace newsfeed
             oss << "News feed service host had a system error: " << StdLibExt::GetDetailsFromSystemError(ex);
             return ErrorStatus(StatusCode::INTERNAL, "Server error", oss.str());
         }
-        catch (std::future_error &ex)
-        {
-            std::ostringstream oss;
-            oss << "News feed service host had a system error: " << StdLibExt::GetDetailsFromFutureError(ex);
-            return ErrorStatus(StatusCode::INTERNAL, "Server error", oss.str());
-        }
         catch (std::exception &ex)
         {
             std::ostringstream oss;